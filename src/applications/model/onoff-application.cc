@@ -41,6 +41,7 @@
 #include "ns3/udp-socket-factory.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("OnOffApplication");
 
@@ -62,6 +63,13 @@ OnOffApplication::GetTypeId (void)
                    UintegerValue (512),
                    MakeUintegerAccessor (&OnOffApplication::m_pktSize),
                    MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("BurstInterval",
+                   "The minimum time between two sending events in on state. "
+                   "The packets generated meanwhile are sent in a burst. "
+                   "Zero sends each packet from its own event.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&OnOffApplication::m_burstInterval),
+                   MakeTimeChecker ())
     .AddAttribute ("Remote", "The address of the destination",
                    AddressValue (),
                    MakeAddressAccessor (&OnOffApplication::m_peer),
@@ -197,10 +205,17 @@ void OnOffApplication::CancelEvents ()
 
   if (m_sendEvent.IsRunning () && m_cbrRateFailSafe == m_cbrRate )
     { // Cancel the pending send packet event
-      // Calculate residual bits since last packet sent
-      Time delta (Simulator::Now () - m_lastStartTime);
-      int64x64_t bits = delta.To (Time::S) * m_cbrRate.GetBitRate ();
-      m_residualBits += bits.GetHigh ();
+      if (!m_burstInterval.IsZero ())
+        { // Send the packets generated before now
+          SendGeneratedPackets ();
+        }
+      else
+        {
+          // Calculate residual bits since last packet sent
+          Time delta (Simulator::Now () - m_lastStartTime);
+          int64x64_t bits = delta.To (Time::S) * m_cbrRate.GetBitRate ();
+          m_residualBits += bits.GetHigh ();
+        }
     }
   m_cbrRateFailSafe = m_cbrRate;
   Simulator::Cancel (m_sendEvent);
@@ -229,7 +244,18 @@ void OnOffApplication::ScheduleNextTx ()
 {
   NS_LOG_FUNCTION (this);
 
-  if (m_maxBytes == 0 || m_totBytes < m_maxBytes)
+  if ((m_maxBytes == 0 || m_totBytes < m_maxBytes) && !m_burstInterval.IsZero ())
+    {
+      // Wake up after the burst interval, or once the next packet is
+      // complete if it takes longer
+      uint32_t bits = m_pktSize * 8 - std::min (m_residualBits, m_pktSize * 8);
+      Time nextTime = std::max (m_burstInterval,
+                                Seconds (bits / static_cast<double>(m_cbrRate.GetBitRate ())));
+      NS_LOG_LOGIC ("nextTime = " << nextTime);
+      m_sendEvent = Simulator::Schedule (nextTime,
+                                         &OnOffApplication::SendBurst, this);
+    }
+  else if (m_maxBytes == 0 || m_totBytes < m_maxBytes)
     {
       uint32_t bits = m_pktSize * 8 - m_residualBits;
       NS_LOG_LOGIC ("bits = " << bits);
@@ -269,6 +295,44 @@ void OnOffApplication::SendPacket ()
   NS_LOG_FUNCTION (this);
 
   NS_ASSERT (m_sendEvent.IsExpired ());
+  SendOnePacket ();
+  m_lastStartTime = Simulator::Now ();
+  m_residualBits = 0;
+  ScheduleNextTx ();
+}
+
+void OnOffApplication::SendBurst ()
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_ASSERT (m_sendEvent.IsExpired ());
+  SendGeneratedPackets ();
+  ScheduleNextTx ();
+}
+
+void OnOffApplication::SendGeneratedPackets ()
+{
+  NS_LOG_FUNCTION (this);
+
+  // Round the bits generated since the last burst to the nearest bit:
+  // truncating them would lower the rate at each burst
+  Time delta (Simulator::Now () - m_lastStartTime);
+  int64x64_t generated = delta.To (Time::S) * m_cbrRate.GetBitRate () + int64x64_t (0.5);
+  uint64_t bits = m_residualBits + generated.GetHigh ();
+  uint64_t packetBits = m_pktSize * 8;
+  while (bits >= packetBits && (m_maxBytes == 0 || m_totBytes < m_maxBytes))
+    {
+      SendOnePacket ();
+      bits -= packetBits;
+    }
+  m_lastStartTime = Simulator::Now ();
+  m_residualBits = std::min (bits, packetBits - 1);
+}
+
+void OnOffApplication::SendOnePacket ()
+{
+  NS_LOG_FUNCTION (this);
+
   Ptr<Packet> packet = Create<Packet> (m_pktSize);
   m_txTrace (packet);
   m_socket->Send (packet);
@@ -291,9 +355,6 @@ void OnOffApplication::SendPacket ()
                    << " port " << Inet6SocketAddress::ConvertFrom (m_peer).GetPort ()
                    << " total Tx " << m_totBytes << " bytes");
     }
-  m_lastStartTime = Simulator::Now ();
-  m_residualBits = 0;
-  ScheduleNextTx ();
 }
 
 
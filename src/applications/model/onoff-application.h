@@ -82,6 +82,14 @@ class Socket;
 *
 * If the underlying socket type supports broadcast, this application
 * will automatically enable the SetAllowBroadcast(true) socket option.
+*
+* At high data rates, the single event per packet can dominate the cost
+* of a simulation. A non-zero "BurstInterval" attribute makes the
+* application wake up at most once per interval instead, and send back
+* to back the packets generated at the data rate since its last wake-up.
+* The long-term rate is the same; each packet is delayed by at most one
+* interval. When a packet takes longer than the interval to generate,
+* the application wakes up when it is complete, as without bursts.
 */
 class OnOffApplication : public Application 
 {
@@ -147,6 +155,20 @@ private:
    * \brief Send a packet
    */
   void SendPacket ();
+  /**
+   * \brief Send the packets generated since the last burst
+   */
+  void SendBurst ();
+
+  /**
+   * \brief Send the packets generated at the data rate since
+   * m_lastStartTime, and keep the bits left in m_residualBits
+   */
+  void SendGeneratedPackets ();
+  /**
+   * \brief Create a packet, trace it and send it to the socket
+   */
+  void SendOnePacket ();
 
   Ptr<Socket>     m_socket;       //!< Associated socket
   Address         m_peer;         //!< Peer address
@@ -156,6 +178,7 @@ private:
   DataRate        m_cbrRate;      //!< Rate that data is generated
   DataRate        m_cbrRateFailSafe;      //!< Rate that data is generated (check copy)
   uint32_t        m_pktSize;      //!< Size of packets
+  Time            m_burstInterval; //!< Minimum time between two sending events, zero for one event per packet
   uint32_t        m_residualBits; //!< Number of generated, but not sent, bits
   Time            m_lastStartTime; //!< Time last packet sent
   uint32_t        m_maxBytes;     //!< Limit total number of bytes sent
@@ -32,6 +32,7 @@
 #include "seq-ts-header.h"
 #include <cstdlib>
 #include <cstdio>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -53,6 +54,12 @@ UdpClient::GetTypeId (void)
                    "The time to wait between packets", TimeValue (Seconds (1.0)),
                    MakeTimeAccessor (&UdpClient::m_interval),
                    MakeTimeChecker ())
+    .AddAttribute ("BurstInterval",
+                   "The minimum time between two sending events. The packets due "
+                   "meanwhile are sent in a burst. Zero sends each packet from its own event.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&UdpClient::m_burstInterval),
+                   MakeTimeChecker ())
     .AddAttribute ("RemoteAddress",
                    "The destination Address of the outbound packets",
                    AddressValue (),
@@ -137,6 +144,7 @@ UdpClient::StartApplication (void)
     }
 
   m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+  m_nextTx = Simulator::Now ();
   m_sendEvent = Simulator::Schedule (Seconds (0.0), &UdpClient::Send, this);
 }
 
@@ -152,6 +160,34 @@ UdpClient::Send (void)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (m_sendEvent.IsExpired ());
+  if (m_burstInterval.IsZero ())
+    {
+      SendPacket ();
+      if (m_sent < m_count)
+        {
+          m_sendEvent = Simulator::Schedule (m_interval, &UdpClient::Send, this);
+        }
+      return;
+    }
+  // Send the packets due until now, then wake up after the burst
+  // interval, or when the next packet is due if it is later
+  do
+    {
+      SendPacket ();
+      m_nextTx += m_interval;
+    }
+  while (m_sent < m_count && m_nextTx <= Simulator::Now ());
+  if (m_sent < m_count)
+    {
+      m_sendEvent = Simulator::Schedule (std::max (m_burstInterval, m_nextTx - Simulator::Now ()),
+                                         &UdpClient::Send, this);
+    }
+}
+
+void
+UdpClient::SendPacket (void)
+{
+  NS_LOG_FUNCTION (this);
   SeqTsHeader seqTs;
   seqTs.SetSeq (m_sent);
   Ptr<Packet> p = Create<Packet> (m_size-(8+4)); // 8+4 : the size of the seqTs header
@@ -181,11 +217,6 @@ UdpClient::Send (void)
       NS_LOG_INFO ("Error while sending " << m_size << " bytes to "
                                           << peerAddressStringStream.str ());
     }
-
-  if (m_sent < m_count)
-    {
-      m_sendEvent = Simulator::Schedule (m_interval, &UdpClient::Send, this);
-    }
 }
 
 } // Namespace ns3
@@ -39,6 +39,9 @@ class Packet;
  * \brief A Udp client. Sends UDP packet carrying sequence number and time stamp
  *  in their payloads
  *
+ * With a non-zero "BurstInterval" attribute, the client wakes up at most
+ * once per interval and sends back to back the packets due since its last
+ * wake-up, instead of scheduling an event per packet.
  */
 class UdpClient : public Application
 {
@@ -81,12 +84,19 @@ private:
   virtual void StopApplication (void);
 
   /**
-   * \brief Send a packet
+   * \brief Send a packet, or the packets due in burst mode
    */
   void Send (void);
 
+  /**
+   * \brief Create a packet with the next sequence number and send it
+   */
+  void SendPacket (void);
+
   uint32_t m_count; //!< Maximum number of packets the application will send
   Time m_interval; //!< Packet inter-send time
+  Time m_burstInterval; //!< Minimum time between two sending events, zero for one event per packet
+  Time m_nextTx; //!< Time the next packet is due, in burst mode
   uint32_t m_size; //!< Size of the sent packet (including the SeqTsHeader)
 
   uint32_t m_sent; //!< Counter for sent packets
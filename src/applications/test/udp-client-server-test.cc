@@ -30,6 +30,8 @@
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/udp-client-server-helper.h"
 #include "ns3/udp-echo-helper.h"
+#include "ns3/on-off-helper.h"
+#include "ns3/data-rate.h"
 #include "ns3/simple-net-device.h"
 #include "ns3/simple-channel.h"
 #include "ns3/test.h"
@@ -331,6 +333,184 @@ void UdpEchoClientSetFillTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * Test that an udpClient application in burst mode sends all its packets
+ * from fewer events, and that they are correctly received by an udpServer
+ * application
+ */
+
+class UdpClientBurstTestCase : public TestCase
+{
+public:
+  UdpClientBurstTestCase ();
+  virtual ~UdpClientBurstTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+};
+
+UdpClientBurstTestCase::UdpClientBurstTestCase ()
+  : TestCase ("Test that the udp packets sent in bursts by an udpClient application are correctly received by an udpServer application")
+{
+}
+
+UdpClientBurstTestCase::~UdpClientBurstTestCase ()
+{
+}
+
+void UdpClientBurstTestCase::DoRun (void)
+{
+  NodeContainer n;
+  n.Create (2);
+
+  InternetStackHelper internet;
+  internet.Install (n);
+
+  Ptr<SimpleNetDevice> txDev = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleNetDevice> rxDev = CreateObject<SimpleNetDevice> ();
+  n.Get (0)->AddDevice (txDev);
+  n.Get (1)->AddDevice (rxDev);
+  Ptr<SimpleChannel> channel1 = CreateObject<SimpleChannel> ();
+  rxDev->SetChannel (channel1);
+  txDev->SetChannel (channel1);
+  NetDeviceContainer d;
+  d.Add (txDev);
+  d.Add (rxDev);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer i = ipv4.Assign (d);
+
+  uint16_t port = 4000;
+  UdpServerHelper server (port);
+  ApplicationContainer apps = server.Install (n.Get (1));
+  apps.Start (Seconds (1.0));
+  apps.Stop (Seconds (10.0));
+
+  // 1000 packets due every millisecond, sent every 10 milliseconds: the
+  // last ones are due at 2.999s and sent at 3s
+  UdpClientHelper client (i.GetAddress (1), port);
+  client.SetAttribute ("MaxPackets", UintegerValue (1000));
+  client.SetAttribute ("Interval", TimeValue (MilliSeconds (1)));
+  client.SetAttribute ("BurstInterval", TimeValue (MilliSeconds (10)));
+  client.SetAttribute ("PacketSize", UintegerValue (1024));
+  apps = client.Install (n.Get (0));
+  apps.Start (Seconds (2.0));
+  apps.Stop (Seconds (4.0));
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (server.GetServer ()->GetLost (), 0, "Packets were lost !");
+  NS_TEST_ASSERT_MSG_EQ (server.GetServer ()->GetReceived (), 1000, "Did not receive expected number of packets !");
+}
+
+/**
+ * Test that an OnOffApplication in burst mode sends as many packets as
+ * with one event per packet, from fewer events
+ */
+
+class OnOffBurstTestCase : public TestCase
+{
+public:
+  OnOffBurstTestCase ();
+  virtual ~OnOffBurstTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run an OnOffApplication alternating 0.3s on and 0.2s off periods
+   * \param burstInterval the BurstInterval attribute of the application
+   */
+  void RunOnOff (Time burstInterval);
+  /// Trace sink of the Tx trace of the application
+  void Tx (Ptr<const Packet> packet);
+
+  uint32_t m_txPackets;    //!< number of packets sent
+  uint32_t m_txEvents;     //!< number of distinct times packets were sent at
+  Time m_lastTx;           //!< time of the last packet sent
+};
+
+OnOffBurstTestCase::OnOffBurstTestCase ()
+  : TestCase ("Test that an OnOffApplication sends at the same rate in burst mode")
+{
+}
+
+OnOffBurstTestCase::~OnOffBurstTestCase ()
+{
+}
+
+void
+OnOffBurstTestCase::Tx (Ptr<const Packet> packet)
+{
+  NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), 1000, "Wrong packet size");
+  if (m_txPackets == 0 || Simulator::Now () != m_lastTx)
+    {
+      m_txEvents++;
+    }
+  m_txPackets++;
+  m_lastTx = Simulator::Now ();
+}
+
+void
+OnOffBurstTestCase::RunOnOff (Time burstInterval)
+{
+  m_txPackets = 0;
+  m_txEvents = 0;
+
+  NodeContainer n;
+  n.Create (2);
+
+  InternetStackHelper internet;
+  internet.Install (n);
+
+  Ptr<SimpleNetDevice> txDev = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleNetDevice> rxDev = CreateObject<SimpleNetDevice> ();
+  n.Get (0)->AddDevice (txDev);
+  n.Get (1)->AddDevice (rxDev);
+  Ptr<SimpleChannel> channel1 = CreateObject<SimpleChannel> ();
+  rxDev->SetChannel (channel1);
+  txDev->SetChannel (channel1);
+  NetDeviceContainer d;
+  d.Add (txDev);
+  d.Add (rxDev);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer i = ipv4.Assign (d);
+
+  // 8 Mb/s of 1000 bytes packets: a packet every millisecond
+  OnOffHelper onoff ("ns3::UdpSocketFactory", InetSocketAddress (i.GetAddress (1), 4000));
+  onoff.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=0.3]"));
+  onoff.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0.2]"));
+  onoff.SetAttribute ("DataRate", DataRateValue (DataRate ("8Mb/s")));
+  onoff.SetAttribute ("PacketSize", UintegerValue (1000));
+  onoff.SetAttribute ("BurstInterval", TimeValue (burstInterval));
+  ApplicationContainer apps = onoff.Install (n.Get (0));
+  apps.Get (0)->TraceConnectWithoutContext ("Tx", MakeCallback (&OnOffBurstTestCase::Tx, this));
+  apps.Start (Seconds (1.0));
+  apps.Stop (Seconds (3.0));
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+OnOffBurstTestCase::DoRun (void)
+{
+  RunOnOff (Seconds (0));
+  uint32_t packets = m_txPackets;
+  NS_TEST_ASSERT_MSG_EQ (m_txEvents, packets, "Packets sent at the same time without bursts");
+  NS_TEST_ASSERT_MSG_EQ_TOL (packets, 1200, 4, "Wrong number of packets in four 0.3s on periods");
+
+  RunOnOff (MilliSeconds (10));
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_txPackets, packets, 1, "Burst mode changed the number of packets");
+  // a burst every 10 packets, and one more at the end of each on period
+  NS_TEST_ASSERT_MSG_LT (m_txEvents, packets / 10 + 8, "Too many sending events in burst mode");
+}
+
 class UdpClientServerTestSuite : public TestSuite
 {
 public:
@@ -344,6 +524,8 @@ UdpClientServerTestSuite::UdpClientServerTestSuite ()
   AddTestCase (new UdpClientServerTestCase, TestCase::QUICK);
   AddTestCase (new PacketLossCounterTestCase, TestCase::QUICK);
   AddTestCase (new UdpEchoClientSetFillTestCase, TestCase::QUICK);
+  AddTestCase (new UdpClientBurstTestCase, TestCase::QUICK);
+  AddTestCase (new OnOffBurstTestCase, TestCase::QUICK);
 }
 
 static UdpClientServerTestSuite udpClientServerTestSuite;
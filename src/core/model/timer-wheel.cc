@@ -0,0 +1,318 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "timer-wheel.h"
+#include "simulator.h"
+#include "assert.h"
+#include "log.h"
+
+NS_LOG_COMPONENT_DEFINE ("TimerWheel");
+
+namespace ns3 {
+
+TimerWheel::Entry::Entry ()
+  : m_wheel (0),
+    m_next (0),
+    m_pprev (0),
+    m_expires (0),
+    m_level (0)
+{
+}
+
+TimerWheel::Entry::Entry (const Entry &o)
+  : m_function (o.m_function),
+    m_wheel (0),
+    m_next (0),
+    m_pprev (0),
+    m_expires (0),
+    m_level (0)
+{
+}
+
+TimerWheel::Entry::~Entry ()
+{
+  if (m_wheel != 0)
+    {
+      m_wheel->Cancel (*this);
+    }
+}
+
+TimerWheel::Entry &
+TimerWheel::Entry::operator = (const Entry &o)
+{
+  m_function = o.m_function;
+  return *this;
+}
+
+void
+TimerWheel::Entry::SetFunction (Callback<void> function)
+{
+  m_function = function;
+}
+
+bool
+TimerWheel::Entry::IsPending (void) const
+{
+  return m_pprev != 0;
+}
+
+TimerWheel::TimerWheel (Time resolution)
+  : m_resolution (resolution),
+    m_size (0),
+    m_current (0),
+    m_wakeTick (0),
+    m_waking (false)
+{
+  NS_LOG_FUNCTION (this << resolution);
+  NS_ASSERT_MSG (resolution.IsStrictlyPositive (), "The resolution of a TimerWheel must be positive");
+  for (uint32_t i = 0; i < SLOTS; i++)
+    {
+      m_slots[i] = 0;
+    }
+  for (uint32_t i = 0; i < LEVELS; i++)
+    {
+      m_levelSize[i] = 0;
+    }
+}
+
+TimerWheel::~TimerWheel ()
+{
+  NS_LOG_FUNCTION (this);
+  m_wake.Cancel ();
+  for (uint32_t i = 0; i < SLOTS; i++)
+    {
+      while (m_slots[i] != 0)
+        {
+          Unlink (m_slots[i]);
+        }
+    }
+}
+
+Time
+TimerWheel::GetResolution (void) const
+{
+  return m_resolution;
+}
+
+uint32_t
+TimerWheel::GetSize (void) const
+{
+  return m_size;
+}
+
+uint64_t
+TimerWheel::TickOf (Time t) const
+{
+  return t.GetTimeStep () / m_resolution.GetTimeStep ();
+}
+
+void
+TimerWheel::Schedule (Entry &entry, Time delay)
+{
+  NS_LOG_FUNCTION (this << &entry << delay);
+  NS_ASSERT_MSG (!entry.IsPending (), "Entry is still pending while re-scheduling.");
+  NS_ASSERT (!delay.IsStrictlyNegative ());
+  int64_t res = m_resolution.GetTimeStep ();
+  int64_t end = (Simulator::Now () + delay).GetTimeStep ();
+  entry.m_expires = (end + res - 1) / res;
+  if (m_size == 0)
+    {
+      // nothing to cascade: skip the ticks elapsed since the wheel was last used
+      m_current = std::max (m_current, TickOf (Simulator::Now ()));
+    }
+  entry.m_wheel = this;
+  Insert (&entry);
+  if (entry.m_level == 0)
+    {
+      Arm (std::max (entry.m_expires, m_current));
+    }
+  else
+    {
+      Arm ((m_current + ROOT_SIZE - 1) & ~uint64_t (ROOT_SIZE - 1));
+    }
+}
+
+void
+TimerWheel::Cancel (Entry &entry)
+{
+  NS_LOG_FUNCTION (this << &entry);
+  if (entry.IsPending ())
+    {
+      NS_ASSERT (entry.m_wheel == this);
+      // the simulator event is left as is: it finds nothing to expire
+      Unlink (&entry);
+    }
+}
+
+Time
+TimerWheel::GetDelayLeft (const Entry &entry) const
+{
+  NS_ASSERT (entry.m_wheel == this);
+  Time end = TimeStep (entry.m_expires * m_resolution.GetTimeStep ());
+  return std::max (end - Simulator::Now (), TimeStep (0));
+}
+
+void
+TimerWheel::Insert (Entry *entry)
+{
+  uint64_t expires = std::max (entry->m_expires, m_current);
+  uint64_t ticks = expires - m_current;
+  uint32_t slot;
+  if (ticks < ROOT_SIZE)
+    {
+      entry->m_level = 0;
+      slot = expires & (ROOT_SIZE - 1);
+    }
+  else if (ticks >= (uint64_t (1) << (ROOT_BITS + (LEVELS - 1) * LEVEL_BITS)))
+    {
+      // beyond the range of the wheel: wait in the next bucket of the
+      // top level, to be placed again when it is cascaded
+      uint32_t shift = ROOT_BITS + (LEVELS - 2) * LEVEL_BITS;
+      entry->m_level = LEVELS - 1;
+      slot = ROOT_SIZE + (LEVELS - 2) * LEVEL_SIZE + (((m_current >> shift) + 1) & (LEVEL_SIZE - 1));
+    }
+  else
+    {
+      uint32_t shift = ROOT_BITS;
+      entry->m_level = 1;
+      while (ticks >= (uint64_t (1) << (shift + LEVEL_BITS)))
+        {
+          entry->m_level++;
+          shift += LEVEL_BITS;
+        }
+      slot = ROOT_SIZE + (entry->m_level - 1) * LEVEL_SIZE + ((expires >> shift) & (LEVEL_SIZE - 1));
+    }
+  Entry **head = &m_slots[slot];
+  entry->m_next = *head;
+  if (*head != 0)
+    {
+      (*head)->m_pprev = &entry->m_next;
+    }
+  *head = entry;
+  entry->m_pprev = head;
+  m_levelSize[entry->m_level]++;
+  m_size++;
+}
+
+void
+TimerWheel::Unlink (Entry *entry)
+{
+  *entry->m_pprev = entry->m_next;
+  if (entry->m_next != 0)
+    {
+      entry->m_next->m_pprev = entry->m_pprev;
+    }
+  entry->m_next = 0;
+  entry->m_pprev = 0;
+  entry->m_wheel = 0;
+  m_levelSize[entry->m_level]--;
+  m_size--;
+}
+
+uint32_t
+TimerWheel::Cascade (uint32_t level)
+{
+  uint32_t shift = ROOT_BITS + (level - 1) * LEVEL_BITS;
+  uint32_t index = (m_current >> shift) & (LEVEL_SIZE - 1);
+  Entry **head = &m_slots[ROOT_SIZE + (level - 1) * LEVEL_SIZE + index];
+  Entry *list = *head;
+  *head = 0;
+  if (list != 0)
+    {
+      list->m_pprev = &list;
+    }
+  while (list != 0)
+    {
+      Entry *entry = list;
+      Unlink (entry);
+      entry->m_wheel = this;
+      Insert (entry);
+    }
+  return index;
+}
+
+uint64_t
+TimerWheel::NextTick (void) const
+{
+  bool upper = m_size > m_levelSize[0];
+  uint64_t tick = m_current;
+  for (uint32_t i = 0; i < ROOT_SIZE; i++, tick++)
+    {
+      if (m_slots[tick & (ROOT_SIZE - 1)] != 0
+          || (upper && (tick & (ROOT_SIZE - 1)) == 0))
+        {
+          return tick;
+        }
+    }
+  NS_ASSERT_MSG (false, "TimerWheel: no expiration found in a non-empty wheel");
+  return tick;
+}
+
+void
+TimerWheel::Arm (uint64_t tick)
+{
+  if (m_waking || (m_wake.IsRunning () && m_wakeTick <= tick))
+    {
+      return;
+    }
+  m_wake.Cancel ();
+  m_wakeTick = tick;
+  Time at = TimeStep (tick * m_resolution.GetTimeStep ());
+  m_wake = Simulator::Schedule (std::max (at - Simulator::Now (), TimeStep (0)), &TimerWheel::Wake, this);
+}
+
+void
+TimerWheel::Wake (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_waking = true;
+  uint64_t now = TickOf (Simulator::Now ());
+  while (m_size > 0 && m_current <= now)
+    {
+      if ((m_current & (ROOT_SIZE - 1)) == 0)
+        {
+          for (uint32_t level = 1; level < LEVELS; level++)
+            {
+              if (Cascade (level) != 0)
+                {
+                  break;
+                }
+            }
+        }
+      Entry **head = &m_slots[m_current & (ROOT_SIZE - 1)];
+      Entry *expired = *head;
+      *head = 0;
+      if (expired != 0)
+        {
+          expired->m_pprev = &expired;
+        }
+      m_current++;
+      // the functions may schedule or cancel any entry, including the
+      // ones left in the expired list
+      while (expired != 0)
+        {
+          Entry *entry = expired;
+          Unlink (entry);
+          entry->m_function ();
+        }
+    }
+  m_waking = false;
+  if (m_size > 0)
+    {
+      Arm (NextTick ());
+    }
+}
+
+} // namespace ns3
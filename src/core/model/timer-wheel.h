@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+#include "nstime.h"
+#include "event-id.h"
+#include "callback.h"
+#include "simple-ref-count.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup timer
+ *
+ * \brief A hierarchical timer wheel which multiplexes many timers on a
+ * single simulator event.
+ *
+ * Protocols which keep several timers per flow (e.g. TCP) cancel and
+ * reschedule them on nearly every packet. Scheduling each of them in
+ * the simulator event list makes its size, and the cost of every
+ * insertion, grow with the number of flows. A TimerWheel instead keeps
+ * its timers in buckets of a fixed granularity: scheduling or
+ * cancelling a timer is a constant-time list operation and only the
+ * earliest expiration of the wheel is scheduled in the simulator.
+ *
+ * The wheel has a first level of 256 buckets of one tick each and
+ * three upper levels of 64 buckets, each bucket covering a whole
+ * lower level; the timers of an upper-level bucket are moved down
+ * ("cascaded") when the current tick enters the range of that bucket.
+ * Delays longer than 2^26 ticks are handled by cascading the timer
+ * again from the top level.
+ *
+ * The expiration times are rounded up to the next multiple of the
+ * resolution: a timer never expires before its delay, but may expire
+ * up to one resolution later. Timers expiring at the same tick expire
+ * in an unspecified, but deterministic, order.
+ *
+ * The simulator event of the wheel inherits the context of the caller
+ * which schedules it: a wheel should be shared only by the timers of a
+ * single node.
+ *
+ * Timer and Watchdog use a wheel instead of the simulator when one is
+ * given to Timer::SetWheel or Watchdog::SetWheel.
+ */
+class TimerWheel : public SimpleRefCount<TimerWheel>
+{
+public:
+  /**
+   * \brief A timer of a TimerWheel.
+   *
+   * The entry is owned by its user, and is linked into the buckets of
+   * the wheel while it is scheduled. Destroying a scheduled entry
+   * cancels it. Copying an entry copies its function only: the copy
+   * is not scheduled.
+   */
+  class Entry
+  {
+public:
+    Entry ();
+    Entry (const Entry &o);
+    ~Entry ();
+    Entry & operator = (const Entry &o);
+
+    /**
+     * \param function the function invoked when the entry expires
+     */
+    void SetFunction (Callback<void> function);
+    /**
+     * \returns true if the entry is scheduled in a wheel and has not
+     *          expired yet, false otherwise.
+     */
+    bool IsPending (void) const;
+
+private:
+    friend class TimerWheel;
+
+    Callback<void> m_function; //!< the function invoked on expiration
+    TimerWheel *m_wheel;       //!< the wheel the entry is scheduled in, if any
+    Entry *m_next;             //!< next entry in the same bucket
+    Entry **m_pprev;           //!< link pointing to this entry, 0 if not scheduled
+    uint64_t m_expires;        //!< expiration tick
+    uint32_t m_level;          //!< level of the bucket holding the entry
+  };
+
+  /**
+   * \param resolution the duration of a tick of the wheel, strictly
+   *        positive
+   */
+  TimerWheel (Time resolution);
+  ~TimerWheel ();
+
+  /**
+   * \returns the duration of a tick of the wheel.
+   */
+  Time GetResolution (void) const;
+  /**
+   * \returns the number of entries scheduled in the wheel.
+   */
+  uint32_t GetSize (void) const;
+
+  /**
+   * \param entry the entry to schedule. It must not be pending.
+   * \param delay the minimum delay until the expiration of the entry
+   */
+  void Schedule (Entry &entry, Time delay);
+  /**
+   * \param entry the entry to cancel. Do nothing if it is not pending.
+   */
+  void Cancel (Entry &entry);
+  /**
+   * \param entry a pending entry of this wheel
+   * \returns the amount of time left until the entry expires.
+   */
+  Time GetDelayLeft (const Entry &entry) const;
+
+private:
+  TimerWheel (const TimerWheel &o);
+  TimerWheel & operator = (const TimerWheel &o);
+
+  enum
+  {
+    LEVELS = 4,
+    ROOT_BITS = 8,
+    LEVEL_BITS = 6,
+    ROOT_SIZE = 1 << ROOT_BITS,
+    LEVEL_SIZE = 1 << LEVEL_BITS,
+    SLOTS = ROOT_SIZE + (LEVELS - 1) * LEVEL_SIZE
+  };
+
+  /// \returns the tick holding a time, rounded down
+  uint64_t TickOf (Time t) const;
+  /// Link an entry into the bucket of its expiration tick
+  void Insert (Entry *entry);
+  /// Unlink a scheduled entry from its bucket
+  void Unlink (Entry *entry);
+  /**
+   * Move the entries of the current bucket of an upper level to the
+   * lower levels.
+   * \param level the upper level
+   * \returns the index of the bucket in its level
+   */
+  uint32_t Cascade (uint32_t level);
+  /// \returns the next tick with an expiration or a cascade
+  uint64_t NextTick (void) const;
+  /// Schedule the simulator event at a tick, if it is earlier than the current one
+  void Arm (uint64_t tick);
+  /// Expire the timers of the elapsed ticks
+  void Wake (void);
+
+  Time m_resolution;            //!< duration of a tick
+  Entry *m_slots[SLOTS];        //!< the buckets of all levels
+  uint32_t m_levelSize[LEVELS]; //!< number of entries at each level
+  uint32_t m_size;              //!< number of scheduled entries
+  uint64_t m_current;           //!< the first tick not expired yet
+  EventId m_wake;               //!< the simulator event which expires the timers
+  uint64_t m_wakeTick;          //!< the tick of m_wake
+  bool m_waking;                //!< true while Wake runs
+};
+
+} // namespace ns3
+
+#endif /* TIMER_WHEEL_H */
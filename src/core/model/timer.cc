@@ -49,11 +49,15 @@ Timer::~Timer ()
   NS_LOG_FUNCTION (this);
   if (m_flags & CHECK_ON_DESTROY)
     {
-      if (m_event.IsRunning ())
+      if (m_event.IsRunning () || m_entry.IsPending ())
         {
           NS_FATAL_ERROR ("Event is still running while destroying.");
         }
     }
+  else if (m_wheel != 0)
+    {
+      m_wheel->Cancel (m_entry);
+    }
   else if (m_flags & CANCEL_ON_DESTROY)
     {
       m_event.Cancel ();
@@ -71,6 +75,20 @@ Timer::SetDelay (const Time &time)
   NS_LOG_FUNCTION (this << time);
   m_delay = time;
 }
+void
+Timer::SetWheel (Ptr<TimerWheel> wheel)
+{
+  NS_LOG_FUNCTION (this << wheel);
+  NS_ASSERT_MSG (IsExpired (), "Cannot change the wheel of a running or suspended timer.");
+  m_wheel = wheel;
+  m_entry.SetFunction (MakeCallback (&Timer::Expire, this));
+}
+void
+Timer::Expire (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_impl->Invoke ();
+}
 Time
 Timer::GetDelay (void) const
 {
@@ -84,6 +102,10 @@ Timer::GetDelayLeft (void) const
   switch (GetState ())
     {
     case Timer::RUNNING:
+      if (m_wheel != 0)
+        {
+          return m_wheel->GetDelayLeft (m_entry);
+        }
       return Simulator::GetDelayLeft (m_event);
       break;
     case Timer::EXPIRED:
@@ -103,24 +125,42 @@ void
 Timer::Cancel (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_wheel != 0)
+    {
+      m_wheel->Cancel (m_entry);
+      return;
+    }
   Simulator::Cancel (m_event);
 }
 void
 Timer::Remove (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_wheel != 0)
+    {
+      m_wheel->Cancel (m_entry);
+      return;
+    }
   Simulator::Remove (m_event);
 }
 bool
 Timer::IsExpired (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_wheel != 0)
+    {
+      return !IsSuspended () && !m_entry.IsPending ();
+    }
   return !IsSuspended () && m_event.IsExpired ();
 }
 bool
 Timer::IsRunning (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_wheel != 0)
+    {
+      return !IsSuspended () && m_entry.IsPending ();
+    }
   return !IsSuspended () && m_event.IsRunning ();
 }
 bool
@@ -160,10 +200,15 @@ Timer::Schedule (Time delay)
 {
   NS_LOG_FUNCTION (this << delay);
   NS_ASSERT (m_impl != 0);
-  if (m_event.IsRunning ())
+  if (m_event.IsRunning () || m_entry.IsPending ())
     {
       NS_FATAL_ERROR ("Event is still running while re-scheduling.");
     }
+  if (m_wheel != 0)
+    {
+      m_wheel->Schedule (m_entry, delay);
+      return;
+    }
   m_event = m_impl->Schedule (delay);
 }
 
@@ -172,8 +217,8 @@ Timer::Suspend (void)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (IsRunning ());
-  m_delayLeft = Simulator::GetDelayLeft (m_event);
-  Simulator::Remove (m_event);
+  m_delayLeft = GetDelayLeft ();
+  Remove ();
   m_flags |= TIMER_SUSPENDED;
 }
 
@@ -182,7 +227,14 @@ Timer::Resume (void)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (m_flags & TIMER_SUSPENDED);
-  m_event = m_impl->Schedule (m_delayLeft);
+  if (m_wheel != 0)
+    {
+      m_wheel->Schedule (m_entry, m_delayLeft);
+    }
+  else
+    {
+      m_event = m_impl->Schedule (m_delayLeft);
+    }
   m_flags &= ~TIMER_SUSPENDED;
 }
 
@@ -24,6 +24,8 @@
 #include "nstime.h"
 #include "event-id.h"
 #include "int-to-type.h"
+#include "ptr.h"
+#include "timer-wheel.h"
 
 namespace ns3 {
 
@@ -166,6 +168,15 @@ public:
    * The next call to Schedule will schedule the timer with this delay.
    */
   void SetDelay (const Time &delay);
+  /**
+   * \param wheel the wheel in which to schedule this timer, or zero to
+   *        schedule it directly in the simulator (the default)
+   *
+   * A timer scheduled in a wheel expires at the first tick of the wheel
+   * following its delay. The wheel cannot be changed while the timer
+   * is running or suspended.
+   */
+  void SetWheel (Ptr<TimerWheel> wheel);
   /**
    * \returns the currently-configured delay for the next Schedule.
    */
@@ -235,11 +246,16 @@ private:
     TIMER_SUSPENDED = (1 << 7)
   };
 
+  /// Invoke the function of a timer scheduled in a wheel
+  void Expire (void);
+
   int m_flags;
   Time m_delay;
   EventId m_event;
   TimerImpl *m_impl;
   Time m_delayLeft;
+  Ptr<TimerWheel> m_wheel;
+  TimerWheel::Entry m_entry;
 };
 
 } // namespace ns3
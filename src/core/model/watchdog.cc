@@ -44,24 +44,48 @@ Watchdog::Ping (Time delay)
   NS_LOG_FUNCTION (this << delay);
   Time end = Simulator::Now () + delay;
   m_end = std::max (m_end, end);
-  if (m_event.IsRunning ())
+  if (m_event.IsRunning () || m_entry.IsPending ())
     {
       return;
     }
-  m_event = Simulator::Schedule (m_end - Now (), &Watchdog::Expire, this);
+  Schedule ();
+}
+
+void
+Watchdog::SetWheel (Ptr<TimerWheel> wheel)
+{
+  NS_LOG_FUNCTION (this << wheel);
+  NS_ASSERT_MSG (!m_event.IsRunning () && !m_entry.IsPending (), "Cannot change the wheel of a running watchdog.");
+  m_wheel = wheel;
+  m_entry.SetFunction (MakeCallback (&Watchdog::Expire, this));
+}
+
+void
+Watchdog::Schedule (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_wheel != 0)
+    {
+      m_wheel->Schedule (m_entry, m_end - Now ());
+    }
+  else
+    {
+      m_event = Simulator::Schedule (m_end - Now (), &Watchdog::Expire, this);
+    }
 }
 
 void
 Watchdog::Expire (void)
 {
   NS_LOG_FUNCTION (this);
-  if (m_end == Simulator::Now ())
+  // a wheel may expire the watchdog after m_end
+  if (m_end <= Simulator::Now ())
     {
       m_impl->Invoke ();
     }
   else
     {
-      m_event = Simulator::Schedule (m_end - Now (), &Watchdog::Expire, this);
+      Schedule ();
     }
 }
 
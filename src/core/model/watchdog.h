@@ -22,6 +22,8 @@
 
 #include "nstime.h"
 #include "event-id.h"
+#include "ptr.h"
+#include "timer-wheel.h"
 
 namespace ns3 {
 
@@ -49,6 +51,15 @@ public:
    */
   void Ping (Time delay);
 
+  /**
+   * \param wheel the wheel in which to schedule the expiration of this
+   *        watchdog, or zero to schedule it directly in the simulator
+   *        (the default)
+   *
+   * The wheel must be set before the first call to Ping.
+   */
+  void SetWheel (Ptr<TimerWheel> wheel);
+
   /**
    * \param fn the function
    *
@@ -127,9 +138,13 @@ public:
 
 private:
   void Expire (void);
+  /// Schedule Expire at m_end
+  void Schedule (void);
   TimerImpl *m_impl;
   EventId m_event;
   Time m_end;
+  Ptr<TimerWheel> m_wheel;
+  TimerWheel::Entry m_entry;
 };
 
 } // namespace ns3
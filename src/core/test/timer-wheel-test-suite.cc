@@ -0,0 +1,235 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <vector>
+#include "ns3/timer-wheel.h"
+#include "ns3/timer.h"
+#include "ns3/watchdog.h"
+#include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * Schedule, cancel and reschedule many entries with delays covering all
+ * the levels of a wheel, and check that each one expires once, at the
+ * first tick following its delay.
+ */
+class TimerWheelExpirationTestCase : public TestCase
+{
+public:
+  TimerWheelExpirationTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /// Schedule an entry with a random delay
+  void Start (uint32_t i);
+  /// Cancel or reschedule random entries
+  void Churn (void);
+  /// Check the expiration of an entry
+  void Expire (uint32_t i);
+  /// The function of an entry
+  static void ExpireEntry (TimerWheelExpirationTestCase *test, uint32_t i);
+
+  Ptr<TimerWheel> m_wheel;
+  Ptr<UniformRandomVariable> m_rng;
+  std::vector<TimerWheel::Entry> m_entries;
+  std::vector<Time> m_expected;    //!< expected expiration time of each entry, -1 if not pending
+  std::vector<uint32_t> m_restarts; //!< number of times each entry was rescheduled from its function
+  uint32_t m_expired;
+  uint32_t m_errors;
+};
+
+TimerWheelExpirationTestCase::TimerWheelExpirationTestCase ()
+  : TestCase ("Check the expiration times of the entries of a TimerWheel")
+{
+}
+
+void
+TimerWheelExpirationTestCase::Start (uint32_t i)
+{
+  Time delay;
+  double level = m_rng->GetValue ();
+  if (level < 0.6)
+    {
+      delay = NanoSeconds (m_rng->GetInteger (0, 300000));
+    }
+  else if (level < 0.9)
+    {
+      delay = MicroSeconds (m_rng->GetInteger (0, 100000));
+    }
+  else
+    {
+      // beyond the 2^26 ticks of the wheel
+      delay = MilliSeconds (m_rng->GetInteger (0, 200000));
+    }
+  int64_t tick = MicroSeconds (1).GetTimeStep ();
+  int64_t end = (Simulator::Now () + delay).GetTimeStep ();
+  m_expected[i] = TimeStep ((end + tick - 1) / tick * tick);
+  m_wheel->Schedule (m_entries[i], delay);
+}
+
+void
+TimerWheelExpirationTestCase::Churn (void)
+{
+  for (uint32_t n = 0; n < 20; n++)
+    {
+      uint32_t i = m_rng->GetInteger (0, m_entries.size () - 1);
+      if (!m_entries[i].IsPending ())
+        {
+          continue;
+        }
+      if (m_wheel->GetDelayLeft (m_entries[i]) != m_expected[i] - Simulator::Now ())
+        {
+          m_errors++;
+        }
+      m_wheel->Cancel (m_entries[i]);
+      m_expected[i] = Seconds (-1);
+      if (m_rng->GetValue () < 0.8)
+        {
+          Start (i);
+        }
+    }
+  if (m_wheel->GetSize () > 0)
+    {
+      Simulator::Schedule (NanoSeconds (m_rng->GetInteger (1, 20000000)), &TimerWheelExpirationTestCase::Churn, this);
+    }
+}
+
+void
+TimerWheelExpirationTestCase::Expire (uint32_t i)
+{
+  if (Simulator::Now () != m_expected[i] || m_entries[i].IsPending ())
+    {
+      m_errors++;
+    }
+  m_expected[i] = Seconds (-1);
+  m_expired++;
+  if (m_restarts[i] < 2)
+    {
+      m_restarts[i]++;
+      Start (i);
+    }
+}
+
+void
+TimerWheelExpirationTestCase::ExpireEntry (TimerWheelExpirationTestCase *test, uint32_t i)
+{
+  test->Expire (i);
+}
+
+void
+TimerWheelExpirationTestCase::DoRun (void)
+{
+  m_wheel = Create<TimerWheel> (MicroSeconds (1));
+  m_rng = CreateObject<UniformRandomVariable> ();
+  m_rng->SetStream (1);
+  m_entries.resize (2000);
+  m_expected.resize (m_entries.size (), Seconds (-1));
+  m_restarts.resize (m_entries.size (), 0);
+  m_expired = 0;
+  m_errors = 0;
+  for (uint32_t i = 0; i < m_entries.size (); i++)
+    {
+      m_entries[i].SetFunction (MakeBoundCallback (&TimerWheelExpirationTestCase::ExpireEntry, this, i));
+      Simulator::Schedule (MicroSeconds (m_rng->GetInteger (0, 1000)), &TimerWheelExpirationTestCase::Start, this, i);
+    }
+  Simulator::Schedule (MicroSeconds (1), &TimerWheelExpirationTestCase::Churn, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_errors, 0, "entries expired at the wrong time");
+  NS_TEST_ASSERT_MSG_EQ (m_wheel->GetSize (), 0, "entries left in the wheel");
+  NS_TEST_ASSERT_MSG_GT (m_expired, 2 * m_entries.size (), "too few expirations");
+  for (uint32_t i = 0; i < m_entries.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_entries[i].IsPending (), false, "entry " << i << " still pending");
+    }
+  m_entries.clear ();
+  m_wheel = 0;
+}
+
+/**
+ * Check a Timer and a Watchdog scheduled in a wheel.
+ */
+class TimerWheelTimerTestCase : public TestCase
+{
+public:
+  TimerWheelTimerTestCase ();
+  virtual void DoRun (void);
+  void Expire (Time *at);
+};
+
+TimerWheelTimerTestCase::TimerWheelTimerTestCase ()
+  : TestCase ("Check Timer and Watchdog with a TimerWheel")
+{
+}
+
+void
+TimerWheelTimerTestCase::Expire (Time *at)
+{
+  *at = Simulator::Now ();
+}
+
+void
+TimerWheelTimerTestCase::DoRun (void)
+{
+  Ptr<TimerWheel> wheel = Create<TimerWheel> (MilliSeconds (1));
+  Time timerExpired = Seconds (-1);
+  Time watchdogExpired = Seconds (-1);
+  {
+    Timer timer (Timer::CANCEL_ON_DESTROY);
+    timer.SetFunction (&TimerWheelTimerTestCase::Expire, this);
+    timer.SetArguments (&timerExpired);
+    timer.SetWheel (wheel);
+    timer.Schedule (MicroSeconds (2500));
+    NS_TEST_ASSERT_MSG_EQ (timer.GetState (), Timer::RUNNING, "timer not running");
+    NS_TEST_ASSERT_MSG_EQ (timer.GetDelayLeft (), MilliSeconds (3), "delay not rounded to the resolution");
+    timer.Suspend ();
+    NS_TEST_ASSERT_MSG_EQ (timer.GetState (), Timer::SUSPENDED, "timer not suspended");
+    NS_TEST_ASSERT_MSG_EQ (wheel->GetSize (), 0, "suspended timer left in the wheel");
+    timer.Resume ();
+    NS_TEST_ASSERT_MSG_EQ (timer.IsRunning (), true, "timer not resumed");
+
+    Watchdog watchdog;
+    watchdog.SetFunction (&TimerWheelTimerTestCase::Expire, this);
+    watchdog.SetArguments (&watchdogExpired);
+    watchdog.SetWheel (wheel);
+    watchdog.Ping (MicroSeconds (10));
+    Simulator::Schedule (MicroSeconds (5), &Watchdog::Ping, &watchdog, MicroSeconds (20));
+    Simulator::Schedule (MicroSeconds (2100), &Watchdog::Ping, &watchdog, MicroSeconds (3000));
+
+    Simulator::Run ();
+    NS_TEST_ASSERT_MSG_EQ (timer.IsExpired (), true, "timer not expired");
+  }
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (timerExpired, MilliSeconds (3), "timer expired at the wrong time");
+  // the watchdog expired at the tick of 1ms, then again after the
+  // ping at 2.1ms
+  NS_TEST_ASSERT_MSG_EQ (watchdogExpired, MilliSeconds (6), "watchdog expired at the wrong time");
+  NS_TEST_ASSERT_MSG_EQ (wheel->GetSize (), 0, "entries left in the wheel");
+}
+
+static class TimerWheelTestSuite : public TestSuite
+{
+public:
+  TimerWheelTestSuite ()
+    : TestSuite ("timer-wheel", UNIT)
+  {
+    AddTestCase (new TimerWheelExpirationTestCase (), TestCase::QUICK);
+    AddTestCase (new TimerWheelTimerTestCase (), TestCase::QUICK);
+  }
+} g_timerWheelTestSuite;
@@ -23,6 +23,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/delivery-batcher.h"
 
 NS_LOG_COMPONENT_DEFINE ("CsmaChannel");
 
@@ -221,6 +222,7 @@ CsmaChannel::TransmitEnd ()
 
   NS_LOG_LOGIC ("Receive");
 
+  DeliveryBatcher batcher;
   std::vector<CsmaDeviceRec>::iterator it;
   uint32_t devId = 0;
   for (it = m_deviceList.begin (); it < m_deviceList.end (); it++)
@@ -228,13 +230,14 @@ CsmaChannel::TransmitEnd ()
       if (it->IsActive ())
         {
           // schedule reception events
-          Simulator::ScheduleWithContext (it->devicePtr->GetNode ()->GetId (),
-                                          m_delay,
-                                          &CsmaNetDevice::Receive, it->devicePtr,
-                                          m_currentPkt->Copy (), m_deviceList[m_currentSrc].devicePtr);
+          batcher.Add (it->devicePtr->GetNode ()->GetId (),
+                       m_delay,
+                       MakeEvent (&CsmaNetDevice::Receive, it->devicePtr,
+                                  m_currentPkt->Copy (), m_deviceList[m_currentSrc].devicePtr));
         }
       devId++;
     }
+  batcher.Schedule ();
 
   // also schedule for the tx side to go back to IDLE
   Simulator::Schedule (m_delay, &CsmaChannel::PropagationCompleteEvent,
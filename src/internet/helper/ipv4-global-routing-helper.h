@@ -83,6 +83,20 @@ public:
    *
    */
   static void RecomputeRoutingTables (void);
+  /**
+   * \brief Update the routes previously installed by PopulateRoutingTables()
+   * after a change in the global topology.
+   *
+   * The result is the same as the one of RecomputeRoutingTables(), but
+   * when the only changes are removed links (for instance, interfaces
+   * which went down), the shortest paths are only recomputed for the
+   * routers which used one of those links, and the other routers only lose
+   * their routes to the addresses which are no longer reachable.  Any other
+   * change triggers a full recomputation.  So does the first call, unless
+   * the IncrementalRouteUpdates attribute of Ipv4GlobalRouting is set, since
+   * the shortest path trees are only recorded from then on.
+   */
+  static void UpdateRoutingTables (void);
 private:
   /**
    * \internal
@@ -57,16 +57,18 @@ operator<< (std::ostream& os, const CandidateQueue& q)
   for (CIter_t iter = list.begin (); iter != list.end (); iter++)
     {
       os << "<" 
-      << (*iter)->GetVertexId () << ", "
-      << (*iter)->GetDistanceFromRoot () << ", "
-      << (*iter)->GetVertexType () << ">" << std::endl;
+      << iter->vertex->GetVertexId () << ", "
+      << iter->vertex->GetDistanceFromRoot () << ", "
+      << iter->vertex->GetVertexType () << ">" << std::endl;
     }
   os << "*** CandidateQueue End ***";
   return os;
 }
 
 CandidateQueue::CandidateQueue()
-  : m_candidates ()
+  : m_candidates (),
+    m_index (),
+    m_sequence (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -94,11 +96,12 @@ CandidateQueue::Push (SPFVertex *vNew)
 {
   NS_LOG_FUNCTION (this << vNew);
 
-  CandidateList_t::iterator i = std::upper_bound (
-      m_candidates.begin (), m_candidates.end (), vNew,
-      &CandidateQueue::CompareSPFVertex
-      );
-  m_candidates.insert (i, vNew);
+  Candidate candidate;
+  candidate.vertex = vNew;
+  candidate.sequence = m_sequence++;
+  candidate.id = m_index.insert (std::make_pair (vNew->GetVertexId (), m_candidates.size ()));
+  m_candidates.push_back (candidate);
+  SiftUp (m_candidates.size () - 1);
 }
 
 SPFVertex *
@@ -110,8 +113,14 @@ CandidateQueue::Pop (void)
       return 0;
     }
 
-  SPFVertex *v = m_candidates.front ();
-  m_candidates.pop_front ();
+  SPFVertex *v = m_candidates.front ().vertex;
+  Swap (0, m_candidates.size () - 1);
+  m_index.erase (m_candidates.back ().id);
+  m_candidates.pop_back ();
+  if (!m_candidates.empty ())
+    {
+      SiftDown (0);
+    }
   return v;
 }
 
@@ -124,7 +133,7 @@ CandidateQueue::Top (void) const
       return 0;
     }
 
-  return m_candidates.front ();
+  return m_candidates.front ().vertex;
 }
 
 bool
@@ -145,18 +154,23 @@ SPFVertex *
 CandidateQueue::Find (const Ipv4Address addr) const
 {
   NS_LOG_FUNCTION (this);
-  CandidateList_t::const_iterator i = m_candidates.begin ();
+  std::pair<CandidateIndex_t::const_iterator, CandidateIndex_t::const_iterator> range =
+    m_index.equal_range (addr);
+  if (range.first == range.second)
+    {
+      return 0;
+    }
 
-  for (; i != m_candidates.end (); i++)
+  // if several candidates share this ID, return the one popped first
+  uint32_t found = range.first->second;
+  for (CandidateIndex_t::const_iterator i = range.first; i != range.second; i++)
     {
-      SPFVertex *v = *i;
-      if (v->GetVertexId () == addr)
+      if (IsBefore (i->second, found))
         {
-          return v;
+          found = i->second;
         }
     }
-
-  return 0;
+  return m_candidates[found].vertex;
 }
 
 void
@@ -164,11 +178,98 @@ CandidateQueue::Reorder (void)
 {
   NS_LOG_FUNCTION (this);
 
-  m_candidates.sort (&CandidateQueue::CompareSPFVertex);
+  for (uint32_t i = m_candidates.size () / 2; i > 0; i--)
+    {
+      SiftDown (i - 1);
+    }
   NS_LOG_LOGIC ("After reordering the CandidateQueue");
   NS_LOG_LOGIC (*this);
 }
 
+void
+CandidateQueue::DecreaseKey (SPFVertex *v)
+{
+  NS_LOG_FUNCTION (this << v);
+
+  std::pair<CandidateIndex_t::iterator, CandidateIndex_t::iterator> range =
+    m_index.equal_range (v->GetVertexId ());
+  for (CandidateIndex_t::iterator i = range.first; i != range.second; i++)
+    {
+      if (m_candidates[i->second].vertex == v)
+        {
+          m_candidates[i->second].sequence = m_sequence++;
+          SiftUp (i->second);
+          return;
+        }
+    }
+  NS_ASSERT_MSG (false, "CandidateQueue::DecreaseKey (): vertex " << v->GetVertexId () << " is not in the queue");
+}
+
+bool
+CandidateQueue::IsBefore (uint32_t i, uint32_t j) const
+{
+  const Candidate &ci = m_candidates[i];
+  const Candidate &cj = m_candidates[j];
+  if (CompareSPFVertex (ci.vertex, cj.vertex))
+    {
+      return true;
+    }
+  if (CompareSPFVertex (cj.vertex, ci.vertex))
+    {
+      return false;
+    }
+  return ci.sequence < cj.sequence;
+}
+
+void
+CandidateQueue::Swap (uint32_t i, uint32_t j)
+{
+  std::swap (m_candidates[i], m_candidates[j]);
+  m_candidates[i].id->second = i;
+  m_candidates[j].id->second = j;
+}
+
+void
+CandidateQueue::SiftUp (uint32_t i)
+{
+  while (i > 0)
+    {
+      uint32_t parent = (i - 1) / 2;
+      if (!IsBefore (i, parent))
+        {
+          break;
+        }
+      Swap (i, parent);
+      i = parent;
+    }
+}
+
+void
+CandidateQueue::SiftDown (uint32_t i)
+{
+  uint32_t n = m_candidates.size ();
+  while (true)
+    {
+      uint32_t first = i;
+      uint32_t left = 2 * i + 1;
+      uint32_t right = left + 1;
+      if (left < n && IsBefore (left, first))
+        {
+          first = left;
+        }
+      if (right < n && IsBefore (right, first))
+        {
+          first = right;
+        }
+      if (first == i)
+        {
+          break;
+        }
+      Swap (i, first);
+      i = first;
+    }
+}
+
 /*
  * In this implementation, SPFVertex follows the ordering where
  * a vertex is ranked first if its GetDistanceFromRoot () is smaller;
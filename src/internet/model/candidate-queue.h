@@ -22,7 +22,8 @@
 #define CANDIDATE_QUEUE_H
 
 #include <stdint.h>
-#include <list>
+#include <vector>
+#include <map>
 #include "ns3/ipv4-address.h"
 
 namespace ns3 {
@@ -43,8 +44,11 @@ class SPFVertex;
  *
  * Although a STL priority_queue almost does what we want, the requirement
  * for a Find () operation, the dynamic nature of the data and the derived
- * requirement for a Reorder () operation led us to implement this simple 
- * enhanced priority queue.
+ * requirement for a DecreaseKey () operation led us to implement this
+ * enhanced priority queue.  It is a binary heap indexed by vertex ID, so
+ * that Push (), Pop (), Find () and DecreaseKey () are logarithmic in the
+ * number of candidates.  Vertices which compare equal are popped in the
+ * order they were pushed (or had their distance decreased).
  */
 class CandidateQueue
 {
@@ -156,12 +160,26 @@ public:
  * increasing distance.
  *
  * This method is provided in case the values of m_distanceFromRoot change
- * during the routing calculations.
+ * during the routing calculations.  When the distance of a single vertex
+ * is decreased, DecreaseKey () does the same in logarithmic time.
  *
  * @see SPFVertex
  */
   void Reorder (void);
 
+/**
+ * @brief Restores the position of a vertex in the Candidate Queue after
+ * its m_distanceFromRoot has been decreased.
+ * @internal
+ *
+ * The vertex is ordered after the vertices of the queue which have the
+ * same distance and type, as if it had just been pushed.
+ *
+ * @see SPFVertex
+ * @param v The Shortest Path First Vertex, which must be in the queue.
+ */
+  void DecreaseKey (SPFVertex *v);
+
 private:
 /**
  * Candidate Queue copy construction is disallowed (not implemented) to 
@@ -192,8 +210,51 @@ private:
  */
   static bool CompareSPFVertex (const SPFVertex* v1, const SPFVertex* v2);
 
-  typedef std::list<SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
-  CandidateList_t m_candidates;  //!< SPFVertex candidates
+/**
+ * \brief return true if the candidate at heap index i should be popped
+ * before the one at heap index j
+ *
+ * \param i first heap index
+ * \param j second heap index
+ * \return True if the candidate i should be popped before j; false otherwise
+ */
+  bool IsBefore (uint32_t i, uint32_t j) const;
+/**
+ * \brief Swap two candidates of the heap and update their index.
+ *
+ * \param i first heap index
+ * \param j second heap index
+ */
+  void Swap (uint32_t i, uint32_t j);
+/**
+ * \brief Move a candidate towards the top of the heap.
+ *
+ * \param i the heap index of the candidate
+ */
+  void SiftUp (uint32_t i);
+/**
+ * \brief Move a candidate towards the bottom of the heap.
+ *
+ * \param i the heap index of the candidate
+ */
+  void SiftDown (uint32_t i);
+
+  typedef std::multimap<Ipv4Address, uint32_t> CandidateIndex_t; //!< heap index of each vertex ID
+
+  /**
+   * A candidate in the heap.
+   */
+  struct Candidate
+  {
+    SPFVertex *vertex;              //!< the vertex
+    uint64_t sequence;              //!< rank among the vertices which compare equal
+    CandidateIndex_t::iterator id;  //!< entry of the vertex in m_index
+  };
+
+  typedef std::vector<Candidate> CandidateList_t; //!< container of candidates
+  CandidateList_t m_candidates;  //!< SPFVertex candidates, as a binary heap
+  CandidateIndex_t m_index;      //!< heap index of the candidates by vertex ID
+  uint64_t m_sequence;           //!< sequence number of the next pushed vertex
 
   /**
    * \brief Stream insertion operator.
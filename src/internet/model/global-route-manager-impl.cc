@@ -539,7 +539,10 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 
 GlobalRouteManagerImpl::GlobalRouteManagerImpl () 
   :
-    m_spfroot (0)
+    m_spfroot (0),
+    m_spftree (0),
+    m_recordTrees (false),
+    m_nFullRecomputes (0)
 {
   NS_LOG_FUNCTION (this);
   m_lsdb = new GlobalRouteManagerLSDB ();
@@ -700,6 +703,8 @@ GlobalRouteManagerImpl::InitializeRoutes ()
 // Walk the list of nodes in the system.
 //
   NS_LOG_INFO ("About to start SPF calculation");
+  m_spftrees.clear ();
+  m_recordTrees = m_recordTrees || IsIncrementalUpdateEnabled ();
   NodeList::Iterator listEnd = NodeList::End ();
   for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
     {
@@ -730,6 +735,341 @@ GlobalRouteManagerImpl::InitializeRoutes ()
   NS_LOG_INFO ("Finished SPF calculation");
 }
 
+//
+// The shortest path tree of each root is recorded by SPFCalculate () as the
+// set of its (parent, child) edges.  If a link goes away, the roots whose
+// tree does not contain it pop the same vertices in the same order, with the
+// same exit directions, so that their routing table is only missing the
+// routes which were installed from the link records which disappeared.  The
+// other roots run the SPF calculation again.
+//
+void
+GlobalRouteManagerImpl::UpdateGlobalRoutes ()
+{
+  NS_LOG_FUNCTION (this);
+  m_recordTrees = true;
+  GlobalRouteManagerLSDB *previous = m_lsdb;
+  m_lsdb = new GlobalRouteManagerLSDB ();
+  BuildGlobalRoutingDatabase ();
+
+  KeySet_t edges;
+  std::set<Ipv4Address> lsas;
+  KeySet_t hosts;
+  KeySet_t networks;
+  bool incremental = !m_spftrees.empty () && DiffLSDB (previous, edges, lsas, hosts, networks);
+  delete previous;
+  if (!incremental)
+    {
+      NS_LOG_LOGIC ("Recomputing all the global routes");
+      m_nFullRecomputes++;
+//
+// DeleteGlobalRoutes () also replaces the LSDB, which is already up to date.
+//
+      GlobalRouteManagerLSDB *current = m_lsdb;
+      m_lsdb = 0;
+      DeleteGlobalRoutes ();
+      m_lsdb = current;
+      InitializeRoutes ();
+      return;
+    }
+  NS_LOG_LOGIC (edges.size () << " edges, " << hosts.size () << " host routes and " << 
+                networks.size () << " network routes removed");
+
+  uint32_t systemId = MpiInterface::GetSystemId ();
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<Node> node = *i;
+      Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter> ();
+      if (rtr == 0)
+        {
+          continue;
+        }
+      Ptr<Ipv4GlobalRouting> gr = rtr->GetRoutingProtocol ();
+      Ipv4Address routerId = rtr->GetRouterId ();
+      bool local = node->GetSystemId () == systemId && rtr->GetNumLSAs ();
+      std::map<Ipv4Address, SPFTree>::iterator tree = m_spftrees.find (routerId);
+      if (local && tree != m_spftrees.end () && !lsas.count (routerId)
+          && !IsTreeAffected (tree->second, edges)
+          && RemoveRoutes (gr, tree->second, hosts, networks))
+        {
+          continue;
+        }
+      NS_LOG_LOGIC ("Recomputing the routes of node " << node->GetId ());
+      while (gr->GetNRoutes ())
+        {
+          gr->RemoveRoute (0);
+        }
+      if (local)
+        {
+          SPFCalculate (routerId);
+        }
+    }
+}
+
+uint32_t
+GlobalRouteManagerImpl::GetNFullRecomputes (void) const
+{
+  return m_nFullRecomputes;
+}
+
+bool
+GlobalRouteManagerImpl::IsIncrementalUpdateEnabled (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter> ();
+      if (rtr == 0)
+        {
+          continue;
+        }
+      if (rtr->GetRoutingProtocol ()->GetIncrementalRouteUpdates ())
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+uint64_t
+GlobalRouteManagerImpl::GetKey (Ipv4Address a, Ipv4Address b)
+{
+  return (static_cast<uint64_t> (a.Get ()) << 32) | b.Get ();
+}
+
+void
+GlobalRouteManagerImpl::AddTreeEdge (Ipv4Address from, Ipv4Address to)
+{
+  NS_LOG_FUNCTION (this << from << to);
+  if (m_spftree)
+    {
+      m_spftree->edges.insert (GetKey (from, to));
+    }
+}
+
+void
+GlobalRouteManagerImpl::ClearTree (SPFTree &tree)
+{
+  NS_LOG_FUNCTION (this);
+  tree.edges.clear ();
+  tree.hostSources.clear ();
+  tree.networkSources.clear ();
+  tree.nExternalRoutes = 0;
+}
+
+bool
+GlobalRouteManagerImpl::IsTreeAffected (const SPFTree &tree, const KeySet_t &edges) const
+{
+  NS_LOG_FUNCTION (this);
+  for (KeySet_t::const_iterator i = edges.begin (); i != edges.end (); i++)
+    {
+      if (tree.edges.count (*i))
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+bool
+GlobalRouteManagerImpl::RemoveRoutes (Ptr<Ipv4GlobalRouting> gr, SPFTree &tree,
+                                      const KeySet_t &hosts, const KeySet_t &networks) const
+{
+  NS_LOG_FUNCTION (this << gr);
+  uint32_t nHostRoutes = tree.hostSources.size ();
+  if (gr->GetNRoutes () != nHostRoutes + tree.networkSources.size () + tree.nExternalRoutes)
+    {
+      // the routing table was modified behind our back
+      return false;
+    }
+//
+// Ipv4GlobalRouting lists the host routes first, then the network routes.
+// Remove the routes from the end, so that the indexes remain valid.
+//
+  for (uint32_t j = tree.networkSources.size (); j-- > 0; )
+    {
+      if (networks.count (tree.networkSources[j]))
+        {
+          gr->RemoveRoute (nHostRoutes + j);
+          tree.networkSources.erase (tree.networkSources.begin () + j);
+        }
+    }
+  for (uint32_t j = nHostRoutes; j-- > 0; )
+    {
+      if (hosts.count (tree.hostSources[j]))
+        {
+          gr->RemoveRoute (j);
+          tree.hostSources.erase (tree.hostSources.begin () + j);
+        }
+    }
+  return true;
+}
+
+void
+GlobalRouteManagerImpl::RemoveLinkRecord (GlobalRoutingLSA *lsa, GlobalRoutingLinkRecord *l, 
+                                          KeySet_t &edges, KeySet_t &hosts, KeySet_t &networks) const
+{
+  NS_LOG_FUNCTION (this << lsa << l);
+  Ipv4Address id = lsa->GetLinkStateId ();
+  if (l->GetLinkType () == GlobalRoutingLinkRecord::PointToPoint)
+    {
+      edges.insert (GetKey (id, l->GetLinkId ()));
+      edges.insert (GetKey (l->GetLinkId (), id));
+      hosts.insert (GetKey (id, l->GetLinkData ()));
+    }
+  else if (l->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork)
+    {
+      edges.insert (GetKey (id, l->GetLinkId ()));
+      edges.insert (GetKey (l->GetLinkId (), id));
+    }
+  else if (l->GetLinkType () == GlobalRoutingLinkRecord::StubNetwork)
+    {
+      networks.insert (GetKey (id, l->GetLinkId ().CombineMask (Ipv4Mask (l->GetLinkData ().Get ()))));
+    }
+}
+
+void
+GlobalRouteManagerImpl::RemoveAttachedRouter (GlobalRouteManagerLSDB *previous, GlobalRoutingLSA *lsa,
+                                              Ipv4Address router, KeySet_t &edges) const
+{
+  NS_LOG_FUNCTION (this << previous << lsa << router);
+  GlobalRoutingLSA *rlsa = previous->GetLSAByLinkData (router);
+  if (rlsa)
+    {
+      edges.insert (GetKey (lsa->GetLinkStateId (), rlsa->GetLinkStateId ()));
+      edges.insert (GetKey (rlsa->GetLinkStateId (), lsa->GetLinkStateId ()));
+    }
+}
+
+bool
+GlobalRouteManagerImpl::DiffLSDB (GlobalRouteManagerLSDB *previous, KeySet_t &edges, std::set<Ipv4Address> &lsas,
+                                  KeySet_t &hosts, KeySet_t &networks) const
+{
+  NS_LOG_FUNCTION (this << previous);
+//
+// The AS external LSAs are processed by every root: they must not change.
+//
+  if (previous->GetNumExtLSAs () != m_lsdb->GetNumExtLSAs ())
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < m_lsdb->GetNumExtLSAs (); i++)
+    {
+      GlobalRoutingLSA *before = previous->GetExtLSA (i);
+      GlobalRoutingLSA *after = m_lsdb->GetExtLSA (i);
+      if (before->GetLinkStateId () != after->GetLinkStateId ()
+          || before->GetNetworkLSANetworkMask () != after->GetNetworkLSANetworkMask ()
+          || before->GetAdvertisingRouter () != after->GetAdvertisingRouter ())
+        {
+          return false;
+        }
+    }
+
+  GlobalRouteManagerLSDB::LSDBMap_t::const_iterator i;
+  for (i = m_lsdb->m_database.begin (); i != m_lsdb->m_database.end (); i++)
+    {
+      if (previous->m_database.find (i->first) == previous->m_database.end ())
+        {
+          NS_LOG_LOGIC ("New LSA " << i->first);
+          return false;
+        }
+    }
+
+  for (i = previous->m_database.begin (); i != previous->m_database.end (); i++)
+    {
+      GlobalRoutingLSA *before = i->second;
+      GlobalRouteManagerLSDB::LSDBMap_t::const_iterator found = m_lsdb->m_database.find (i->first);
+      if (found == m_lsdb->m_database.end ())
+        {
+          NS_LOG_LOGIC ("Removed LSA " << i->first);
+          lsas.insert (i->first);
+          for (uint32_t j = 0; j < before->GetNLinkRecords (); j++)
+            {
+              RemoveLinkRecord (before, before->GetLinkRecord (j), edges, hosts, networks);
+            }
+          for (uint32_t j = 0; j < before->GetNAttachedRouters (); j++)
+            {
+              RemoveAttachedRouter (previous, before, before->GetAttachedRouter (j), edges);
+            }
+          continue;
+        }
+      GlobalRoutingLSA *after = found->second;
+      if (before->GetLSType () != after->GetLSType ()
+          || before->GetAdvertisingRouter () != after->GetAdvertisingRouter ()
+          || before->GetNetworkLSANetworkMask () != after->GetNetworkLSANetworkMask ())
+        {
+          return false;
+        }
+//
+// The link records and attached routers of the new LSA must be those of the
+// previous one, in the same order, minus the removed ones.
+//
+      uint32_t k = 0;
+      for (uint32_t j = 0; j < before->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *l = before->GetLinkRecord (j);
+          if (k < after->GetNLinkRecords ())
+            {
+              GlobalRoutingLinkRecord *m = after->GetLinkRecord (k);
+              if (l->GetLinkType () == m->GetLinkType () && l->GetLinkId () == m->GetLinkId ()
+                  && l->GetLinkData () == m->GetLinkData () && l->GetMetric () == m->GetMetric ())
+                {
+                  k++;
+                  continue;
+                }
+            }
+          lsas.insert (i->first);
+          RemoveLinkRecord (before, l, edges, hosts, networks);
+        }
+      if (k != after->GetNLinkRecords ())
+        {
+          return false;
+        }
+      k = 0;
+      for (uint32_t j = 0; j < before->GetNAttachedRouters (); j++)
+        {
+          if (k < after->GetNAttachedRouters () 
+              && before->GetAttachedRouter (j) == after->GetAttachedRouter (k))
+            {
+              k++;
+              continue;
+            }
+          lsas.insert (i->first);
+          RemoveAttachedRouter (previous, before, before->GetAttachedRouter (j), edges);
+        }
+      if (k != after->GetNAttachedRouters ())
+        {
+          return false;
+        }
+    }
+
+//
+// The routes of a removed link record are identified by the vertex and the
+// destination: another record of the same vertex must not install them.
+//
+  for (i = m_lsdb->m_database.begin (); i != m_lsdb->m_database.end (); i++)
+    {
+      GlobalRoutingLSA *lsa = i->second;
+      for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *l = lsa->GetLinkRecord (j);
+          if (l->GetLinkType () == GlobalRoutingLinkRecord::PointToPoint
+              && hosts.count (GetKey (i->first, l->GetLinkData ())))
+            {
+              return false;
+            }
+          if (l->GetLinkType () == GlobalRoutingLinkRecord::StubNetwork
+              && networks.count (GetKey (i->first, l->GetLinkId ().CombineMask (Ipv4Mask (l->GetLinkData ().Get ()))))) 
+            {
+              return false;
+            }
+        }
+    }
+  return true;
+}
+
 //
 // This method is derived from quagga ospf_spf_next ().  See RFC2328 Section 
 // 16.1 (2) for further details.
@@ -960,7 +1300,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
 // If we've changed the cost to get to the vertex represented by <w>, we 
 // must reorder the priority queue keyed to that cost.
 //
-                  candidate.Reorder ();
+                  candidate.DecreaseKey (cw);
                 }
             } // new lower cost path found
         } // end W is already on the candidate list
@@ -1326,6 +1666,10 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
                   NS_ASSERT (gr);
                   gr->AddNetworkRouteTo (Ipv4Address ("0.0.0.0"), Ipv4Mask ("0.0.0.0"), lr->GetLinkData (), 
                                          FindOutgoingInterfaceId (transitLink->GetLinkData ()));
+                  if (m_spftree)
+                    {
+                      m_spftree->networkSources.push_back (0);
+                    }
                   NS_LOG_LOGIC ("Inserting default route for node " << myRouterId << " to next hop " << 
                                 lr->GetLinkData () << " via interface " << 
                                 FindOutgoingInterfaceId (transitLink->GetLinkData ()));
@@ -1361,6 +1705,16 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 // shortest path first (SPF) tree.
 //
   v = new SPFVertex (m_lsdb->GetLSA (root));
+//
+// Forget the tree previously computed for this root, if any.  The trees are
+// only needed by UpdateGlobalRoutes ().
+//
+  m_spftree = 0;
+  if (m_recordTrees)
+    {
+      m_spftree = &m_spftrees[root];
+      ClearTree (*m_spftree);
+    }
 // 
 // This vertex is the root of the SPF tree and it is distance 0 from the root.
 // We also mark this vertex as being in the SPF tree.
@@ -1380,6 +1734,14 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
   if (NodeList::GetNNodes () > 0 && CheckForStubNode (root))
     {
       NS_LOG_LOGIC ("SPFCalculate truncated for stub node " << root);
+      GlobalRoutingLSA *rlsa = m_spfroot->GetLSA ();
+      for (uint32_t i = 0; i < rlsa->GetNLinkRecords (); i++)
+        {
+          if (rlsa->GetLinkRecord (i)->GetLinkType () != GlobalRoutingLinkRecord::StubNetwork)
+            {
+              AddTreeEdge (root, rlsa->GetLinkRecord (i)->GetLinkId ());
+            }
+        }
       delete m_spfroot;
       return;
     }
@@ -1437,6 +1799,10 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 // to now.
 //
       SPFVertexAddParent (v);
+      for (uint32_t i = 0; v->GetParent (i); i++)
+        {
+          AddTreeEdge (v->GetParent (i)->GetVertexId (), v->GetVertexId ());
+        }
 //
 // Note that when there is a choice of vertices closest to the root, network
 // vertices must be chosen before router vertices in order to necessarily
@@ -1643,6 +2009,10 @@ GlobalRouteManagerImpl::SPFAddASExternal (GlobalRoutingLSA *extlsa, SPFVertex *v
               if (outIf >= 0)
                 {
                   gr->AddASExternalRouteTo (tempip, tempmask, nextHop, outIf);
+                  if (m_spftree)
+                    {
+                      m_spftree->nExternalRoutes++;
+                    }
                   NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
                                 " add external network route to " << tempip <<
                                 " using next hop " << nextHop <<
@@ -1814,6 +2184,10 @@ GlobalRouteManagerImpl::SPFIntraAddStub (GlobalRoutingLinkRecord *l, SPFVertex*
               if (outIf >= 0)
                 {
                   gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
+                  if (m_spftree)
+                    {
+                      m_spftree->networkSources.push_back (GetKey (v->GetVertexId (), tempip));
+                    }
                   NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
                                 " add network route to " << tempip <<
                                 " using next hop " << nextHop <<
@@ -2050,6 +2424,10 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
                     {
                       gr->AddHostRouteTo (lr->GetLinkData (), nextHop,
                                           outIf);
+                      if (m_spftree)
+                        {
+                          m_spftree->hostSources.push_back (GetKey (v->GetVertexId (), lr->GetLinkData ()));
+                        }
                       NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
                                     " adding host route to " << lr->GetLinkData () <<
                                     " using next hop " << nextHop <<
@@ -2163,6 +2541,10 @@ GlobalRouteManagerImpl::SPFIntraAddTransit (SPFVertex* v)
               if (outIf >= 0)
                 {
                   gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
+                  if (m_spftree)
+                    {
+                      m_spftree->networkSources.push_back (0);
+                    }
                   NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
                                 " add network route to " << tempip <<
                                 " using next hop " << nextHop <<
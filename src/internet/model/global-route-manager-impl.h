@@ -26,6 +26,7 @@
 #include <list>
 #include <queue>
 #include <map>
+#include <set>
 #include <vector>
 #include "ns3/object.h"
 #include "ns3/ptr.h"
@@ -704,6 +705,8 @@ private:
   LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
   std::vector<GlobalRoutingLSA*> m_extdatabase; //!< database of External Link State Advertisements
 
+  friend class GlobalRouteManagerImpl;
+
 /**
  * @brief GlobalRouteManagerLSDB copy construction is disallowed.  There's no 
  * need for it and a compiler provided shallow copy would be wrong.
@@ -758,6 +761,35 @@ public:
  */
   virtual void InitializeRoutes ();
 
+/**
+ * @brief Rebuild the Link State Database and update the routes after a
+ * change in the topology.
+ * @internal
+ *
+ * The new database is compared with the previous one.  When the only
+ * changes are removed link records, network LSA attached routers or
+ * LSAs, the SPF calculation is run again only for the roots whose
+ * shortest path tree (as recorded during the last calculation) contains
+ * one of the removed links; the other roots only lose the routes which
+ * were installed from the removed link records.  Any other change, or an ambiguous one,
+ * falls back to DeleteGlobalRoutes (), BuildGlobalRoutingDatabase () and
+ * InitializeRoutes ().  Either way, the resulting routing tables are
+ * identical.
+ *
+ * The trees are only recorded when a node has the IncrementalRouteUpdates
+ * attribute of Ipv4GlobalRouting set, or once this method has been called.
+ * Otherwise, the first call recomputes all the routes.
+ */
+  virtual void UpdateGlobalRoutes ();
+
+/**
+ * @brief Get the number of times UpdateGlobalRoutes () fell back to the
+ * recomputation of all the routes.
+ * @internal
+ * @returns the number of full recomputations
+ */
+  uint32_t GetNFullRecomputes (void) const;
+
 /**
  * @brief Debugging routine; allow client code to supply a pre-built LSDB
  * @internal
@@ -789,6 +821,118 @@ private:
   SPFVertex* m_spfroot; //!< the root node
   GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
 
+  /// container of edges of the SPF graph or of route sources (see GetKey ())
+  typedef std::set<uint64_t> KeySet_t;
+
+  /**
+   * \brief The last shortest path tree computed for a root, and the
+   * origin of the routes it installed.
+   */
+  struct SPFTree
+  {
+    KeySet_t edges; //!< (parent, child) edges of the tree
+    std::vector<uint64_t> hostSources; //!< vertex and link data of each host route
+    std::vector<uint64_t> networkSources; //!< vertex and stub network of each network route (zero for the others)
+    uint32_t nExternalRoutes; //!< number of AS external routes
+  };
+
+  std::map<Ipv4Address, SPFTree> m_spftrees; //!< the tree of each SPF root
+  SPFTree* m_spftree; //!< the tree of the current SPF calculation, zero if the trees are not recorded
+  bool m_recordTrees; //!< true if SPFCalculate () records the trees for UpdateGlobalRoutes ()
+  uint32_t m_nFullRecomputes; //!< number of times UpdateGlobalRoutes () recomputed all the routes
+
+  /**
+   * \brief Test if a node asks for incremental route updates, in which case
+   * the shortest path trees are recorded from the first SPF calculation.
+   *
+   * \returns true if the IncrementalRouteUpdates attribute of a node is set
+   */
+  bool IsIncrementalUpdateEnabled (void) const;
+
+  /**
+   * \brief Build the key of a pair of addresses, that is either a directed
+   * edge of the SPF graph, or the vertex and the destination of a route.
+   *
+   * \param a the first address
+   * \param b the second address
+   * \returns the key of the pair
+   */
+  static uint64_t GetKey (Ipv4Address a, Ipv4Address b);
+
+  /**
+   * \brief Note that an edge is part of the tree of the current SPF root,
+   * if the trees are recorded.
+   *
+   * \param from the vertex id of the parent
+   * \param to the vertex id of the child
+   */
+  void AddTreeEdge (Ipv4Address from, Ipv4Address to);
+
+  /**
+   * \brief Forget the tree recorded for a root.
+   *
+   * \param tree the tree of the root
+   */
+  void ClearTree (SPFTree &tree);
+
+  /**
+   * \brief Test if the tree recorded for a root contains a changed edge.
+   *
+   * \param tree the tree of the root
+   * \param edges the changed edges
+   * \returns true if the root must run the SPF calculation again
+   */
+  bool IsTreeAffected (const SPFTree &tree, const KeySet_t &edges) const;
+
+  /**
+   * \brief Remove the routes installed by removed link records.
+   *
+   * \param gr the routing protocol of the root
+   * \param tree the tree of the root
+   * \param hosts the sources of the removed host routes
+   * \param networks the sources of the removed network routes
+   * \returns false if the routing table does not match the recorded sources
+   */
+  bool RemoveRoutes (Ptr<Ipv4GlobalRouting> gr, SPFTree &tree,
+                     const KeySet_t &hosts, const KeySet_t &networks) const;
+
+  /**
+   * \brief Compare the current LSDB with a previous one.
+   *
+   * \param previous the previous LSDB
+   * \param edges filled with the edges which have been removed
+   * \param lsas filled with the ids of the LSAs which have changed
+   * \param hosts filled with the sources of the removed host routes
+   * \param networks filled with the sources of the removed network routes
+   * \returns false if the change is not only made of removals, in which case
+   * all routes must be recomputed
+   */
+  bool DiffLSDB (GlobalRouteManagerLSDB *previous, KeySet_t &edges, std::set<Ipv4Address> &lsas,
+                 KeySet_t &hosts, KeySet_t &networks) const;
+
+  /**
+   * \brief Note the edges and the routes of a removed link record.
+   *
+   * \param lsa the router LSA owning the record
+   * \param l the removed link record
+   * \param edges the removed edges
+   * \param hosts the sources of the removed host routes
+   * \param networks the sources of the removed network routes
+   */
+  void RemoveLinkRecord (GlobalRoutingLSA *lsa, GlobalRoutingLinkRecord *l, KeySet_t &edges,
+                         KeySet_t &hosts, KeySet_t &networks) const;
+
+  /**
+   * \brief Note the edges of a router removed from a network LSA.
+   *
+   * \param previous the previous LSDB
+   * \param lsa the network LSA
+   * \param router the address of the removed attached router
+   * \param edges the removed edges
+   */
+  void RemoveAttachedRouter (GlobalRouteManagerLSDB *previous, GlobalRoutingLSA *lsa,
+                             Ipv4Address router, KeySet_t &edges) const;
+
   /**
    * \brief Test if a node is a stub, from an OSPF sense.
    *
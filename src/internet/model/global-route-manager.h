@@ -67,6 +67,14 @@ public:
  */
   static void InitializeRoutes ();
 
+/**
+ * @brief Rebuild the routing database and update the per-node forwarding
+ * tables after a change in the topology, running the SPF computation again
+ * only for the routers whose shortest path tree is affected by the change.
+ * @internal
+ */
+  static void UpdateGlobalRoutes ();
+
 private:
 /**
  * @brief Global Route Manager copy construction is disallowed.  There's no 
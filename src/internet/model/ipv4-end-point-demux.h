@@ -23,7 +23,9 @@
 
 #include <stdint.h>
 #include <list>
+#include <map>
 #include "ns3/ipv4-address.h"
+#include "ns3/sgi-hashmap.h"
 #include "ipv4-interface.h"
 
 namespace ns3 {
@@ -38,6 +40,12 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints are hashed by local port and by (local port, peer address,
+ * peer port), so that a lookup only examines the endpoints which can match
+ * the packet: the connected ones with the exact peer and the ones with
+ * a wildcard peer address or port.  The candidates are then ranked in
+ * allocation order exactly as if the whole list had been walked.
  */
 
 class Ipv4EndPointDemux {
@@ -175,9 +183,98 @@ private:
   uint16_t m_portFirst;
 
   /**
-   * \brief A list of IPv4 end points.
+   * \brief Endpoints sorted by allocation order.
+   */
+  typedef std::map<uint64_t, Ipv4EndPoint *> OrderedEndPoints;
+
+  /**
+   * \brief The part of a four-tuple which is hashed: the local
+   * address is not, since its matching depends on the incoming interface.
+   */
+  struct PeerKey
+  {
+    uint16_t localPort;       //!< local port
+    Ipv4Address peerAddress;  //!< peer address
+    uint16_t peerPort;        //!< peer port
+
+    /**
+     * \param other the key to compare with
+     * \return true if the keys are equal
+     */
+    bool operator == (const PeerKey &other) const;
+  };
+
+  /**
+   * \brief Hash function class for PeerKey.
+   */
+  struct PeerKeyHash
+  {
+    /**
+     * \param key the key to hash
+     * \return the hash of the key
+     */
+    size_t operator () (const PeerKey &key) const;
+  };
+
+  /**
+   * \brief Endpoints by local port.
+   */
+  typedef sgi::hash_map<uint16_t, OrderedEndPoints> PortIndex;
+
+  /**
+   * \brief Endpoints by local port and peer.
+   */
+  typedef sgi::hash_map<PeerKey, OrderedEndPoints, PeerKeyHash> PeerIndex;
+
+  /**
+   * \brief Add an endpoint to the indexes, with its current peer.
+   * \param endPoint the end point
+   */
+  void AddToIndex (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Remove an endpoint from the indexes, with its current peer.
+   * \param endPoint the end point
+   */
+  void RemoveFromIndex (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Record a newly allocated endpoint.
+   * \param endPoint the end point
+   */
+  void Insert (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Copy into candidates the endpoints of a (local port, peer) key.
+   * \param candidates the endpoints found so far
+   * \param localPort local port
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   */
+  void AddCandidates (OrderedEndPoints &candidates, uint16_t localPort,
+                      Ipv4Address peerAddress, uint16_t peerPort) const;
+
+  /**
+   * \brief The next allocation sequence number.
    */
-  EndPoints m_endPoints;
+  uint64_t m_sequence;
+
+  /**
+   * \brief All the IPv4 end points, by allocation order.
+   */
+  OrderedEndPoints m_endPoints;
+
+  /**
+   * \brief The IPv4 end points by local port.
+   */
+  PortIndex m_portIndex;
+
+  /**
+   * \brief The IPv4 end points by local port and peer.
+   */
+  PeerIndex m_peerIndex;
+
+  friend class Ipv4EndPoint;
 };
 
 } // namespace ns3
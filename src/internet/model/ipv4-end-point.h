@@ -32,6 +32,7 @@ namespace ns3 {
 
 class Header;
 class Packet;
+class Ipv4EndPointDemux;
 
 /**
  * \brief A representation of an internet endpoint/connection
@@ -229,6 +230,21 @@ private:
    * \brief The destroy callback.
    */
   Callback<void> m_destroyCallback;
+
+  /**
+   * \brief The demux which allocated this EndPoint (if any).
+   *
+   * The demux indexes its endpoints by peer, so it must be told
+   * when the peer changes.
+   */
+  Ipv4EndPointDemux *m_demux;
+
+  /**
+   * \brief The allocation order of this EndPoint in m_demux.
+   */
+  uint64_t m_sequence;
+
+  friend class Ipv4EndPointDemux;
 };
 
 } // namespace ns3
@@ -27,6 +27,7 @@
 #include "ns3/ipv4-route.h"
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/boolean.h"
+#include "ns3/uinteger.h"
 #include "ipv4-global-routing.h"
 #include "global-route-manager.h"
 
@@ -51,13 +52,28 @@ Ipv4GlobalRouting::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&Ipv4GlobalRouting::m_respondToInterfaceEvents),
                    MakeBooleanChecker ())
+    .AddAttribute ("IncrementalRouteUpdates",
+                   "Set to true if the interface events should only recompute the routes of the nodes affected by the event, instead of all the global routes (see RespondToInterfaceEvents)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv4GlobalRouting::m_incrementalRouteUpdates),
+                   MakeBooleanChecker ())
+    .AddAttribute ("RouteCacheSize",
+                   "The maximum number of destinations whose routes are cached (0 disables the route cache)",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&Ipv4GlobalRouting::m_routeCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
 
 Ipv4GlobalRouting::Ipv4GlobalRouting () 
   : m_randomEcmpRouting (false),
-    m_respondToInterfaceEvents (false)
+    m_respondToInterfaceEvents (false),
+    m_incrementalRouteUpdates (false),
+    m_routeCacheSize (0),
+    m_hostTrie (32),
+    m_networkTrie (32),
+    m_ASexternalTrie (32)
 {
   NS_LOG_FUNCTION (this);
 
@@ -78,6 +94,8 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
   m_hostRoutes.push_back (route);
+  m_hostTrie.Insert (dest.Get (), 0xffffffff, route);
+  FlushRouteCache ();
 }
 
 void 
@@ -88,6 +106,8 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
   m_hostRoutes.push_back (route);
+  m_hostTrie.Insert (dest.Get (), 0xffffffff, route);
+  FlushRouteCache ();
 }
 
 void 
@@ -103,6 +123,8 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_networkTrie.Insert (network.Get (), networkMask.Get (), route);
+  FlushRouteCache ();
 }
 
 void 
@@ -116,6 +138,8 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_networkTrie.Insert (network.Get (), networkMask.Get (), route);
+  FlushRouteCache ();
 }
 
 void 
@@ -131,6 +155,8 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_ASexternalRoutes.push_back (route);
+  m_ASexternalTrie.Insert (network.Get (), networkMask.Get (), route);
+  FlushRouteCache ();
 }
 
 
@@ -139,14 +165,62 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
 {
   NS_LOG_FUNCTION (this << dest << oif);
   NS_LOG_LOGIC ("Looking for route for destination " << dest);
-  Ptr<Ipv4Route> rtentry = 0;
+  if (m_routeCacheSize > 0 && oif == 0)
+    {
+      RouteCache::iterator it = m_routeCache.find (dest.Get ());
+      if (it == m_routeCache.end ())
+        {
+          if (m_routeCache.size () >= m_routeCacheSize)
+            {
+              NS_LOG_LOGIC ("Route cache full, flushing");
+              m_routeCache.clear ();
+            }
+          RouteVec allRoutes;
+          FindRoutes (dest, oif, allRoutes);
+          it = m_routeCache.insert (std::make_pair (dest.Get (), CachedRoutes ())).first;
+          for (RouteVec::const_iterator i = allRoutes.begin (); i != allRoutes.end (); i++)
+            {
+              it->second.push_back (CreateRoute (*i));
+            }
+        }
+      else
+        {
+          NS_LOG_LOGIC ("Found " << it->second.size () << " cached routes");
+        }
+      if (it->second.empty ())
+        {
+          return 0;
+        }
+      return it->second[SelectRoute (it->second.size ())];
+    }
+
   // store all available routes that bring packets to their destination
-  typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
-  RouteVec_t allRoutes;
+  RouteVec allRoutes;
+  FindRoutes (dest, oif, allRoutes);
+  if (allRoutes.size () > 0 ) // if route(s) is found
+    {
+      Ipv4RoutingTableEntry* route = allRoutes.at (SelectRoute (allRoutes.size ()));
+      // create a Ipv4Route object from the selected routing table entry
+      return CreateRoute (route);
+    }
+  else 
+    {
+      return 0;
+    }
+}
+
+void
+Ipv4GlobalRouting::FindRoutes (Ipv4Address dest, Ptr<NetDevice> oif, RouteVec &allRoutes) const
+{
+  NS_LOG_FUNCTION (this << dest << oif);
+  // the routes whose prefix matches the destination, in the order of the tables
+  RouteVec &routes = m_matches;
 
   NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
-  for (HostRoutesCI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
+  routes.clear ();
+  m_hostTrie.Match (dest.Get (), routes);
+  for (RouteVec::const_iterator i = routes.begin (); 
+       i != routes.end (); 
        i++) 
     {
       NS_ASSERT ((*i)->IsHost ());
@@ -167,8 +241,10 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
   if (allRoutes.size () == 0) // if no host route is found
     {
       NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
-      for (NetworkRoutesI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end (); 
+      routes.clear ();
+      m_networkTrie.Match (dest.Get (), routes);
+      for (RouteVec::const_iterator j = routes.begin (); 
+           j != routes.end (); 
            j++) 
         {
           Ipv4Mask mask = (*j)->GetDestNetworkMask ();
@@ -190,8 +266,10 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
     }
   if (allRoutes.size () == 0)  // consider external if no host/network found
     {
-      for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
-           k != m_ASexternalRoutes.end ();
+      routes.clear ();
+      m_ASexternalTrie.Match (dest.Get (), routes);
+      for (RouteVec::const_iterator k = routes.begin ();
+           k != routes.end ();
            k++)
         {
           Ipv4Mask mask = (*k)->GetDestNetworkMask ();
@@ -212,35 +290,39 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
             }
         }
     }
-  if (allRoutes.size () > 0 ) // if route(s) is found
-    {
-      // pick up one of the routes uniformly at random if random
-      // ECMP routing is enabled, or always select the first route
-      // consistently if random ECMP routing is disabled
-      uint32_t selectIndex;
-      if (m_randomEcmpRouting)
-        {
-          selectIndex = m_rand->GetInteger (0, allRoutes.size ()-1);
-        }
-      else 
-        {
-          selectIndex = 0;
-        }
-      Ipv4RoutingTableEntry* route = allRoutes.at (selectIndex); 
-      // create a Ipv4Route object from the selected routing table entry
-      rtentry = Create<Ipv4Route> ();
-      rtentry->SetDestination (route->GetDest ());
-      /// \todo handle multi-address case
-      rtentry->SetSource (m_ipv4->GetAddress (route->GetInterface (), 0).GetLocal ());
-      rtentry->SetGateway (route->GetGateway ());
-      uint32_t interfaceIdx = route->GetInterface ();
-      rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
-      return rtentry;
-    }
-  else 
+}
+
+Ptr<Ipv4Route>
+Ipv4GlobalRouting::CreateRoute (const Ipv4RoutingTableEntry *route) const
+{
+  Ptr<Ipv4Route> rtentry = Create<Ipv4Route> ();
+  rtentry->SetDestination (route->GetDest ());
+  /// \todo handle multi-address case
+  rtentry->SetSource (m_ipv4->GetAddress (route->GetInterface (), 0).GetLocal ());
+  rtentry->SetGateway (route->GetGateway ());
+  uint32_t interfaceIdx = route->GetInterface ();
+  rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
+  return rtentry;
+}
+
+uint32_t
+Ipv4GlobalRouting::SelectRoute (uint32_t n)
+{
+  // pick up one of the routes uniformly at random if random
+  // ECMP routing is enabled, or always select the first route
+  // consistently if random ECMP routing is disabled
+  if (m_randomEcmpRouting)
     {
-      return 0;
+      return m_rand->GetInteger (0, n - 1);
     }
+  return 0;
+}
+
+void
+Ipv4GlobalRouting::FlushRouteCache (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_routeCache.clear ();
 }
 
 uint32_t 
@@ -307,6 +389,7 @@ void
 Ipv4GlobalRouting::RemoveRoute (uint32_t index)
 {
   NS_LOG_FUNCTION (this << index);
+  FlushRouteCache ();
   if (index < m_hostRoutes.size ())
     {
       uint32_t tmp = 0;
@@ -317,6 +400,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           if (tmp  == index)
             {
               NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_hostRoutes.size ());
+              m_hostTrie.Remove ((*i)->GetDest ().Get (), 0xffffffff, *i);
               delete *i;
               m_hostRoutes.erase (i);
               NS_LOG_LOGIC ("Done removing host route " << index << "; host route remaining size = " << m_hostRoutes.size ());
@@ -334,6 +418,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_networkRoutes.size ());
+          m_networkTrie.Remove ((*j)->GetDestNetwork ().Get (), (*j)->GetDestNetworkMask ().Get (), *j);
           delete *j;
           m_networkRoutes.erase (j);
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
@@ -350,6 +435,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_ASexternalRoutes.size ());
+          m_ASexternalTrie.Remove ((*k)->GetDestNetwork ().Get (), (*k)->GetDestNetworkMask ().Get (), *k);
           delete *k;
           m_ASexternalRoutes.erase (k);
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
@@ -360,6 +446,12 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
   NS_ASSERT (false);
 }
 
+bool
+Ipv4GlobalRouting::GetIncrementalRouteUpdates (void) const
+{
+  return m_incrementalRouteUpdates;
+}
+
 int64_t
 Ipv4GlobalRouting::AssignStreams (int64_t stream)
 {
@@ -390,6 +482,10 @@ Ipv4GlobalRouting::DoDispose (void)
     {
       delete (*l);
     }
+  m_hostTrie.Clear ();
+  m_networkTrie.Clear ();
+  m_ASexternalTrie.Clear ();
+  m_routeCache.clear ();
 
   Ipv4RoutingProtocol::DoDispose ();
 }
@@ -554,11 +650,10 @@ void
 Ipv4GlobalRouting::NotifyInterfaceUp (uint32_t i)
 {
   NS_LOG_FUNCTION (this << i);
+  FlushRouteCache ();
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      RecomputeGlobalRoutes ();
     }
 }
 
@@ -566,11 +661,10 @@ void
 Ipv4GlobalRouting::NotifyInterfaceDown (uint32_t i)
 {
   NS_LOG_FUNCTION (this << i);
+  FlushRouteCache ();
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      RecomputeGlobalRoutes ();
     }
 }
 
@@ -578,11 +672,10 @@ void
 Ipv4GlobalRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
   NS_LOG_FUNCTION (this << interface << address);
+  FlushRouteCache ();
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
-      GlobalRouteManager::DeleteGlobalRoutes ();
-      GlobalRouteManager::BuildGlobalRoutingDatabase ();
-      GlobalRouteManager::InitializeRoutes ();
+      RecomputeGlobalRoutes ();
     }
 }
 
@@ -590,7 +683,22 @@ void
 Ipv4GlobalRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
   NS_LOG_FUNCTION (this << interface << address);
+  FlushRouteCache ();
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
+    {
+      RecomputeGlobalRoutes ();
+    }
+}
+
+void
+Ipv4GlobalRouting::RecomputeGlobalRoutes (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_incrementalRouteUpdates)
+    {
+      GlobalRouteManager::UpdateGlobalRoutes ();
+    }
+  else
     {
       GlobalRouteManager::DeleteGlobalRoutes ();
       GlobalRouteManager::BuildGlobalRoutingDatabase ();
@@ -21,6 +21,8 @@
 #define IPV4_GLOBAL_ROUTING_H
 
 #include <list>
+#include <map>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
@@ -28,6 +30,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/prefix-trie.h"
 
 namespace ns3 {
 
@@ -63,6 +66,14 @@ class Node;
  *
  * This class deals with Ipv4 unicast routes only.
  *
+ * The Ipv4Route objects built for the destinations looked up without a
+ * requested output device can be cached (see the RouteCacheSize attribute),
+ * so that the packets sent or forwarded to the same destination share them
+ * instead of looking up the routing table and allocating a new route each
+ * time.  All the equal-cost routes of a destination are cached, hence the
+ * ECMP selection is not affected.  The cache is flushed whenever the
+ * routing table or the interfaces of the node change.
+ *
  * \see Ipv4RoutingProtocol
  * \see GlobalRouteManager
  */
@@ -216,6 +227,12 @@ public:
    */
   void RemoveRoute (uint32_t i);
 
+  /**
+   * \returns true if the interface events only recompute the routes of the
+   * nodes affected by the event (see the IncrementalRouteUpdates attribute)
+   */
+  bool GetIncrementalRouteUpdates (void) const;
+
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model.  Return the number of streams (possibly zero) that
@@ -234,6 +251,10 @@ private:
   bool m_randomEcmpRouting;
   /// Set to true if this interface should respond to interface events by globallly recomputing routes 
   bool m_respondToInterfaceEvents;
+  /// Set to true if the interface events should only trigger the recomputation of the affected routes
+  bool m_incrementalRouteUpdates;
+  /// Maximum number of destinations in the route cache (0 disables the cache)
+  uint32_t m_routeCacheSize;
   /// A uniform random number generator for randomly routing packets among ECMP 
   Ptr<UniformRandomVariable> m_rand;
 
@@ -258,12 +279,58 @@ private:
   /// iterator of container of Ipv4RoutingTableEntry (routes to external AS)
   typedef std::list<Ipv4RoutingTableEntry *>::iterator ASExternalRoutesI;
 
+  /// container of Ipv4RoutingTableEntry (routes found by a lookup)
+  typedef std::vector<Ipv4RoutingTableEntry *> RouteVec;
+  /// the equal-cost routes of a destination
+  typedef std::vector<Ptr<Ipv4Route> > CachedRoutes;
+  /// container of the cached routes, by destination
+  typedef std::map<uint32_t, CachedRoutes> RouteCache;
+
   Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
 
+  /**
+   * \brief Find the routing table entries of a destination.
+   * \param dest the destination
+   * \param oif the output device requested, if any
+   * \param allRoutes the equal-cost entries found
+   */
+  void FindRoutes (Ipv4Address dest, Ptr<NetDevice> oif, RouteVec &allRoutes) const;
+
+  /**
+   * \param route a routing table entry
+   * \return a new Ipv4Route built from the entry
+   */
+  Ptr<Ipv4Route> CreateRoute (const Ipv4RoutingTableEntry *route) const;
+
+  /**
+   * \param n the number of equal-cost routes
+   * \return the index of the route to use (see RandomEcmpRouting)
+   */
+  uint32_t SelectRoute (uint32_t n);
+
+  /**
+   * \brief Flush the route cache, after a change of the routes or of
+   * the interfaces.
+   */
+  void FlushRouteCache (void);
+
+  /**
+   * \brief Recompute the global routes after an interface event, either
+   * entirely or incrementally (see the IncrementalRouteUpdates attribute).
+   */
+  void RecomputeGlobalRoutes (void);
+
   HostRoutes m_hostRoutes;             //!< Routes to hosts
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  PrefixTrie<Ipv4RoutingTableEntry *> m_hostTrie;       //!< Routes to hosts, by destination
+  PrefixTrie<Ipv4RoutingTableEntry *> m_networkTrie;    //!< Routes to networks, by prefix
+  PrefixTrie<Ipv4RoutingTableEntry *> m_ASexternalTrie; //!< External routes imported, by prefix
+  mutable RouteVec m_matches; //!< Routes matching the destination of a lookup, kept to reuse their storage
+
+  RouteCache m_routeCache; //!< Cached routes, by destination
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
@@ -31,6 +31,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/prefix-trie.h"
 
 namespace ns3 {
 
@@ -425,11 +426,36 @@ private:
    */
   Ipv4Address SourceAddressSelection (uint32_t interface, Ipv4Address dest);
 
+  /**
+   * \brief Append a route to the forwarding table for network.
+   * \param route the route
+   * \param metric metric of the route
+   */
+  void InsertNetworkRoute (Ipv4RoutingTableEntry *route, uint32_t metric);
+
+  /**
+   * \brief Delete a route of the forwarding table for network.
+   * \param it the route
+   * \return the next route of the table
+   */
+  NetworkRoutesI EraseNetworkRoute (NetworkRoutesI it);
+
   /**
    * \brief the forwarding table for network.
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the routes of the forwarding table for network, by prefix.
+   */
+  PrefixTrie<std::pair <Ipv4RoutingTableEntry *, uint32_t> > m_networkTrie;
+
+  /**
+   * \brief the routes matching the destination of a lookup, kept to
+   * reuse their storage.
+   */
+  std::vector<std::pair <Ipv4RoutingTableEntry *, uint32_t> > m_networkMatches;
+
   /**
    * \brief the forwarding table for multicast.
    */
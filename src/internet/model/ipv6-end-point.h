@@ -34,6 +34,7 @@ namespace ns3
 
 class Header;
 class Packet;
+class Ipv6EndPointDemux;
 
 /**
  * \brief A representation of an internet IPv6 endpoint/connection
@@ -237,6 +238,21 @@ private:
    * \brief The destroy callback.
    */
   Callback<void> m_destroyCallback;
+
+  /**
+   * \brief The demux which allocated this EndPoint (if any).
+   *
+   * The demux indexes its endpoints by peer, so it must be told
+   * when the peer changes.
+   */
+  Ipv6EndPointDemux *m_demux;
+
+  /**
+   * \brief The allocation order of this EndPoint in m_demux.
+   */
+  uint64_t m_sequence;
+
+  friend class Ipv6EndPointDemux;
 };
 
 } /* namespace ns3 */
@@ -30,6 +30,7 @@
 #include "ns3/ipv6.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-routing-protocol.h"
+#include "ns3/prefix-trie.h"
 
 namespace ns3 {
 
@@ -292,11 +293,36 @@ private:
    */
   Ptr<Ipv6MulticastRoute> LookupStatic (Ipv6Address origin, Ipv6Address group, uint32_t ifIndex);
 
+  /**
+   * \brief Append a route to the forwarding table for network.
+   * \param route the route
+   * \param metric metric of the route
+   */
+  void InsertNetworkRoute (Ipv6RoutingTableEntry *route, uint32_t metric);
+
+  /**
+   * \brief Delete a route of the forwarding table for network.
+   * \param it the route
+   * \return the next route of the table
+   */
+  NetworkRoutesI EraseNetworkRoute (NetworkRoutesI it);
+
   /**
    * \brief the forwarding table for network.
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the routes of the forwarding table for network, by prefix.
+   */
+  PrefixTrie<std::pair <Ipv6RoutingTableEntry *, uint32_t> > m_networkTrie;
+
+  /**
+   * \brief the routes matching the destination of a lookup, kept to
+   * reuse their storage.
+   */
+  std::vector<std::pair <Ipv6RoutingTableEntry *, uint32_t> > m_networkMatches;
+
   /**
    * \brief the forwarding table for multicast.
    */
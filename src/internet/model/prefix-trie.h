@@ -0,0 +1,529 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PREFIX_TRIE_H
+#define PREFIX_TRIE_H
+
+#include <stdint.h>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief Path-compressed binary trie (Patricia trie) of address prefixes,
+ * used by the routing protocols to find the routes matching a destination
+ * without scanning the whole routing table.
+ *
+ * Each prefix (an address and a mask of up to 128 bits, most significant
+ * byte first) is associated with any number of values.  Match () returns
+ * the values of all the prefixes which match an address, in the order they
+ * were inserted: the routing protocols, whose routing tables are lists to
+ * which the routes are appended, can therefore apply to the result the
+ * same selection rules (longest prefix, metric, ECMP) as to the full list.
+ *
+ * Masks whose bits are not contiguous are supported, but are not stored
+ * in the trie: they are checked one by one.
+ */
+template <typename T>
+class PrefixTrie
+{
+public:
+  /**
+   * \param bits the number of bits of the addresses (32 or 128)
+   */
+  PrefixTrie (uint32_t bits);
+  ~PrefixTrie ();
+
+  /**
+   * \brief Associate a value with a prefix.
+   * \param prefix the address of the prefix (only the masked bits are used)
+   * \param mask the mask of the prefix
+   * \param value the value
+   */
+  void Insert (const uint8_t *prefix, const uint8_t *mask, T value);
+  /**
+   * \brief Associate a value with a 32 bit prefix.
+   * \param prefix the address of the prefix, in host order
+   * \param mask the mask of the prefix, in host order
+   * \param value the value
+   */
+  void Insert (uint32_t prefix, uint32_t mask, T value);
+  /**
+   * \brief Remove the first occurrence of a value from a prefix.
+   * \param prefix the address of the prefix
+   * \param mask the mask of the prefix
+   * \param value the value
+   * \return true if the value was found
+   */
+  bool Remove (const uint8_t *prefix, const uint8_t *mask, T value);
+  /**
+   * \brief Remove the first occurrence of a value from a 32 bit prefix.
+   * \param prefix the address of the prefix, in host order
+   * \param mask the mask of the prefix, in host order
+   * \param value the value
+   * \return true if the value was found
+   */
+  bool Remove (uint32_t prefix, uint32_t mask, T value);
+  /**
+   * \brief Remove all the prefixes.
+   */
+  void Clear (void);
+  /**
+   * \brief Find the values of all the prefixes which match an address.
+   *
+   * The values of the prefixes along the path to the address are merged
+   * without any allocation of the trie: a caller which passes the same
+   * vector, cleared, to each lookup does not allocate either.
+   *
+   * \param address the address
+   * \param values the matching values, appended in insertion order
+   */
+  void Match (const uint8_t *address, std::vector<T> &values) const;
+  /**
+   * \brief Find the values of all the prefixes which match a 32 bit address.
+   * \param address the address, in host order
+   * \param values the matching values, appended in insertion order
+   */
+  void Match (uint32_t address, std::vector<T> &values) const;
+
+private:
+  /// a value and its insertion sequence number
+  typedef std::pair<uint64_t, T> Value;
+
+  /// a node of the trie, that is a prefix
+  struct Node
+  {
+    uint8_t key[16];          //!< the prefix, with the bits beyond its length cleared
+    uint32_t length;          //!< the prefix length
+    Node *child[2];           //!< the longer prefixes, by value of the bit following the prefix
+    std::vector<Value> values; //!< the values of the prefix, in insertion order
+  };
+
+  /// a prefix whose mask is not contiguous
+  struct Irregular
+  {
+    uint8_t prefix[16]; //!< the masked address of the prefix
+    uint8_t mask[16];   //!< the mask of the prefix
+    Value value;        //!< the value of the prefix
+  };
+
+  /// the values of a node not yet merged by Match ()
+  struct Cursor
+  {
+    const Value *current; //!< the next value
+    const Value *end;     //!< past the last value
+  };
+
+  /**
+   * \param key a bit string
+   * \param i the index of a bit
+   * \return the i-th bit, starting from the most significant bit of key[0]
+   */
+  static uint32_t GetBit (const uint8_t *key, uint32_t i);
+  /**
+   * \param a a bit string
+   * \param b a bit string
+   * \param max the number of bits to compare
+   * \return the length of the common prefix of a and b, at most max
+   */
+  static uint32_t GetCommonLength (const uint8_t *a, const uint8_t *b, uint32_t max);
+  /**
+   * \param mask a mask
+   * \return the number of leading ones of the mask, or -1 if the mask is
+   * not contiguous
+   */
+  int32_t GetPrefixLength (const uint8_t *mask) const;
+  /**
+   * \param key a bit string
+   * \param length the length of the prefix of key to keep
+   * \return a new leaf node
+   */
+  static Node * CreateNode (const uint8_t *key, uint32_t length);
+  /**
+   * \brief Remove a node without values and with at most one child.
+   * \param link the pointer to the node
+   */
+  static void Prune (Node **link);
+  /**
+   * \brief Delete a subtree.
+   * \param node the root of the subtree
+   */
+  static void Delete (Node *node);
+  /**
+   * \param address an address
+   * \param i the first prefix whose mask is not contiguous to check
+   * \return the first prefix from i which matches the address
+   */
+  typename std::vector<Irregular>::const_iterator
+  FindIrregular (const uint8_t *address, typename std::vector<Irregular>::const_iterator i) const;
+
+  /// Disallow copies
+  PrefixTrie (const PrefixTrie &);
+  /// Disallow copies
+  PrefixTrie & operator= (const PrefixTrie &);
+
+  uint32_t m_bits;       //!< the number of bits of the addresses
+  Node *m_root;          //!< the shortest prefix
+  std::vector<Irregular> m_irregular; //!< the prefixes whose mask is not contiguous
+  uint64_t m_sequence;   //!< the sequence number of the next value
+};
+
+} // namespace ns3
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename T>
+PrefixTrie<T>::PrefixTrie (uint32_t bits)
+  : m_bits (bits),
+    m_root (0),
+    m_sequence (0)
+{
+  NS_ASSERT (bits <= 128 && bits % 8 == 0);
+}
+
+template <typename T>
+PrefixTrie<T>::~PrefixTrie ()
+{
+  Delete (m_root);
+}
+
+template <typename T>
+uint32_t
+PrefixTrie<T>::GetBit (const uint8_t *key, uint32_t i)
+{
+  return (key[i >> 3] >> (7 - (i & 7))) & 1;
+}
+
+template <typename T>
+uint32_t
+PrefixTrie<T>::GetCommonLength (const uint8_t *a, const uint8_t *b, uint32_t max)
+{
+  uint32_t i = 0;
+  while (i + 8 <= max && a[i >> 3] == b[i >> 3])
+    {
+      i += 8;
+    }
+  while (i < max && GetBit (a, i) == GetBit (b, i))
+    {
+      i++;
+    }
+  return i;
+}
+
+template <typename T>
+int32_t
+PrefixTrie<T>::GetPrefixLength (const uint8_t *mask) const
+{
+  uint32_t length = 0;
+  while (length < m_bits && GetBit (mask, length))
+    {
+      length++;
+    }
+  for (uint32_t i = length; i < m_bits; i++)
+    {
+      if (GetBit (mask, i))
+        {
+          return -1;
+        }
+    }
+  return length;
+}
+
+template <typename T>
+typename PrefixTrie<T>::Node *
+PrefixTrie<T>::CreateNode (const uint8_t *key, uint32_t length)
+{
+  Node *node = new Node;
+  std::memset (node->key, 0, sizeof (node->key));
+  std::memcpy (node->key, key, length >> 3);
+  if (length & 7)
+    {
+      node->key[length >> 3] = key[length >> 3] & (0xff << (8 - (length & 7)));
+    }
+  node->length = length;
+  node->child[0] = 0;
+  node->child[1] = 0;
+  return node;
+}
+
+template <typename T>
+void
+PrefixTrie<T>::Prune (Node **link)
+{
+  Node *node = *link;
+  if (node == 0 || !node->values.empty () || (node->child[0] != 0 && node->child[1] != 0))
+    {
+      return;
+    }
+  *link = node->child[0] != 0 ? node->child[0] : node->child[1];
+  delete node;
+}
+
+template <typename T>
+void
+PrefixTrie<T>::Delete (Node *node)
+{
+  if (node != 0)
+    {
+      Delete (node->child[0]);
+      Delete (node->child[1]);
+      delete node;
+    }
+}
+
+template <typename T>
+typename std::vector<typename PrefixTrie<T>::Irregular>::const_iterator
+PrefixTrie<T>::FindIrregular (const uint8_t *address, typename std::vector<Irregular>::const_iterator i) const
+{
+  for (; i != m_irregular.end (); i++)
+    {
+      bool match = true;
+      for (uint32_t j = 0; match && j < m_bits / 8; j++)
+        {
+          match = (address[j] & i->mask[j]) == i->prefix[j];
+        }
+      if (match)
+        {
+          break;
+        }
+    }
+  return i;
+}
+
+template <typename T>
+void
+PrefixTrie<T>::Insert (const uint8_t *prefix, const uint8_t *mask, T value)
+{
+  Value v = std::make_pair (m_sequence++, value);
+  int32_t length = GetPrefixLength (mask);
+  if (length < 0)
+    {
+      Irregular irregular;
+      for (uint32_t i = 0; i < m_bits / 8; i++)
+        {
+          irregular.prefix[i] = prefix[i] & mask[i];
+          irregular.mask[i] = mask[i];
+        }
+      irregular.value = v;
+      m_irregular.push_back (irregular);
+      return;
+    }
+  Node **link = &m_root;
+  while (*link != 0)
+    {
+      Node *node = *link;
+      uint32_t common = GetCommonLength (prefix, node->key, std::min<uint32_t> (length, node->length));
+      if (common == node->length)
+        {
+          if (node->length == static_cast<uint32_t> (length))
+            {
+              node->values.push_back (v);
+              return;
+            }
+          link = &node->child[GetBit (prefix, node->length)];
+          continue;
+        }
+      // the prefixes diverge (or the new one is shorter): insert a node
+      // for their common prefix above this one.
+      Node *branch = CreateNode (prefix, common);
+      branch->child[GetBit (node->key, common)] = node;
+      *link = branch;
+      if (common == static_cast<uint32_t> (length))
+        {
+          branch->values.push_back (v);
+        }
+      else
+        {
+          Node *leaf = CreateNode (prefix, length);
+          leaf->values.push_back (v);
+          branch->child[GetBit (prefix, common)] = leaf;
+        }
+      return;
+    }
+  *link = CreateNode (prefix, length);
+  (*link)->values.push_back (v);
+}
+
+template <typename T>
+bool
+PrefixTrie<T>::Remove (const uint8_t *prefix, const uint8_t *mask, T value)
+{
+  int32_t length = GetPrefixLength (mask);
+  if (length < 0)
+    {
+      for (typename std::vector<Irregular>::iterator i = m_irregular.begin (); i != m_irregular.end (); i++)
+        {
+          bool same = i->value.second == value;
+          for (uint32_t j = 0; same && j < m_bits / 8; j++)
+            {
+              same = i->mask[j] == mask[j] && i->prefix[j] == (prefix[j] & mask[j]);
+            }
+          if (same)
+            {
+              m_irregular.erase (i);
+              return true;
+            }
+        }
+      return false;
+    }
+  Node **parent = 0;
+  Node **link = &m_root;
+  while (*link != 0 && (*link)->length < static_cast<uint32_t> (length))
+    {
+      if (GetCommonLength (prefix, (*link)->key, (*link)->length) < (*link)->length)
+        {
+          return false;
+        }
+      parent = link;
+      link = &(*link)->child[GetBit (prefix, (*link)->length)];
+    }
+  Node *node = *link;
+  if (node == 0 || node->length != static_cast<uint32_t> (length)
+      || GetCommonLength (prefix, node->key, length) < static_cast<uint32_t> (length))
+    {
+      return false;
+    }
+  for (typename std::vector<Value>::iterator i = node->values.begin (); i != node->values.end (); i++)
+    {
+      if (i->second == value)
+        {
+          node->values.erase (i);
+          Prune (link);
+          if (parent != 0)
+            {
+              Prune (parent);
+            }
+          return true;
+        }
+    }
+  return false;
+}
+
+template <typename T>
+void
+PrefixTrie<T>::Clear (void)
+{
+  Delete (m_root);
+  m_root = 0;
+  m_irregular.clear ();
+}
+
+template <typename T>
+void
+PrefixTrie<T>::Match (const uint8_t *address, std::vector<T> &values) const
+{
+  // the values of each node are in insertion order, and so are the
+  // prefixes whose mask is not contiguous: merge them by sequence number.
+  // There is at most one node per prefix length on the path.
+  Cursor cursors[129];
+  uint32_t n = 0;
+  const Node *node = m_root;
+  while (node != 0 && GetCommonLength (address, node->key, node->length) == node->length)
+    {
+      if (!node->values.empty ())
+        {
+          cursors[n].current = &node->values[0];
+          cursors[n].end = cursors[n].current + node->values.size ();
+          n++;
+        }
+      if (node->length == m_bits)
+        {
+          break;
+        }
+      node = node->child[GetBit (address, node->length)];
+    }
+  typename std::vector<Irregular>::const_iterator irregular = FindIrregular (address, m_irregular.begin ());
+  if (n == 1 && irregular == m_irregular.end ())
+    {
+      for (const Value *i = cursors[0].current; i != cursors[0].end; i++)
+        {
+          values.push_back (i->second);
+        }
+      return;
+    }
+  while (true)
+    {
+      const Value *next = 0;
+      uint32_t from = n;
+      for (uint32_t i = 0; i < n; i++)
+        {
+          if (cursors[i].current != cursors[i].end
+              && (next == 0 || cursors[i].current->first < next->first))
+            {
+              next = cursors[i].current;
+              from = i;
+            }
+        }
+      if (irregular != m_irregular.end () && (next == 0 || irregular->value.first < next->first))
+        {
+          next = &irregular->value;
+          from = n;
+        }
+      if (next == 0)
+        {
+          return;
+        }
+      values.push_back (next->second);
+      if (from < n)
+        {
+          cursors[from].current++;
+        }
+      else
+        {
+          irregular = FindIrregular (address, irregular + 1);
+        }
+    }
+}
+
+template <typename T>
+void
+PrefixTrie<T>::Insert (uint32_t prefix, uint32_t mask, T value)
+{
+  uint8_t p[4] = { uint8_t (prefix >> 24), uint8_t (prefix >> 16), uint8_t (prefix >> 8), uint8_t (prefix) };
+  uint8_t m[4] = { uint8_t (mask >> 24), uint8_t (mask >> 16), uint8_t (mask >> 8), uint8_t (mask) };
+  Insert (p, m, value);
+}
+
+template <typename T>
+bool
+PrefixTrie<T>::Remove (uint32_t prefix, uint32_t mask, T value)
+{
+  uint8_t p[4] = { uint8_t (prefix >> 24), uint8_t (prefix >> 16), uint8_t (prefix >> 8), uint8_t (prefix) };
+  uint8_t m[4] = { uint8_t (mask >> 24), uint8_t (mask >> 16), uint8_t (mask >> 8), uint8_t (mask) };
+  return Remove (p, m, value);
+}
+
+template <typename T>
+void
+PrefixTrie<T>::Match (uint32_t address, std::vector<T> &values) const
+{
+  uint8_t a[4] = { uint8_t (address >> 24), uint8_t (address >> 16), uint8_t (address >> 8), uint8_t (address) };
+  Match (a, values);
+}
+
+} // namespace ns3
+
+#endif /* PREFIX_TRIE_H */
@@ -28,6 +28,19 @@ namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (TcpHeader);
 
+const uint32_t TcpHeader::MAX_SACK_BLOCKS;
+
+namespace {
+/// option kinds (RFC 793, RFC 2018)
+enum
+{
+  OPTION_END = 0,
+  OPTION_NOP = 1,
+  OPTION_SACK_PERMITTED = 4,
+  OPTION_SACK = 5
+};
+} // anonymous namespace
+
 TcpHeader::TcpHeader ()
   : m_sourcePort (0),
     m_destinationPort (0),
@@ -38,7 +51,8 @@ TcpHeader::TcpHeader ()
     m_windowSize (0xffff),
     m_urgentPointer (0),
     m_calcChecksum (false),
-    m_goodChecksum (true)
+    m_goodChecksum (true),
+    m_sackPermitted (false)
 {
 }
 
@@ -118,6 +132,49 @@ uint16_t TcpHeader::GetUrgentPointer () const
   return m_urgentPointer;
 }
 
+void TcpHeader::SetSackPermitted (bool permitted)
+{
+  m_sackPermitted = permitted;
+  UpdateLength ();
+}
+bool TcpHeader::IsSackPermitted () const
+{
+  return m_sackPermitted;
+}
+void TcpHeader::AddSackBlock (SequenceNumber32 left, SequenceNumber32 right)
+{
+  if (m_sackList.size () < MAX_SACK_BLOCKS)
+    {
+      m_sackList.push_back (SackBlock (left, right));
+      UpdateLength ();
+    }
+}
+const TcpHeader::SackList & TcpHeader::GetSackList () const
+{
+  return m_sackList;
+}
+void TcpHeader::ClearSackList ()
+{
+  m_sackList.clear ();
+  UpdateLength ();
+}
+
+void
+TcpHeader::UpdateLength ()
+{
+  // Both options are aligned on 32 bits by two NOPs
+  uint32_t options = 0;
+  if (m_sackPermitted)
+    {
+      options += 4;
+    }
+  if (!m_sackList.empty ())
+    {
+      options += 4 + 8 * m_sackList.size ();
+    }
+  m_length = 5 + options / 4;
+}
+
 void 
 TcpHeader::InitializeChecksum (Ipv4Address source, 
                                Ipv4Address destination,
@@ -252,6 +309,14 @@ void TcpHeader::Print (std::ostream &os)  const
       os<<"]";
     }
   os<<" Seq="<<m_sequenceNumber<<" Ack="<<m_ackNumber<<" Win="<<m_windowSize;
+  if (m_sackPermitted)
+    {
+      os<<" SackPermitted";
+    }
+  for (SackList::const_iterator it = m_sackList.begin (); it != m_sackList.end (); ++it)
+    {
+      os<<" Sack="<<it->first<<"-"<<it->second;
+    }
 }
 uint32_t TcpHeader::GetSerializedSize (void)  const
 {
@@ -269,6 +334,34 @@ void TcpHeader::Serialize (Buffer::Iterator start)  const
   i.WriteHtonU16 (0);
   i.WriteHtonU16 (m_urgentPointer);
 
+  uint32_t options = 4 * m_length - 20;
+  if (m_sackPermitted && options >= 4)
+    {
+      i.WriteU8 (OPTION_NOP);
+      i.WriteU8 (OPTION_NOP);
+      i.WriteU8 (OPTION_SACK_PERMITTED);
+      i.WriteU8 (2);
+      options -= 4;
+    }
+  if (!m_sackList.empty () && options >= 4 + 8 * m_sackList.size ())
+    {
+      i.WriteU8 (OPTION_NOP);
+      i.WriteU8 (OPTION_NOP);
+      i.WriteU8 (OPTION_SACK);
+      i.WriteU8 (2 + 8 * m_sackList.size ());
+      for (SackList::const_iterator it = m_sackList.begin (); it != m_sackList.end (); ++it)
+        {
+          i.WriteHtonU32 (it->first.GetValue ());
+          i.WriteHtonU32 (it->second.GetValue ());
+        }
+      options -= 4 + 8 * m_sackList.size ();
+    }
+  // Pad a header whose length was set explicitly
+  for (; options > 0; options--)
+    {
+      i.WriteU8 (OPTION_END);
+    }
+
   if(m_calcChecksum)
     {
       uint16_t headerChecksum = CalculateHeaderChecksum (start.GetSize ());
@@ -294,6 +387,13 @@ uint32_t TcpHeader::Deserialize (Buffer::Iterator start)
   i.Next (2);
   m_urgentPointer = i.ReadNtohU16 ();
 
+  m_sackPermitted = false;
+  m_sackList.clear ();
+  if (m_length > 5)
+    {
+      DeserializeOptions (i, 4 * m_length - 20);
+    }
+
   if(m_calcChecksum)
     {
       uint16_t headerChecksum = CalculateHeaderChecksum (start.GetSize ());
@@ -305,5 +405,54 @@ uint32_t TcpHeader::Deserialize (Buffer::Iterator start)
   return GetSerializedSize ();
 }
 
+void
+TcpHeader::DeserializeOptions (Buffer::Iterator i, uint32_t size)
+{
+  while (size > 0)
+    {
+      uint8_t kind = i.ReadU8 ();
+      size--;
+      if (kind == OPTION_END)
+        {
+          break;
+        }
+      if (kind == OPTION_NOP)
+        {
+          continue;
+        }
+      if (size == 0)
+        {
+          break;
+        }
+      uint8_t length = i.ReadU8 ();
+      size--;
+      if (length < 2 || length - 2u > size)
+        {
+          break; // malformed option
+        }
+      uint32_t payload = length - 2;
+      if (kind == OPTION_SACK_PERMITTED && payload == 0)
+        {
+          m_sackPermitted = true;
+        }
+      else if (kind == OPTION_SACK && payload % 8 == 0)
+        {
+          while (payload > 0 && m_sackList.size () < MAX_SACK_BLOCKS)
+            {
+              SequenceNumber32 left (i.ReadNtohU32 ());
+              SequenceNumber32 right (i.ReadNtohU32 ());
+              m_sackList.push_back (SackBlock (left, right));
+              payload -= 8;
+            }
+          i.Next (payload);
+        }
+      else
+        {
+          i.Next (payload);
+        }
+      size -= length - 2;
+    }
+}
+
 
 } // namespace ns3
@@ -22,6 +22,8 @@
 #define TCP_HEADER_H
 
 #include <stdint.h>
+#include <list>
+#include <utility>
 #include "ns3/header.h"
 #include "ns3/buffer.h"
 #include "ns3/tcp-socket-factory.h"
@@ -38,6 +40,10 @@ namespace ns3 {
  * This class has fields corresponding to those in a network TCP header
  * (port numbers, sequence and acknowledgement numbers, flags, etc) as well
  * as methods for serialization to and deserialization from a byte buffer.
+ *
+ * The SACK-permitted and SACK options of RFC 2018 are supported; the
+ * header length is updated whenever an option is added. Other options
+ * are skipped on deserialization.
  */
 
 class TcpHeader : public Header 
@@ -121,6 +127,47 @@ public:
    */
   uint16_t GetUrgentPointer () const;
 
+  /**
+   * \brief A SACK block: the first and the last + 1 sequence numbers of
+   * a block of contiguous data received out of order.
+   */
+  typedef std::pair<SequenceNumber32, SequenceNumber32> SackBlock;
+  /**
+   * \brief The SACK blocks of a header, in the order of the option
+   */
+  typedef std::list<SackBlock> SackList;
+
+  /**
+   * \brief Maximum number of SACK blocks in a header (RFC 2018)
+   */
+  static const uint32_t MAX_SACK_BLOCKS = 4;
+
+  /**
+   * \param permitted true to carry the SACK-permitted option (SYN segments)
+   */
+  void SetSackPermitted (bool permitted);
+  /**
+   * \return true if this header carries the SACK-permitted option
+   */
+  bool IsSackPermitted () const;
+  /**
+   * \brief Append a block to the SACK option of this header
+   *
+   * Blocks beyond MAX_SACK_BLOCKS are ignored.
+   *
+   * \param left the first sequence number of the block
+   * \param right the sequence number following the last byte of the block
+   */
+  void AddSackBlock (SequenceNumber32 left, SequenceNumber32 right);
+  /**
+   * \return the blocks of the SACK option of this header, if any
+   */
+  const SackList & GetSackList () const;
+  /**
+   * \brief Remove the SACK option of this header
+   */
+  void ClearSackList ();
+
   /**
    * \brief Initialize the TCP checksum.
    *
@@ -205,6 +252,16 @@ private:
    * \returns the checksum
    */
   uint16_t CalculateHeaderChecksum (uint16_t size) const;
+  /**
+   * \brief Set the header length according to the options
+   */
+  void UpdateLength ();
+  /**
+   * \brief Read the options of the header
+   * \param i iterator on the first byte of the options
+   * \param size size of the options, in bytes
+   */
+  void DeserializeOptions (Buffer::Iterator i, uint32_t size);
   uint16_t m_sourcePort;        //!< Source port
   uint16_t m_destinationPort;   //!< Destination port
   SequenceNumber32 m_sequenceNumber;  //!< Sequence number
@@ -220,6 +277,9 @@ private:
 
   bool m_calcChecksum;    //!< Flag to calculate checksum
   bool m_goodChecksum;    //!< Flag to indicate that checksum is correct
+
+  bool m_sackPermitted;   //!< SACK-permitted option
+  SackList m_sackList;    //!< Blocks of the SACK option
 };
 
 } // namespace ns3
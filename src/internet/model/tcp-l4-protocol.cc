@@ -78,6 +78,12 @@ TcpL4Protocol::GetTypeId (void)
                    TypeIdValue (TcpNewReno::GetTypeId ()),
                    MakeTypeIdAccessor (&TcpL4Protocol::m_socketTypeId),
                    MakeTypeIdChecker ())
+    .AddAttribute ("TimerResolution",
+                   "The resolution of the timer wheel shared by the timers of the sockets. "
+                   "Zero schedules each timer in the simulator.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&TcpL4Protocol::m_timerResolution),
+                   MakeTimeChecker ())
     .AddAttribute ("SocketList", "The list of sockets associated to this protocol.",
                    ObjectVectorValue (),
                    MakeObjectVectorAccessor (&TcpL4Protocol::m_sockets),
@@ -169,6 +175,7 @@ TcpL4Protocol::DoDispose (void)
       m_endPoints6 = 0;
     }
 
+  m_timerWheel = 0;
   m_node = 0;
   m_downTarget.Nullify ();
   m_downTarget6.Nullify ();
@@ -198,6 +205,16 @@ TcpL4Protocol::CreateSocket (void)
   return CreateSocket (m_socketTypeId);
 }
 
+Ptr<TimerWheel>
+TcpL4Protocol::GetTimerWheel (void)
+{
+  if (m_timerWheel == 0 && m_timerResolution.IsStrictlyPositive ())
+    {
+      m_timerWheel = Create<TimerWheel> (m_timerResolution);
+    }
+  return m_timerWheel;
+}
+
 Ipv4EndPoint *
 TcpL4Protocol::Allocate (void)
 {
@@ -611,7 +628,6 @@ TcpL4Protocol::SendPacket (Ptr<Packet> packet, const TcpHeader &outgoing,
   // XXX outgoingHeader cannot be logged
 
   TcpHeader outgoingHeader = outgoing;
-  outgoingHeader.SetLength (5); //header length in units of 32bit words
   /** \todo UrgentPointer */
   /* outgoingHeader.SetUrgentPointer (0); */
   if(Node::ChecksumEnabled ())
@@ -663,7 +679,6 @@ TcpL4Protocol::SendPacket (Ptr<Packet> packet, const TcpHeader &outgoing,
       return (SendPacket (packet, outgoing, saddr.GetIpv4MappedAddress(), daddr.GetIpv4MappedAddress(), oif));
     }
   TcpHeader outgoingHeader = outgoing;
-  outgoingHeader.SetLength (5); //header length in units of 32bit words
   /** \todo UrgentPointer */
   /* outgoingHeader.SetUrgentPointer (0); */
   if(Node::ChecksumEnabled ())
@@ -28,6 +28,8 @@
 #include "ns3/ipv6-address.h"
 #include "ns3/ptr.h"
 #include "ns3/object-factory.h"
+#include "ns3/nstime.h"
+#include "ns3/timer-wheel.h"
 #include "ip-l4-protocol.h"
 #include "ns3/net-device.h"
 
@@ -90,6 +92,17 @@ public:
    */
   Ptr<Socket> CreateSocket (TypeId socketTypeId);
 
+  /**
+   * \brief Get the timer wheel shared by the timers of the sockets
+   *
+   * The wheel is created by the first call, if the TimerResolution
+   * attribute is not zero.
+   *
+   * \return the timer wheel of the sockets of this node, or zero if their
+   * timers are scheduled directly in the simulator
+   */
+  Ptr<TimerWheel> GetTimerWheel (void);
+
   /**
    * \brief Allocate an IPv4 Endpoint
    * \return the Endpoint
@@ -232,6 +245,8 @@ private:
   Ipv6EndPointDemux *m_endPoints6; //!< A list of IPv6 end points.
   TypeId m_rttTypeId; //!< The RTT Estimator TypeId
   TypeId m_socketTypeId; //!< The socket TypeId
+  Time m_timerResolution; //!< The resolution of the timer wheel, zero for none
+  Ptr<TimerWheel> m_timerWheel; //!< The timer wheel of the sockets
 private:
   friend class TcpSocketBase;
   void SendPacket (Ptr<Packet>, const TcpHeader &,
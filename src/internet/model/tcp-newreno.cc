@@ -122,7 +122,15 @@ TcpNewReno::NewAck (const SequenceNumber32& seq)
                 " ssthresh " << m_ssThresh);
 
   // Check for exit condition of fast recovery
-  if (m_inFastRec && seq < m_recover)
+  if (m_inFastRec && seq < m_recover && m_sackPermitted)
+    { // Partial ACK, the scoreboard tells which segments to retransmit (RFC6675 sec.5)
+      NS_LOG_INFO ("Partial ACK in SACK recovery: cwnd " << m_cWnd << " pipe " << Pipe ());
+      m_txBuffer.DiscardUpTo (seq);
+      TcpSocketBase::NewAck (seq);
+      SendSackRecovery ();
+      return;
+    }
+  else if (m_inFastRec && seq < m_recover)
     { // Partial ACK, partial window deflation (RFC2582 sec.3 bullet #5 paragraph 3)
       m_cWnd -= seq - m_txBuffer.HeadSequence ();
       m_cWnd += m_segmentSize;  // increase cwnd
@@ -163,7 +171,22 @@ void
 TcpNewReno::DupAck (const TcpHeader& t, uint32_t count)
 {
   NS_LOG_FUNCTION (this << count);
-  if (count == m_retxThresh && !m_inFastRec)
+  // With SACK, the loss is also detected once more than (ReTxThreshold - 1)
+  // segments were SACKed (RFC6675 sec.5)
+  bool sackLoss = m_sackPermitted && m_txBuffer.SackedBytes () > (m_retxThresh - 1) * m_segmentSize;
+  if ((count == m_retxThresh || sackLoss) && !m_inFastRec && m_sackPermitted)
+    { // SACK-based loss recovery: the pipe, not cwnd inflation, clocks the transmissions
+      m_ssThresh = std::max (2 * m_segmentSize, BytesInFlight () / 2);
+      m_cWnd = m_ssThresh;
+      m_recover = m_highTxMark;
+      m_inFastRec = true;
+      NS_LOG_INFO ("Loss detected. Enter SACK recovery mode. Reset cwnd to " << m_cWnd <<
+                   ", ssthresh to " << m_ssThresh << " at fast recovery seqnum " << m_recover);
+      DoRetransmit ();
+      m_highRxt = m_txBuffer.HeadSequence () + SequenceNumber32 (std::min (m_segmentSize, m_txBuffer.Size ()));
+      SendSackRecovery ();
+    }
+  else if (count == m_retxThresh && !m_inFastRec)
     { // triple duplicate ack triggers fast retransmit (RFC2582 sec.3 bullet #1)
       m_ssThresh = std::max (2 * m_segmentSize, BytesInFlight () / 2);
       m_cWnd = m_ssThresh + 3 * m_segmentSize;
@@ -173,6 +196,10 @@ TcpNewReno::DupAck (const TcpHeader& t, uint32_t count)
                    ", ssthresh to " << m_ssThresh << " at fast recovery seqnum " << m_recover);
       DoRetransmit ();
     }
+  else if (m_inFastRec && m_sackPermitted)
+    { // The dupack SACKed more data, which left the pipe
+      SendSackRecovery ();
+    }
   else if (m_inFastRec)
     { // Increase cwnd for every additional dupack (RFC2582, sec.3 bullet #3)
       m_cWnd += m_segmentSize;
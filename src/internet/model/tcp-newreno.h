@@ -32,6 +32,11 @@ namespace ns3 {
  * \brief An implementation of a stream socket using TCP.
  *
  * This class contains the NewReno implementation of TCP, as of \RFC{2582}.
+ *
+ * When the SACK option is negotiated (attribute ns3::TcpSocketBase::Sack),
+ * the fast recovery follows the conservative SACK-based loss recovery of
+ * \RFC{6675}: the holes below the highest SACKed byte are retransmitted
+ * as allowed by the estimated pipe, instead of one segment per partial ACK.
  */
 class TcpNewReno : public TcpSocketBase
 {
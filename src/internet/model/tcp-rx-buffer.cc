@@ -48,7 +48,8 @@ TcpRxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpRxBuffer::TcpRxBuffer (uint32_t n)
-  : m_nextRxSeq (n), m_gotFin (false), m_size (0), m_maxBuffer (32768), m_availBytes (0)
+  : m_nextRxSeq (n), m_gotFin (false), m_size (0), m_maxBuffer (32768), m_availBytes (0),
+    m_lastAddedSeq (n)
 {
 }
 
@@ -152,8 +153,14 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
+  // Remove overlapped bytes from packet. The buffered packets do not
+  // overlap, so only the last one starting at or before headSeq and the
+  // following ones can overlap the new packet.
+  BufIterator i = m_data.upper_bound (headSeq);
+  if (i != m_data.begin ())
+    {
+      --i;
+    }
   while (i != m_data.end () && i->first <= tailSeq)
     {
       SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
@@ -192,16 +199,14 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   // Insert packet into buffer
   NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
   m_data [ headSeq ] = p;
+  m_lastAddedSeq = headSeq;
   NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
   // Update variables
   m_size += p->GetSize ();      // Occupancy
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  // The packets before m_nextRxSeq are in sequence already
+  for (BufIterator i = m_data.lower_bound (m_nextRxSeq); i != m_data.end (); ++i)
     {
-      if (i->first < m_nextRxSeq)
-        {
-          continue;
-        }
-      else if (i->first > m_nextRxSeq)
+      if (i->first > m_nextRxSeq)
         {
           break;
         };
@@ -261,4 +266,49 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   return outPkt;
 }
 
+TcpHeader::SackList
+TcpRxBuffer::GetSackList (uint32_t maxBlocks) const
+{
+  NS_LOG_FUNCTION (this << maxBlocks);
+
+  TcpHeader::SackList blocks;
+  if (maxBlocks == 0)
+    {
+      return blocks;
+    }
+  // Merge the buffered packets beyond the first hole into contiguous
+  // blocks, most recent first, then highest first
+  TcpHeader::SackBlock recent;
+  bool found = false;
+  std::map<SequenceNumber32, Ptr<Packet> >::const_iterator i = m_data.upper_bound (m_nextRxSeq);
+  while (i != m_data.end ())
+    {
+      TcpHeader::SackBlock block (i->first, i->first + SequenceNumber32 (i->second->GetSize ()));
+      bool holdsRecent = (i->first == m_lastAddedSeq);
+      for (++i; i != m_data.end () && i->first == block.second; ++i)
+        {
+          block.second = i->first + SequenceNumber32 (i->second->GetSize ());
+          holdsRecent = holdsRecent || (i->first == m_lastAddedSeq);
+        }
+      if (holdsRecent)
+        {
+          recent = block;
+          found = true;
+        }
+      else
+        {
+          blocks.push_front (block);
+        }
+    }
+  if (found)
+    {
+      blocks.push_front (recent);
+    }
+  while (blocks.size () > maxBlocks)
+    {
+      blocks.pop_back ();
+    }
+  return blocks;
+}
+
 } //namepsace ns3
@@ -124,6 +124,17 @@ public:
    * \returns a packet
    */
   Ptr<Packet> Extract (uint32_t maxSize);
+
+  /**
+   * Get the blocks of contiguous data received beyond NextRxSequence, to
+   * be reported in a SACK option. As required by RFC 2018, the first block
+   * holds the most recently received segment; the other blocks follow in
+   * decreasing order of sequence numbers.
+   *
+   * \param maxBlocks maximum number of blocks to report
+   * \returns the SACK blocks, empty if no data was received out of order
+   */
+  TcpHeader::SackList GetSackList (uint32_t maxBlocks) const;
 public:
   /// container for data stored in the buffer
   typedef std::map<SequenceNumber32, Ptr<Packet> >::iterator BufIterator;
@@ -134,6 +145,7 @@ public:
   uint32_t m_maxBuffer;                      //!< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //!< Number of bytes available to read, i.e. contiguous block at head
   std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null)
+  SequenceNumber32 m_lastAddedSeq;           //!< Seqnum of the last data added to the buffer
 };
 
 } //namepsace ns3
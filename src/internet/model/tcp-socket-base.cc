@@ -39,6 +39,7 @@
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/trace-source-accessor.h"
 #include "tcp-socket-base.h"
 #include "tcp-l4-protocol.h"
@@ -75,6 +76,10 @@ TcpSocketBase::GetTypeId (void)
                    UintegerValue (65535),
                    MakeUintegerAccessor (&TcpSocketBase::m_maxWinSize),
                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("Sack", "Enable the selective acknowledgement option (RFC 2018)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_sackEnabled),
+                   MakeBooleanChecker ())
     .AddAttribute ("IcmpCallback", "Callback invoked whenever an icmp error is received on this socket.",
                    CallbackValue (),
                    MakeCallbackAccessor (&TcpSocketBase::m_icmpCallback),
@@ -106,7 +111,13 @@ TcpSocketBase::GetTypeId (void)
 }
 
 TcpSocketBase::TcpSocketBase (void)
-  : m_dupAckCount (0),
+  : m_retxTimer (Timer::CANCEL_ON_DESTROY),
+    m_lastAckTimer (Timer::CANCEL_ON_DESTROY),
+    m_delAckTimer (Timer::CANCEL_ON_DESTROY),
+    m_persistTimer (Timer::CANCEL_ON_DESTROY),
+    m_timewaitTimer (Timer::CANCEL_ON_DESTROY),
+    m_retxFlags (0),
+    m_dupAckCount (0),
     m_delAckCount (0),
     m_endPoint (0),
     m_endPoint6 (0),
@@ -127,14 +138,23 @@ TcpSocketBase::TcpSocketBase (void)
     m_connected (false),
     m_segmentSize (0),
     // For attribute initialization consistency (quiet valgrind)
-    m_rWnd (0)
+    m_rWnd (0),
+    m_sackEnabled (false),
+    m_sackPermitted (false)
 {
   NS_LOG_FUNCTION (this);
+  InitTimers ();
 }
 
 TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
   : TcpSocket (sock),
     //copy object::m_tid and socket::callbacks
+    m_retxTimer (Timer::CANCEL_ON_DESTROY),
+    m_lastAckTimer (Timer::CANCEL_ON_DESTROY),
+    m_delAckTimer (Timer::CANCEL_ON_DESTROY),
+    m_persistTimer (Timer::CANCEL_ON_DESTROY),
+    m_timewaitTimer (Timer::CANCEL_ON_DESTROY),
+    m_retxFlags (0),
     m_dupAckCount (sock.m_dupAckCount),
     m_delAckCount (0),
     m_delAckMaxCount (sock.m_delAckMaxCount),
@@ -162,10 +182,18 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_msl (sock.m_msl),
     m_segmentSize (sock.m_segmentSize),
     m_maxWinSize (sock.m_maxWinSize),
-    m_rWnd (sock.m_rWnd)
+    m_rWnd (sock.m_rWnd),
+    m_sackEnabled (sock.m_sackEnabled),
+    m_sackPermitted (sock.m_sackPermitted),
+    m_highRxt (sock.m_highRxt)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_LOGIC ("Invoked the copy constructor");
+  InitTimers ();
+  if (m_tcp != 0)
+    {
+      SetTimerWheel (m_tcp->GetTimerWheel ());
+    }
   // Copy the rtt estimator if it is set
   if (sock.m_rtt)
     {
@@ -222,6 +250,10 @@ void
 TcpSocketBase::SetTcp (Ptr<TcpL4Protocol> tcp)
 {
   m_tcp = tcp;
+  if (m_tcp != 0)
+    {
+      SetTimerWheel (m_tcp->GetTimerWheel ());
+    }
 }
 
 /* Set an RTT estimator with this socket */
@@ -883,7 +915,7 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, Ipv4Header header, uint16_t port
   if (m_rWnd.Get () == 0 && tcpHeader.GetWindowSize () != 0)
     { // persist probes end
       NS_LOG_LOGIC (this << " Leaving zerowindow persist state");
-      m_persistEvent.Cancel ();
+      m_persistTimer.Cancel ();
     }
   m_rWnd = tcpHeader.GetWindowSize ();
 
@@ -978,7 +1010,7 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, Ipv6Header header, uint16_t port
   if (m_rWnd.Get () == 0 && tcpHeader.GetWindowSize () != 0)
     { // persist probes end
       NS_LOG_LOGIC (this << " Leaving zerowindow persist state");
-      m_persistEvent.Cancel ();
+      m_persistTimer.Cancel ();
     }
   m_rWnd = tcpHeader.GetWindowSize ();
 
@@ -1176,7 +1208,7 @@ TcpSocketBase::ProcessSynSent (Ptr<Packet> packet, const TcpHeader& tcpHeader)
       NS_LOG_INFO ("SYN_SENT -> ESTABLISHED");
       m_state = ESTABLISHED;
       m_connected = true;
-      m_retxEvent.Cancel ();
+      m_retxTimer.Cancel ();
       m_delAckCount = m_delAckMaxCount;
       ReceivedData (packet, tcpHeader);
       Simulator::ScheduleNow (&TcpSocketBase::ConnectionSucceeded, this);
@@ -1198,7 +1230,7 @@ TcpSocketBase::ProcessSynSent (Ptr<Packet> packet, const TcpHeader& tcpHeader)
       NS_LOG_INFO ("SYN_SENT -> ESTABLISHED");
       m_state = ESTABLISHED;
       m_connected = true;
-      m_retxEvent.Cancel ();
+      m_retxTimer.Cancel ();
       m_rxBuffer.SetNextRxSequence (tcpHeader.GetSequenceNumber () + SequenceNumber32 (1));
       m_highTxMark = ++m_nextTxSequence;
       m_txBuffer.SetHeadSequence (m_nextTxSequence);
@@ -1239,7 +1271,7 @@ TcpSocketBase::ProcessSynRcvd (Ptr<Packet> packet, const TcpHeader& tcpHeader,
       NS_LOG_INFO ("SYN_RCVD -> ESTABLISHED");
       m_state = ESTABLISHED;
       m_connected = true;
-      m_retxEvent.Cancel ();
+      m_retxTimer.Cancel ();
       m_highTxMark = ++m_nextTxSequence;
       m_txBuffer.SetHeadSequence (m_nextTxSequence);
       if (m_endPoint)
@@ -1273,7 +1305,7 @@ TcpSocketBase::ProcessSynRcvd (Ptr<Packet> packet, const TcpHeader& tcpHeader,
       if (tcpHeader.GetSequenceNumber () == m_rxBuffer.NextRxSequence ())
         { // In-sequence FIN before connection complete. Set up connection and close.
           m_connected = true;
-          m_retxEvent.Cancel ();
+          m_retxTimer.Cancel ();
           m_highTxMark = ++m_nextTxSequence;
           m_txBuffer.SetHeadSequence (m_nextTxSequence);
           if (m_endPoint)
@@ -1519,8 +1551,8 @@ TcpSocketBase::DoPeerClose (void)
   if (m_state == LAST_ACK)
     {
       NS_LOG_LOGIC ("TcpSocketBase " << this << " scheduling LATO1");
-      m_lastAckEvent = Simulator::Schedule (m_rtt->RetransmitTimeout (),
-                                            &TcpSocketBase::LastAckTimeout, this);
+      m_lastAckTimer.Cancel ();
+      m_lastAckTimer.Schedule (m_rtt->RetransmitTimeout ());
     }
 }
 
@@ -1541,7 +1573,7 @@ TcpSocketBase::Destroy (void)
         }
     }
   NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                (Simulator::Now () + m_retxTimer.GetDelayLeft ()).GetSeconds ());
   CancelAllTimers ();
 }
 
@@ -1562,7 +1594,7 @@ TcpSocketBase::Destroy6 (void)
         }
     }
   NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                (Simulator::Now () + m_retxTimer.GetDelayLeft ()).GetSeconds ());
   CancelAllTimers ();
 }
 
@@ -1669,15 +1701,16 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
     }
   if (flags & TcpHeader::ACK)
     { // If sending an ACK, cancel the delay ACK as well
-      m_delAckEvent.Cancel ();
+      m_delAckTimer.Cancel ();
       m_delAckCount = 0;
     }
-  if (m_retxEvent.IsExpired () && (hasSyn || hasFin) && !isAck )
+  if (m_retxTimer.IsExpired () && (hasSyn || hasFin) && !isAck )
     { // Retransmit SYN / SYN+ACK / FIN / FIN+ACK to guard against lost
       NS_LOG_LOGIC ("Schedule retransmission timeout at time "
                     << Simulator::Now ().GetSeconds () << " to expire at time "
                     << (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
+      m_retxFlags = flags;
+      m_retxTimer.Schedule (m_rto);
     }
 }
 
@@ -1910,13 +1943,14 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
     }
   header.SetWindowSize (AdvertisedWindowSize ());
   AddOptions (header);
-  if (m_retxEvent.IsExpired () )
+  if (m_retxTimer.IsExpired () )
     { // Schedule retransmit
       m_rto = m_rtt->RetransmitTimeout ();
       NS_LOG_LOGIC (this << " SendDataPacket Schedule ReTxTimeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds () );
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      m_retxFlags = 0;
+      m_retxTimer.Schedule (m_rto);
     }
   NS_LOG_LOGIC ("Send packet via TcpL4Protocol with flags 0x" << std::hex << static_cast<uint32_t> (flags) << std::dec);
   if (m_endPoint)
@@ -2053,15 +2087,14 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
     { // In-sequence packet: ACK if delayed ack count allows
       if (++m_delAckCount >= m_delAckMaxCount)
         {
-          m_delAckEvent.Cancel ();
+          m_delAckTimer.Cancel ();
           m_delAckCount = 0;
           SendEmptyPacket (TcpHeader::ACK);
         }
-      else if (m_delAckEvent.IsExpired ())
+      else if (m_delAckTimer.IsExpired ())
         {
-          m_delAckEvent = Simulator::Schedule (m_delAckTimeout,
-                                               &TcpSocketBase::DelAckTimeout, this);
-          NS_LOG_LOGIC (this << " scheduled delayed ACK at " << (Simulator::Now () + Simulator::GetDelayLeft (m_delAckEvent)).GetSeconds ());
+          m_delAckTimer.Schedule (m_delAckTimeout);
+          NS_LOG_LOGIC (this << " scheduled delayed ACK at " << (Simulator::Now () + m_delAckTimer.GetDelayLeft ()).GetSeconds ());
         }
     }
   // Notify app to receive if necessary
@@ -2115,26 +2148,27 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack)
   if (m_state != SYN_RCVD)
     { // Set RTO unless the ACK is received in SYN_RCVD state
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
+                    (Simulator::Now () + m_retxTimer.GetDelayLeft ()).GetSeconds ());
+      m_retxTimer.Cancel ();
       // On recieving a "New" ack we restart retransmission timer .. RFC 2988
       m_rto = m_rtt->RetransmitTimeout ();
       NS_LOG_LOGIC (this << " Schedule ReTxTimeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      m_retxFlags = 0;
+      m_retxTimer.Schedule (m_rto);
     }
-  if (m_rWnd.Get () == 0 && m_persistEvent.IsExpired ())
+  if (m_rWnd.Get () == 0 && m_persistTimer.IsExpired ())
     { // Zero window: Enter persist state to send 1 byte to probe
       NS_LOG_LOGIC (this << "Enter zerowindow persist state");
       NS_LOG_LOGIC (this << "Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
+                    (Simulator::Now () + m_retxTimer.GetDelayLeft ()).GetSeconds ());
+      m_retxTimer.Cancel ();
       NS_LOG_LOGIC ("Schedule persist timeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_persistTimeout).GetSeconds ());
-      m_persistEvent = Simulator::Schedule (m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
-      NS_ASSERT (m_persistTimeout == Simulator::GetDelayLeft (m_persistEvent));
+      m_persistTimer.Schedule (m_persistTimeout);
+      NS_ASSERT (m_persistTimer.GetDelayLeft () >= m_persistTimeout);
     }
   // Note the highest ACK and tell app to send more
   NS_LOG_LOGIC ("TCP " << this << " NewAck " << ack <<
@@ -2151,8 +2185,8 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack)
   if (m_txBuffer.Size () == 0 && m_state != FIN_WAIT_1 && m_state != CLOSING)
     { // No retransmit timer if no data to retransmit
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
+                    (Simulator::Now () + m_retxTimer.GetDelayLeft ()).GetSeconds ());
+      m_retxTimer.Cancel ();
     }
   // Try to send more data
   SendPendingData (m_connected);
@@ -2174,10 +2208,25 @@ TcpSocketBase::ReTxTimeout ()
     {
       return;
     }
+  // The receiver may have discarded the data it SACKed (RFC 2018)
+  m_txBuffer.ClearSackBlocks ();
 
   Retransmit ();
 }
 
+void
+TcpSocketBase::RetxTimerExpired (void)
+{
+  if (m_retxFlags != 0)
+    {
+      SendEmptyPacket (m_retxFlags);
+    }
+  else
+    {
+      ReTxTimeout ();
+    }
+}
+
 void
 TcpSocketBase::DelAckTimeout (void)
 {
@@ -2190,7 +2239,7 @@ TcpSocketBase::LastAckTimeout (void)
 {
   NS_LOG_FUNCTION (this);
 
-  m_lastAckEvent.Cancel ();
+  m_lastAckTimer.Cancel ();
   if (m_state == LAST_ACK)
     {
       CloseAndNotify ();
@@ -2239,7 +2288,7 @@ TcpSocketBase::PersistTimeout ()
   NS_LOG_LOGIC ("Schedule persist timeout at time "
                 << Simulator::Now ().GetSeconds () << " to expire at time "
                 << (Simulator::Now () + m_persistTimeout).GetSeconds ());
-  m_persistEvent = Simulator::Schedule (m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
+  m_persistTimer.Schedule (m_persistTimeout);
 }
 
 void
@@ -2288,11 +2337,31 @@ TcpSocketBase::DoRetransmit ()
 void
 TcpSocketBase::CancelAllTimers ()
 {
-  m_retxEvent.Cancel ();
-  m_persistEvent.Cancel ();
-  m_delAckEvent.Cancel ();
-  m_lastAckEvent.Cancel ();
-  m_timewaitEvent.Cancel ();
+  m_retxTimer.Cancel ();
+  m_persistTimer.Cancel ();
+  m_delAckTimer.Cancel ();
+  m_lastAckTimer.Cancel ();
+  m_timewaitTimer.Cancel ();
+}
+
+void
+TcpSocketBase::InitTimers ()
+{
+  m_retxTimer.SetFunction (&TcpSocketBase::RetxTimerExpired, this);
+  m_lastAckTimer.SetFunction (&TcpSocketBase::LastAckTimeout, this);
+  m_delAckTimer.SetFunction (&TcpSocketBase::DelAckTimeout, this);
+  m_persistTimer.SetFunction (&TcpSocketBase::PersistTimeout, this);
+  m_timewaitTimer.SetFunction (&TcpSocketBase::CloseAndNotify, this);
+}
+
+void
+TcpSocketBase::SetTimerWheel (Ptr<TimerWheel> wheel)
+{
+  m_retxTimer.SetWheel (wheel);
+  m_lastAckTimer.SetWheel (wheel);
+  m_delAckTimer.SetWheel (wheel);
+  m_persistTimer.SetWheel (wheel);
+  m_timewaitTimer.SetWheel (wheel);
 }
 
 /* Move TCP to Time_Wait state and schedule a transition to Closed state */
@@ -2304,8 +2373,7 @@ TcpSocketBase::TimeWait ()
   CancelAllTimers ();
   // Move from TIME_WAIT to CLOSED after 2*MSL. Max segment lifetime is 2 min
   // according to RFC793, p.28
-  m_timewaitEvent = Simulator::Schedule (Seconds (2 * m_msl),
-                                         &TcpSocketBase::CloseAndNotify, this);
+  m_timewaitTimer.Schedule (Seconds (2 * m_msl));
 }
 
 /* Below are the attribute get/set functions */
@@ -2432,16 +2500,88 @@ TcpSocketBase::GetAllowBroadcast (void) const
   return false;
 }
 
-/* Placeholder function for future extension that reads more from the TCP header */
 void
-TcpSocketBase::ReadOptions (const TcpHeader&)
+TcpSocketBase::ReadOptions (const TcpHeader& tcpHeader)
+{
+  if (tcpHeader.GetFlags () & TcpHeader::SYN)
+    { // SACK is used if both sides offered it in their SYN
+      m_sackPermitted = m_sackEnabled && tcpHeader.IsSackPermitted ();
+      return;
+    }
+  if (!m_sackPermitted || (tcpHeader.GetFlags () & TcpHeader::ACK) == 0)
+    {
+      return;
+    }
+  const TcpHeader::SackList &blocks = tcpHeader.GetSackList ();
+  for (TcpHeader::SackList::const_iterator i = blocks.begin (); i != blocks.end (); ++i)
+    {
+      m_txBuffer.AddSackBlock (i->first, i->second);
+    }
+}
+
+void
+TcpSocketBase::AddOptions (TcpHeader& tcpHeader)
 {
+  uint8_t flags = tcpHeader.GetFlags ();
+  if (flags & TcpHeader::SYN)
+    { // Offer SACK in a SYN, accept it in a SYN-ACK if it was offered
+      tcpHeader.SetSackPermitted ((flags & TcpHeader::ACK) ? m_sackPermitted : m_sackEnabled);
+      return;
+    }
+  if (!m_sackPermitted || (flags & TcpHeader::ACK) == 0)
+    {
+      return;
+    }
+  TcpHeader::SackList blocks = m_rxBuffer.GetSackList (TcpHeader::MAX_SACK_BLOCKS);
+  for (TcpHeader::SackList::const_iterator i = blocks.begin (); i != blocks.end (); ++i)
+    {
+      tcpHeader.AddSackBlock (i->first, i->second);
+    }
+}
+
+uint32_t
+TcpSocketBase::Pipe (void) const
+{
+  SequenceNumber32 head = m_txBuffer.HeadSequence ();
+  uint32_t outstanding = m_highTxMark.Get () - head;
+  uint32_t sacked = std::min (m_txBuffer.SackedBytes (), outstanding);
+  // Lost and not retransmitted yet
+  uint32_t lost = 0;
+  SequenceNumber32 from = std::max (m_highRxt, head);
+  SequenceNumber32 highestSacked = m_txBuffer.HighestSacked ();
+  if (from < highestSacked)
+    {
+      lost = (highestSacked - from) - m_txBuffer.SackedBytesFromSequence (from);
+    }
+  return outstanding - sacked - std::min (lost, outstanding - sacked);
 }
 
-/* Placeholder function for future extension that changes the TCP header */
 void
-TcpSocketBase::AddOptions (TcpHeader&)
+TcpSocketBase::SendSackRecovery (void)
 {
+  NS_LOG_FUNCTION (this);
+  while (Pipe () + m_segmentSize <= Window ())
+    {
+      // First lost segment which was not retransmitted yet
+      SequenceNumber32 seq = std::max (m_highRxt, m_txBuffer.HeadSequence ());
+      uint32_t hole = m_txBuffer.NextHole (seq);
+      if (hole > 0 && seq < m_txBuffer.HighestSacked ())
+        {
+          NS_LOG_LOGIC ("TcpSocketBase " << this << " retxing lost seq " << seq);
+          uint32_t sz = SendDataPacket (seq, std::min (m_segmentSize, hole), true);
+          m_highRxt = seq + SequenceNumber32 (sz);
+          continue;
+        }
+      // New data, within the receiver window
+      uint32_t available = m_txBuffer.SizeFromSequence (m_nextTxSequence);
+      uint32_t inFlight = m_nextTxSequence.Get () - m_txBuffer.HeadSequence ();
+      if (available == 0 || inFlight + std::min (available, m_segmentSize) > m_rWnd.Get ())
+        {
+          break;
+        }
+      uint32_t sz = SendDataPacket (m_nextTxSequence, m_segmentSize, true);
+      m_nextTxSequence += sz;
+    }
 }
 
 } // namespace ns3
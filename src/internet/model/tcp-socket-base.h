@@ -33,6 +33,7 @@
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-interface.h"
 #include "ns3/event-id.h"
+#include "ns3/timer.h"
 #include "tcp-tx-buffer.h"
 #include "tcp-rx-buffer.h"
 #include "rtt-estimator.h"
@@ -363,6 +364,19 @@ protected:
    */
   void CancelAllTimers (void);
 
+  /**
+   * \brief Set the functions of the timers, called by the constructors
+   */
+  void InitTimers (void);
+
+  /**
+   * \brief Schedule the timers in the timer wheel of the L4 protocol, if
+   * it has one
+   * \param wheel the timer wheel, or zero to schedule the timers directly
+   * in the simulator
+   */
+  void SetTimerWheel (Ptr<TimerWheel> wheel);
+
   /**
    * \brief Move from CLOSING or FIN_WAIT_2 to TIME_WAIT state
    */
@@ -513,6 +527,12 @@ protected:
    */
   virtual void ReTxTimeout (void);
 
+  /**
+   * \brief Expiration of the retransmission timer: resend the empty segment
+   * (SYN or FIN) it guards, or call ReTxTimeout()
+   */
+  void RetxTimerExpired (void);
+
   /**
    * \brief Halving cwnd and call DoRetransmit()
    */
@@ -540,24 +560,51 @@ protected:
 
   /**
    * \brief Read option from incoming packets
+   *
+   * Negotiates SACK on SYN segments and records the SACK blocks of
+   * the ACKs in the scoreboard of the Tx buffer.
+   *
    * \param tcpHeader the packet's TCP header
    */
   virtual void ReadOptions (const TcpHeader& tcpHeader);
 
   /**
    * \brief Add option to outgoing packets
+   *
+   * Offers SACK on SYN segments and reports the data received out of
+   * order on the other segments once SACK is negotiated.
+   *
    * \param tcpHeader the packet's TCP header
    */
   virtual void AddOptions (TcpHeader& tcpHeader);
 
+  /**
+   * \brief Estimate the number of bytes in flight during a SACK-based
+   * recovery (the "pipe" of RFC 6675)
+   *
+   * The holes below the highest SACKed byte are considered lost; those
+   * below m_highRxt were retransmitted and are in flight again.
+   *
+   * \returns the estimated number of bytes in the network
+   */
+  uint32_t Pipe (void) const;
+
+  /**
+   * \brief Send segments during a SACK-based recovery, while the window
+   * exceeds the pipe by a segment: first the lost segments which were not
+   * retransmitted yet, then new data
+   */
+  void SendSackRecovery (void);
+
 
 protected:
-  // Counters and events
-  EventId           m_retxEvent;       //!< Retransmission event
-  EventId           m_lastAckEvent;    //!< Last ACK timeout event
-  EventId           m_delAckEvent;     //!< Delayed ACK timeout event
-  EventId           m_persistEvent;    //!< Persist event: Send 1 byte to probe for a non-zero Rx window
-  EventId           m_timewaitEvent;   //!< TIME_WAIT expiration event: Move this socket to CLOSED state
+  // Counters and timers
+  Timer             m_retxTimer;       //!< Retransmission timer
+  Timer             m_lastAckTimer;    //!< Last ACK timer
+  Timer             m_delAckTimer;     //!< Delayed ACK timer
+  Timer             m_persistTimer;    //!< Persist timer: Send 1 byte to probe for a non-zero Rx window
+  Timer             m_timewaitTimer;   //!< TIME_WAIT timer: Move this socket to CLOSED state
+  uint8_t           m_retxFlags;       //!< Flags of the empty segment guarded by m_retxTimer, 0 for data
   uint32_t          m_dupAckCount;     //!< Dupack counter
   uint32_t          m_delAckCount;     //!< Delayed ACK counter
   uint32_t          m_delAckMaxCount;  //!< Number of packet to fire an ACK before delay timeout
@@ -600,6 +647,11 @@ protected:
   uint32_t              m_segmentSize; //!< Segment size
   uint16_t              m_maxWinSize;  //!< Maximum window size to advertise
   TracedValue<uint32_t> m_rWnd;        //!< Flow control window at remote side
+
+  // Selective acknowledgements
+  bool                  m_sackEnabled;   //!< Offer/accept the SACK option
+  bool                  m_sackPermitted; //!< SACK negotiated with the peer
+  SequenceNumber32      m_highRxt;       //!< Highest seqno retransmitted in the SACK-based recovery (HighRxt)
 };
 
 } // namespace ns3
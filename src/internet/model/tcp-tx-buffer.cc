@@ -53,7 +53,7 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0)
+  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_headOffset (0), m_sackedBytes (0)
 {
 }
 
@@ -107,7 +107,10 @@ TcpTxBuffer::Add (Ptr<Packet> p)
     {
       if (p->GetSize () > 0)
         {
-          m_data.push_back (p);
+          Chunk chunk;
+          chunk.packet = p;
+          chunk.start = m_headOffset + m_size;
+          m_data.push_back (chunk);
           m_size += p->GetSize ();
           NS_LOG_LOGIC ("Updated size=" << m_size << ", lastSeq=" << m_firstByteSeq + SequenceNumber32 (m_size));
         }
@@ -143,58 +146,67 @@ TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
       return Create<Packet> (s);
     }
 
-  // Extract data from the buffer and return
+  // Extract data from the buffer and return: the first chunk is found
+  // by binary search, the following ones are appended until s bytes are
+  // collected.  The packets share their data with the buffer.
   uint32_t offset = seq - m_firstByteSeq.Get ();
-  uint32_t count = 0;      // Offset of the first byte of a packet in the buffer
-  uint32_t pktSize = 0;
-  bool beginFound = false;
-  int pktCount = 0;
-  Ptr<Packet> outPacket;
-  NS_LOG_LOGIC ("There are " << m_data.size () << " number of packets in buffer");
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  uint32_t index = FindChunk (offset);
+  const Chunk &first = m_data[index];
+  uint32_t packetOffset = m_headOffset + offset - first.start;
+  uint32_t fragmentLength = first.packet->GetSize () - packetOffset;
+  NS_LOG_LOGIC ("First byte found in packet #" << index << " at packet offset " << packetOffset
+                                               << ", packet len=" << first.packet->GetSize ());
+  if (fragmentLength >= s)
+    { // Data to be copied falls entirely in this packet
+      return first.packet->CreateFragment (packetOffset, s);
+    }
+  // This packet only fulfills part of the request
+  Ptr<Packet> outPacket = first.packet->CreateFragment (packetOffset, fragmentLength);
+  uint32_t remaining = s - fragmentLength;
+  while (remaining > 0)
     {
-      pktCount++;
-      pktSize = (*i)->GetSize ();
-      if (!beginFound)
-        { // Look for first fragment
-          if (count + pktSize > offset)
-            {
-              NS_LOG_LOGIC ("First byte found in packet #" << pktCount << " at buffer offset " << count
-                                                           << ", packet len=" << pktSize);
-              beginFound = true;
-              uint32_t packetOffset = offset - count;
-              uint32_t fragmentLength = count + pktSize - offset;
-              if (fragmentLength >= s)
-                { // Data to be copied falls entirely in this packet
-                  return (*i)->CreateFragment (packetOffset, s);
-                }
-              else
-                { // This packet only fulfills part of the request
-                  outPacket = (*i)->CreateFragment (packetOffset, fragmentLength);
-                }
-              NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-            }
+      ++index;
+      NS_ASSERT (index < m_data.size ());
+      Ptr<Packet> p = m_data[index].packet;
+      if (p->GetSize () < remaining)
+        {
+          NS_LOG_LOGIC ("Appending to output the packet #" << index << " len=" << p->GetSize ());
+          outPacket->AddAtEnd (p);
+          remaining -= p->GetSize ();
         }
-      else if (count + pktSize >= offset + s)
+      else
         { // Last packet fragment found
-          NS_LOG_LOGIC ("Last byte found in packet #" << pktCount << " at buffer offset " << count
-                                                      << ", packet len=" << pktSize);
-          uint32_t fragmentLength = offset + s - count;
-          Ptr<Packet> endFragment = (*i)->CreateFragment (0, fragmentLength);
-          outPacket->AddAtEnd (endFragment);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-          break;
+          NS_LOG_LOGIC ("Last byte found in packet #" << index << ", packet len=" << p->GetSize ());
+          outPacket->AddAtEnd (p->CreateFragment (0, remaining));
+          remaining = 0;
+        }
+      NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
+    }
+  NS_ASSERT (outPacket->GetSize () == s);
+  return outPacket;
+}
+
+uint32_t
+TcpTxBuffer::FindChunk (uint32_t offset) const
+{
+  NS_ASSERT (offset < m_size);
+  uint64_t position = m_headOffset + offset;
+  // last chunk starting at or before position
+  uint32_t low = 0;
+  uint32_t high = m_data.size ();
+  while (high - low > 1)
+    {
+      uint32_t middle = low + (high - low) / 2;
+      if (m_data[middle].start <= position)
+        {
+          low = middle;
         }
       else
         {
-          NS_LOG_LOGIC ("Appending to output the packet #" << pktCount << " of offset " << count << " len=" << pktSize);
-          outPacket->AddAtEnd (*i);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
+          high = middle;
         }
-      count += pktSize;
     }
-  NS_ASSERT (outPacket->GetSize () == s);
-  return outPacket;
+  return low;
 }
 
 void
@@ -213,31 +225,47 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
   // Cases do not need to scan the buffer
   if (m_firstByteSeq >= seq) return;
 
-  // Scan the buffer and discard packets
+  // Discard the acknowledged packets from the front of the buffer
   uint32_t offset = seq - m_firstByteSeq.Get ();  // Number of bytes to remove
-  uint32_t pktSize;
   NS_LOG_LOGIC ("Offset=" << offset);
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end ())
+  while (offset > 0 && !m_data.empty ())
     {
-      if (offset > (*i)->GetSize ())
+      Chunk &front = m_data.front ();
+      uint32_t pktSize = front.packet->GetSize ();
+      if (offset >= pktSize)
         { // This packet is behind the seqnum. Remove this packet from the buffer
-          pktSize = (*i)->GetSize ();
           m_size -= pktSize;
           offset -= pktSize;
           m_firstByteSeq += pktSize;
-          i = m_data.erase (i);
+          m_headOffset += pktSize;
+          m_data.pop_front ();
           NS_LOG_LOGIC ("Removed one packet of size " << pktSize << ", offset=" << offset);
         }
-      else if (offset > 0)
+      else
         { // Part of the packet is behind the seqnum. Fragment
-          pktSize = (*i)->GetSize () - offset;
-          *i = (*i)->CreateFragment (offset, pktSize);
+          front.packet = front.packet->CreateFragment (offset, pktSize - offset);
+          front.start += offset;
           m_size -= offset;
           m_firstByteSeq += offset;
-          NS_LOG_LOGIC ("Fragmented one packet by size " << offset << ", new size=" << pktSize);
-          break;
+          m_headOffset += offset;
+          NS_LOG_LOGIC ("Fragmented one packet by size " << offset << ", new size=" << pktSize - offset);
+          offset = 0;
+        }
+    }
+  // Trim the scoreboard
+  while (!m_sacked.empty () && m_sacked.begin ()->first < seq)
+    {
+      SackBlocks::iterator first = m_sacked.begin ();
+      if (first->second <= seq)
+        {
+          m_sackedBytes -= first->second - first->first;
         }
+      else
+        {
+          m_sackedBytes -= seq - first->first;
+          m_sacked[seq] = first->second;
+        }
+      m_sacked.erase (first);
     }
   // Catching the case of ACKing a FIN
   if (m_size == 0)
@@ -249,4 +277,97 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
   NS_ASSERT (m_firstByteSeq == seq);
 }
 
+void
+TcpTxBuffer::AddSackBlock (const SequenceNumber32& left, const SequenceNumber32& right)
+{
+  NS_LOG_FUNCTION (this << left << right);
+  SequenceNumber32 start = std::max (left, m_firstByteSeq.Get ());
+  SequenceNumber32 end = std::min (right, TailSequence ());
+  if (start >= end)
+    {
+      return;
+    }
+  // Merge with the blocks overlapping or adjacent to [start, end)
+  SackBlocks::iterator i = m_sacked.upper_bound (start);
+  if (i != m_sacked.begin ())
+    {
+      SackBlocks::iterator previous = i;
+      --previous;
+      if (previous->second >= start)
+        {
+          i = previous;
+          start = previous->first;
+        }
+    }
+  while (i != m_sacked.end () && i->first <= end)
+    {
+      end = std::max (end, i->second);
+      m_sackedBytes -= i->second - i->first;
+      m_sacked.erase (i++);
+    }
+  m_sacked[start] = end;
+  m_sackedBytes += end - start;
+  NS_LOG_LOGIC ("SACKed " << start << "-" << end << ", sacked bytes=" << m_sackedBytes);
+}
+
+void
+TcpTxBuffer::ClearSackBlocks (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_sacked.clear ();
+  m_sackedBytes = 0;
+}
+
+uint32_t
+TcpTxBuffer::SackedBytes (void) const
+{
+  return m_sackedBytes;
+}
+
+uint32_t
+TcpTxBuffer::SackedBytesFromSequence (const SequenceNumber32& seq) const
+{
+  uint32_t below = 0;
+  for (SackBlocks::const_iterator i = m_sacked.begin (); i != m_sacked.end () && i->first < seq; ++i)
+    {
+      below += std::min (i->second, seq) - i->first;
+    }
+  return m_sackedBytes - below;
+}
+
+SequenceNumber32
+TcpTxBuffer::HighestSacked (void) const
+{
+  if (m_sacked.empty ())
+    {
+      return m_firstByteSeq;
+    }
+  return m_sacked.rbegin ()->second;
+}
+
+uint32_t
+TcpTxBuffer::NextHole (SequenceNumber32& seq) const
+{
+  if (seq < m_firstByteSeq)
+    {
+      seq = m_firstByteSeq;
+    }
+  SackBlocks::const_iterator i = m_sacked.upper_bound (seq);
+  if (i != m_sacked.begin ())
+    {
+      SackBlocks::const_iterator previous = i;
+      --previous;
+      if (previous->second > seq)
+        {
+          seq = previous->second;
+        }
+    }
+  SequenceNumber32 end = (i == m_sacked.end ()) ? TailSequence () : i->first;
+  if (seq >= end)
+    {
+      return 0;
+    }
+  return end - seq;
+}
+
 } // namepsace ns3
@@ -21,7 +21,8 @@
 #ifndef TCP_TX_BUFFER_H
 #define TCP_TX_BUFFER_H
 
-#include <list>
+#include <deque>
+#include <map>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/object.h"
@@ -127,14 +128,83 @@ public:
    */
   void DiscardUpTo (const SequenceNumber32& seq);
 
+  // SACK scoreboard
+
+  /**
+   * Record a block of data reported by the receiver in a SACK option.
+   * The part of the block outside of the buffer is ignored.
+   *
+   * \param left the first sequence number of the block
+   * \param right the sequence number following the last byte of the block
+   */
+  void AddSackBlock (const SequenceNumber32& left, const SequenceNumber32& right);
+
+  /**
+   * Forget the SACKed data, e.g. on a retransmission timeout (RFC 2018)
+   */
+  void ClearSackBlocks (void);
+
+  /**
+   * Returns the number of bytes of the buffer which were SACKed
+   * \returns the number of SACKed bytes
+   */
+  uint32_t SackedBytes (void) const;
+
+  /**
+   * Returns the number of SACKed bytes in the range [seq, tailSequence)
+   * \param seq initial sequence number
+   * \returns the number of SACKed bytes from seq
+   */
+  uint32_t SackedBytesFromSequence (const SequenceNumber32& seq) const;
+
+  /**
+   * Returns the sequence number following the highest SACKed byte, or the
+   * head sequence if no data was SACKed
+   * \returns the right edge of the highest SACK block
+   */
+  SequenceNumber32 HighestSacked (void) const;
+
+  /**
+   * Find the first byte at or after seq which was not SACKed.
+   *
+   * \param seq the sequence number to start from; updated to the first
+   *        byte of the hole
+   * \returns the length of the hole, up to the next SACK block or to the
+   *          end of the buffer
+   */
+  uint32_t NextHole (SequenceNumber32& seq) const;
+
 private:
+  /**
+   * A packet written by the application, and the position of its first
+   * byte in the stream of bytes ever added to the buffer.
+   */
+  struct Chunk
+  {
+    Ptr<Packet> packet; //!< the data
+    uint64_t start;     //!< stream offset of the first byte of packet
+  };
+
   /// container for data stored in the buffer
-  typedef std::list<Ptr<Packet> >::iterator BufIterator;
+  typedef std::deque<Chunk> Chunks;
+
+  /// SACKed blocks, left edge to right edge, not overlapping nor adjacent
+  typedef std::map<SequenceNumber32, SequenceNumber32> SackBlocks;
+
+  /**
+   * Find the chunk which holds a byte of the buffer, by binary search.
+   * \param offset offset of the byte from the head of the buffer
+   * \returns the index of the chunk in m_data
+   */
+  uint32_t FindChunk (uint32_t offset) const;
 
   TracedValue<SequenceNumber32> m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
   uint32_t m_size;                              //!< Number of data bytes
   uint32_t m_maxBuffer;                         //!< Max number of data bytes in buffer (SND.WND)
-  std::list<Ptr<Packet> > m_data;               //!< Corresponding data (may be null)
+  uint64_t m_headOffset;                        //!< Stream offset of the first byte in data
+  Chunks m_data;                                //!< Corresponding data (may be null)
+  SackBlocks m_sacked;                          //!< SACK scoreboard
+  uint32_t m_sackedBytes;                       //!< Number of SACKed bytes
 };
 
 } // namepsace ns3
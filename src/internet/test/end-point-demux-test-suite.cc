@@ -0,0 +1,238 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-end-point-demux.h"
+
+using namespace ns3;
+
+/**
+ * Check the precedence of the matches of the IPv4 end point demux, the
+ * lookups after a change of peer and after the end points are removed.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+  virtual ~Ipv4EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \returns the single end point found by a lookup, 0 if none
+   */
+  Ipv4EndPoint * LookupOne (Ipv4EndPointDemux &demux, Ipv4Address daddr, uint16_t dport,
+                            Ipv4Address saddr, uint16_t sport);
+
+  Ptr<Ipv4Interface> m_interface;  //!< the incoming interface
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("Check the lookups of the IPv4 end point demux")
+{
+}
+
+Ipv4EndPointDemuxTestCase::~Ipv4EndPointDemuxTestCase ()
+{
+}
+
+Ipv4EndPoint *
+Ipv4EndPointDemuxTestCase::LookupOne (Ipv4EndPointDemux &demux, Ipv4Address daddr, uint16_t dport,
+                                      Ipv4Address saddr, uint16_t sport)
+{
+  Ipv4EndPointDemux::EndPoints found = demux.Lookup (daddr, dport, saddr, sport, m_interface);
+  NS_TEST_EXPECT_MSG_LT (found.size (), 2, "more than one end point for " << saddr << ":" << sport);
+  return found.empty () ? 0 : found.front ();
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv4Address local ("10.0.0.1");
+  Ipv4Address other ("10.0.1.1");
+  Ipv4Address peer ("10.0.0.2");
+  Ipv4Address peer2 ("10.0.0.3");
+  Ipv4Address any = Ipv4Address::GetAny ();
+  m_interface = CreateObject<Ipv4Interface> ();
+  m_interface->AddAddress (Ipv4InterfaceAddress (local, Ipv4Mask ("255.255.255.0")));
+
+  Ipv4EndPointDemux demux;
+  Ipv4EndPoint *wildcard = demux.Allocate (80);
+  Ipv4EndPoint *wildcardPeer = demux.Allocate (local, 80);
+  Ipv4EndPoint *wildcardLocal = demux.Allocate (any, 80, peer, 1234);
+  Ipv4EndPoint *exact = demux.Allocate (local, 80, peer, 1234);
+  Ipv4EndPoint *exact2 = demux.Allocate (local, 80, peer2, 5678);
+  NS_TEST_ASSERT_MSG_NE (exact2, 0, "allocation failed");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (local, 80), 0, "duplicate local address and port");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (local, 80, peer, 1234), 0, "duplicate four-tuple");
+
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1234), exact, "the exact four-tuple first");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer2, 5678), exact2, "the exact four-tuple of the other peer");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer2, 1234), wildcardPeer, "no exact peer: the local address");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, other, 80, peer2, 1234), wildcard, "no exact local address: the wildcard");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 81, peer, 1234), 0, "no end point on the port");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1234), exact, "the exact four-tuple first");
+
+  // removing the best match each time exposes the next one
+  demux.DeAllocate (exact);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1234), wildcardLocal, "the exact peer with any local address");
+  demux.DeAllocate (wildcardLocal);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1234), wildcardPeer, "the local address with any peer");
+  demux.DeAllocate (wildcardPeer);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1234), wildcard, "the wildcard");
+  demux.DeAllocate (wildcard);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1234), 0, "no end point left for the peer");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupLocal (any, 80), false, "the wildcard was removed");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (80), true, "an end point is left on the port");
+
+  // a new peer moves the end point to the new four-tuple
+  exact2->SetPeer (peer, 1234);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1234), exact2, "the end point of the new peer");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer2, 5678), 0, "the end point left the old peer");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1234), exact2, "the end point of the new peer");
+  Ipv4EndPoint *reallocated = demux.Allocate (local, 80, peer2, 5678);
+  NS_TEST_ASSERT_MSG_NE (reallocated, 0, "the old four-tuple is free again");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer2, 5678), reallocated, "the end point of the old four-tuple");
+
+  demux.DeAllocate (exact2);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1234), 0, "no end point left for the peer");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer2, 5678), reallocated, "the other end point is left");
+  demux.DeAllocate (reallocated);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (80), false, "no end point left on the port");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetAllEndPoints ().size (), 0, "no end point left");
+
+  m_interface = 0;
+}
+
+/**
+ * Check the precedence of the matches of the IPv6 end point demux, the
+ * lookups after a change of peer and after the end points are removed.
+ */
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv6EndPointDemuxTestCase ();
+  virtual ~Ipv6EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \returns the single end point found by a lookup, 0 if none
+   */
+  Ipv6EndPoint * LookupOne (Ipv6EndPointDemux &demux, Ipv6Address daddr, uint16_t dport,
+                            Ipv6Address saddr, uint16_t sport);
+
+  Ptr<Ipv6Interface> m_interface;  //!< the incoming interface
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase ()
+  : TestCase ("Check the lookups of the IPv6 end point demux")
+{
+}
+
+Ipv6EndPointDemuxTestCase::~Ipv6EndPointDemuxTestCase ()
+{
+}
+
+Ipv6EndPoint *
+Ipv6EndPointDemuxTestCase::LookupOne (Ipv6EndPointDemux &demux, Ipv6Address daddr, uint16_t dport,
+                                      Ipv6Address saddr, uint16_t sport)
+{
+  Ipv6EndPointDemux::EndPoints found = demux.Lookup (daddr, dport, saddr, sport, m_interface);
+  NS_TEST_EXPECT_MSG_LT (found.size (), 2, "more than one end point for " << saddr << ":" << sport);
+  return found.empty () ? 0 : found.front ();
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv6Address local ("2001:1::1");
+  Ipv6Address other ("2001:2::1");
+  Ipv6Address peer ("2001:1::2");
+  Ipv6Address peer2 ("2001:1::3");
+  Ipv6Address any = Ipv6Address::GetAny ();
+  m_interface = CreateObject<Ipv6Interface> ();
+
+  Ipv6EndPointDemux demux;
+  Ipv6EndPoint *wildcard = demux.Allocate (80);
+  Ipv6EndPoint *wildcardPeer = demux.Allocate (local, 80);
+  Ipv6EndPoint *wildcardLocal = demux.Allocate (any, 80, peer, 1234);
+  Ipv6EndPoint *exact = demux.Allocate (local, 80, peer, 1234);
+  Ipv6EndPoint *exact2 = demux.Allocate (local, 80, peer2, 5678);
+  NS_TEST_ASSERT_MSG_NE (exact2, 0, "allocation failed");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (local, 80), 0, "duplicate local address and port");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (local, 80, peer, 1234), 0, "duplicate four-tuple");
+
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1234), exact, "the exact four-tuple first");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer2, 5678), exact2, "the exact four-tuple of the other peer");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer2, 1234), wildcardPeer, "no exact peer: the local address");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, other, 80, peer2, 1234), wildcard, "no exact local address: the wildcard");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 81, peer, 1234), 0, "no end point on the port");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1234), exact, "the exact four-tuple first");
+
+  // removing the best match each time exposes the next one
+  demux.DeAllocate (exact);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1234), wildcardLocal, "the exact peer with any local address");
+  demux.DeAllocate (wildcardLocal);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1234), wildcardPeer, "the local address with any peer");
+  demux.DeAllocate (wildcardPeer);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1234), wildcard, "the wildcard");
+  demux.DeAllocate (wildcard);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1234), 0, "no end point left for the peer");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupLocal (any, 80), false, "the wildcard was removed");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (80), true, "an end point is left on the port");
+
+  // a new peer moves the end point to the new four-tuple
+  exact2->SetPeer (peer, 1234);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1234), exact2, "the end point of the new peer");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer2, 5678), 0, "the end point left the old peer");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1234), exact2, "the end point of the new peer");
+
+  Ipv6EndPoint *reallocated = demux.Allocate (local, 80, peer2, 5678);
+  NS_TEST_ASSERT_MSG_NE (reallocated, 0, "the old four-tuple is free again");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer2, 5678), reallocated, "the end point of the old four-tuple");
+
+  demux.DeAllocate (exact2);
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer, 1234), 0, "no end point left for the peer");
+  NS_TEST_EXPECT_MSG_EQ (LookupOne (demux, local, 80, peer2, 5678), reallocated, "the other end point is left");
+  demux.DeAllocate (reallocated);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (80), false, "no end point left on the port");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetEndPoints ().size (), 0, "no end point left");
+
+  m_interface = 0;
+}
+
+class EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxTestSuite ();
+};
+
+EndPointDemuxTestSuite::EndPointDemuxTestSuite ()
+  : TestSuite ("end-point-demux", UNIT)
+{
+  AddTestCase (new Ipv4EndPointDemuxTestCase (), TestCase::QUICK);
+  AddTestCase (new Ipv6EndPointDemuxTestCase (), TestCase::QUICK);
+}
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite;
@@ -27,6 +27,8 @@
 #include "ns3/candidate-queue.h"
 #include "ns3/simulator.h"
 #include <cstdlib> // for rand()
+#include <map>
+#include <vector>
 
 using namespace ns3;
 
@@ -213,6 +215,119 @@ GlobalRouteManagerImplTestCase::DoRun (void)
   // does not crash
 }
 
+class CandidateQueueTestCase : public TestCase
+{
+public:
+  CandidateQueueTestCase();
+  virtual void DoRun (void);
+};
+
+CandidateQueueTestCase::CandidateQueueTestCase()
+  : TestCase ("CandidateQueueTestCase")
+{
+}
+void
+CandidateQueueTestCase::DoRun (void)
+{
+  CandidateQueue candidate;
+
+  // random distances: the vertices come out by increasing distance, the
+  // network vertices before the router vertices of equal distance, and
+  // the remaining ties in the order of Push () and DecreaseKey ()
+  std::vector<SPFVertex *> vertices;
+  std::map<SPFVertex *, uint32_t> order;
+  uint32_t stamp = 0;
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      SPFVertex *v = new SPFVertex;
+      v->SetVertexId (Ipv4Address (i + 1));
+      v->SetVertexType (i % 5 == 0 ? SPFVertex::VertexNetwork : SPFVertex::VertexRouter);
+      v->SetDistanceFromRoot (std::rand () % 50);
+      vertices.push_back (v);
+      candidate.Push (v);
+      order[v] = stamp++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (candidate.Size (), 1000, "wrong queue size");
+  for (uint32_t i = 0; i < 1000; i += 7)
+    {
+      NS_TEST_ASSERT_MSG_EQ (candidate.Find (Ipv4Address (i + 1)), vertices[i], "wrong vertex found");
+    }
+  NS_TEST_ASSERT_MSG_EQ (candidate.Find (Ipv4Address (2000)), 0, "found a vertex which is not in the queue");
+
+  // decrease the distance of some vertices
+  for (uint32_t i = 0; i < 1000; i += 3)
+    {
+      if (vertices[i]->GetDistanceFromRoot () > 0)
+        {
+          vertices[i]->SetDistanceFromRoot (vertices[i]->GetDistanceFromRoot () / 2);
+          candidate.DecreaseKey (vertices[i]);
+          order[vertices[i]] = stamp++;
+        }
+    }
+
+  SPFVertex *previous = 0;
+  uint32_t n = 0;
+  while (!candidate.Empty ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (candidate.Top (), candidate.Top (), "Top () is not stable");
+      SPFVertex *v = candidate.Pop ();
+      if (previous != 0)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((previous->GetDistanceFromRoot () <= v->GetDistanceFromRoot ()), true,
+                                 "vertices are not popped by increasing distance");
+          if (previous->GetDistanceFromRoot () == v->GetDistanceFromRoot ())
+            {
+              bool previousIsNetwork = previous->GetVertexType () == SPFVertex::VertexNetwork;
+              bool isNetwork = v->GetVertexType () == SPFVertex::VertexNetwork;
+              NS_TEST_ASSERT_MSG_EQ ((previousIsNetwork || !isNetwork), true,
+                                     "a router vertex is popped before a network vertex of equal distance");
+              if (previousIsNetwork == isNetwork)
+                {
+                  NS_TEST_ASSERT_MSG_LT (order[previous], order[v],
+                                         "vertices of equal distance are not popped in the order they were pushed");
+                }
+            }
+        }
+      delete previous;
+      previous = v;
+      n++;
+    }
+  delete previous;
+  NS_TEST_ASSERT_MSG_EQ (n, 1000, "wrong number of vertices popped");
+
+  // ties: network vertices first, then the order of Push () and DecreaseKey ()
+  SPFVertex *r1 = new SPFVertex;
+  r1->SetVertexId ("0.0.0.1");
+  r1->SetVertexType (SPFVertex::VertexRouter);
+  r1->SetDistanceFromRoot (10);
+  SPFVertex *r2 = new SPFVertex;
+  r2->SetVertexId ("0.0.0.2");
+  r2->SetVertexType (SPFVertex::VertexRouter);
+  r2->SetDistanceFromRoot (20);
+  SPFVertex *r3 = new SPFVertex;
+  r3->SetVertexId ("0.0.0.3");
+  r3->SetVertexType (SPFVertex::VertexRouter);
+  r3->SetDistanceFromRoot (10);
+  SPFVertex *n1 = new SPFVertex;
+  n1->SetVertexId ("10.0.0.1");
+  n1->SetVertexType (SPFVertex::VertexNetwork);
+  n1->SetDistanceFromRoot (10);
+  candidate.Push (r1);
+  candidate.Push (r2);
+  candidate.Push (r3);
+  candidate.Push (n1);
+  r2->SetDistanceFromRoot (10);
+  candidate.DecreaseKey (r2);
+  SPFVertex *expected[] = { n1, r1, r3, r2 };
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      SPFVertex *v = candidate.Pop ();
+      NS_TEST_EXPECT_MSG_EQ (v, expected[i], "wrong order of equal cost vertices");
+      delete v;
+    }
+  NS_TEST_ASSERT_MSG_EQ (candidate.Pop (), 0, "the queue should be empty");
+}
+
 
 static class GlobalRouteManagerImplTestSuite : public TestSuite
 {
@@ -221,5 +336,6 @@ public:
     : TestSuite ("global-route-manager-impl", UNIT)
   {
     AddTestCase (new GlobalRouteManagerImplTestCase (), TestCase::QUICK);
+    AddTestCase (new CandidateQueueTestCase (), TestCase::QUICK);
   }
 } g_globalRoutingManagerImplTestSuite;
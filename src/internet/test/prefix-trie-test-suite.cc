@@ -0,0 +1,257 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include <sstream>
+#include "ns3/test.h"
+#include "ns3/prefix-trie.h"
+#include "ns3/random-variable-stream.h"
+
+using namespace ns3;
+
+/**
+ * Insert and remove random prefixes, and check after each step that
+ * the matches found by the trie are the ones (and in the same order)
+ * found by a linear scan of the prefixes.
+ */
+class PrefixTrieTestCase : public TestCase
+{
+public:
+  PrefixTrieTestCase (uint32_t bits);
+  virtual void DoRun (void);
+
+private:
+  /// a prefix and its value, in insertion order
+  struct Entry
+  {
+    uint8_t prefix[16];
+    uint8_t mask[16];
+    uint32_t value;
+  };
+
+  /**
+   * \param length the prefix length
+   * \param mask the mask to fill
+   */
+  void MakeMask (uint32_t length, uint8_t *mask) const;
+  /**
+   * \param a the address to fill, close to the existing prefixes
+   */
+  void MakeAddress (uint8_t *a);
+  /**
+   * \param address an address
+   * \return the values of the prefixes in m_entries which match the address
+   */
+  std::vector<uint32_t> Scan (const uint8_t *address) const;
+
+  uint32_t m_bits;
+  std::vector<Entry> m_entries;
+  Ptr<UniformRandomVariable> m_random;
+};
+
+PrefixTrieTestCase::PrefixTrieTestCase (uint32_t bits)
+  : TestCase (bits == 32 ? "Check the prefix trie against a linear scan (32 bits)" : "Check the prefix trie against a linear scan (128 bits)"),
+    m_bits (bits)
+{
+}
+
+void
+PrefixTrieTestCase::MakeMask (uint32_t length, uint8_t *mask) const
+{
+  for (uint32_t i = 0; i < m_bits / 8; i++)
+    {
+      if (length >= 8 * (i + 1))
+        {
+          mask[i] = 0xff;
+        }
+      else if (length > 8 * i)
+        {
+          mask[i] = 0xff << (8 - (length - 8 * i));
+        }
+      else
+        {
+          mask[i] = 0;
+        }
+    }
+}
+
+void
+PrefixTrieTestCase::MakeAddress (uint8_t *a)
+{
+  // only a few values per byte so that the prefixes share long common parts
+  for (uint32_t i = 0; i < m_bits / 8; i++)
+    {
+      a[i] = m_random->GetInteger (0, 3) << 6 | m_random->GetInteger (0, 1);
+    }
+}
+
+std::vector<uint32_t>
+PrefixTrieTestCase::Scan (const uint8_t *address) const
+{
+  std::vector<uint32_t> values;
+  for (std::vector<Entry>::const_iterator i = m_entries.begin (); i != m_entries.end (); i++)
+    {
+      bool match = true;
+      for (uint32_t j = 0; match && j < m_bits / 8; j++)
+        {
+          match = (address[j] & i->mask[j]) == (i->prefix[j] & i->mask[j]);
+        }
+      if (match)
+        {
+          values.push_back (i->value);
+        }
+    }
+  return values;
+}
+
+void
+PrefixTrieTestCase::DoRun (void)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+  PrefixTrie<uint32_t> trie (m_bits);
+  uint32_t nextValue = 0;
+
+  for (uint32_t step = 0; step < 2000; step++)
+    {
+      if (m_entries.empty () || m_random->GetInteger (0, 2) > 0)
+        {
+          Entry entry;
+          MakeAddress (entry.prefix);
+          if (m_random->GetInteger (0, 19) == 0)
+            {
+              // a non-contiguous mask
+              MakeAddress (entry.mask);
+            }
+          else
+            {
+              MakeMask (m_random->GetInteger (0, m_bits), entry.mask);
+            }
+          // some values are inserted several times for the same prefix
+          entry.value = m_random->GetInteger (0, 9) == 0 ? 0 : ++nextValue;
+          trie.Insert (entry.prefix, entry.mask, entry.value);
+          m_entries.push_back (entry);
+        }
+      else
+        {
+          uint32_t index = m_random->GetInteger (0, m_entries.size () - 1);
+          Entry entry = m_entries[index];
+          NS_TEST_ASSERT_MSG_EQ (trie.Remove (entry.prefix, entry.mask, entry.value), true, "value not found");
+          // the trie removes the first occurrence of the value in the prefix
+          for (std::vector<Entry>::iterator i = m_entries.begin (); i != m_entries.end (); i++)
+            {
+              bool same = i->value == entry.value;
+              for (uint32_t j = 0; same && j < m_bits / 8; j++)
+                {
+                  same = i->mask[j] == entry.mask[j]
+                    && (i->prefix[j] & i->mask[j]) == (entry.prefix[j] & entry.mask[j]);
+                }
+              if (same)
+                {
+                  m_entries.erase (i);
+                  break;
+                }
+            }
+        }
+
+      for (uint32_t k = 0; k < 10; k++)
+        {
+          uint8_t address[16];
+          MakeAddress (address);
+          std::vector<uint32_t> actual;
+          trie.Match (address, actual);
+          std::vector<uint32_t> expected = Scan (address);
+          NS_TEST_ASSERT_MSG_EQ (actual.size (), expected.size (), "wrong number of matches at step " << step);
+          NS_TEST_ASSERT_MSG_EQ ((actual == expected), true, "wrong matches at step " << step);
+        }
+    }
+
+  uint8_t zero[16] = { 0 };
+  uint8_t ones[16];
+  MakeMask (m_bits, ones);
+  NS_TEST_ASSERT_MSG_EQ (trie.Remove (zero, ones, nextValue + 1), false, "removed a missing value");
+  trie.Clear ();
+  std::vector<uint32_t> values;
+  trie.Match (zero, values);
+  NS_TEST_ASSERT_MSG_EQ (values.size (), 0, "matches in an empty trie");
+}
+
+/**
+ * Check the 32 bit interface.
+ */
+class PrefixTrieHostOrderTestCase : public TestCase
+{
+public:
+  PrefixTrieHostOrderTestCase ();
+  virtual void DoRun (void);
+};
+
+PrefixTrieHostOrderTestCase::PrefixTrieHostOrderTestCase ()
+  : TestCase ("Check the longest prefix match of 32 bit addresses")
+{
+}
+
+void
+PrefixTrieHostOrderTestCase::DoRun (void)
+{
+  PrefixTrie<uint32_t> trie (32);
+  uint32_t any = 0;
+  trie.Insert (any, any, 1); // default route
+  trie.Insert (0x0a000000, 0xff000000, 2); // 10.0.0.0/8
+  trie.Insert (0x0a010000, 0xffff0000, 3); // 10.1.0.0/16
+  trie.Insert (0x0a010100, 0xffffff00, 4); // 10.1.1.0/24
+  trie.Insert (0x0a010101, 0xffffffff, 5); // 10.1.1.1/32
+  trie.Insert (0x0a000000, 0xff000000, 6); // 10.0.0.0/8 again
+
+  std::vector<uint32_t> values;
+  trie.Match (0x0a010101, values);
+  NS_TEST_ASSERT_MSG_EQ (values.size (), 6, "10.1.1.1 matches all the prefixes");
+  for (uint32_t i = 0; i < values.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (values[i], i + 1, "matches not in insertion order");
+    }
+
+  values.clear ();
+  trie.Match (0x0a020000, values);
+  NS_TEST_ASSERT_MSG_EQ (values.size (), 3, "10.2.0.0 matches 0/0 and 10/8 twice");
+  NS_TEST_ASSERT_MSG_EQ (values[2], 6, "wrong match");
+
+  NS_TEST_ASSERT_MSG_EQ (trie.Remove (0x0a010000, 0xffff0000, 3), true, "10.1.0.0/16 not found");
+  NS_TEST_ASSERT_MSG_EQ (trie.Remove (0x0a010000, 0xffff0000, 3), false, "10.1.0.0/16 removed twice");
+  values.clear ();
+  trie.Match (0x0a010101, values);
+  NS_TEST_ASSERT_MSG_EQ (values.size (), 5, "10.1.0.0/16 still matches");
+
+  values.clear ();
+  trie.Match (0xc0a80001, values);
+  NS_TEST_ASSERT_MSG_EQ (values.size (), 1, "192.168.0.1 only matches the default route");
+}
+
+class PrefixTrieTestSuite : public TestSuite
+{
+public:
+  PrefixTrieTestSuite ();
+};
+
+PrefixTrieTestSuite::PrefixTrieTestSuite ()
+  : TestSuite ("prefix-trie", UNIT)
+{
+  AddTestCase (new PrefixTrieHostOrderTestCase (), TestCase::QUICK);
+  AddTestCase (new PrefixTrieTestCase (32), TestCase::QUICK);
+  AddTestCase (new PrefixTrieTestCase (128), TestCase::QUICK);
+}
+
+static PrefixTrieTestSuite g_prefixTrieTestSuite;
@@ -0,0 +1,187 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/tcp-rx-buffer.h"
+#include "ns3/random-variable-stream.h"
+
+using namespace ns3;
+
+/// \return the byte of the stream at a given offset
+static uint8_t
+StreamByte (uint32_t offset)
+{
+  return (offset * 7 + offset / 251) & 0xff;
+}
+
+/**
+ * \param offset offset of the first byte in the stream
+ * \param size number of bytes
+ * \return a packet holding a part of the stream
+ */
+static Ptr<Packet>
+StreamPacket (uint32_t offset, uint32_t size)
+{
+  std::vector<uint8_t> data (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      data[i] = StreamByte (offset + i);
+    }
+  return Create<Packet> (size ? &data[0] : 0, size);
+}
+
+/**
+ * \param p a packet
+ * \param offset offset of the first byte of the packet in the stream
+ * \return true if the packet holds the expected part of the stream
+ */
+static bool
+IsStreamPacket (Ptr<Packet> p, uint32_t offset)
+{
+  std::vector<uint8_t> data (p->GetSize () + 1);
+  p->CopyData (&data[0], p->GetSize ());
+  for (uint32_t i = 0; i < p->GetSize (); i++)
+    {
+      if (data[i] != StreamByte (offset + i))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+/**
+ * Write packets of random sizes into a TcpTxBuffer, read random
+ * segments back and acknowledge random amounts of data, across the
+ * wrap-around of the sequence numbers.
+ */
+class TcpTxBufferTestCase : public TestCase
+{
+public:
+  TcpTxBufferTestCase ();
+  virtual void DoRun (void);
+};
+
+TcpTxBufferTestCase::TcpTxBufferTestCase ()
+  : TestCase ("Check the segments read from TcpTxBuffer")
+{
+}
+
+void
+TcpTxBufferTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+  uint32_t isn = 0xffff0000;
+  TcpTxBuffer buffer (isn);
+  buffer.SetMaxBufferSize (20000);
+  uint32_t written = 0;
+  uint32_t acked = 0;
+  for (uint32_t step = 0; step < 5000; step++)
+    {
+      uint32_t size = rng->GetInteger (1, 1500);
+      if (buffer.Add (StreamPacket (written, size)))
+        {
+          written += size;
+        }
+      NS_TEST_ASSERT_MSG_EQ (buffer.Size (), written - acked, "wrong buffer size");
+      uint32_t offset = acked + rng->GetInteger (0, written - acked);
+      uint32_t length = rng->GetInteger (0, 3000);
+      Ptr<Packet> p = buffer.CopyFromSequence (length, SequenceNumber32 (isn + offset));
+      NS_TEST_ASSERT_MSG_EQ (p->GetSize (), std::min (length, written - offset), "wrong segment size");
+      NS_TEST_ASSERT_MSG_EQ (IsStreamPacket (p, offset), true, "wrong segment at offset " << offset);
+      if (rng->GetValue () < 0.3)
+        {
+          acked += rng->GetInteger (0, written - acked);
+          buffer.DiscardUpTo (SequenceNumber32 (isn + acked));
+          NS_TEST_ASSERT_MSG_EQ (buffer.HeadSequence (), SequenceNumber32 (isn + acked), "wrong head");
+        }
+    }
+}
+
+/**
+ * Deliver a stream to a TcpRxBuffer as random, possibly overlapping,
+ * segments in random order, and check the data extracted in sequence.
+ */
+class TcpRxBufferTestCase : public TestCase
+{
+public:
+  TcpRxBufferTestCase ();
+  virtual void DoRun (void);
+};
+
+TcpRxBufferTestCase::TcpRxBufferTestCase ()
+  : TestCase ("Check the data reassembled by TcpRxBuffer")
+{
+}
+
+void
+TcpRxBufferTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (2);
+  uint32_t isn = 0xfffff000;
+  TcpRxBuffer buffer (isn);
+  buffer.SetMaxBufferSize (30000);
+  uint32_t read = 0;
+  for (uint32_t step = 0; step < 20000; step++)
+    {
+      // a segment filling the first hole, possibly retransmitting some
+      // data, or a segment anywhere in the receive window
+      uint32_t next = buffer.NextRxSequence () - SequenceNumber32 (isn);
+      uint32_t offset = next - rng->GetInteger (0, std::min (next, 1000U));
+      if (rng->GetValue () < 0.7)
+        {
+          offset = next + rng->GetInteger (0, buffer.MaxRxSequence () - buffer.NextRxSequence ());
+        }
+      uint32_t size = rng->GetInteger (1, 1500);
+      TcpHeader header;
+      header.SetSequenceNumber (SequenceNumber32 (isn + offset));
+      buffer.Add (StreamPacket (offset, size), header);
+      NS_TEST_ASSERT_MSG_EQ ((buffer.Size () >= buffer.Available ()), true, "inconsistent sizes");
+      if (rng->GetValue () < 0.2)
+        {
+          Ptr<Packet> p = buffer.Extract (rng->GetInteger (1, 10000));
+          if (p != 0)
+            {
+              NS_TEST_ASSERT_MSG_EQ (IsStreamPacket (p, read), true, "wrong data at offset " << read);
+              read += p->GetSize ();
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (buffer.NextRxSequence (), SequenceNumber32 (isn + read + buffer.Available ()),
+                             "wrong next sequence");
+    }
+  NS_TEST_ASSERT_MSG_GT (read, 100000, "too little data delivered in sequence");
+}
+
+class TcpBufferTestSuite : public TestSuite
+{
+public:
+  TcpBufferTestSuite ();
+};
+
+TcpBufferTestSuite::TcpBufferTestSuite ()
+  : TestSuite ("tcp-buffer", UNIT)
+{
+  AddTestCase (new TcpTxBufferTestCase (), TestCase::QUICK);
+  AddTestCase (new TcpRxBufferTestCase (), TestCase::QUICK);
+}
+
+static TcpBufferTestSuite g_tcpBufferTestSuite;
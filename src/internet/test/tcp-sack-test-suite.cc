@@ -0,0 +1,282 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/buffer.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/tcp-rx-buffer.h"
+
+using namespace ns3;
+
+/**
+ * Serialize and deserialize headers carrying the SACK options, and parse
+ * options written by other implementations.
+ */
+class TcpSackHeaderTestCase : public TestCase
+{
+public:
+  TcpSackHeaderTestCase ();
+  virtual void DoRun (void);
+};
+
+TcpSackHeaderTestCase::TcpSackHeaderTestCase ()
+  : TestCase ("Check the serialization of the SACK options")
+{
+}
+
+void
+TcpSackHeaderTestCase::DoRun (void)
+{
+  TcpHeader syn;
+  syn.SetFlags (TcpHeader::SYN);
+  syn.SetSackPermitted (true);
+  NS_TEST_ASSERT_MSG_EQ (syn.GetSerializedSize (), 24, "wrong size with SACK-permitted");
+  Ptr<Packet> p = Create<Packet> (10);
+  p->AddHeader (syn);
+  TcpHeader received;
+  p->RemoveHeader (received);
+  NS_TEST_ASSERT_MSG_EQ (received.IsSackPermitted (), true, "SACK-permitted lost");
+  NS_TEST_ASSERT_MSG_EQ (received.GetSackList ().size (), 0, "unexpected SACK blocks");
+  NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 10, "wrong payload");
+
+  for (uint32_t n = 1; n <= TcpHeader::MAX_SACK_BLOCKS + 1; n++)
+    {
+      TcpHeader ack;
+      ack.SetFlags (TcpHeader::ACK);
+      ack.SetAckNumber (SequenceNumber32 (0xfffffff0));
+      for (uint32_t b = 0; b < n; b++)
+        {
+          // blocks across the wrap-around of the sequence numbers
+          ack.AddSackBlock (SequenceNumber32 (1000 * b), SequenceNumber32 (1000 * b + 500));
+        }
+      uint32_t blocks = std::min (n, TcpHeader::MAX_SACK_BLOCKS);
+      NS_TEST_ASSERT_MSG_EQ (ack.GetSerializedSize (), 24 + 8 * blocks, "wrong size with " << n << " blocks");
+      p = Create<Packet> ();
+      p->AddHeader (ack);
+      p->RemoveHeader (received);
+      NS_TEST_ASSERT_MSG_EQ (received.GetAckNumber (), SequenceNumber32 (0xfffffff0), "wrong ack number");
+      NS_TEST_ASSERT_MSG_EQ (received.IsSackPermitted (), false, "unexpected SACK-permitted");
+      NS_TEST_ASSERT_MSG_EQ (received.GetSackList ().size (), blocks, "wrong number of blocks");
+      uint32_t b = 0;
+      for (TcpHeader::SackList::const_iterator i = received.GetSackList ().begin ();
+           i != received.GetSackList ().end (); ++i, ++b)
+        {
+          NS_TEST_ASSERT_MSG_EQ (i->first, SequenceNumber32 (1000 * b), "wrong left edge");
+          NS_TEST_ASSERT_MSG_EQ (i->second, SequenceNumber32 (1000 * b + 500), "wrong right edge");
+        }
+      NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 0, "header not fully read");
+    }
+
+  // MSS, window scale (after a NOP), SACK-permitted and timestamps, in the
+  // layout of a common SYN segment
+  uint8_t options[] = { 2, 4, 0x05, 0xb4,
+                        1, 3, 3, 7,
+                        4, 2, 8, 10, 0, 0, 0, 1, 0, 0, 0, 0,
+                        1, 1, 5, 10, 0, 0, 0, 100, 0, 0, 0, 200 };
+  Buffer buffer;
+  buffer.AddAtStart (20 + sizeof (options));
+  Buffer::Iterator i = buffer.Begin ();
+  i.WriteHtonU16 (1);
+  i.WriteHtonU16 (2);
+  i.WriteHtonU32 (3);
+  i.WriteHtonU32 (4);
+  i.WriteHtonU16 (((20 + sizeof (options)) / 4) << 12 | TcpHeader::SYN);
+  i.WriteHtonU16 (5);
+  i.WriteHtonU16 (0);
+  i.WriteHtonU16 (0);
+  i.Write (options, sizeof (options));
+  TcpHeader parsed;
+  uint32_t size = parsed.Deserialize (buffer.Begin ());
+  NS_TEST_ASSERT_MSG_EQ (size, 20 + sizeof (options), "wrong header size");
+  NS_TEST_ASSERT_MSG_EQ (parsed.GetWindowSize (), 5, "wrong window");
+  NS_TEST_ASSERT_MSG_EQ (parsed.IsSackPermitted (), true, "SACK-permitted not parsed");
+  NS_TEST_ASSERT_MSG_EQ (parsed.GetSackList ().size (), 1, "SACK option not parsed");
+  NS_TEST_ASSERT_MSG_EQ (parsed.GetSackList ().front ().first, SequenceNumber32 (100), "wrong left edge");
+  NS_TEST_ASSERT_MSG_EQ (parsed.GetSackList ().front ().second, SequenceNumber32 (200), "wrong right edge");
+}
+
+/**
+ * Check the SACK blocks generated by TcpRxBuffer for a window with
+ * several holes.
+ */
+class TcpSackRxBufferTestCase : public TestCase
+{
+public:
+  TcpSackRxBufferTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * \param buffer the buffer
+   * \param offset offset of the segment from the initial sequence number
+   * \param size size of the segment
+   */
+  void AddSegment (TcpRxBuffer &buffer, uint32_t offset, uint32_t size);
+  /**
+   * \param blocks the SACK blocks
+   * \param n index of a block
+   * \return the block, relative to the initial sequence number
+   */
+  std::pair<uint32_t, uint32_t> GetBlock (const TcpHeader::SackList &blocks, uint32_t n);
+  uint32_t m_isn; //!< initial sequence number
+};
+
+TcpSackRxBufferTestCase::TcpSackRxBufferTestCase ()
+  : TestCase ("Check the SACK blocks of TcpRxBuffer"),
+    m_isn (0xffffff00)
+{
+}
+
+void
+TcpSackRxBufferTestCase::AddSegment (TcpRxBuffer &buffer, uint32_t offset, uint32_t size)
+{
+  TcpHeader header;
+  header.SetSequenceNumber (SequenceNumber32 (m_isn + offset));
+  buffer.Add (Create<Packet> (size), header);
+}
+
+std::pair<uint32_t, uint32_t>
+TcpSackRxBufferTestCase::GetBlock (const TcpHeader::SackList &blocks, uint32_t n)
+{
+  TcpHeader::SackList::const_iterator i = blocks.begin ();
+  std::advance (i, n);
+  return std::make_pair (i->first - SequenceNumber32 (m_isn), i->second - SequenceNumber32 (m_isn));
+}
+
+void
+TcpSackRxBufferTestCase::DoRun (void)
+{
+  TcpRxBuffer buffer (m_isn);
+  buffer.SetMaxBufferSize (100000);
+  AddSegment (buffer, 0, 1000);
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetSackList (4).size (), 0, "no data out of order");
+
+  // segments 1000, 3000 and 5000 lost
+  AddSegment (buffer, 2000, 1000);
+  TcpHeader::SackList blocks = buffer.GetSackList (4);
+  NS_TEST_ASSERT_MSG_EQ (blocks.size (), 1, "wrong number of blocks");
+  NS_TEST_ASSERT_MSG_EQ (GetBlock (blocks, 0).first, 2000, "wrong block");
+  AddSegment (buffer, 4000, 1000);
+  AddSegment (buffer, 6000, 1000);
+  AddSegment (buffer, 7000, 1000);
+  blocks = buffer.GetSackList (4);
+  NS_TEST_ASSERT_MSG_EQ (blocks.size (), 3, "wrong number of blocks");
+  NS_TEST_ASSERT_MSG_EQ (GetBlock (blocks, 0).first, 6000, "most recent block not first");
+  NS_TEST_ASSERT_MSG_EQ (GetBlock (blocks, 0).second, 8000, "adjacent segments not merged");
+  NS_TEST_ASSERT_MSG_EQ (GetBlock (blocks, 1).first, 4000, "wrong second block");
+  NS_TEST_ASSERT_MSG_EQ (GetBlock (blocks, 2).first, 2000, "wrong third block");
+
+  // a retransmission fills the middle hole: the block it extends comes first
+  AddSegment (buffer, 5000, 1000);
+  blocks = buffer.GetSackList (4);
+  NS_TEST_ASSERT_MSG_EQ (blocks.size (), 2, "wrong number of blocks");
+  NS_TEST_ASSERT_MSG_EQ (GetBlock (blocks, 0).first, 4000, "most recent block not first");
+  NS_TEST_ASSERT_MSG_EQ (GetBlock (blocks, 0).second, 8000, "wrong most recent block");
+  NS_TEST_ASSERT_MSG_EQ (GetBlock (blocks, 1).first, 2000, "wrong second block");
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetSackList (1).size (), 1, "too many blocks");
+
+  // the first hole is filled: only the data beyond the next hole is reported
+  AddSegment (buffer, 1000, 1000);
+  NS_TEST_ASSERT_MSG_EQ (buffer.NextRxSequence (), SequenceNumber32 (m_isn + 3000), "wrong next sequence");
+  blocks = buffer.GetSackList (4);
+  NS_TEST_ASSERT_MSG_EQ (blocks.size (), 1, "wrong number of blocks");
+  NS_TEST_ASSERT_MSG_EQ (GetBlock (blocks, 0).first, 4000, "wrong block");
+  AddSegment (buffer, 3000, 1000);
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetSackList (4).size (), 0, "no data out of order");
+  NS_TEST_ASSERT_MSG_EQ (buffer.NextRxSequence (), SequenceNumber32 (m_isn + 8000), "wrong next sequence");
+}
+
+/**
+ * Check the scoreboard of TcpTxBuffer: merge of the SACK blocks, holes
+ * and trimming on cumulative acknowledgements.
+ */
+class TcpSackScoreboardTestCase : public TestCase
+{
+public:
+  TcpSackScoreboardTestCase ();
+  virtual void DoRun (void);
+};
+
+TcpSackScoreboardTestCase::TcpSackScoreboardTestCase ()
+  : TestCase ("Check the SACK scoreboard of TcpTxBuffer")
+{
+}
+
+void
+TcpSackScoreboardTestCase::DoRun (void)
+{
+  uint32_t isn = 0xfffff000;
+  SequenceNumber32 head (isn);
+  TcpTxBuffer buffer (isn);
+  buffer.SetMaxBufferSize (100000);
+  buffer.Add (Create<Packet> (10000));
+  NS_TEST_ASSERT_MSG_EQ (buffer.HighestSacked (), head, "nothing SACKed");
+
+  buffer.AddSackBlock (head + SequenceNumber32 (2000), head + SequenceNumber32 (3000));
+  buffer.AddSackBlock (head + SequenceNumber32 (6000), head + SequenceNumber32 (7000));
+  buffer.AddSackBlock (head + SequenceNumber32 (4000), head + SequenceNumber32 (5000));
+  NS_TEST_ASSERT_MSG_EQ (buffer.SackedBytes (), 3000, "wrong SACKed bytes");
+  // overlapping and adjacent blocks are merged
+  buffer.AddSackBlock (head + SequenceNumber32 (4500), head + SequenceNumber32 (6000));
+  NS_TEST_ASSERT_MSG_EQ (buffer.SackedBytes (), 4000, "wrong SACKed bytes after merge");
+  buffer.AddSackBlock (head + SequenceNumber32 (2000), head + SequenceNumber32 (3000));
+  NS_TEST_ASSERT_MSG_EQ (buffer.SackedBytes (), 4000, "duplicate block counted twice");
+  // blocks beyond the buffer are clipped
+  buffer.AddSackBlock (head + SequenceNumber32 (9500), head + SequenceNumber32 (12000));
+  NS_TEST_ASSERT_MSG_EQ (buffer.SackedBytes (), 4500, "block not clipped");
+  NS_TEST_ASSERT_MSG_EQ (buffer.HighestSacked (), head + SequenceNumber32 (10000), "wrong highest SACKed");
+  NS_TEST_ASSERT_MSG_EQ (buffer.SackedBytesFromSequence (head + SequenceNumber32 (4500)), 3000, "wrong SACKed bytes from");
+
+  // holes: [0, 2000) [3000, 4000) [7000, 9500)
+  SequenceNumber32 seq = head;
+  NS_TEST_ASSERT_MSG_EQ (buffer.NextHole (seq), 2000, "wrong first hole");
+  NS_TEST_ASSERT_MSG_EQ (seq, head, "wrong first hole start");
+  seq = head + SequenceNumber32 (2500);
+  NS_TEST_ASSERT_MSG_EQ (buffer.NextHole (seq), 1000, "wrong second hole");
+  NS_TEST_ASSERT_MSG_EQ (seq, head + SequenceNumber32 (3000), "wrong second hole start");
+  seq = head + SequenceNumber32 (4000);
+  NS_TEST_ASSERT_MSG_EQ (buffer.NextHole (seq), 2500, "wrong third hole");
+  NS_TEST_ASSERT_MSG_EQ (seq, head + SequenceNumber32 (7000), "wrong third hole start");
+  seq = head + SequenceNumber32 (9600);
+  NS_TEST_ASSERT_MSG_EQ (buffer.NextHole (seq), 0, "hole beyond the buffer");
+
+  // a cumulative ACK trims the scoreboard
+  buffer.DiscardUpTo (head + SequenceNumber32 (4500));
+  NS_TEST_ASSERT_MSG_EQ (buffer.SackedBytes (), 3000, "scoreboard not trimmed");
+  seq = head;
+  NS_TEST_ASSERT_MSG_EQ (buffer.NextHole (seq), 2500, "wrong hole after ACK");
+  NS_TEST_ASSERT_MSG_EQ (seq, head + SequenceNumber32 (7000), "wrong hole start after ACK");
+  buffer.ClearSackBlocks ();
+  NS_TEST_ASSERT_MSG_EQ (buffer.SackedBytes (), 0, "scoreboard not cleared");
+  NS_TEST_ASSERT_MSG_EQ (buffer.HighestSacked (), head + SequenceNumber32 (4500), "scoreboard not cleared");
+}
+
+class TcpSackTestSuite : public TestSuite
+{
+public:
+  TcpSackTestSuite ();
+};
+
+TcpSackTestSuite::TcpSackTestSuite ()
+  : TestSuite ("tcp-sack", UNIT)
+{
+  AddTestCase (new TcpSackHeaderTestCase (), TestCase::QUICK);
+  AddTestCase (new TcpSackRxBufferTestCase (), TestCase::QUICK);
+  AddTestCase (new TcpSackScoreboardTestCase (), TestCase::QUICK);
+}
+
+static TcpSackTestSuite g_tcpSackTestSuite;
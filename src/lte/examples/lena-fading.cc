@@ -53,31 +53,38 @@ int main (int argc, char *argv[])
   //lteHelper->EnableLogComponents ();
   
 
-  lteHelper->SetAttribute ("FadingModel", StringValue ("ns3::TraceFadingLossModel"));
-  
+  // the trace is looked up from the directory of test.py and from the
+  // top directory; it is not shipped with ns-3, see
+  // src/lte/model/fading-traces/fading_trace_generator.m to generate it
+  std::string traceFile = "../../src/lte/model/fading-traces/fading_trace_EPA_3kmph.fad";
   std::ifstream ifTraceFile;
-  ifTraceFile.open ("../../src/lte/model/fading-traces/fading_trace_EPA_3kmph.fad", std::ifstream::in);
+  ifTraceFile.open (traceFile.c_str (), std::ifstream::in);
+  if (!ifTraceFile.good ())
+    {
+      traceFile = "src/lte/model/fading-traces/fading_trace_EPA_3kmph.fad";
+      ifTraceFile.clear ();
+      ifTraceFile.open (traceFile.c_str (), std::ifstream::in);
+    }
   if (ifTraceFile.good ())
     {
-      // script launched by test.py
-      lteHelper->SetFadingModelAttribute ("TraceFilename", StringValue ("../../src/lte/model/fading-traces/fading_trace_EPA_3kmph.fad"));
+      lteHelper->SetAttribute ("FadingModel", StringValue ("ns3::TraceFadingLossModel"));
+      lteHelper->SetFadingModelAttribute ("TraceFilename", StringValue (traceFile));
+
+      // these parameters have to setted only in case of the trace format 
+      // differs from the standard one, that is
+      // - 10 seconds length trace
+      // - 10,000 samples
+      // - 0.5 seconds for window size
+      // - 100 RB
+      lteHelper->SetFadingModelAttribute ("TraceLength", TimeValue (Seconds (10.0)));
+      lteHelper->SetFadingModelAttribute ("SamplesNum", UintegerValue (10000));
+      lteHelper->SetFadingModelAttribute ("WindowSize", TimeValue (Seconds (0.5)));
+      lteHelper->SetFadingModelAttribute ("RbNum", UintegerValue (100));
     }
   else
     {
-      // script launched as an example
-      lteHelper->SetFadingModelAttribute ("TraceFilename", StringValue ("src/lte/model/fading-traces/fading_trace_EPA_3kmph.fad"));
+      std::cout << "Fading trace " << traceFile << " not found, running without fading" << std::endl;
     }
-    
-  // these parameters have to setted only in case of the trace format 
-  // differs from the standard one, that is
-  // - 10 seconds length trace
-  // - 10,000 samples
-  // - 0.5 seconds for window size
-  // - 100 RB
-  lteHelper->SetFadingModelAttribute ("TraceLength", TimeValue (Seconds (10.0)));
-  lteHelper->SetFadingModelAttribute ("SamplesNum", UintegerValue (10000));
-  lteHelper->SetFadingModelAttribute ("WindowSize", TimeValue (Seconds (0.5)));
-  lteHelper->SetFadingModelAttribute ("RbNum", UintegerValue (100));
  
   // Create Nodes: eNodeB and UE
   NodeContainer enbNodes;
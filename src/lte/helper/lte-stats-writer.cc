@@ -0,0 +1,160 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-stats-writer.h"
+#include <ns3/simulator.h>
+#include <ns3/uinteger.h>
+#include <ns3/log.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteStatsWriter");
+
+NS_OBJECT_ENSURE_REGISTERED (LteStatsWriter);
+
+LteStatsWriter::LteStatsWriter ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LteStatsWriter::~LteStatsWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  CloseAll ();
+}
+
+TypeId
+LteStatsWriter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LteStatsWriter")
+    .SetParent<Object> ()
+    .AddConstructor<LteStatsWriter> ()
+    .AddAttribute ("BufferSize",
+                   "Size in bytes of the buffer of each output file.",
+                   UintegerValue (65536),
+                   MakeUintegerAccessor (&LteStatsWriter::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("FlushInterval",
+                   "Interval of simulated time between two flushes of the output files. "
+                   "If zero, the files are only flushed when their buffer is full and "
+                   "at the end of the simulation.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&LteStatsWriter::m_flushInterval),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+Ptr<LteStatsWriter>
+LteStatsWriter::Get (void)
+{
+  return *DoGet ();
+}
+
+Ptr<LteStatsWriter> *
+LteStatsWriter::DoGet (void)
+{
+  static Ptr<LteStatsWriter> ptr = 0;
+  if (ptr == 0)
+    {
+      ptr = CreateObject<LteStatsWriter> ();
+      Simulator::ScheduleDestroy (&LteStatsWriter::Delete);
+    }
+  return &ptr;
+}
+
+void
+LteStatsWriter::Delete (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Ptr<LteStatsWriter> *ptr = DoGet ();
+  (*ptr)->Dispose ();
+  *ptr = 0;
+}
+
+void
+LteStatsWriter::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  CloseAll ();
+  Object::DoDispose ();
+}
+
+std::ostream *
+LteStatsWriter::Open (std::string filename, bool truncate)
+{
+  std::map<std::string, File>::iterator it = m_files.find (filename);
+  if (it != m_files.end ())
+    {
+      if (!truncate)
+        {
+          if (m_flushInterval.IsStrictlyPositive () && Simulator::Now () >= m_nextFlush)
+            {
+              Flush ();
+            }
+          return it->second.stream;
+        }
+      // another calculator starts the file again
+      delete it->second.stream;
+      delete [] it->second.buffer;
+      m_files.erase (it);
+    }
+
+  NS_LOG_LOGIC ("open " << filename << (truncate ? " truncated" : " for append"));
+  File file;
+  file.buffer = new char[m_bufferSize];
+  file.stream = new std::ofstream ();
+  // the buffer must be set before the file is opened
+  file.stream->rdbuf ()->pubsetbuf (file.buffer, m_bufferSize);
+  file.stream->open (filename.c_str (), truncate ? std::ios_base::trunc : std::ios_base::app);
+  if (!file.stream->is_open ())
+    {
+      delete file.stream;
+      delete [] file.buffer;
+      return 0;
+    }
+  if (m_files.empty ())
+    {
+      m_nextFlush = Simulator::Now () + m_flushInterval;
+    }
+  m_files[filename] = file;
+  return file.stream;
+}
+
+void
+LteStatsWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::map<std::string, File>::iterator it = m_files.begin (); it != m_files.end (); ++it)
+    {
+      it->second.stream->flush ();
+    }
+  m_nextFlush = Simulator::Now () + m_flushInterval;
+}
+
+void
+LteStatsWriter::CloseAll (void)
+{
+  for (std::map<std::string, File>::iterator it = m_files.begin (); it != m_files.end (); ++it)
+    {
+      // the stream writes its buffer when closed, before the buffer is freed
+      delete it->second.stream;
+      delete [] it->second.buffer;
+    }
+  m_files.clear ();
+}
+
+} // namespace ns3
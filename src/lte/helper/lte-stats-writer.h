@@ -0,0 +1,104 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_STATS_WRITER_H_
+#define LTE_STATS_WRITER_H_
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include <fstream>
+#include <string>
+#include <map>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * Keeps the output files of the LTE stats calculators open for the
+ * whole simulation.
+ *
+ * The calculators write a line per TTI and per UE: opening and closing
+ * the file for each line, and flushing it with std::endl, costs several
+ * system calls per record. The writer instead holds a single buffered
+ * stream per file name, shared by all the calculators writing to that
+ * file. The streams are flushed when their buffer is full, by the
+ * first record written after each FlushInterval of simulated time if
+ * that attribute is set, and closed at Simulator::Destroy. The periodic
+ * flush is not a simulator event: it does not keep a simulation
+ * running.
+ *
+ * The writer is a singleton: its attributes are set with
+ * Config::SetDefault before the first record is written.
+ */
+class LteStatsWriter : public Object
+{
+public:
+  LteStatsWriter ();
+  virtual ~LteStatsWriter ();
+
+  // inherited from Object
+  static TypeId GetTypeId (void);
+
+  /**
+   * \returns the writer shared by all the stats calculators
+   */
+  static Ptr<LteStatsWriter> Get (void);
+
+  /**
+   * Get the stream of a file, opening it if needed.
+   *
+   * \param filename the name of the file
+   * \param truncate true to discard the content of the file, as done by
+   *        the first write of a calculator; otherwise the records are
+   *        appended to the file
+   * \returns the stream, or 0 if the file can't be opened
+   */
+  std::ostream * Open (std::string filename, bool truncate);
+
+  /**
+   * Write the buffered records of all the files.
+   */
+  void Flush (void);
+
+protected:
+  // inherited from Object
+  virtual void DoDispose (void);
+
+private:
+  /// Close all the files
+  void CloseAll (void);
+  /// \returns the address of the singleton pointer
+  static Ptr<LteStatsWriter> * DoGet (void);
+  /// Release the singleton at Simulator::Destroy
+  static void Delete (void);
+
+  /// An open output file and its buffer
+  struct File
+  {
+    std::ofstream *stream;
+    char *buffer;
+  };
+
+  std::map<std::string, File> m_files; //!< open files, by name
+  uint32_t m_bufferSize;               //!< size of the buffer of each file
+  Time m_flushInterval;                //!< interval between flushes, 0 to flush only when needed
+  Time m_nextFlush;                    //!< time of the next periodic flush
+};
+
+} // namespace ns3
+
+#endif /* LTE_STATS_WRITER_H_ */
@@ -22,6 +22,7 @@
 #include "ns3/string.h"
 #include <ns3/simulator.h>
 #include <ns3/log.h>
+#include "lte-stats-writer.h"
 
 namespace ns3 {
 
@@ -93,27 +94,18 @@ MacStatsCalculator::DlScheduling (uint16_t cellId, uint64_t imsi, uint32_t frame
   NS_LOG_FUNCTION (this << cellId << imsi << frameNo << subframeNo << rnti << (uint32_t) mcsTb1 << sizeTb1 << (uint32_t) mcsTb2 << sizeTb2);
   NS_LOG_INFO ("Write DL Mac Stats in " << GetDlOutputFilename ().c_str ());
 
-  std::ofstream outFile;
+  std::ostream *stream = LteStatsWriter::Get ()->Open (GetDlOutputFilename (), m_dlFirstWrite);
+  if (stream == 0)
+    {
+      NS_LOG_ERROR ("Can't open file " << GetDlOutputFilename ().c_str ());
+      return;
+    }
+  std::ostream &outFile = *stream;
   if ( m_dlFirstWrite == true )
     {
-      outFile.open (GetDlOutputFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetDlOutputFilename ().c_str ());
-          return;
-        }
       m_dlFirstWrite = false;
       outFile << "% time\tcellId\tIMSI\tframe\tsframe\tRNTI\tmcsTb1\tsizeTb1\tmcsTb2\tsizeTb2";
-      outFile << std::endl;
-    }
-  else
-    {
-      outFile.open (GetDlOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetDlOutputFilename ().c_str ());
-          return;
-        }
+      outFile << "\n";
     }
 
   outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
@@ -125,8 +117,7 @@ MacStatsCalculator::DlScheduling (uint16_t cellId, uint64_t imsi, uint32_t frame
   outFile << (uint32_t) mcsTb1 << "\t";
   outFile << sizeTb1 << "\t";
   outFile << (uint32_t) mcsTb2 << "\t";
-  outFile << sizeTb2 << std::endl;
-  outFile.close ();
+  outFile << sizeTb2 << "\n";
 }
 
 void
@@ -136,27 +127,18 @@ MacStatsCalculator::UlScheduling (uint16_t cellId, uint64_t imsi, uint32_t frame
   NS_LOG_FUNCTION (this << cellId << imsi << frameNo << subframeNo << rnti << (uint32_t) mcsTb << size);
   NS_LOG_INFO ("Write UL Mac Stats in " << GetUlOutputFilename ().c_str ());
 
-  std::ofstream outFile;
+  std::ostream *stream = LteStatsWriter::Get ()->Open (GetUlOutputFilename (), m_ulFirstWrite);
+  if (stream == 0)
+    {
+      NS_LOG_ERROR ("Can't open file " << GetUlOutputFilename ().c_str ());
+      return;
+    }
+  std::ostream &outFile = *stream;
   if ( m_ulFirstWrite == true )
     {
-      outFile.open (GetUlOutputFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUlOutputFilename ().c_str ());
-          return;
-        }
       m_ulFirstWrite = false;
       outFile << "% time\tcellId\tIMSI\tframe\tsframe\tRNTI\tmcs\tsize";
-      outFile << std::endl;
-    }
-  else
-    {
-      outFile.open (GetUlOutputFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUlOutputFilename ().c_str ());
-          return;
-        }
+      outFile << "\n";
     }
 
   outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
@@ -166,8 +148,7 @@ MacStatsCalculator::UlScheduling (uint16_t cellId, uint64_t imsi, uint32_t frame
   outFile << subframeNo << "\t";
   outFile << rnti << "\t";
   outFile << (uint32_t) mcsTb << "\t";
-  outFile << size << std::endl;
-  outFile.close ();
+  outFile << size << "\n";
 }
 
 void
@@ -22,6 +22,7 @@
 #include "ns3/string.h"
 #include <ns3/simulator.h>
 #include <ns3/log.h>
+#include "lte-stats-writer.h"
 
 namespace ns3 {
 
@@ -113,27 +114,18 @@ PhyStatsCalculator::ReportCurrentCellRsrpSinr (uint16_t cellId, uint64_t imsi, u
   NS_LOG_FUNCTION (this << cellId <<  imsi << rnti  << rsrp << sinr);
   NS_LOG_INFO ("Write RSRP/SINR Phy Stats in " << GetCurrentCellRsrpSinrFilename ().c_str ());
 
-  std::ofstream outFile;
+  std::ostream *stream = LteStatsWriter::Get ()->Open (GetCurrentCellRsrpSinrFilename (), m_RsrpSinrFirstWrite);
+  if (stream == 0)
+    {
+      NS_LOG_ERROR ("Can't open file " << GetCurrentCellRsrpSinrFilename ().c_str ());
+      return;
+    }
+  std::ostream &outFile = *stream;
   if ( m_RsrpSinrFirstWrite == true )
     {
-      outFile.open (GetCurrentCellRsrpSinrFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetCurrentCellRsrpSinrFilename ().c_str ());
-          return;
-        }
       m_RsrpSinrFirstWrite = false;
       outFile << "% time\tcellId\tIMSI\tRNTI\trsrp\tsinr";
-      outFile << std::endl;
-    }
-  else
-    {
-      outFile.open (GetCurrentCellRsrpSinrFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetCurrentCellRsrpSinrFilename ().c_str ());
-          return;
-        }
+      outFile << "\n";
     }
 
   outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
@@ -141,8 +133,7 @@ PhyStatsCalculator::ReportCurrentCellRsrpSinr (uint16_t cellId, uint64_t imsi, u
   outFile << imsi << "\t";
   outFile << rnti << "\t";
   outFile << rsrp << "\t";
-  outFile << sinr << std::endl;
-  outFile.close ();
+  outFile << sinr << "\n";
 }
 
 void
@@ -151,35 +142,25 @@ PhyStatsCalculator::ReportUeSinr (uint16_t cellId, uint64_t imsi, uint16_t rnti,
   NS_LOG_FUNCTION (this << cellId <<  imsi << rnti  << sinrLinear);
   NS_LOG_INFO ("Write SINR Linear Phy Stats in " << GetUeSinrFilename ().c_str ());
 
-  std::ofstream outFile;
+  std::ostream *stream = LteStatsWriter::Get ()->Open (GetUeSinrFilename (), m_UeSinrFirstWrite);
+  if (stream == 0)
+    {
+      NS_LOG_ERROR ("Can't open file " << GetUeSinrFilename ().c_str ());
+      return;
+    }
+  std::ostream &outFile = *stream;
   if ( m_UeSinrFirstWrite == true )
     {
-      outFile.open (GetUeSinrFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUeSinrFilename ().c_str ());
-          return;
-        }
       m_UeSinrFirstWrite = false;
       outFile << "% time\tcellId\tIMSI\tRNTI\tsinrLinear";
-      outFile << std::endl;
-    }
-  else
-    {
-      outFile.open (GetUeSinrFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetUeSinrFilename ().c_str ());
-          return;
-        }
+      outFile << "\n";
     }
 
   outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
   outFile << cellId << "\t";
   outFile << imsi << "\t";
   outFile << rnti << "\t";
-  outFile << sinrLinear << std::endl;
-  outFile.close ();
+  outFile << sinrLinear << "\n";
 }
 
 void
@@ -188,33 +169,28 @@ PhyStatsCalculator::ReportInterference (uint16_t cellId, Ptr<SpectrumValue> inte
   NS_LOG_FUNCTION (this << cellId <<  interference);
   NS_LOG_INFO ("Write Interference Phy Stats in " << GetInterferenceFilename ().c_str ());
 
-  std::ofstream outFile;
+  std::ostream *stream = LteStatsWriter::Get ()->Open (GetInterferenceFilename (), m_InterferenceFirstWrite);
+  if (stream == 0)
+    {
+      NS_LOG_ERROR ("Can't open file " << GetInterferenceFilename ().c_str ());
+      return;
+    }
+  std::ostream &outFile = *stream;
   if ( m_InterferenceFirstWrite == true )
     {
-      outFile.open (GetInterferenceFilename ().c_str ());
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetInterferenceFilename ().c_str ());
-          return;
-        }
       m_InterferenceFirstWrite = false;
       outFile << "% time\tcellId\tInterference";
-      outFile << std::endl;
-    }
-  else
-    {
-      outFile.open (GetInterferenceFilename ().c_str (),  std::ios_base::app);
-      if (!outFile.is_open ())
-        {
-          NS_LOG_ERROR ("Can't open file " << GetInterferenceFilename ().c_str ());
-          return;
-        }
+      outFile << "\n";
     }
 
   outFile << Simulator::Now ().GetNanoSeconds () / (double) 1e9 << "\t";
   outFile << cellId << "\t";
-  outFile << *interference;
-  outFile.close ();
+  // same format as operator<< of SpectrumValue, without the flush of std::endl
+  for (Values::const_iterator it = interference->ConstValuesBegin (); it != interference->ConstValuesEnd (); ++it)
+    {
+      outFile << *it << " ";
+    }
+  outFile << "\n";
 }
 
 
@@ -36,15 +36,181 @@
 #include <ns3/node.h>
 #include <ns3/buildings-helper.h>
 #include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/lte-enb-net-device.h>
+#include <ns3/lte-enb-phy.h>
+#include <ns3/lte-spectrum-phy.h>
+#include <ns3/node-list.h>
+#include <ns3/building-list.h>
+#include <ns3/buildings-propagation-loss-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/antenna-model.h>
+#include <ns3/core-config.h>
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#endif
 
 #include <fstream>
 #include <limits>
+#include <cmath>
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("RadioEnvironmentMapHelper");
 
 namespace ns3 {
 
 
+/**
+ * Computes the SINR of a range of points of the map in offline mode.
+ *
+ * Each worker only touches objects that it owns (the receivers of its
+ * points, and with more than one thread its own copies of the
+ * transmitters) so that no reference count is shared among threads.
+ * The loss models and the antenna models are shared, hence they must
+ * not have any state when several workers run concurrently.
+ */
+class RemOfflineWorker : public SimpleRefCount<RemOfflineWorker>
+{
+public:
+  RemOfflineWorker (Ptr<PropagationLossModel> propagationLoss,
+                    Ptr<SpectrumPropagationLossModel> spectrumPropagationLoss,
+                    double maxLossDb, double noisePower);
+
+  /**
+   * \param mobility the mobility model of the transmitter
+   * \param antenna the antenna model of the transmitter, possibly null
+   * \param psd the tx PSD, in the spectrum model of the map
+   */
+  void AddTransmitter (Ptr<MobilityModel> mobility, Ptr<AntennaModel> antenna, Ptr<const SpectrumValue> psd);
+
+  /**
+   * \param points the positions of the points of the iteration
+   * \param rx the receivers of the points of the iteration
+   * \param sinr where the SINR of the points is stored
+   * \param begin the first point to be computed by this worker
+   * \param end one past the last point to be computed by this worker
+   */
+  void SetPoints (const std::vector<Vector> *points, const std::vector<Ptr<MobilityModel> > *rx,
+                  std::vector<double> *sinr, uint32_t begin, uint32_t end);
+
+  /// compute the SINR of the points set by SetPoints
+  void Run (void);
+
+private:
+  double CalcRxPower (uint32_t tx, Ptr<MobilityModel> rxMobility) const;
+
+  Ptr<PropagationLossModel> m_propagationLoss;
+  Ptr<SpectrumPropagationLossModel> m_spectrumPropagationLoss;
+  double m_maxLossDb;
+  double m_noisePower;
+  bool m_makeConsistent;
+
+  std::vector<Ptr<MobilityModel> > m_txMobility;
+  std::vector<Ptr<AntennaModel> > m_txAntenna;
+  std::vector<Ptr<const SpectrumValue> > m_txPsd;
+
+  const std::vector<Vector> *m_points;
+  const std::vector<Ptr<MobilityModel> > *m_rx;
+  std::vector<double> *m_sinr;
+  uint32_t m_begin;
+  uint32_t m_end;
+};
+
+RemOfflineWorker::RemOfflineWorker (Ptr<PropagationLossModel> propagationLoss,
+                                    Ptr<SpectrumPropagationLossModel> spectrumPropagationLoss,
+                                    double maxLossDb, double noisePower)
+  : m_propagationLoss (propagationLoss),
+    m_spectrumPropagationLoss (spectrumPropagationLoss),
+    m_maxLossDb (maxLossDb),
+    m_noisePower (noisePower),
+    m_makeConsistent (BuildingList::GetNBuildings () > 0),
+    m_points (0),
+    m_rx (0),
+    m_sinr (0),
+    m_begin (0),
+    m_end (0)
+{
+}
+
+void
+RemOfflineWorker::AddTransmitter (Ptr<MobilityModel> mobility, Ptr<AntennaModel> antenna, Ptr<const SpectrumValue> psd)
+{
+  m_txMobility.push_back (mobility);
+  m_txAntenna.push_back (antenna);
+  m_txPsd.push_back (psd);
+}
+
+void
+RemOfflineWorker::SetPoints (const std::vector<Vector> *points, const std::vector<Ptr<MobilityModel> > *rx,
+                             std::vector<double> *sinr, uint32_t begin, uint32_t end)
+{
+  m_points = points;
+  m_rx = rx;
+  m_sinr = sinr;
+  m_begin = begin;
+  m_end = end;
+}
+
+void
+RemOfflineWorker::Run (void)
+{
+  for (uint32_t i = m_begin; i < m_end; ++i)
+    {
+      // the receiver is used by reference, as its reference count
+      // could be changed concurrently by another worker otherwise
+      const Ptr<MobilityModel> &rxMobility = (*m_rx)[i];
+      rxMobility->SetPosition ((*m_points)[i]);
+      if (m_makeConsistent)
+        {
+          BuildingsHelper::MakeConsistent (rxMobility);
+        }
+
+      // same as RemSpectrumPhy, with the transmitters in node order
+      double referenceSignalPower = 0;
+      double sumPower = 0;
+      for (uint32_t tx = 0; tx < m_txPsd.size (); ++tx)
+        {
+          double power = CalcRxPower (tx, rxMobility);
+          sumPower += power;
+          if (power > referenceSignalPower)
+            {
+              referenceSignalPower = power;
+            }
+        }
+      (*m_sinr)[i] = referenceSignalPower / (sumPower - referenceSignalPower + m_noisePower);
+    }
+}
+
+double
+RemOfflineWorker::CalcRxPower (uint32_t tx, Ptr<MobilityModel> rxMobility) const
+{
+  // same as SpectrumChannel::StartTx, the REM having no rx antenna
+  const Ptr<MobilityModel> &txMobility = m_txMobility[tx];
+  double pathLossDb = 0;
+  if (m_txAntenna[tx] != 0)
+    {
+      Angles txAngles (rxMobility->GetPosition (), txMobility->GetPosition ());
+      pathLossDb -= m_txAntenna[tx]->GetGainDb (txAngles);
+    }
+  if (m_propagationLoss != 0)
+    {
+      pathLossDb -= m_propagationLoss->CalcRxPower (0, txMobility, rxMobility);
+    }
+  if (pathLossDb > m_maxLossDb)
+    {
+      // beyond range
+      return 0;
+    }
+  Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue> (m_txPsd[tx]);
+  *rxPsd *= std::pow (10.0, (-pathLossDb) / 10.0);
+  if (m_spectrumPropagationLoss != 0)
+    {
+      rxPsd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxPsd, txMobility, rxMobility);
+    }
+  return Integral (*rxPsd);
+}
+
 
 NS_OBJECT_ENSURE_REGISTERED (RadioEnvironmentMapHelper);
 
@@ -63,6 +229,9 @@ void
 RadioEnvironmentMapHelper::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_workers.clear ();
+  m_offlineRx.clear ();
+  m_channel = 0;
 }
 
 TypeId
@@ -133,6 +302,21 @@ RadioEnvironmentMapHelper::GetTypeId (void)
                    MakeUintegerAccessor (&RadioEnvironmentMapHelper::SetBandwidth, 
                                          &RadioEnvironmentMapHelper::GetBandwidth),
                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("Offline",
+                   "If true, Install () generates the map right away by evaluating the "
+                   "loss models of the channel, instead of deploying RemSpectrumPhy "
+                   "instances that are fed by the simulation",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RadioEnvironmentMapHelper::m_offline),
+                   MakeBooleanChecker ())
+    .AddAttribute ("NumThreads",
+                   "The number of threads among which the points are split in offline mode. "
+                   "More than one thread requires loss models with no state (e.g., no "
+                   "shadowing, random variables, caches or fading traces); "
+                   "buildings are only supported with a single thread.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&RadioEnvironmentMapHelper::m_numThreads),
+                   MakeUintegerChecker<uint32_t> (1, 256))
   ;
   return tid;
 }
@@ -188,7 +372,13 @@ RadioEnvironmentMapHelper::Install ()
       NS_FATAL_ERROR ("Can't open file " << (m_outputFile));
       return;
     }
-  
+
+  if (m_offline)
+    {
+      InstallOffline ();
+      return;
+    }
+
   Simulator::Schedule (Seconds (0.0026), 
                        &RadioEnvironmentMapHelper::DelayedInstall,
                                    this);
@@ -318,6 +508,189 @@ RadioEnvironmentMapHelper::PrintAndReset ()
     }
 }
 
+void
+RadioEnvironmentMapHelper::InstallOffline ()
+{
+  NS_LOG_FUNCTION (this);
+  m_xStep = (m_xMax - m_xMin)/(m_xRes-1);
+  m_yStep = (m_yMax - m_yMin)/(m_yRes-1);
+
+  if ((double)m_xRes * (double) m_yRes < (double) m_maxPointsPerIteration)
+    {
+      m_maxPointsPerIteration = m_xRes * m_yRes;
+    }
+
+  uint32_t numThreads = m_numThreads;
+#ifndef HAVE_PTHREAD_H
+  if (numThreads > 1)
+    {
+      NS_LOG_WARN ("no thread support, generating the REM with one thread");
+      numThreads = 1;
+    }
+#endif
+  Ptr<PropagationLossModel> propagationLoss = m_channel->GetPropagationLossModel ();
+  if (numThreads > 1
+      && (BuildingList::GetNBuildings () > 0 || DynamicCast<BuildingsPropagationLossModel> (propagationLoss) != 0))
+    {
+      NS_LOG_WARN ("buildings are not thread safe, generating the REM with one thread");
+      numThreads = 1;
+    }
+  if (numThreads > m_maxPointsPerIteration)
+    {
+      numThreads = m_maxPointsPerIteration;
+    }
+
+  DoubleValue maxLossDb;
+  m_channel->GetAttribute ("MaxLossDb", maxLossDb);
+  for (uint32_t i = 0; i < numThreads; ++i)
+    {
+      m_workers.push_back (Create<RemOfflineWorker> (propagationLoss,
+                                                     m_channel->GetSpectrumPropagationLossModel (),
+                                                     maxLossDb.Get (), m_noisePower));
+    }
+
+  // the transmitters are the eNBs transmitting on the channel, as
+  // their control frame covers the whole bandwidth
+  Ptr<const SpectrumModel> rxSpectrumModel = LteSpectrumValueHelper::GetSpectrumModel (m_earfcn, m_bandwidth);
+  for (NodeList::Iterator nodeIt = NodeList::Begin (); nodeIt != NodeList::End (); ++nodeIt)
+    {
+      for (uint32_t i = 0; i < (*nodeIt)->GetNDevices (); ++i)
+        {
+          Ptr<LteEnbNetDevice> enbDev = DynamicCast<LteEnbNetDevice> ((*nodeIt)->GetDevice (i));
+          if (enbDev == 0)
+            {
+              continue;
+            }
+          Ptr<LteEnbPhy> enbPhy = enbDev->GetPhy ();
+          Ptr<LteSpectrumPhy> txPhy = enbPhy->GetDownlinkSpectrumPhy ();
+          if (txPhy->GetChannel () != m_channel || txPhy->GetMobility () == 0)
+            {
+              continue;
+            }
+          std::vector<int> rbs;
+          for (uint8_t rb = 0; rb < enbDev->GetDlBandwidth (); rb++)
+            {
+              rbs.push_back (rb);
+            }
+          Ptr<SpectrumValue> txPsd = LteSpectrumValueHelper::CreateTxPowerSpectralDensity (enbDev->GetDlEarfcn (),
+                                                                                           enbDev->GetDlBandwidth (),
+                                                                                           enbPhy->GetTxPower (),
+                                                                                           rbs);
+          if (txPsd->GetSpectrumModelUid () != rxSpectrumModel->GetUid ())
+            {
+              SpectrumConverter converter (txPsd->GetSpectrumModel (), rxSpectrumModel);
+              txPsd = converter.Convert (txPsd);
+            }
+          NS_LOG_LOGIC ("transmitter cellId " << enbDev->GetCellId ()
+                        << " at " << txPhy->GetMobility ()->GetPosition ());
+
+          for (uint32_t w = 0; w < numThreads; ++w)
+            {
+              if (numThreads == 1)
+                {
+                  m_workers.at (w)->AddTransmitter (txPhy->GetMobility (), txPhy->GetRxAntenna (), txPsd);
+                  continue;
+                }
+              // private copies, so that the threads do not share any
+              // reference count (including the one of the SpectrumModel)
+              Ptr<MobilityModel> txMobility = CreateObject<ConstantPositionMobilityModel> ();
+              txMobility->SetPosition (txPhy->GetMobility ()->GetPosition ());
+              txMobility->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+              BuildingsHelper::MakeConsistent (txMobility);
+              Ptr<SpectrumModel> spectrumModel = Create<SpectrumModel> (Bands (rxSpectrumModel->Begin (),
+                                                                               rxSpectrumModel->End ()));
+              Ptr<SpectrumValue> psd = Create<SpectrumValue> (spectrumModel);
+              std::copy (txPsd->ConstValuesBegin (), txPsd->ConstValuesEnd (), psd->ValuesBegin ());
+              m_workers.at (w)->AddTransmitter (txMobility, txPhy->GetRxAntenna (), psd);
+            }
+        }
+    }
+
+  for (uint32_t i = 0; i < m_maxPointsPerIteration; ++i)
+    {
+      Ptr<MobilityModel> rx = CreateObject<ConstantPositionMobilityModel> ();
+      Ptr<MobilityBuildingInfo> buildingInfo = CreateObject<MobilityBuildingInfo> ();
+      rx->AggregateObject (buildingInfo); // operation usually done by BuildingsHelper::Install
+      BuildingsHelper::MakeConsistent (rx);
+      m_offlineRx.push_back (rx);
+    }
+
+  // same points and iterations as DelayedInstall
+  std::vector<Vector> points;
+  points.reserve (m_maxPointsPerIteration);
+  for (double x = m_xMin; x < m_xMax + 0.5*m_xStep; x += m_xStep)
+    {
+      for (double y = m_yMin; y < m_yMax + 0.5*m_yStep ; y += m_yStep)
+        {
+          points.push_back (Vector (x, y, m_z));
+          if (points.size () == m_maxPointsPerIteration)
+            {
+              RunOfflineIteration (points);
+              points.clear ();
+            }
+        }
+    }
+  if (!points.empty ())
+    {
+      RunOfflineIteration (points);
+    }
+
+  m_workers.clear ();
+  m_offlineRx.clear ();
+  m_outFile.close ();
+  if (m_stopWhenDone)
+    {
+      // Simulator::Run () would reset a plain Simulator::Stop ()
+      Simulator::Stop (Seconds (0));
+    }
+}
+
+void
+RadioEnvironmentMapHelper::RunOfflineIteration (const std::vector<Vector> &points)
+{
+  NS_LOG_FUNCTION (this << points.size ());
+  std::vector<double> sinr (points.size ());
+  uint32_t numWorkers = m_workers.size ();
+  for (uint32_t w = 0; w < numWorkers; ++w)
+    {
+      m_workers.at (w)->SetPoints (&points, &m_offlineRx, &sinr,
+                                   points.size () * w / numWorkers,
+                                   points.size () * (w + 1) / numWorkers);
+    }
+
+  if (numWorkers == 1)
+    {
+      m_workers.at (0)->Run ();
+    }
+  else
+    {
+#ifdef HAVE_PTHREAD_H
+      std::vector<Ptr<SystemThread> > threads;
+      for (uint32_t w = 0; w < numWorkers; ++w)
+        {
+          threads.push_back (Create<SystemThread> (MakeCallback (&RemOfflineWorker::Run, m_workers.at (w))));
+          threads.back ()->Start ();
+        }
+      for (uint32_t w = 0; w < numWorkers; ++w)
+        {
+          threads.at (w)->Join ();
+        }
+#else
+      NS_FATAL_ERROR ("no thread support");
+#endif
+    }
+
+  for (uint32_t i = 0; i < points.size (); ++i)
+    {
+      m_outFile << points[i].x << "\t"
+                << points[i].y << "\t"
+                << points[i].z << "\t"
+                << sinr[i]
+                << "\n";
+    }
+  m_outFile.flush ();
+}
+
 void 
 RadioEnvironmentMapHelper::Finalize ()
 {
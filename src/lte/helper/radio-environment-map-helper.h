@@ -24,7 +24,9 @@
 
 
 #include <ns3/object.h>
+#include <ns3/vector.h>
 #include <fstream>
+#include <vector>
 
 
 namespace ns3 {
@@ -35,10 +37,17 @@ class NetDevice;
 class SpectrumChannel;
 //class BuildingsMobilityModel;
 class MobilityModel;
+class RemOfflineWorker;
 
 /** 
  * Generates a 2D map of the SINR from the strongest transmitter in the downlink of an LTE FDD system.
- * 
+ *
+ * By default the map is generated by attaching RemSpectrumPhy
+ * instances to the channel and letting the simulation run until the
+ * control frames of all the eNBs have been received. When the Offline
+ * attribute is set, Install () instead evaluates the loss models of the
+ * channel directly for every point of the map, without involving the
+ * simulator, possibly splitting the points among several threads.
  */
 class RadioEnvironmentMapHelper : public Object
 {
@@ -64,13 +73,15 @@ public:
 
   /** 
    * Deploy the RemSpectrumPhy objects that generate the map according to the specified settings.
-   * 
+   * In offline mode, the map is instead generated and written to the output file before returning.
    */
   void Install ();
 
 private:
 
   void DelayedInstall ();
+  void InstallOffline ();
+  void RunOfflineIteration (const std::vector<Vector> &points);
   void RunOneIteration (double xMin, double xMax, double yMin, double yMax);
   void PrintAndReset ();
   void Finalize ();
@@ -112,6 +123,14 @@ private:
 
   std::ofstream m_outFile;
 
+  bool m_offline;
+  uint32_t m_numThreads;
+
+  /// the per-thread state of the offline mode, one per thread
+  std::vector<Ptr<RemOfflineWorker> > m_workers;
+  /// the receivers of the offline mode, one per point of an iteration
+  std::vector<Ptr<MobilityModel> > m_offlineRx;
+
 };
 
 
@@ -31,8 +31,6 @@
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/ipv4-header.h"
-#include "ns3/udp-header.h"
-#include "ns3/tcp-header.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/tcp-l4-protocol.h"
 
@@ -40,6 +38,30 @@ NS_LOG_COMPONENT_DEFINE ("EpcTftClassifier");
 
 namespace ns3 {
 
+/// the maximum number of flows remembered by a classifier
+static const uint32_t MAX_CACHED_FLOWS = 1024;
+
+bool
+EpcTftClassifier::FlowId::operator == (const FlowId &other) const
+{
+  return direction == other.direction
+    && remoteAddress == other.remoteAddress
+    && localAddress == other.localAddress
+    && remotePort == other.remotePort
+    && localPort == other.localPort
+    && tos == other.tos;
+}
+
+size_t
+EpcTftClassifier::FlowIdHash::operator () (const FlowId &id) const
+{
+  size_t h = id.remoteAddress.Get ();
+  h = h * 31 + id.localAddress.Get ();
+  h = h * 31 + ((id.remotePort << 16) | id.localPort);
+  h = h * 31 + ((id.tos << 8) | id.direction);
+  return h;
+}
+
 EpcTftClassifier::EpcTftClassifier ()
 {
   NS_LOG_FUNCTION (this);
@@ -51,6 +73,7 @@ EpcTftClassifier::Add (Ptr<EpcTft> tft, uint32_t id)
   NS_LOG_FUNCTION (this << tft);
   
   m_tftMap[id] = tft;  
+  m_flowCache.clear ();
   
   // simple sanity check: there shouldn't be more than 16 bearers (hence TFTs) per UE
   NS_ASSERT (m_tftMap.size () <= 16);
@@ -61,6 +84,7 @@ EpcTftClassifier::Delete (uint32_t id)
 {
   NS_LOG_FUNCTION (this << id);
   m_tftMap.erase (id);
+  m_flowCache.clear ();
 }
 
  
@@ -69,10 +93,8 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
 {
   NS_LOG_FUNCTION (this << p << direction);
 
-  Ptr<Packet> pCopy = p->Copy ();
-
   Ipv4Header ipv4Header;
-  pCopy->RemoveHeader (ipv4Header);
+  p->PeekHeader (ipv4Header);
 
   Ipv4Address localAddress;
   Ipv4Address remoteAddress;
@@ -97,35 +119,27 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
   uint16_t localPort = 0;
   uint16_t remotePort = 0;
 
-  if (protocol == UdpL4Protocol::PROT_NUMBER)
+  if (protocol == UdpL4Protocol::PROT_NUMBER || protocol == TcpL4Protocol::PROT_NUMBER)
     {
-      UdpHeader udpHeader;
-      pCopy->RemoveHeader (udpHeader);
+      // both UDP and TCP headers start with the source and destination
+      // ports, which are read in place rather than from a copy of the
+      // packet
+      uint32_t ipv4HeaderSize = ipv4Header.GetSerializedSize ();
+      uint8_t buf[60 + 4];
+      NS_ASSERT (ipv4HeaderSize + 4 <= sizeof (buf));
+      p->CopyData (buf, ipv4HeaderSize + 4);
+      uint16_t sourcePort = (buf[ipv4HeaderSize] << 8) | buf[ipv4HeaderSize + 1];
+      uint16_t destinationPort = (buf[ipv4HeaderSize + 2] << 8) | buf[ipv4HeaderSize + 3];
 
       if (direction ==  EpcTft::UPLINK)
 	{
-	  localPort = udpHeader.GetSourcePort ();
-	  remotePort = udpHeader.GetDestinationPort ();
+	  localPort = sourcePort;
+	  remotePort = destinationPort;
 	}
       else
 	{
-	  remotePort = udpHeader.GetSourcePort ();
-	  localPort = udpHeader.GetDestinationPort ();
-	}
-    }
-  else if (protocol == TcpL4Protocol::PROT_NUMBER)
-    {
-      TcpHeader tcpHeader;
-      pCopy->RemoveHeader (tcpHeader);
-      if (direction ==  EpcTft::UPLINK)
-	{
-	  localPort = tcpHeader.GetSourcePort ();
-	  remotePort = tcpHeader.GetDestinationPort ();
-	}
-      else
-	{
-	  remotePort = tcpHeader.GetSourcePort ();
-	  localPort = tcpHeader.GetDestinationPort ();
+	  remotePort = sourcePort;
+	  localPort = destinationPort;
 	}
     }
   else
@@ -141,6 +155,24 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
 	       << " remotePort=" << remotePort 
 	       << " tos=0x" << (uint16_t) tos );
 
+  FlowId flowId;
+  flowId.direction = direction;
+  flowId.remoteAddress = remoteAddress;
+  flowId.localAddress = localAddress;
+  flowId.remotePort = remotePort;
+  flowId.localPort = localPort;
+  flowId.tos = tos;
+  sgi::hash_map<FlowId, uint32_t, FlowIdHash>::const_iterator cacheIt = m_flowCache.find (flowId);
+  if (cacheIt != m_flowCache.end ())
+    {
+      NS_LOG_LOGIC ("known flow, matches with TFT ID = " << cacheIt->second);
+      return cacheIt->second;
+    }
+  if (m_flowCache.size () >= MAX_CACHED_FLOWS)
+    {
+      m_flowCache.clear ();
+    }
+
   // now it is possible to classify the packet!
   // we use a reverse iterator since filter priority is not implemented properly.
   // This way, since the default bearer is expected to be added first, it will be evaluated last.
@@ -155,10 +187,12 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
       if (tft->Matches (direction, remoteAddress, localAddress, remotePort, localPort, tos))
         {
 	  NS_LOG_LOGIC ("matches with TFT ID = " << it->first);
+	  m_flowCache[flowId] = it->first;
 	  return it->first; // the id of the matching TFT
         }
     }
   NS_LOG_LOGIC ("no match");
+  m_flowCache[flowId] = 0;
   return 0;  // no match
 }
 
@@ -26,6 +26,7 @@
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
 #include "ns3/epc-tft.h"
+#include "ns3/sgi-hashmap.h"
 
 #include <map>
 
@@ -39,6 +40,9 @@ class Packet;
  * \brief classifies IP packets accoding to Traffic Flow Templates (TFTs)
  * 
  * \note this implementation works with IPv4 only.
+ *
+ * \note the classifier remembers the outcome for each flow, hence a
+ * TFT must not be modified once it has been added.
  */
 class EpcTftClassifier : public SimpleRefCount<EpcTftClassifier>
 {
@@ -74,6 +78,42 @@ public:
 protected:
   
   std::map <uint32_t, Ptr<EpcTft> > m_tftMap;
+
+private:
+
+  /**
+   * The fields of an IP packet that the TFTs look at
+   */
+  struct FlowId
+  {
+    EpcTft::Direction direction;
+    Ipv4Address remoteAddress;
+    Ipv4Address localAddress;
+    uint16_t remotePort;
+    uint16_t localPort;
+    uint8_t tos;
+
+    bool operator == (const FlowId &other) const;
+  };
+
+  /**
+   * Hash function class for FlowId
+   */
+  struct FlowIdHash
+  {
+    /**
+     * \param id the flow
+     * \return the hash of the flow
+     */
+    size_t operator () (const FlowId &id) const;
+  };
+
+  /**
+   * The identifier of the TFT matching each flow seen since the TFTs
+   * last changed, so that only the first packet of a flow goes through
+   * the packet filters
+   */
+  sgi::hash_map<FlowId, uint32_t, FlowIdHash> m_flowCache;
   
 };
 
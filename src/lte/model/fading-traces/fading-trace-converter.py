@@ -0,0 +1,71 @@
+#! /usr/bin/env python
+## -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation;
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+"""
+Convert a text fading trace, as written by fading_trace_generator.m,
+into the binary format of ns3::LteFadingTrace, which
+ns3::TraceFadingLossModel maps in memory instead of parsing it.
+
+Usage: fading-trace-converter.py [--rbs N] [--samples N] input.fad output.fadb
+
+The binary file is written in the byte order of the host running the
+script: convert the traces on the hosts which run the simulations.
+"""
+
+import array
+import optparse
+import struct
+import sys
+
+MAGIC = b'NS3FAD01'
+BYTE_ORDER_MARK = 0x01020304
+
+
+def main(argv):
+    parser = optparse.OptionParser(usage='%prog [options] input.fad output.fadb')
+    parser.add_option('--rbs', type='int', default=100,
+                      help='number of RBs of the trace (default: %default)')
+    parser.add_option('--samples', type='int', default=10000,
+                      help='number of samples per RB (default: %default)')
+    (options, args) = parser.parse_args(argv[1:])
+    if len(args) != 2:
+        parser.error('an input and an output file are needed')
+
+    samples = array.array('d')
+    needed = options.rbs * options.samples
+    with open(args[0]) as f:
+        for line in f:
+            for value in line.split():
+                samples.append(float(value))
+                if len(samples) == needed:
+                    break
+            if len(samples) == needed:
+                break
+    if len(samples) < needed:
+        sys.stderr.write('%s: %d samples found, %d RBs of %d samples are needed\n'
+                         % (args[0], len(samples), options.rbs, options.samples))
+        return 1
+
+    with open(args[1], 'wb') as f:
+        # native byte order and standard sizes, without alignment
+        f.write(MAGIC)
+        f.write(struct.pack('=IIII', BYTE_ORDER_MARK, options.rbs, options.samples, 0))
+        samples.tofile(f)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/fatal-error.h>
+#include <ns3/ff-mac-scheduler-harq.h>
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("FfMacSchedulerHarq");
+
+namespace ns3 {
+
+FfMacSchedulerHarq::FfMacSchedulerHarq ()
+{
+}
+
+void
+FfMacSchedulerHarq::AddUe (uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+  if (rnti >= m_ues.size ())
+    {
+      m_ues.resize (rnti + 1);
+    }
+  UeHarq &ue = m_ues[rnti];
+  ue.active = true;
+  ue.dlProcessId = 0;
+  ue.dlStatus.assign (HARQ_PROC_NUM, 0);
+  ue.dlTimers.assign (HARQ_PROC_NUM, 0);
+  ue.dlDcis.assign (HARQ_PROC_NUM, DlDciListElement_s ());
+  // the RLC PDUs of the two layers
+  ue.dlRlcPdus.assign (2, RlcPduList_t (HARQ_PROC_NUM));
+  ue.ulProcessId = 0;
+  ue.ulStatus.assign (HARQ_PROC_NUM, 0);
+  ue.ulDcis.assign (HARQ_PROC_NUM, UlDciListElement_s ());
+}
+
+void
+FfMacSchedulerHarq::RemoveUe (uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+  if (rnti >= m_ues.size ())
+    {
+      return;
+    }
+  // release the buffers, the entry is reused if the RNTI is allocated again
+  m_ues[rnti] = UeHarq ();
+}
+
+void
+FfMacSchedulerHarq::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_ues.clear ();
+}
+
+bool
+FfMacSchedulerHarq::IsDlProcessAvailable (uint16_t rnti) const
+{
+  const DlHarqProcessesStatus_t &status = Get (rnti).dlStatus;
+  return (std::find (status.begin (), status.end (), 0) != status.end ());
+}
+
+uint8_t
+FfMacSchedulerHarq::UpdateDlProcessId (uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+  UeHarq &ue = Get (rnti);
+  uint8_t i = ue.dlProcessId;
+  do
+    {
+      i = (i + 1) % HARQ_PROC_NUM;
+    }
+  while ((ue.dlStatus.at (i) != 0) && (i != ue.dlProcessId));
+  if (ue.dlStatus.at (i) != 0)
+    {
+      NS_FATAL_ERROR ("No HARQ process available for RNTI " << rnti << " check before update with IsDlProcessAvailable");
+    }
+  ue.dlProcessId = i;
+  ue.dlStatus.at (i) = 1;
+  return (i);
+}
+
+void
+FfMacSchedulerHarq::RefreshDlProcesses (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t rnti = 0; rnti < m_ues.size (); rnti++)
+    {
+      UeHarq &ue = m_ues[rnti];
+      if (!ue.active)
+        {
+          continue;
+        }
+      for (uint16_t i = 0; i < HARQ_PROC_NUM; i++)
+        {
+          if (ue.dlTimers.at (i) == HARQ_DL_TIMEOUT)
+            {
+              // reset HARQ process
+              NS_LOG_DEBUG (this << " Reset HARQ proc " << i << " for RNTI " << rnti);
+              ue.dlStatus.at (i) = 0;
+              ue.dlTimers.at (i) = 0;
+            }
+          else
+            {
+              ue.dlTimers.at (i)++;
+            }
+        }
+    }
+}
+
+void
+FfMacSchedulerHarq::UpdateUlProcessIds (void)
+{
+  for (std::vector <UeHarq>::iterator it = m_ues.begin (); it != m_ues.end (); it++)
+    {
+      if (it->active)
+        {
+          it->ulProcessId = (it->ulProcessId + 1) % HARQ_PROC_NUM;
+        }
+    }
+}
+
+FfMacSchedulerHarq::UeHarq&
+FfMacSchedulerHarq::Get (uint16_t rnti)
+{
+  if (!HasUe (rnti))
+    {
+      NS_FATAL_ERROR ("No HARQ processes for RNTI " << rnti);
+    }
+  return m_ues[rnti];
+}
+
+const FfMacSchedulerHarq::UeHarq&
+FfMacSchedulerHarq::Get (uint16_t rnti) const
+{
+  if (!HasUe (rnti))
+    {
+      NS_FATAL_ERROR ("No HARQ processes for RNTI " << rnti);
+    }
+  return m_ues[rnti];
+}
+
+} // namespace ns3
@@ -0,0 +1,210 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FF_MAC_SCHEDULER_HARQ_H
+#define FF_MAC_SCHEDULER_HARQ_H
+
+#include <ns3/ff-mac-common.h>
+#include <vector>
+
+#define HARQ_PROC_NUM 8
+#define HARQ_DL_TIMEOUT 11
+
+namespace ns3 {
+
+typedef std::vector < uint8_t > DlHarqProcessesStatus_t;
+typedef std::vector < uint8_t > DlHarqProcessesTimer_t;
+typedef std::vector < DlDciListElement_s > DlHarqProcessesDciBuffer_t;
+typedef std::vector < std::vector <struct RlcPduListElement_s> > RlcPduList_t; // vector of the LCs and layers per UE
+typedef std::vector < RlcPduList_t > DlHarqRlcPduListBuffer_t; // vector of the 8 HARQ processes per UE
+
+typedef std::vector < UlDciListElement_s > UlHarqProcessesDciBuffer_t;
+typedef std::vector < uint8_t > UlHarqProcessesStatus_t;
+
+/**
+ * \ingroup lte
+ *
+ * The DL and UL HARQ processes of the UEs of an FF MAC scheduler,
+ * stored in an array indexed by RNTI.
+ *
+ * All the schedulers keep the same HARQ state: the current process of
+ * each direction, the status of the processes, the timers of the DL
+ * processes and the DCIs and RLC PDUs to retransmit. This class holds
+ * it for all of them, along with the bookkeeping of the processes, so
+ * that the schedulers only decide what to retransmit and where.
+ *
+ * The accessors abort the simulation for an RNTI which was not added.
+ */
+class FfMacSchedulerHarq
+{
+public:
+  FfMacSchedulerHarq ();
+
+  /**
+   * Create the HARQ processes of a UE, all of them free.
+   *
+   * \param rnti the RNTI of the UE
+   */
+  void AddUe (uint16_t rnti);
+  /**
+   * Remove the HARQ processes of a UE.
+   *
+   * \param rnti the RNTI of the UE
+   */
+  void RemoveUe (uint16_t rnti);
+  /**
+   * Remove the HARQ processes of all the UEs.
+   */
+  void Clear (void);
+  /**
+   * \param rnti the RNTI of a UE
+   * \returns true if the UE has HARQ processes
+   */
+  bool HasUe (uint16_t rnti) const
+  {
+    return (rnti < m_ues.size ()) && m_ues[rnti].active;
+  }
+  /**
+   * \returns an upper bound of the RNTIs of the UEs, i.e., one more
+   * than the largest RNTI which was added
+   */
+  uint32_t GetRntiBound (void) const
+  {
+    return m_ues.size ();
+  }
+
+  /**
+   * \param rnti the RNTI of a UE
+   * \returns true if the UE has a free DL HARQ process
+   */
+  bool IsDlProcessAvailable (uint16_t rnti) const;
+  /**
+   * Move the UE to its next free DL HARQ process and mark it as busy.
+   *
+   * \param rnti the RNTI of the UE
+   * \returns the id of the process
+   */
+  uint8_t UpdateDlProcessId (uint16_t rnti);
+  /**
+   * Advance the timers of the DL HARQ processes by one TTI, and free
+   * the processes which timed out.
+   */
+  void RefreshDlProcesses (void);
+  /**
+   * Advance the current UL HARQ process of all the UEs by one TTI.
+   */
+  void UpdateUlProcessIds (void);
+
+  /**
+   * \param rnti the RNTI of a UE
+   * \returns the status of the DL HARQ processes of the UE, 0 for a
+   * free process, x>0 for the transmission count of a busy one
+   */
+  DlHarqProcessesStatus_t& GetDlStatus (uint16_t rnti)
+  {
+    return Get (rnti).dlStatus;
+  }
+  /**
+   * \param rnti the RNTI of a UE
+   * \returns the timers of the DL HARQ processes of the UE, in TTIs
+   */
+  DlHarqProcessesTimer_t& GetDlTimers (uint16_t rnti)
+  {
+    return Get (rnti).dlTimers;
+  }
+  /**
+   * \param rnti the RNTI of a UE
+   * \returns the DCIs of the DL HARQ processes of the UE
+   */
+  DlHarqProcessesDciBuffer_t& GetDlDcis (uint16_t rnti)
+  {
+    return Get (rnti).dlDcis;
+  }
+  /**
+   * \param rnti the RNTI of a UE
+   * \returns the RLC PDUs of the DL HARQ processes of the UE, per layer
+   */
+  DlHarqRlcPduListBuffer_t& GetDlRlcPdus (uint16_t rnti)
+  {
+    return Get (rnti).dlRlcPdus;
+  }
+  /**
+   * \param rnti the RNTI of a UE
+   * \returns the current UL HARQ process of the UE
+   */
+  uint8_t GetUlProcessId (uint16_t rnti)
+  {
+    return Get (rnti).ulProcessId;
+  }
+  /**
+   * \param rnti the RNTI of a UE
+   * \returns the number of retransmissions of the UL HARQ processes of
+   * the UE
+   */
+  UlHarqProcessesStatus_t& GetUlStatus (uint16_t rnti)
+  {
+    return Get (rnti).ulStatus;
+  }
+  /**
+   * \param rnti the RNTI of a UE
+   * \returns the DCIs of the UL HARQ processes of the UE
+   */
+  UlHarqProcessesDciBuffer_t& GetUlDcis (uint16_t rnti)
+  {
+    return Get (rnti).ulDcis;
+  }
+
+private:
+  /**
+   * The HARQ processes of a UE.
+   */
+  struct UeHarq
+  {
+    UeHarq ()
+      : active (false),
+        dlProcessId (0),
+        ulProcessId (0)
+    {
+    }
+
+    bool active;                          //!< the UE was added
+    uint8_t dlProcessId;                  //!< the current DL process
+    DlHarqProcessesStatus_t dlStatus;     //!< the status of the DL processes
+    DlHarqProcessesTimer_t dlTimers;      //!< the timers of the DL processes
+    DlHarqProcessesDciBuffer_t dlDcis;    //!< the DCIs of the DL processes
+    DlHarqRlcPduListBuffer_t dlRlcPdus;   //!< the RLC PDUs of the DL processes
+    uint8_t ulProcessId;                  //!< the current UL process
+    UlHarqProcessesStatus_t ulStatus;     //!< the status of the UL processes
+    UlHarqProcessesDciBuffer_t ulDcis;    //!< the DCIs of the UL processes
+  };
+
+  /**
+   * \param rnti the RNTI of a UE
+   * \returns the HARQ processes of the UE
+   */
+  UeHarq& Get (uint16_t rnti);
+  /**
+   * \param rnti the RNTI of a UE
+   * \returns the HARQ processes of the UE
+   */
+  const UeHarq& Get (uint16_t rnti) const;
+
+  std::vector <UeHarq> m_ues;  //!< the HARQ processes, indexed by RNTI
+};
+
+} // namespace ns3
+
+#endif /* FF_MAC_SCHEDULER_HARQ_H */
@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/ff-mac-scheduler-ue-table.h>
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("FfMacSchedulerUeTable");
+
+namespace ns3 {
+
+const uint8_t FfMacSchedulerUeTable::NO_TX_MODE;
+
+FfMacSchedulerUeTable::FfMacSchedulerUeTable ()
+{
+}
+
+void
+FfMacSchedulerUeTable::Update (const RlcBufferReqMap_t& rlcBufferReq,
+                               const FfMacSchedulerHarq& harq,
+                               const std::map <uint16_t, uint8_t>& uesTxMode)
+{
+  NS_LOG_FUNCTION (this);
+
+  // the maps are sorted by RNTI: their last element has the largest one
+  uint32_t size = harq.GetRntiBound ();
+  if (!rlcBufferReq.empty ())
+    {
+      size = std::max<uint32_t> (size, rlcBufferReq.rbegin ()->first.m_rnti + 1);
+    }
+  if (!uesTxMode.empty ())
+    {
+      size = std::max<uint32_t> (size, uesTxMode.rbegin ()->first + 1);
+    }
+  m_activeLcs.assign (size, 0);
+  m_dlHarqAvailable.assign (size, HARQ_UNKNOWN);
+  m_layers.assign (size, NO_TX_MODE);
+
+  for (RlcBufferReqMap_t::const_iterator it = rlcBufferReq.begin (); it != rlcBufferReq.end (); it++)
+    {
+      if (((*it).second.m_rlcTransmissionQueueSize > 0)
+          || ((*it).second.m_rlcRetransmissionQueueSize > 0)
+          || ((*it).second.m_rlcStatusPduSize > 0))
+        {
+          m_activeLcs[(*it).first.m_rnti]++;
+        }
+    }
+
+  for (uint32_t rnti = 0; rnti < harq.GetRntiBound (); rnti++)
+    {
+      if (harq.HasUe (rnti))
+        {
+          m_dlHarqAvailable[rnti] = harq.IsDlProcessAvailable (rnti) ? HARQ_AVAILABLE : HARQ_BUSY;
+        }
+    }
+
+  for (std::map <uint16_t, uint8_t>::const_iterator it = uesTxMode.begin (); it != uesTxMode.end (); it++)
+    {
+      m_layers[(*it).first] = TransmissionModesLayers::TxMode2LayerNum ((*it).second);
+    }
+}
+
+bool
+FfMacSchedulerUeTable::IsDlHarqProcessAvailable (uint16_t rnti) const
+{
+  if (rnti >= m_dlHarqAvailable.size () || m_dlHarqAvailable[rnti] == HARQ_UNKNOWN)
+    {
+      NS_FATAL_ERROR ("No HARQ process information for RNTI " << rnti);
+    }
+  return (m_dlHarqAvailable[rnti] == HARQ_AVAILABLE);
+}
+
+int
+FfMacSchedulerUeTable::GetLayers (uint16_t rnti) const
+{
+  if (rnti >= m_layers.size () || m_layers[rnti] == NO_TX_MODE)
+    {
+      NS_FATAL_ERROR ("No Transmission Mode info on user " << rnti);
+    }
+  return (m_layers[rnti]);
+}
+
+uint16_t
+FfMacSchedulerUeTable::CountActiveLcs (const RlcBufferReqMap_t& rlcBufferReq, uint16_t rnti)
+{
+  uint16_t lcActive = 0;
+  for (RlcBufferReqMap_t::const_iterator it = rlcBufferReq.lower_bound (LteFlowId_t (rnti, 0));
+       it != rlcBufferReq.end () && (*it).first.m_rnti == rnti; it++)
+    {
+      if (((*it).second.m_rlcTransmissionQueueSize > 0)
+          || ((*it).second.m_rlcRetransmissionQueueSize > 0)
+          || ((*it).second.m_rlcStatusPduSize > 0))
+        {
+          lcActive++;
+        }
+    }
+  return (lcActive);
+}
+
+} // namespace ns3
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FF_MAC_SCHEDULER_UE_TABLE_H
+#define FF_MAC_SCHEDULER_UE_TABLE_H
+
+#include <ns3/lte-common.h>
+#include <ns3/ff-mac-common.h>
+#include <ns3/ff-mac-sched-sap.h>
+#include <ns3/ff-mac-scheduler-harq.h>
+#include <vector>
+#include <map>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * The per-UE DL state queried by the FF MAC schedulers for each UE and
+ * each RBG of a TTI, stored in arrays indexed by RNTI.
+ *
+ * The schedulers keep their state in maps keyed by RNTI or by flow,
+ * which makes these queries logarithmic, or linear for the number of
+ * active LCs of a UE. The table takes a snapshot of that state once per
+ * TTI, before the allocation of the RBGs, so that the allocation
+ * queries it in constant time. The snapshot is valid as long as the
+ * RLC buffers, the HARQ processes and the transmission modes of the UEs
+ * are not changed, i.e., until the DCIs of the TTI are built.
+ */
+class FfMacSchedulerUeTable
+{
+public:
+  /// the RLC buffer status of the flows, as kept by the schedulers
+  typedef std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters> RlcBufferReqMap_t;
+
+  FfMacSchedulerUeTable ();
+
+  /**
+   * Take the snapshot of the state of the UEs.
+   *
+   * \param rlcBufferReq the RLC buffer status of the flows
+   * \param harq the HARQ processes of the UEs
+   * \param uesTxMode the transmission mode of the UEs
+   */
+  void Update (const RlcBufferReqMap_t& rlcBufferReq,
+               const FfMacSchedulerHarq& harq,
+               const std::map <uint16_t, uint8_t>& uesTxMode);
+
+  /**
+   * \param rnti the RNTI of a UE
+   * \returns the number of LCs of the UE with data to transmit
+   */
+  uint16_t GetActiveLcs (uint16_t rnti) const
+  {
+    return (rnti < m_activeLcs.size ()) ? m_activeLcs[rnti] : 0;
+  }
+
+  /**
+   * \param rnti the RNTI of a UE
+   * \returns true if the UE has a free DL HARQ process
+   */
+  bool IsDlHarqProcessAvailable (uint16_t rnti) const;
+
+  /**
+   * \param rnti the RNTI of a UE
+   * \returns the number of layers of the transmission mode of the UE
+   */
+  int GetLayers (uint16_t rnti) const;
+
+  /**
+   * Count the LCs of a UE with data to transmit, looking up only the
+   * flows of the UE.
+   *
+   * \param rlcBufferReq the RLC buffer status of the flows
+   * \param rnti the RNTI of the UE
+   * \returns the number of LCs of the UE with data to transmit
+   */
+  static uint16_t CountActiveLcs (const RlcBufferReqMap_t& rlcBufferReq, uint16_t rnti);
+
+  /**
+   * \param rlcBufferReq the RLC buffer status of the flows
+   * \param rnti the RNTI of a UE
+   * \returns the first flow of the UE, or the first flow of the next
+   * UEs if the UE has none
+   */
+  static RlcBufferReqMap_t::iterator FindFirstFlow (RlcBufferReqMap_t& rlcBufferReq, uint16_t rnti)
+  {
+    return rlcBufferReq.lower_bound (LteFlowId_t (rnti, 0));
+  }
+
+private:
+  /// values of m_dlHarqAvailable
+  enum HarqState_e
+  {
+    HARQ_UNKNOWN = 0,
+    HARQ_BUSY,
+    HARQ_AVAILABLE
+  };
+
+  /// value of m_layers for the UEs without transmission mode
+  static const uint8_t NO_TX_MODE = 0xff;
+
+  std::vector <uint16_t> m_activeLcs;      //!< the number of active LCs
+  std::vector <uint8_t> m_dlHarqAvailable; //!< a HarqState_e per UE
+  std::vector <uint8_t> m_layers;          //!< the number of layers per UE
+};
+
+} // namespace ns3
+
+#endif /* FF_MAC_SCHEDULER_UE_TABLE_H */
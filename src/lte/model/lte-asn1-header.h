@@ -25,6 +25,7 @@
 
 #include <bitset>
 #include <string>
+#include <vector>
 
 #include "ns3/lte-rrc-sap.h"
 
@@ -53,7 +54,7 @@ public:
   virtual void Print (std::ostream &os) const = 0;
     
   /**
-   * This function serializes class attributes to m_serializationResult local Buffer.
+   * This function serializes class attributes to m_serializationResult local byte vector.
    * As ASN1 encoding produces a bitstream that does not have a fixed length,
    * this function is needed to store the result, so its length can be retrieved
    * with Header::GetSerializedSize() function.
@@ -66,11 +67,32 @@ protected:
   mutable uint8_t m_serializationPendingBits;
   mutable uint8_t m_numSerializationPendingBits;
   mutable bool m_isDataSerialized;
-  mutable Buffer m_serializationResult;
+  mutable std::vector<uint8_t> m_serializationResult;
 
   // Function to write in m_serializationResult, after resizing its size
   void WriteOctet (uint8_t octet) const;
 
+  /**
+   * Append the numBits least significant bits of value to the bitstream,
+   * most significant bit first. The complete octets are written to
+   * m_serializationResult at once, the remaining bits are kept pending.
+   *
+   * \param value the bits to append
+   * \param numBits the number of bits to append, at most 32
+   */
+  void SerializeBits (uint32_t value, uint8_t numBits) const;
+
+  /**
+   * Read the next numBits bits of the bitstream, most significant bit
+   * first, starting with the bits pending from the last read octet.
+   *
+   * \param value the read bits, as the least significant bits
+   * \param numBits the number of bits to read, at most 32
+   * \param bIterator the iterator of the next octet to read
+   * \return the iterator of the octet following the last read one
+   */
+  Buffer::Iterator DeserializeBits (uint32_t *value, uint8_t numBits, Buffer::Iterator bIterator);
+
   // Serialization functions
   void SerializeBoolean (bool value) const;
   void SerializeInteger (int n, int nmin, int nmax) const;
@@ -957,6 +957,10 @@ LteEnbMac::DoSchedDlConfigInd (FfMacSchedSapUser::SchedDlConfigIndParameters ind
   // Create DL PHY PDU
   Ptr<PacketBurst> pb = CreateObject<PacketBurst> ();
   std::map <LteFlowId_t, LteMacSapUser* >::iterator it;
+  // the new data opportunities of each RLC instance, delivered together
+  // after all the UEs are processed, in the order of their first opportunity
+  std::map<LteMacSapUser*, std::vector<LteMacSapUser::TxOpportunityParameters> > txOpportunities;
+  std::vector<LteMacSapUser*> txOpportunityUsers;
 
   for (unsigned int i = 0; i < ind.m_buildDataList.size (); i++)
     {
@@ -988,7 +992,16 @@ LteEnbMac::DoSchedDlConfigInd (FfMacSchedSapUser::SchedDlConfigIndParameters ind
                   std::map<uint8_t, LteMacSapUser*>::iterator lcidIt = rntiIt->second.find (lcid);
                   NS_ASSERT_MSG (lcidIt != rntiIt->second.end (), "could not find LCID" << lcid);
                   NS_LOG_DEBUG (this << " rnti= " << rnti << " lcid= " << (uint32_t) lcid << " layer= " << k);
-                  (*lcidIt).second->NotifyTxOpportunity (ind.m_buildDataList.at (i).m_rlcPduList.at (j).at (k).m_size, k, ind.m_buildDataList.at (i).m_dci.m_harqProcess);
+                  std::vector<LteMacSapUser::TxOpportunityParameters>& opportunities = txOpportunities[(*lcidIt).second];
+                  if (opportunities.empty ())
+                    {
+                      txOpportunityUsers.push_back ((*lcidIt).second);
+                    }
+                  LteMacSapUser::TxOpportunityParameters opportunity;
+                  opportunity.bytes = ind.m_buildDataList.at (i).m_rlcPduList.at (j).at (k).m_size;
+                  opportunity.layer = k;
+                  opportunity.harqId = ind.m_buildDataList.at (i).m_dci.m_harqProcess;
+                  opportunities.push_back (opportunity);
                 }
               else
                 {
@@ -1013,6 +1026,12 @@ LteEnbMac::DoSchedDlConfigInd (FfMacSchedSapUser::SchedDlConfigIndParameters ind
       m_enbPhySapProvider->SendLteControlMessage (msg);
     }
 
+  for (std::vector<LteMacSapUser*>::const_iterator user = txOpportunityUsers.begin ();
+       user != txOpportunityUsers.end (); ++user)
+    {
+      (*user)->NotifyTxOpportunities (txOpportunities[*user]);
+    }
+
   // Fire the trace with the DL information
   for (  uint32_t i  = 0; i < ind.m_buildDataList.size (); i++ )
     {
@@ -0,0 +1,204 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-fading-trace.h"
+#include <ns3/core-config.h>
+#include <ns3/log.h>
+#include <ns3/fatal-error.h>
+#include <fstream>
+#include <cstring>
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+NS_LOG_COMPONENT_DEFINE ("LteFadingTrace");
+
+namespace ns3 {
+
+namespace {
+
+/// The first bytes of a binary trace
+const char g_binaryMagic[8] = { 'N', 'S', '3', 'F', 'A', 'D', '0', '1' };
+
+/// The header of a binary trace
+struct BinaryHeader
+{
+  char magic[8];         //!< g_binaryMagic
+  uint32_t byteOrder;    //!< 0x01020304 in the byte order of the writer
+  uint32_t rbNum;        //!< number of RBs
+  uint32_t samplesNum;   //!< number of samples per RB
+  uint32_t padding;      //!< align the samples on 8 bytes
+};
+
+} // anonymous namespace
+
+LteFadingTrace::LteFadingTrace (Key key)
+  : m_key (key),
+    m_samples (0),
+    m_stride (key.second.second),
+    m_map (0),
+    m_mapLength (0),
+    m_binary (false)
+{
+  NS_LOG_FUNCTION (this << key.first);
+  if (!LoadBinary ())
+    {
+      LoadText ();
+    }
+}
+
+LteFadingTrace::~LteFadingTrace ()
+{
+  NS_LOG_FUNCTION (this);
+  GetTraces ()->erase (m_key);
+#ifdef HAVE_SYS_MMAN_H
+  if (m_map != 0)
+    {
+      munmap (m_map, m_mapLength);
+    }
+#endif
+}
+
+std::map<LteFadingTrace::Key, LteFadingTrace *> *
+LteFadingTrace::GetTraces (void)
+{
+  static std::map<Key, LteFadingTrace *> traces;
+  return &traces;
+}
+
+Ptr<const LteFadingTrace>
+LteFadingTrace::Get (std::string filename, uint32_t rbNum, uint32_t samplesNum)
+{
+  NS_LOG_FUNCTION (filename << rbNum << samplesNum);
+  Key key = std::make_pair (filename, std::make_pair (rbNum, samplesNum));
+  std::map<Key, LteFadingTrace *>::iterator it = GetTraces ()->find (key);
+  if (it != GetTraces ()->end ())
+    {
+      return Ptr<const LteFadingTrace> (it->second);
+    }
+  Ptr<LteFadingTrace> trace = Ptr<LteFadingTrace> (new LteFadingTrace (key), false);
+  (*GetTraces ())[key] = PeekPointer (trace);
+  return trace;
+}
+
+uint32_t
+LteFadingTrace::GetRbNum (void) const
+{
+  return m_key.second.first;
+}
+
+uint32_t
+LteFadingTrace::GetSamplesNum (void) const
+{
+  return m_key.second.second;
+}
+
+bool
+LteFadingTrace::IsBinary (void) const
+{
+  return m_binary;
+}
+
+bool
+LteFadingTrace::LoadBinary (void)
+{
+  std::ifstream file (m_key.first.c_str (), std::ios_base::in | std::ios_base::binary);
+  if (!file.good ())
+    {
+      NS_FATAL_ERROR ("Fading trace file " << m_key.first << " not found");
+    }
+  BinaryHeader header;
+  file.read (reinterpret_cast<char *> (&header), sizeof (header));
+  if (file.gcount () != sizeof (header)
+      || std::memcmp (header.magic, g_binaryMagic, sizeof (g_binaryMagic)) != 0)
+    {
+      return false;
+    }
+  if (header.byteOrder != 0x01020304)
+    {
+      NS_FATAL_ERROR ("Fading trace file " << m_key.first << " was written with another byte order");
+    }
+  uint32_t rbNum = m_key.second.first;
+  uint32_t samplesNum = m_key.second.second;
+  if (header.rbNum < rbNum || header.samplesNum < samplesNum)
+    {
+      NS_FATAL_ERROR ("Fading trace file " << m_key.first << " has " << header.rbNum << " RBs of "
+                      << header.samplesNum << " samples, " << rbNum << " RBs of "
+                      << samplesNum << " samples are needed");
+    }
+  m_binary = true;
+  m_stride = header.samplesNum;
+  size_t length = sizeof (header) + sizeof (double) * size_t (header.rbNum) * header.samplesNum;
+  NS_LOG_LOGIC (this << " binary trace of " << header.rbNum << " RBs and " << header.samplesNum << " samples");
+
+#ifdef HAVE_SYS_MMAN_H
+  int fd = open (m_key.first.c_str (), O_RDONLY);
+  struct stat st;
+  if (fd >= 0 && fstat (fd, &st) == 0 && size_t (st.st_size) >= length)
+    {
+      void *map = mmap (0, length, PROT_READ, MAP_SHARED, fd, 0);
+      if (map != MAP_FAILED)
+        {
+          m_map = map;
+          m_mapLength = length;
+          m_samples = reinterpret_cast<const double *> (static_cast<const char *> (map) + sizeof (header));
+        }
+    }
+  if (fd >= 0)
+    {
+      close (fd);
+    }
+  if (m_samples != 0)
+    {
+      return true;
+    }
+  NS_LOG_LOGIC (this << " mapping failed, reading the trace");
+#endif
+
+  m_buffer.resize (size_t (header.rbNum) * header.samplesNum);
+  file.read (reinterpret_cast<char *> (&m_buffer[0]), sizeof (double) * m_buffer.size ());
+  if (file.gcount () != std::streamsize (sizeof (double) * m_buffer.size ()))
+    {
+      NS_FATAL_ERROR ("Fading trace file " << m_key.first << " is truncated");
+    }
+  m_samples = &m_buffer[0];
+  return true;
+}
+
+void
+LteFadingTrace::LoadText (void)
+{
+  std::ifstream file (m_key.first.c_str (), std::ifstream::in);
+  uint32_t rbNum = m_key.second.first;
+  uint32_t samplesNum = m_key.second.second;
+  m_buffer.resize (size_t (rbNum) * samplesNum);
+  for (size_t i = 0; i < m_buffer.size (); i++)
+    {
+      file >> m_buffer[i];
+    }
+  if (file.fail ())
+    {
+      NS_FATAL_ERROR ("Fading trace file " << m_key.first << " has less than " << rbNum << " RBs of "
+                      << samplesNum << " samples");
+    }
+  m_samples = &m_buffer[0];
+}
+
+} // namespace ns3
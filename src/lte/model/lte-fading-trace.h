@@ -0,0 +1,124 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_FADING_TRACE_H
+#define LTE_FADING_TRACE_H
+
+#include <ns3/simple-ref-count.h>
+#include <ns3/ptr.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * \brief The samples of a fading trace, loaded once and shared by all
+ * the TraceFadingLossModel instances using the same file.
+ *
+ * A trace holds, for each RB, a series of fading samples in dB. Two
+ * file formats are supported:
+ *
+ * - the text format written by the fading trace generator
+ *   (src/lte/model/fading-traces/fading_trace_generator.m): the samples
+ *   separated by white space, all the samples of the first RB, then
+ *   all the samples of the second one, and so on;
+ *
+ * - a binary format, written from a text trace by
+ *   src/lte/model/fading-traces/fading-trace-converter.py: a 24 bytes
+ *   header, made of the 8 characters "NS3FAD01", the 32 bits byte order
+ *   mark 0x01020304, the number of RBs and the number of samples per RB
+ *   (32 bits each) and 4 bytes of padding, followed by the samples as
+ *   64 bits IEEE doubles in the same order as the text format. All the
+ *   integers and the samples are in the byte order of the host which
+ *   reads the file.
+ *
+ * Binary files are mapped in memory read-only when the platform
+ * supports it: loading them costs no parsing, and the pages of the
+ * samples are shared by all the simulations running on the host.
+ */
+class LteFadingTrace : public SimpleRefCount<LteFadingTrace>
+{
+public:
+  ~LteFadingTrace ();
+
+  /**
+   * Get the trace stored in a file, loading it if no other trace of the
+   * same file and dimensions is in use.
+   *
+   * \param filename the name of the file, in the text or binary format
+   * \param rbNum the number of RBs to read
+   * \param samplesNum the number of samples per RB to read
+   * \returns the trace
+   */
+  static Ptr<const LteFadingTrace> Get (std::string filename, uint32_t rbNum, uint32_t samplesNum);
+
+  /**
+   * \param rb the index of a RB
+   * \param sample the index of a sample
+   * \returns the fading sample, in dB
+   */
+  double GetSample (uint32_t rb, uint32_t sample) const
+  {
+    return m_samples[rb * m_stride + sample];
+  }
+
+  /**
+   * \returns the number of RBs of the trace
+   */
+  uint32_t GetRbNum (void) const;
+  /**
+   * \returns the number of samples per RB of the trace
+   */
+  uint32_t GetSamplesNum (void) const;
+  /**
+   * \returns true if the trace was loaded from a binary file
+   */
+  bool IsBinary (void) const;
+
+private:
+  /// Key of the traces in use: file name, number of RBs and of samples
+  typedef std::pair<std::string, std::pair<uint32_t, uint32_t> > Key;
+
+  /// \param key the file and dimensions of the trace
+  LteFadingTrace (Key key);
+
+  /**
+   * Load a binary trace, if the file is in the binary format.
+   * \returns false if the file is not a binary trace
+   */
+  bool LoadBinary (void);
+  /// Load a text trace
+  void LoadText (void);
+
+  /// \returns the traces in use
+  static std::map<Key, LteFadingTrace *> * GetTraces (void);
+
+  Key m_key;                     //!< the file and dimensions of the trace
+  const double *m_samples;       //!< the samples, RB after RB
+  uint32_t m_stride;             //!< number of samples between two RBs
+  std::vector<double> m_buffer;  //!< the samples, when they are not mapped
+  void *m_map;                   //!< the mapped file, if any
+  size_t m_mapLength;            //!< the length of the mapping
+  bool m_binary;                 //!< true if loaded from a binary file
+};
+
+} // namespace ns3
+
+#endif /* LTE_FADING_TRACE_H */
@@ -25,6 +25,8 @@
 #include <ns3/simulator.h>
 #include <ns3/log.h>
 
+#include <algorithm>
+
 
 NS_LOG_COMPONENT_DEFINE ("LteInterference");
 
@@ -34,7 +36,8 @@ namespace ns3 {
 LteInterference::LteInterference ()
   : m_receiving (false),
     m_lastSignalId (0),
-    m_lastSignalIdBeforeReset (0)
+    m_lastSignalIdBeforeReset (0),
+    m_abstract (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -113,7 +116,15 @@ LteInterference::EndRx ()
     }
   else
     {
-      ConditionallyEvaluateChunk ();
+      if (!m_abstract)
+        {
+          ConditionallyEvaluateChunk ();
+        }
+      else if (Now () > m_lastChangeTime)
+        {
+          // the single chunk of the RX
+          EvaluateChunk ();
+        }
       m_receiving = false;
       for (std::list<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
         {
@@ -135,6 +146,17 @@ void
 LteInterference::AddSignal (Ptr<const SpectrumValue> spd, const Time duration)
 {
   NS_LOG_FUNCTION (this << *spd << duration);
+  if (m_abstract)
+    {
+      if (Now () >= m_lastSignalEnd)
+        {
+          NS_LOG_LOGIC ("first signal since the previous ones ended");
+          (*m_allSignals) = 0.0;
+        }
+      (*m_allSignals) += (*spd);
+      m_lastSignalEnd = std::max (m_lastSignalEnd, Now () + duration);
+      return;
+    }
   DoAddSignal (spd);
   uint32_t signalId = ++m_lastSignalId;
   if (signalId == m_lastSignalIdBeforeReset)
@@ -184,28 +206,35 @@ LteInterference::ConditionallyEvaluateChunk ()
       NS_LOG_DEBUG (this << " Receiving");
     }
   NS_LOG_DEBUG (this << " now "  << Now () << " last " << m_lastChangeTime);
-  if (m_receiving && (Now () > m_lastChangeTime))
+  if (m_receiving && (Now () > m_lastChangeTime) && !m_abstract)
     {
-      NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
+      EvaluateChunk ();
+    }
+}
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
+void
+LteInterference::EvaluateChunk ()
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
 
-      SpectrumValue sinr = (*m_rxSignal) / interf;
-      Time duration = Now () - m_lastChangeTime;
-      for (std::list<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
-        {
-          (*it)->EvaluateSinrChunk (sinr, duration);
-        }
-      for (std::list<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
-        {
-          (*it)->EvaluateSinrChunk (interf, duration);
-        }
-      for (std::list<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
-        {
-          (*it)->EvaluateSinrChunk (*m_rxSignal, duration);
-        }
-      m_lastChangeTime = Now ();
+  SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
+
+  SpectrumValue sinr = (*m_rxSignal) / interf;
+  Time duration = Now () - m_lastChangeTime;
+  for (std::list<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
+    {
+      (*it)->EvaluateSinrChunk (sinr, duration);
     }
+  for (std::list<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_interfChunkProcessorList.begin (); it != m_interfChunkProcessorList.end (); ++it)
+    {
+      (*it)->EvaluateSinrChunk (interf, duration);
+    }
+  for (std::list<Ptr<LteSinrChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
+    {
+      (*it)->EvaluateSinrChunk (*m_rxSignal, duration);
+    }
+  m_lastChangeTime = Now ();
 }
 
 void
@@ -225,6 +254,14 @@ LteInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd
   // record the last SignalId so that we can ignore all signals that
   // were scheduled for subtraction before m_allSignal 
   m_lastSignalIdBeforeReset = m_lastSignalId;
+  m_lastSignalEnd = Seconds (0);
+}
+
+void
+LteInterference::SetAbstractMode (bool abstract)
+{
+  NS_LOG_FUNCTION (this << abstract);
+  m_abstract = abstract;
 }
 
 void
@@ -114,8 +114,23 @@ public:
    */
   void SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd);
 
+  /**
+   * In abstract mode, the signals are not tracked one by one: they are
+   * summed as they arrive, and the sum is reset by the first signal
+   * starting after all the previous ones have ended. A single chunk,
+   * spanning the whole RX and including every signal that started
+   * during it, is then evaluated by EndRx. This spares two events per
+   * signal, and it is exact as long as the signals overlapping a RX are
+   * aligned with it, as is the case for LTE signals on a synchronized
+   * network without propagation delay.
+   *
+   * @param abstract whether the abstract mode is used
+   */
+  void SetAbstractMode (bool abstract);
+
 private:
   void ConditionallyEvaluateChunk ();
+  void EvaluateChunk ();
   void DoAddSignal  (Ptr<const SpectrumValue> spd);
   void DoSubtractSignal  (Ptr<const SpectrumValue> spd, uint32_t signalId);
 
@@ -141,6 +156,9 @@ private:
   uint32_t m_lastSignalId;
   uint32_t m_lastSignalIdBeforeReset;
 
+  bool m_abstract;
+  Time m_lastSignalEnd; ///< in abstract mode, the end of the last signal of m_allSignals
+
   /** all the processor instances that need to be notified whenever
   a new interference chunk is calculated */
   std::list<Ptr<LteSinrChunkProcessor> > m_rsPowerChunkProcessorList;
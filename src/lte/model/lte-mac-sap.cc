@@ -33,6 +33,16 @@ LteMacSapUser::~LteMacSapUser ()
 {
 }
 
+void
+LteMacSapUser::NotifyTxOpportunities (const std::vector<TxOpportunityParameters>& opportunities)
+{
+  for (std::vector<TxOpportunityParameters>::const_iterator it = opportunities.begin ();
+       it != opportunities.end (); ++it)
+    {
+      NotifyTxOpportunity (it->bytes, it->layer, it->harqId);
+    }
+}
+
 
 
 
@@ -22,6 +22,7 @@
 #define LTE_MAC_SAP_H
 
 #include <ns3/packet.h>
+#include <vector>
 
 namespace ns3 {
 
@@ -104,6 +105,27 @@ public:
    */
   virtual void NotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId) = 0;
 
+  /**
+   * Parameters of a transmission opportunity, see NotifyTxOpportunity
+   */
+  struct TxOpportunityParameters
+  {
+    uint32_t bytes;  /**< the number of bytes to transmit */
+    uint8_t layer;  /**< the layer of transmission (MIMO) */
+    uint8_t harqId;  /**< the HARQ process id */
+  };
+
+  /**
+   * Called by the MAC to notify the RLC of all the transmission
+   * opportunities granted to this RLC instance in the same TTI. The
+   * outcome is the same as calling NotifyTxOpportunity for each of them
+   * in order, but the RLC can share the work among the PDUs.  The
+   * default implementation does just that.
+   *
+   * \param opportunities the transmission opportunities, in order
+   */
+  virtual void NotifyTxOpportunities (const std::vector<TxOpportunityParameters>& opportunities);
+
   /**
    * Called by the MAC to notify the RLC that an HARQ process related
    * to this RLC instance has failed
@@ -72,6 +72,33 @@ class LteMiErrorModel
 
 public:
 
+  /**
+   * \brief the mutual information of every RB of a SINR
+   *
+   * The MI of all the RBs is computed at once, the first time a
+   * modulation is requested, and then shared by all the TBs evaluated
+   * against the same SINR (e.g., all the TBs received in a subframe, or
+   * all the MCSs tried for a CQI).
+   */
+  class MiPerRb
+  {
+  public:
+    /**
+     * \param sinr the perceived sinrs in the whole bandwidth
+     */
+    MiPerRb (const SpectrumValue& sinr);
+
+    /**
+     * \param mcs an MCS
+     * \return the MI of every RB for the modulation of the MCS
+     */
+    const std::vector<double>& Get (uint8_t mcs);
+
+  private:
+    std::vector<double> m_sinr; //!< the sinrs, in linear units
+    std::vector<double> m_mi[3]; //!< the MI of every RB for QPSK, 16-QAM and 64-QAM
+  };
+
   /** 
    * \brief find the mmib (mean mutual information per bit) for different modulations of the specified TB
    * \param sinr the perceived sinrs in the whole bandwidth
@@ -80,6 +107,14 @@ public:
    * \return the mmib
    */
   static double Mib (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs);
+  /**
+   * \brief find the mmib (mean mutual information per bit) of the specified TB
+   * \param mi the MI of every RB
+   * \param map the actives RBs for the TB
+   * \param mcs the MCS of the TB
+   * \return the mmib
+   */
+  static double Mib (MiPerRb& mi, const std::vector<int>& map, uint8_t mcs);
   /** 
    * \brief map the mmib (mean mutual information per bit) for different MCS
    * \param mib mean mutual information per bit of a code-block
@@ -98,7 +133,18 @@ public:
    * \param miHistory  MI of past transmissions (in case of retx)
    * \return the TB error rate and MI
    */
-  static TbStats_t GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, HarqProcessInfoList_t miHistory);
+  static TbStats_t GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory);
+  /**
+   * \brief run the error-model algorithm for the specified TB, reusing
+   * the MI per RB already computed for the other TBs of the same SINR
+   * \param mi the MI of every RB
+   * \param map the actives RBs for the TB
+   * \param size the size in bytes of the TB
+   * \param mcs the MCS of the TB
+   * \param miHistory  MI of past transmissions (in case of retx)
+   * \return the TB error rate and MI
+   */
+  static TbStats_t GetTbDecodificationStats (MiPerRb& mi, const std::vector<int>& map, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory);
   
   /** 
   * \brief run the error-model algorithm for the specified PCFICH+PDCCH channels
@@ -108,9 +154,17 @@ public:
   static double GetPcfichPdcchError (const SpectrumValue& sinr);
 
 
-//private:
-
+private:
 
+  /**
+   * \brief run the error-model algorithm for a TB of known MI
+   * \param tbMi the mmib of the TB
+   * \param size the size in bytes of the TB
+   * \param mcs the MCS of the TB
+   * \param miHistory  MI of past transmissions (in case of retx)
+   * \return the TB error rate and MI
+   */
+  static TbStats_t GetTbDecodificationStats (double tbMi, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory);
 
 };
 
@@ -75,6 +75,8 @@ LteRlcAm::LteRlcAm ()
 
   // Timers
   m_pollRetransmitTimerValue = MilliSeconds (100);
+  m_txOpportunitiesBatch = false;
+  m_pollRetransmitTimerPending = false;
 }
 
 LteRlcAm::~LteRlcAm ()
@@ -163,6 +165,30 @@ LteRlcAm::DoTransmitPdcpPdu (Ptr<Packet> p)
  * MAC SAP
  */
 
+void
+LteRlcAm::DoNotifyTxOpportunities (const std::vector<LteMacSapUser::TxOpportunityParameters>& opportunities)
+{
+  NS_LOG_FUNCTION (this << m_rnti << (uint32_t) m_lcid << opportunities.size ());
+
+  // the PollRetransmit timer is restarted once for all the polled PDUs,
+  // it expires at the same time since the PDUs are sent at the same time
+  m_txOpportunitiesBatch = true;
+  m_pollRetransmitTimerPending = false;
+  for (std::vector<LteMacSapUser::TxOpportunityParameters>::const_iterator it = opportunities.begin ();
+       it != opportunities.end (); ++it)
+    {
+      DoNotifyTxOpportunity (it->bytes, it->layer, it->harqId);
+    }
+  m_txOpportunitiesBatch = false;
+  if (m_pollRetransmitTimerPending)
+    {
+      m_pollRetransmitTimerPending = false;
+      m_pollRetransmitTimer.Cancel ();
+      m_pollRetransmitTimer = Simulator::Schedule (m_pollRetransmitTimerValue,
+                                                   &LteRlcAm::ExpirePollRetransmitTimer, this);
+    }
+}
+
 void
 LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
 {
@@ -336,7 +362,8 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
   NS_LOG_LOGIC ("First SDU size    = " << (*(m_txonBuffer.begin()))->GetSize ());
   NS_LOG_LOGIC ("Next segment size = " << nextSegmentSize);
   NS_LOG_LOGIC ("Remove SDU from TxBuffer");
-  Ptr<Packet> firstSegment = (*(m_txonBuffer.begin ()))->Copy ();
+  // The SDU is only copied if it has to be segmented
+  Ptr<Packet> firstSegment = *(m_txonBuffer.begin ());
   m_txonBufferSize -= (*(m_txonBuffer.begin()))->GetSize ();
   NS_LOG_LOGIC ("txBufferSize      = " << m_txonBufferSize );
   m_txonBuffer.erase (m_txonBuffer.begin ());
@@ -367,6 +394,7 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
           // Note: This is the only place where a PDU is segmented and
           // therefore its status can change
           LteRlcSduStatusTag oldTag, newTag;
+          firstSegment = firstSegment->Copy ();
           firstSegment->RemovePacketTag (oldTag);
           newSegment->RemovePacketTag (newTag);
           if (oldTag.GetStatus () == LteRlcSduStatusTag::FULL_SDU)
@@ -491,7 +519,7 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
           NS_LOG_LOGIC ("        Remove SDU from TxBuffer");
 
           // (more segments)
-          firstSegment = (*(m_txonBuffer.begin ()))->Copy ();
+          firstSegment = *(m_txonBuffer.begin ());
           m_txonBufferSize -= (*(m_txonBuffer.begin()))->GetSize ();
           m_txonBuffer.erase (m_txonBuffer.begin ());
           NS_LOG_LOGIC ("        txBufferSize = " << m_txonBufferSize );
@@ -515,7 +543,7 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
 
   // FIRST SEGMENT
   LteRlcSduStatusTag tag;
-  (*it)->RemovePacketTag (tag);
+  (*it)->PeekPacketTag (tag);
   if ( (tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU) ||
        (tag.GetStatus () == LteRlcSduStatusTag::FIRST_SEGMENT)
      )
@@ -526,7 +554,6 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
     {
       framingInfo |= LteRlcAmHeader::NO_FIRST_BYTE;
     }
-  (*it)->AddPacketTag (tag);
 
   // Add all SDUs (in DataField) to the Packet
   while (it < dataField.end ())
@@ -539,7 +566,7 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
 
   // LAST SEGMENT (Note: There could be only one and be the first one)
   it--;
-  (*it)->RemovePacketTag (tag);
+  (*it)->PeekPacketTag (tag);
   if ( (tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU) ||
         (tag.GetStatus () == LteRlcSduStatusTag::LAST_SEGMENT) )
     {
@@ -549,7 +576,6 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
     {
       framingInfo |= LteRlcAmHeader::NO_LAST_BYTE;
     }
-  (*it)->AddPacketTag (tag);
 
   // Set the FramingInfo flag after the calculation
   rlcAmHeader.SetFramingInfo (framingInfo);
@@ -575,7 +601,13 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
       m_pollSn = m_vtS - 1;
       NS_LOG_LOGIC ("New POLL_SN = " << m_pollSn);
 
-      if (! m_pollRetransmitTimer.IsRunning () )
+      if (m_txOpportunitiesBatch)
+        {
+          NS_LOG_LOGIC ("Restart PollRetransmit timer after the TX opportunities");
+
+          m_pollRetransmitTimerPending = true;
+        }
+      else if (! m_pollRetransmitTimer.IsRunning () )
         {
           NS_LOG_LOGIC ("Start PollRetransmit timer");
 
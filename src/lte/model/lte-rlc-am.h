@@ -27,6 +27,7 @@
 
 #include <vector>
 #include <map>
+#include <deque>
 
 namespace ns3 {
 
@@ -50,6 +51,7 @@ public:
    * MAC SAP
    */
   virtual void DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId);
+  virtual void DoNotifyTxOpportunities (const std::vector<LteMacSapUser::TxOpportunityParameters>& opportunities);
   virtual void DoNotifyHarqDeliveryFailure ();
   virtual void DoReceivePdu (Ptr<Packet> p);
 
@@ -72,7 +74,7 @@ private:
   void DoReportBufferStatus ();
 
 private:
-    std::vector < Ptr<Packet> > m_txonBuffer;       // Transmission buffer
+    std::deque < Ptr<Packet> > m_txonBuffer;        // Transmission buffer
     std::vector < Ptr<Packet> > m_txedBuffer;       // Transmitted packets buffer
 
     struct RetxBuffer
@@ -144,6 +146,13 @@ private:
   EventId m_reorderingTimer;
   EventId m_statusProhibitTimer;
 
+  /**
+   * While the TX opportunities of a TTI are notified together, the
+   * PollRetransmit timer is (re)started once after the last PDU
+   */
+  bool    m_txOpportunitiesBatch;
+  bool    m_pollRetransmitTimerPending;
+
   /**
    * Configurable parameters. See section 7.4 in TS 36.322
    */
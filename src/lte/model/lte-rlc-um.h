@@ -26,6 +26,7 @@
 
 #include <ns3/event-id.h>
 #include <map>
+#include <deque>
 
 namespace ns3 {
 
@@ -49,10 +50,18 @@ public:
    * MAC SAP
    */
   virtual void DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId);
+  virtual void DoNotifyTxOpportunities (const std::vector<LteMacSapUser::TxOpportunityParameters>& opportunities);
   virtual void DoNotifyHarqDeliveryFailure ();
   virtual void DoReceivePdu (Ptr<Packet> p);
 
 private:
+  /**
+   * Build a PDU from the transmission buffer and send it to the MAC
+   *
+   * \returns true if a PDU was sent
+   */
+  bool BuildAndTransmitPdu (uint32_t bytes, uint8_t layer, uint8_t harqId);
+
   void ExpireReorderingTimer (void);
   void ExpireRbsTimer (void);
 
@@ -68,11 +77,12 @@ private:
 private:
   uint32_t m_maxTxBufferSize;
   uint32_t m_txBufferSize;
-  std::vector < Ptr<Packet> > m_txBuffer;       // Transmission buffer
+  std::deque < Ptr<Packet> > m_txBuffer;        // Transmission buffer
   std::map <uint16_t, Ptr<Packet> > m_rxBuffer; // Reception buffer
   std::vector < Ptr<Packet> > m_reasBuffer;     // Reassembling buffer
 
   std::list < Ptr<Packet> > m_sdusBuffer;       // List of SDUs in a packet
+  std::vector < Ptr<Packet> > m_dataField;      // SDUs and segments of the PDU being built
 
   /**
    * State variables. See section 7.1 in TS 36.322
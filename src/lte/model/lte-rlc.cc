@@ -43,6 +43,7 @@ public:
 
   // Interface implemented from LteMacSapUser
   virtual void NotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId);
+  virtual void NotifyTxOpportunities (const std::vector<TxOpportunityParameters>& opportunities);
   virtual void NotifyHarqDeliveryFailure ();
   virtual void ReceivePdu (Ptr<Packet> p);
 
@@ -66,6 +67,12 @@ LteRlcSpecificLteMacSapUser::NotifyTxOpportunity (uint32_t bytes, uint8_t layer,
   m_rlc->DoNotifyTxOpportunity (bytes, layer, harqId);
 }
 
+void
+LteRlcSpecificLteMacSapUser::NotifyTxOpportunities (const std::vector<TxOpportunityParameters>& opportunities)
+{
+  m_rlc->DoNotifyTxOpportunities (opportunities);
+}
+
 void
 LteRlcSpecificLteMacSapUser::NotifyHarqDeliveryFailure ()
 {
@@ -163,6 +170,17 @@ LteRlc::GetLteMacSapUser ()
   return m_macSapUser;
 }
 
+void
+LteRlc::DoNotifyTxOpportunities (const std::vector<LteMacSapUser::TxOpportunityParameters>& opportunities)
+{
+  NS_LOG_FUNCTION (this << opportunities.size ());
+  for (std::vector<LteMacSapUser::TxOpportunityParameters>::const_iterator it = opportunities.begin ();
+       it != opportunities.end (); ++it)
+    {
+      DoNotifyTxOpportunity (it->bytes, it->layer, it->harqId);
+    }
+}
+
 
 
 ////////////////////////////////////////
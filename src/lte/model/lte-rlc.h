@@ -113,6 +113,7 @@ protected:
 
   // Interface forwarded by LteMacSapUser
   virtual void DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId) = 0;
+  virtual void DoNotifyTxOpportunities (const std::vector<LteMacSapUser::TxOpportunityParameters>& opportunities);
   virtual void DoNotifyHarqDeliveryFailure () = 0;
   virtual void DoReceivePdu (Ptr<Packet> p) = 0;
 
@@ -3896,7 +3896,7 @@ RrcConnectionRequestHeader::Print (std::ostream &os) const
 void
 RrcConnectionRequestHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   SerializeUlCcchMessage (1);
 
@@ -3939,6 +3939,7 @@ RrcConnectionRequestHeader::PreSerialize () const
 uint32_t
 RrcConnectionRequestHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<1> dummy;
   std::bitset<0> optionalOrDefaultMask;
   int selectedOption;
@@ -3972,7 +3973,7 @@ RrcConnectionRequestHeader::Deserialize (Buffer::Iterator bIterator)
   // Deserialize spare
   bIterator = DeserializeBitstring (&dummy,bIterator);
 
-  return GetSerializedSize ();
+  return bIterator.GetDistanceFrom (bIteratorStart);
 }
 
 void
@@ -4025,7 +4026,7 @@ RrcConnectionSetupHeader::Print (std::ostream &os) const
 void
 RrcConnectionSetupHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   SerializeDlCcchMessage (3);
 
@@ -4065,6 +4066,7 @@ RrcConnectionSetupHeader::PreSerialize () const
 uint32_t
 RrcConnectionSetupHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   int n;
 
   std::bitset<0> bitset0;
@@ -4121,7 +4123,7 @@ RrcConnectionSetupHeader::Deserialize (Buffer::Iterator bIterator)
             }
         }
     }
-  return GetSerializedSize ();
+  return bIterator.GetDistanceFrom (bIteratorStart);
 }
 
 void
@@ -4196,7 +4198,7 @@ RrcConnectionSetupCompleteHeader::~RrcConnectionSetupCompleteHeader ()
 void
 RrcConnectionSetupCompleteHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   // Serialize DCCH message
   SerializeUlDcchMessage (4);
@@ -4225,6 +4227,7 @@ RrcConnectionSetupCompleteHeader::PreSerialize () const
 uint32_t
 RrcConnectionSetupCompleteHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
 
   bIterator = DeserializeUlDcchMessage (bIterator);
@@ -4259,7 +4262,7 @@ RrcConnectionSetupCompleteHeader::Deserialize (Buffer::Iterator bIterator)
         }
     }
 
-  return GetSerializedSize ();
+  return bIterator.GetDistanceFrom (bIteratorStart);
 }
 
 void
@@ -4302,7 +4305,7 @@ RrcConnectionReconfigurationCompleteHeader::~RrcConnectionReconfigurationComplet
 void
 RrcConnectionReconfigurationCompleteHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   // Serialize DCCH message
   SerializeUlDcchMessage (2);
@@ -4328,6 +4331,7 @@ RrcConnectionReconfigurationCompleteHeader::PreSerialize () const
 uint32_t
 RrcConnectionReconfigurationCompleteHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
   int n;
 
@@ -4350,7 +4354,7 @@ RrcConnectionReconfigurationCompleteHeader::Deserialize (Buffer::Iterator bItera
       // ...
     }
 
-  return GetSerializedSize ();
+  return bIterator.GetDistanceFrom (bIteratorStart);
 }
 
 void
@@ -4393,7 +4397,7 @@ RrcConnectionReconfigurationHeader::~RrcConnectionReconfigurationHeader ()
 void
 RrcConnectionReconfigurationHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   SerializeDlDcchMessage (4);
 
@@ -4535,6 +4539,7 @@ RrcConnectionReconfigurationHeader::PreSerialize () const
 uint32_t
 RrcConnectionReconfigurationHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
 
   bIterator = DeserializeDlDcchMessage (bIterator);
@@ -4722,7 +4727,7 @@ RrcConnectionReconfigurationHeader::Deserialize (Buffer::Iterator bIterator)
         }
     }
 
-  return GetSerializedSize ();
+  return bIterator.GetDistanceFrom (bIteratorStart);
 }
 
 void
@@ -5074,7 +5079,7 @@ HandoverPreparationInfoHeader::HandoverPreparationInfoHeader ()
 void
 HandoverPreparationInfoHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   // Serialize HandoverPreparationInformation sequence:
   // no default or optional fields. Extension marker not present.
@@ -5148,6 +5153,7 @@ HandoverPreparationInfoHeader::PreSerialize () const
 uint32_t
 HandoverPreparationInfoHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
   int n;
 
@@ -5258,7 +5264,7 @@ HandoverPreparationInfoHeader::Deserialize (Buffer::Iterator bIterator)
         }
     }
 
-  return GetSerializedSize ();
+  return bIterator.GetDistanceFrom (bIteratorStart);
 }
 
 void
@@ -5310,7 +5316,7 @@ RrcConnectionReestablishmentRequestHeader::~RrcConnectionReestablishmentRequestH
 void
 RrcConnectionReestablishmentRequestHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   SerializeUlCcchMessage (0);
 
@@ -5361,6 +5367,7 @@ RrcConnectionReestablishmentRequestHeader::PreSerialize () const
 uint32_t
 RrcConnectionReestablishmentRequestHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
   int n;
 
@@ -5422,7 +5429,7 @@ RrcConnectionReestablishmentRequestHeader::Deserialize (Buffer::Iterator bIterat
       bIterator = DeserializeBitstring (&spare,bIterator);
     }
 
-  return GetSerializedSize ();
+  return bIterator.GetDistanceFrom (bIteratorStart);
 }
 
 void
@@ -5476,7 +5483,7 @@ RrcConnectionReestablishmentHeader::~RrcConnectionReestablishmentHeader ()
 void
 RrcConnectionReestablishmentHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   SerializeDlCcchMessage (0);
 
@@ -5510,6 +5517,7 @@ RrcConnectionReestablishmentHeader::PreSerialize () const
 uint32_t
 RrcConnectionReestablishmentHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
   int n;
 
@@ -5555,7 +5563,7 @@ RrcConnectionReestablishmentHeader::Deserialize (Buffer::Iterator bIterator)
         }
     }
 
-  return GetSerializedSize ();
+  return bIterator.GetDistanceFrom (bIteratorStart);
 }
 
 void
@@ -5604,7 +5612,7 @@ RrcConnectionReestablishmentCompleteHeader::RrcConnectionReestablishmentComplete
 void
 RrcConnectionReestablishmentCompleteHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   // Serialize DCCH message
   SerializeUlDcchMessage (3);
@@ -5630,6 +5638,7 @@ RrcConnectionReestablishmentCompleteHeader::PreSerialize () const
 uint32_t
 RrcConnectionReestablishmentCompleteHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
   int n;
 
@@ -5663,7 +5672,7 @@ RrcConnectionReestablishmentCompleteHeader::Deserialize (Buffer::Iterator bItera
         }
     }
 
-  return GetSerializedSize ();
+  return bIterator.GetDistanceFrom (bIteratorStart);
 }
 
 void
@@ -5706,7 +5715,7 @@ RrcConnectionReestablishmentRejectHeader::~RrcConnectionReestablishmentRejectHea
 void
 RrcConnectionReestablishmentRejectHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   // Serialize CCCH message
   SerializeDlCcchMessage (1);
@@ -5729,6 +5738,7 @@ RrcConnectionReestablishmentRejectHeader::PreSerialize () const
 uint32_t
 RrcConnectionReestablishmentRejectHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
 
   bIterator = DeserializeDlCcchMessage (bIterator);
@@ -5757,7 +5767,7 @@ RrcConnectionReestablishmentRejectHeader::Deserialize (Buffer::Iterator bIterato
         }
     }
 
-  return GetSerializedSize ();
+  return bIterator.GetDistanceFrom (bIteratorStart);
 }
 
 void
@@ -5791,7 +5801,7 @@ RrcConnectionReleaseHeader::~RrcConnectionReleaseHeader ()
 void
 RrcConnectionReleaseHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   // Serialize DCCH message
   SerializeDlDcchMessage (5);
@@ -5823,6 +5833,7 @@ RrcConnectionReleaseHeader::PreSerialize () const
 uint32_t
 RrcConnectionReleaseHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
   int n;
 
@@ -5882,7 +5893,7 @@ RrcConnectionReleaseHeader::Deserialize (Buffer::Iterator bIterator)
         }
     }
 
-  return GetSerializedSize ();
+  return bIterator.GetDistanceFrom (bIteratorStart);
 }
 
 void
@@ -5916,7 +5927,7 @@ RrcConnectionRejectHeader::~RrcConnectionRejectHeader ()
 void
 RrcConnectionRejectHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   // Serialize CCCH message
   SerializeDlCcchMessage (2);
@@ -5945,6 +5956,7 @@ RrcConnectionRejectHeader::PreSerialize () const
 uint32_t
 RrcConnectionRejectHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
   int n;
 
@@ -5989,7 +6001,7 @@ RrcConnectionRejectHeader::Deserialize (Buffer::Iterator bIterator)
         }
     }
 
-  return GetSerializedSize ();
+  return bIterator.GetDistanceFrom (bIteratorStart);
 }
 
 void
@@ -6024,7 +6036,7 @@ MeasurementReportHeader::~MeasurementReportHeader ()
 void
 MeasurementReportHeader::PreSerialize () const
 {
-  m_serializationResult = Buffer ();
+  m_serializationResult.clear ();
 
   // Serialize DCCH message
   SerializeUlDcchMessage (1);
@@ -6055,6 +6067,7 @@ MeasurementReportHeader::PreSerialize () const
 uint32_t
 MeasurementReportHeader::Deserialize (Buffer::Iterator bIterator)
 {
+  Buffer::Iterator bIteratorStart = bIterator;
   std::bitset<0> bitset0;
 
   bIterator = DeserializeSequence (&bitset0,false,bIterator);
@@ -6097,7 +6110,7 @@ MeasurementReportHeader::Deserialize (Buffer::Iterator bIterator)
         }
     }
 
-  return GetSerializedSize ();
+  return bIterator.GetDistanceFrom (bIteratorStart);
 }
 
 void
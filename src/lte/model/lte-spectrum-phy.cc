@@ -116,7 +116,8 @@ LteSpectrumPhy::LteSpectrumPhy ()
   : m_state (IDLE),
     m_cellId (0),
   m_transmissionMode (0),
-  m_layersNum (1)
+  m_layersNum (1),
+  m_abstractMode (false)
 {
   NS_LOG_FUNCTION (this);
   m_random = CreateObject<UniformRandomVariable> ();
@@ -213,6 +214,14 @@ LteSpectrumPhy::GetTypeId (void)
                     BooleanValue (true),
                     MakeBooleanAccessor (&LteSpectrumPhy::m_ctrlErrorModelEnabled),
                     MakeBooleanChecker ())
+    .AddAttribute ("AbstractMode",
+                   "If true, the interference is not tracked signal by signal: the SINR "
+                   "of a reception is evaluated once at its end, from the sum of all the "
+                   "signals that started during it (see LteInterference::SetAbstractMode).",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteSpectrumPhy::SetAbstractMode,
+                                        &LteSpectrumPhy::GetAbstractMode),
+                   MakeBooleanChecker ())
     .AddTraceSource ("DlPhyReception",
                      "DL reception PHY layer statistics.",
                      MakeTraceSourceAccessor (&LteSpectrumPhy::m_dlPhyReception))
@@ -297,6 +306,22 @@ LteSpectrumPhy::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd)
 }
 
   
+void
+LteSpectrumPhy::SetAbstractMode (bool abstract)
+{
+  NS_LOG_FUNCTION (this << abstract);
+  m_abstractMode = abstract;
+  m_interferenceData->SetAbstractMode (abstract);
+  m_interferenceCtrl->SetAbstractMode (abstract);
+}
+
+bool
+LteSpectrumPhy::GetAbstractMode () const
+{
+  return m_abstractMode;
+}
+
+  
 void 
 LteSpectrumPhy::Reset ()
 {
@@ -871,6 +896,8 @@ LteSpectrumPhy::EndRxData ()
   NS_LOG_DEBUG (this << " txMode " << (uint16_t)m_transmissionMode << " gain " << m_txModeGain.at (m_transmissionMode));
   NS_ASSERT (m_transmissionMode < m_txModeGain.size ());
   m_sinrPerceived *= m_txModeGain.at (m_transmissionMode);
+  // the MI per RB is shared by all the TBs of the subframe
+  LteMiErrorModel::MiPerRb miPerRb (m_sinrPerceived);
   
   while (itTb!=m_expectedTbs.end ())
     {
@@ -891,7 +918,7 @@ LteSpectrumPhy::EndRxData ()
                   harqInfoList = m_harqPhyModule->GetHarqProcessInfoUl ((*itTb).first.m_rnti, ulHarqId);
                 }
             }
-          TbStats_t tbStats = LteMiErrorModel::GetTbDecodificationStats (m_sinrPerceived, (*itTb).second.rbBitmap, (*itTb).second.size, (*itTb).second.mcs, harqInfoList);
+          TbStats_t tbStats = LteMiErrorModel::GetTbDecodificationStats (miPerRb, (*itTb).second.rbBitmap, (*itTb).second.size, (*itTb).second.mcs, harqInfoList);
           (*itTb).second.mi = tbStats.mi;
           (*itTb).second.corrupt = m_random->GetValue () > tbStats.tbler ? false : true;
           NS_LOG_DEBUG (this << "RNTI " << (*itTb).first.m_rnti << " size " << (*itTb).second.size << " mcs " << (uint32_t)(*itTb).second.mcs << " bitmap " << (*itTb).second.rbBitmap.size () << " layer " << (uint16_t)(*itTb).first.m_layer << " TBLER " << tbStats.tbler << " corrupted " << (*itTb).second.corrupt);
@@ -197,6 +197,17 @@ public:
    */
   void SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd);
 
+  /**
+   * \param abstract whether the SINR of a reception is evaluated only
+   * once, at its end (see LteInterference::SetAbstractMode)
+   */
+  void SetAbstractMode (bool abstract);
+
+  /**
+   * \return whether the SINR of a reception is evaluated only once
+   */
+  bool GetAbstractMode () const;
+
   /** 
    * reset the internal state
    * 
@@ -470,6 +481,8 @@ private:
   uint8_t m_layersNum;
   std::vector <double> m_txModeGain; // duplicate value of LteUePhy
 
+  bool m_abstractMode; // when true, the interference is evaluated once per RX
+
   Ptr<LteHarqPhy> m_harqPhyModule;
   LtePhyDlHarqFeedbackCallback m_ltePhyDlHarqFeedbackCallback;
   LtePhyUlHarqFeedbackCallback m_ltePhyUlHarqFeedbackCallback;
@@ -307,6 +307,7 @@ LteUeMac::DoReportBufferStatus (LteMacSapProvider::ReportBufferStatusParameters
       m_ulBsrReceived.insert (std::pair<uint8_t, LteMacSapProvider::ReportBufferStatusParameters> (params.lcid, params));
     }
   m_freshUlBsr = true;
+  m_uePhySapProvider->RequestSubframeIndication ();
 }
 
 
@@ -776,6 +777,29 @@ LteUeMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
       m_freshUlBsr = false;
       m_harqProcessId = (m_harqProcessId + 1) % HARQ_PERIOD;
     }
+  if (NeedsNextSubframe ())
+    {
+      m_uePhySapProvider->RequestSubframeIndication ();
+    }
+}
+
+bool
+LteUeMac::NeedsNextSubframe (void) const
+{
+  if (m_freshUlBsr)
+    {
+      return true;
+    }
+  for (uint16_t i = 0; i < m_miUlHarqProcessesPacketTimer.size (); i++)
+    {
+      // a buffer is dropped at the subframe after its timer expired
+      if ((m_miUlHarqProcessesPacketTimer.at (i) > 0)
+          || (m_miUlHarqProcessesPacket.at (i)->GetSize () > 0))
+        {
+          return true;
+        }
+    }
+  return false;
 }
 
 int64_t
@@ -112,6 +112,11 @@ private:
   void RaResponseTimeout (bool contention);
   void SendReportBufferStatus (void);
   void RefreshHarqProcessesPacketBuffer (void);
+  /**
+   * \returns true if the MAC has something to do at the next subframe,
+   * i.e., a BSR to send or HARQ processes still buffering packets
+   */
+  bool NeedsNextSubframe (void) const;
 
 private:
 
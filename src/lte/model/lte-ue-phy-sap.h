@@ -60,6 +60,15 @@ public:
    */
   virtual void SendRachPreamble (uint32_t prachId, uint32_t raRnti) = 0;
 
+  /**
+   * Ask the PHY to indicate the next subframe to the MAC. When skipping
+   * the idle subframes, the PHY only indicates the subframes where it
+   * has something to transmit: the MAC calls this method as long as it
+   * has something to do at the next subframe that did not yet reach the
+   * PHY (e.g., a pending BSR or running HARQ timers).
+   */
+  virtual void RequestSubframeIndication () = 0;
+
 };
 
 
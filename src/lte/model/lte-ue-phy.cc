@@ -26,6 +26,7 @@
 #include <cmath>
 #include <ns3/simulator.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
 #include "lte-ue-phy.h"
 #include "lte-enb-phy.h"
 #include "lte-net-device.h"
@@ -73,6 +74,7 @@ public:
   virtual void SendMacPdu (Ptr<Packet> p);
   virtual void SendLteControlMessage (Ptr<LteControlMessage> msg);
   virtual void SendRachPreamble (uint32_t prachId, uint32_t raRnti);
+  virtual void RequestSubframeIndication ();
 
 private:
   LteUePhy* m_phy;
@@ -101,6 +103,12 @@ UeMemberLteUePhySapProvider::SendRachPreamble (uint32_t prachId, uint32_t raRnti
   m_phy->DoSendRachPreamble (prachId, raRnti);
 }
 
+void
+UeMemberLteUePhySapProvider::RequestSubframeIndication ()
+{
+  m_phy->DoRequestSubframeIndication ();
+}
+
 
 ////////////////////////////////////////
 // LteUePhy methods
@@ -140,7 +148,11 @@ LteUePhy::LteUePhy (Ptr<LteSpectrumPhy> dlPhy, Ptr<LteSpectrumPhy> ulPhy)
     m_pssReceived (false),
     m_ueMeasurementsFilterPeriod (MilliSeconds (200)),
     m_ueMeasurementsFilterLast (MilliSeconds (0)),
-    m_rsrpSinrSampleCounter (0)
+    m_rsrpSinrSampleCounter (0),
+    m_skipIdleSubframes (false),
+    m_subframeIndicationRequested (false),
+    m_lastFrameNo (0),
+    m_lastSubframeNo (0)
 {
   m_amc = CreateObject <LteAmc> ();
   m_uePhySapProvider = new UeMemberLteUePhySapProvider (this);
@@ -149,7 +161,7 @@ LteUePhy::LteUePhy (Ptr<LteSpectrumPhy> dlPhy, Ptr<LteSpectrumPhy> ulPhy)
 
   NS_ASSERT_MSG (Simulator::Now ().GetNanoSeconds () == 0,
                  "Cannot create UE devices after simulation started");
-  Simulator::ScheduleNow (&LteUePhy::SubframeIndication, this, 1, 1);
+  m_subframeIndicationEvent = Simulator::ScheduleNow (&LteUePhy::SubframeIndication, this, 1, 1);
   Simulator::Schedule (m_ueMeasurementsFilterPeriod, &LteUePhy::ReportUeMeasurements, this);
 
   DoReset ();
@@ -270,6 +282,26 @@ LteUePhy::GetTypeId (void)
     .AddTraceSource ("StateTransition",
                      "Trace fired upon every UE PHY state transition",
                      MakeTraceSourceAccessor (&LteUePhy::m_stateTransitionTrace))
+    .AddAttribute ("WidebandCqiPeriodicity",
+                   "Periodicity of the wideband (P10) DL CQI reports (default 1 ms, ideal behavior)",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&LteUePhy::m_p10CqiPeriocity),
+                   MakeTimeChecker ())
+    .AddAttribute ("SubbandCqiPeriodicity",
+                   "Periodicity of the subband (A30) DL CQI reports (default 1 ms, ideal behavior)",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&LteUePhy::m_a30CqiPeriocity),
+                   MakeTimeChecker ())
+    .AddAttribute ("SkipIdleSubframes",
+                   "If true, the subframes where the UE is connected but has nothing to "
+                   "transmit are not indicated to the PHY and to the MAC: the next "
+                   "subframe indication is scheduled directly at the next SRS "
+                   "transmission, and is brought back as soon as there is a PDU, a "
+                   "control message or a MAC procedure to serve. The DL reception "
+                   "(and so the CQI generation) is not affected.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteUePhy::m_skipIdleSubframes),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -363,6 +395,7 @@ LteUePhy::DoSendMacPdu (Ptr<Packet> p)
   NS_LOG_FUNCTION (this);
 
   SetMacPdu (p);
+  WakeUp ();
 }
 
 
@@ -706,6 +739,7 @@ LteUePhy::DoSendLteControlMessage (Ptr<LteControlMessage> msg)
   NS_LOG_FUNCTION (this << msg);
 
   SetControlMessages (msg);
+  WakeUp ();
 }
 
 void 
@@ -719,6 +753,15 @@ LteUePhy::DoSendRachPreamble (uint32_t raPreambleId, uint32_t raRnti)
   m_raPreambleId = raPreambleId;
   m_raRnti = raRnti;
   m_controlMessagesQueue.at (0).push_back (msg);
+  WakeUp ();
+}
+
+void
+LteUePhy::DoRequestSubframeIndication ()
+{
+  NS_LOG_FUNCTION (this);
+  m_subframeIndicationRequested = true;
+  WakeUp ();
 }
 
 
@@ -927,6 +970,7 @@ void
 LteUePhy::QueueSubChannelsForTransmission (std::vector <int> rbMap)
 {
   m_subChannelsForTransmissionQueue.at (m_macChTtiDelay - 1) = rbMap;
+  WakeUp ();
 }
 
 
@@ -937,6 +981,10 @@ LteUePhy::SubframeIndication (uint32_t frameNo, uint32_t subframeNo)
 
   NS_ASSERT_MSG (frameNo > 0, "the SRS index check code assumes that frameNo starts at 1");
 
+  m_lastSubframeTime = Simulator::Now ();
+  m_lastFrameNo = frameNo;
+  m_lastSubframeNo = subframeNo;
+
   // refresh internal variables
   m_rsReceivedPowerUpdated = false;
   m_rsInterferencePowerUpdated = false;
@@ -994,18 +1042,98 @@ LteUePhy::SubframeIndication (uint32_t frameNo, uint32_t subframeNo)
     }  // m_configured
   
   // trigger the MAC
+  m_subframeIndicationRequested = false;
   m_uePhySapUser->SubframeIndication (frameNo, subframeNo);
   
   m_subframeNo = subframeNo;
-  ++subframeNo;
-  if (subframeNo > 10)
+  uint32_t skip = 1;
+  if (m_skipIdleSubframes && CanSkipIdleSubframes ())
     {
-      ++frameNo;
-      subframeNo = 1;
+      skip = GetSubframesToNextSrs (frameNo, subframeNo);
+      NS_LOG_LOGIC (this << " UE idle, skipping " << skip - 1 << " subframes");
     }
+  GetSubframeNumbers (skip, frameNo, subframeNo);
   
   // schedule next subframe indication
-  Simulator::Schedule (Seconds (GetTti ()), &LteUePhy::SubframeIndication, this, frameNo, subframeNo);
+  m_subframeIndicationEvent = Simulator::Schedule (Seconds (GetTti ()) * skip, &LteUePhy::SubframeIndication, this, frameNo, subframeNo);
+}
+
+
+bool
+LteUePhy::CanSkipIdleSubframes () const
+{
+  // only a connected UE, whose SRS keep the UL CQI of the eNB up to date
+  if (!m_dlConfigured || !m_ulConfigured || (m_rnti == 0)
+      || !m_srsConfigured || (m_srsStartTime > Simulator::Now ()))
+    {
+      return false;
+    }
+  if (m_subframeIndicationRequested)
+    {
+      return false;
+    }
+  for (uint8_t i = 0; i < m_macChTtiDelay; i++)
+    {
+      if ((m_packetBurstQueue.at (i)->GetNPackets () > 0)
+          || !m_controlMessagesQueue.at (i).empty ()
+          || !m_subChannelsForTransmissionQueue.at (i).empty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+
+uint32_t
+LteUePhy::GetSubframesToNextSrs (uint32_t frameNo, uint32_t subframeNo) const
+{
+  NS_ASSERT (m_srsPeriodicity > 0);
+  // same index as in the SRS check of SubframeIndication
+  uint32_t next = ((frameNo - 1) * 10 + subframeNo) % m_srsPeriodicity;
+  return 1 + (m_srsSubframeOffset + m_srsPeriodicity - next) % m_srsPeriodicity;
+}
+
+
+uint32_t
+LteUePhy::GetSubframesToNextBoundary () const
+{
+  // the next subframe boundary, or the current one if its indication
+  // would still be pending when not skipping
+  int64_t tti = Seconds (GetTti ()).GetTimeStep ();
+  int64_t elapsed = (Simulator::Now () - m_lastSubframeTime).GetTimeStep ();
+  return std::max<int64_t> (1, (elapsed + tti - 1) / tti);
+}
+
+
+void
+LteUePhy::GetSubframeNumbers (uint32_t skip, uint32_t& frameNo, uint32_t& subframeNo) const
+{
+  subframeNo = m_lastSubframeNo + skip;
+  frameNo = m_lastFrameNo + (subframeNo - 1) / 10;
+  subframeNo = (subframeNo - 1) % 10 + 1;
+}
+
+
+void
+LteUePhy::WakeUp ()
+{
+  if (!m_skipIdleSubframes || !m_subframeIndicationEvent.IsRunning ())
+    {
+      return;
+    }
+  uint32_t skip = GetSubframesToNextBoundary ();
+  Time next = m_lastSubframeTime + Seconds (GetTti ()) * skip;
+  if (Simulator::Now () + Simulator::GetDelayLeft (m_subframeIndicationEvent) <= next)
+    {
+      return;
+    }
+  NS_LOG_LOGIC (this << " UE waking up at " << next);
+  uint32_t frameNo;
+  uint32_t subframeNo;
+  GetSubframeNumbers (skip, frameNo, subframeNo);
+  m_subframeIndicationEvent.Cancel ();
+  m_subframeIndicationEvent = Simulator::Schedule (next - Simulator::Now (), &LteUePhy::SubframeIndication, this, frameNo, subframeNo);
 }
 
 
@@ -1059,6 +1187,25 @@ LteUePhy::DoReset ()
   m_downlinkSpectrumPhy->Reset ();
   m_uplinkSpectrumPhy->Reset ();
 
+  if (m_skipIdleSubframes && m_subframeIndicationEvent.IsRunning ())
+    {
+      // the random access following a reset (e.g., at handover) uses the
+      // number of the last subframe indicated to the MAC: indicate the
+      // current one if it was skipped
+      uint32_t skipped = GetSubframesToNextBoundary () - 1;
+      if (skipped > 0)
+        {
+          uint32_t frameNo;
+          uint32_t subframeNo;
+          GetSubframeNumbers (skipped, frameNo, subframeNo);
+          m_lastSubframeTime += Seconds (GetTti ()) * skipped;
+          m_lastFrameNo = frameNo;
+          m_lastSubframeNo = subframeNo;
+          m_uePhySapUser->SubframeIndication (frameNo, subframeNo);
+        }
+      WakeUp ();
+    }
+
 } // end of void LteUePhy::DoReset ()
 
 void
@@ -1097,6 +1244,7 @@ LteUePhy::DoSynchronizeWithEnb (uint16_t cellId)
 
   m_dlConfigured = false;
   m_ulConfigured = false;
+  WakeUp ();
 
   SwitchToState (SYNCHRONIZED);
 }
@@ -1167,6 +1315,7 @@ LteUePhy::DoSetSrsConfigurationIndex (uint16_t srcCi)
   // a guard time is needed for the case where the SRS periodicity is changed dynamically at run time
   // if we use a static one, we can have a 0ms guard time
   m_srsStartTime = Simulator::Now () + MilliSeconds (0);
+  WakeUp ();
   NS_LOG_DEBUG (this << " UE SRS P " << m_srsPeriodicity << " RNTI " << m_rnti << " offset " << m_srsSubframeOffset << " cellId " << m_cellId << " CI " << srcCi);
 }
 
@@ -1252,6 +1401,7 @@ LteUePhy::ReceiveLteDlHarqFeedback (DlInfoListElement_s m)
   Ptr<DlHarqFeedbackLteControlMessage> msg = Create<DlHarqFeedbackLteControlMessage> ();
   msg->SetDlHarqFeedback (m);
   SetControlMessages (msg);
+  WakeUp ();
 }
 
 void
@@ -242,6 +242,41 @@ private:
 
   void QueueSubChannelsForTransmission (std::vector <int> rbMap);
 
+  /**
+   * \returns true if the UE has nothing to transmit before its next SRS
+   * and the MAC did not ask for the next subframe, so that the
+   * indications of the subframes in between can be skipped
+   */
+  bool CanSkipIdleSubframes () const;
+
+  /**
+   * \param frameNo the frame number of the current subframe
+   * \param subframeNo the number of the current subframe
+   * \returns the number of subframes from the current one to the next
+   * subframe where the UE sends its SRS
+   */
+  uint32_t GetSubframesToNextSrs (uint32_t frameNo, uint32_t subframeNo) const;
+
+  /**
+   * \returns the number of subframes from the last indicated subframe
+   * to the next subframe boundary not yet indicated
+   */
+  uint32_t GetSubframesToNextBoundary () const;
+
+  /**
+   * \param skip a number of subframes
+   * \param frameNo the frame number of the subframe \p skip subframes
+   * after the last indicated one
+   * \param subframeNo the number of that subframe
+   */
+  void GetSubframeNumbers (uint32_t skip, uint32_t& frameNo, uint32_t& subframeNo) const;
+
+  /**
+   * Bring back the next subframe indication to the next subframe
+   * boundary, if it was postponed while skipping the idle subframes.
+   */
+  void WakeUp ();
+
   /**
    * \brief Layer-1 filtering of RSRP and RSRQ measurements and reporting to
    *        the RRC entity.
@@ -268,6 +303,7 @@ private:
   virtual void DoSendMacPdu (Ptr<Packet> p);
   virtual void DoSendLteControlMessage (Ptr<LteControlMessage> msg);
   virtual void DoSendRachPreamble (uint32_t prachId, uint32_t raRnti);
+  virtual void DoRequestSubframeIndication ();
 
   std::vector <int> m_subChannelsForTransmission;
   std::vector <int> m_subChannelsForReception;
@@ -360,6 +396,13 @@ private:
 
   EventId m_sendSrsEvent;
 
+  bool m_skipIdleSubframes;
+  bool m_subframeIndicationRequested; ///< the MAC needs the next subframe
+  EventId m_subframeIndicationEvent;
+  Time m_lastSubframeTime;  ///< the start time of the last indicated subframe
+  uint32_t m_lastFrameNo;   ///< the frame number of the last indicated subframe
+  uint32_t m_lastSubframeNo; ///< the number of the last indicated subframe
+
   /**
    * Trace information regarding PHY stats from DL Tx perspective
    * PhyTrasmissionStatParameters  see lte-common.h
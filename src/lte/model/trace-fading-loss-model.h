@@ -26,9 +26,10 @@
 
 #include <ns3/object.h>
 #include <ns3/spectrum-propagation-loss-model.h>
-#include <map>
+#include <ns3/sgi-hashmap.h>
 #include "ns3/random-variable-stream.h"
 #include <ns3/nstime.h>
+#include <ns3/lte-fading-trace.h>
 
 namespace ns3 {
 
@@ -94,27 +95,42 @@ private:
   void LoadTrace ();
 
 
-   
-  mutable std::map <ChannelRealizationId_t, int > m_windowOffsetsMap;
-  
-  mutable std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> > m_startVariableMap;
-  
+
   /**
-   * Vector with fading samples in time domain (for a fixed RB)
+   * The state of the fading window of a channel realization
    */
-  typedef std::vector<double> FadingTraceSample;
+  struct WindowState
+  {
+    int offset; //!< the first sample of the current window
+    Ptr<UniformRandomVariable> startVariable; //!< draws the first sample of the windows
+  };
+
   /**
-   * Vector collecting the time fading traces in the frequency domain (per RB)
+   * Hash function class for ChannelRealizationId_t
    */
-  typedef std::vector<FadingTraceSample> FadingTrace;
+  struct ChannelRealizationIdHash
+  {
+    /**
+     * \param id the channel realization
+     * \return the hash of the channel realization
+     */
+    size_t operator () (const ChannelRealizationId_t &id) const;
+  };
 
+  /**
+   * The windows of the channel realizations
+   */
+  typedef sgi::hash_map<ChannelRealizationId_t, WindowState, ChannelRealizationIdHash> WindowStateMap;
+
+  mutable WindowStateMap m_windowStates;
 
-  
   std::string m_traceFile;
-  
-  FadingTrace m_fadingTrace;
 
-  
+  /**
+   * The fading samples, shared with the other models using the same trace
+   */
+  Ptr<const LteFadingTrace> m_fadingTrace;
+
   Time m_traceLength;
   uint32_t m_samplesNum;
   Time m_windowSize;
@@ -0,0 +1,224 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/config.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/string.h>
+#include <ns3/uinteger.h>
+#include <ns3/nstime.h>
+#include <ns3/node-container.h>
+#include <ns3/net-device-container.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/position-allocator.h>
+#include <ns3/lte-helper.h>
+#include <ns3/lte-enb-net-device.h>
+#include <ns3/lte-ue-net-device.h>
+#include <ns3/lte-enb-phy.h>
+#include <ns3/lte-ue-phy.h>
+#include <ns3/eps-bearer.h>
+
+NS_LOG_COMPONENT_DEFINE ("LteTestAbstractPhy");
+
+using namespace ns3;
+
+/**
+ * Check that the abstract mode of the LteSpectrumPhy does not change
+ * the outcome of a multi-cell simulation where all the signals are
+ * synchronized: the same SINR is reported and the same TBs are sent in
+ * DL and UL.
+ */
+class LteAbstractPhyTestCase : public TestCase
+{
+public:
+  /**
+   * \param nEnbs the number of eNBs, placed on a line
+   * \param nUesPerEnb the number of UEs attached to each eNB
+   */
+  LteAbstractPhyTestCase (uint16_t nEnbs, uint16_t nUesPerEnb);
+  virtual ~LteAbstractPhyTestCase ();
+
+private:
+  static std::string BuildNameString (uint16_t nEnbs, uint16_t nUesPerEnb);
+  virtual void DoRun (void);
+
+  /**
+   * Run the simulation and trace the PHY activity of all the cells.
+   *
+   * \param abstractMode the value of LteSpectrumPhy::AbstractMode
+   * \returns the trace of the PHY activity, sorted as the order of
+   * simultaneous events is not significant
+   */
+  std::string RunSimulation (bool abstractMode);
+
+  void ReportUeSinr (std::string context, uint16_t cellId, uint16_t rnti, double sinr);
+  void ReportCurrentCellRsrpSinr (std::string context, uint16_t cellId, uint16_t rnti, double rsrp, double sinr);
+  void PhyTransmission (std::string context, PhyTransmissionStatParameters params);
+
+  uint16_t m_nEnbs;
+  uint16_t m_nUesPerEnb;
+  std::ostringstream m_trace;
+};
+
+LteAbstractPhyTestCase::LteAbstractPhyTestCase (uint16_t nEnbs, uint16_t nUesPerEnb)
+  : TestCase (BuildNameString (nEnbs, nUesPerEnb)),
+    m_nEnbs (nEnbs),
+    m_nUesPerEnb (nUesPerEnb)
+{
+}
+
+LteAbstractPhyTestCase::~LteAbstractPhyTestCase ()
+{
+}
+
+std::string
+LteAbstractPhyTestCase::BuildNameString (uint16_t nEnbs, uint16_t nUesPerEnb)
+{
+  std::ostringstream oss;
+  oss << "Abstract PHY with " << nEnbs << " eNBs, " << nUesPerEnb << " UEs per eNB";
+  return oss.str ();
+}
+
+void
+LteAbstractPhyTestCase::DoRun (void)
+{
+  std::string expected = RunSimulation (false);
+  std::string trace = RunSimulation (true);
+  NS_TEST_ASSERT_MSG_GT (expected.size (), 0, "no PHY activity traced");
+  NS_TEST_ASSERT_MSG_EQ (trace, expected, "the PHY activity changed in abstract mode");
+}
+
+std::string
+LteAbstractPhyTestCase::RunSimulation (bool abstractMode)
+{
+  Config::Reset ();
+  Config::SetDefault ("ns3::LteSpectrumPhy::AbstractMode", BooleanValue (abstractMode));
+  Config::SetDefault ("ns3::LteEnbRrc::SrsPeriodicity", UintegerValue (20));
+  m_trace.str ("");
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::FriisSpectrumPropagationLossModel"));
+
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (m_nEnbs);
+  ueNodes.Create (m_nEnbs * m_nUesPerEnb);
+
+  // the UEs of each eNB stand between their eNB and the next one, so
+  // that every subframe carries some inter-cell interference
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  for (uint16_t i = 0; i < m_nEnbs; i++)
+    {
+      positionAlloc->Add (Vector (500.0 * i, 0.0, 0.0));
+    }
+  for (uint16_t i = 0; i < m_nEnbs; i++)
+    {
+      for (uint16_t j = 0; j < m_nUesPerEnb; j++)
+        {
+          positionAlloc->Add (Vector (500.0 * i + 50.0 * (j + 1), 10.0 * j, 0.0));
+        }
+    }
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  // the same random access in both runs
+  int64_t stream = lteHelper->AssignStreams (enbDevs, 1);
+  lteHelper->AssignStreams (ueDevs, stream + 1);
+  for (uint16_t i = 0; i < m_nEnbs; i++)
+    {
+      for (uint16_t j = 0; j < m_nUesPerEnb; j++)
+        {
+          lteHelper->Attach (ueDevs.Get (i * m_nUesPerEnb + j), enbDevs.Get (i));
+        }
+    }
+  lteHelper->ActivateDataRadioBearer (ueDevs, EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+
+  Config::Connect ("/NodeList/*/DeviceList/*/LteEnbPhy/ReportUeSinr",
+                   MakeCallback (&LteAbstractPhyTestCase::ReportUeSinr, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/LteEnbPhy/DlPhyTransmission",
+                   MakeCallback (&LteAbstractPhyTestCase::PhyTransmission, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/LteUePhy/UlPhyTransmission",
+                   MakeCallback (&LteAbstractPhyTestCase::PhyTransmission, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/LteUePhy/ReportCurrentCellRsrpSinr",
+                   MakeCallback (&LteAbstractPhyTestCase::ReportCurrentCellRsrpSinr, this));
+
+  Simulator::Stop (Seconds (0.3));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  Config::Reset ();
+
+  std::vector<std::string> lines;
+  std::istringstream iss (m_trace.str ());
+  std::string line;
+  while (std::getline (iss, line))
+    {
+      lines.push_back (line);
+    }
+  std::sort (lines.begin (), lines.end ());
+  std::ostringstream trace;
+  for (std::vector<std::string>::const_iterator it = lines.begin (); it != lines.end (); ++it)
+    {
+      trace << *it << "\n";
+    }
+  return trace.str ();
+}
+
+void
+LteAbstractPhyTestCase::ReportUeSinr (std::string context, uint16_t cellId, uint16_t rnti, double sinr)
+{
+  m_trace << Simulator::Now ().GetNanoSeconds () << " ul-sinr " << cellId << " " << rnti << " " << sinr << "\n";
+}
+
+void
+LteAbstractPhyTestCase::ReportCurrentCellRsrpSinr (std::string context, uint16_t cellId, uint16_t rnti, double rsrp, double sinr)
+{
+  m_trace << Simulator::Now ().GetNanoSeconds () << " dl-sinr " << cellId << " " << rnti << " " << sinr << "\n";
+}
+
+void
+LteAbstractPhyTestCase::PhyTransmission (std::string context, PhyTransmissionStatParameters params)
+{
+  m_trace << Simulator::Now ().GetNanoSeconds () << " " << context << " " << params.m_cellId
+          << " " << params.m_rnti << " " << (uint16_t) params.m_mcs << " " << params.m_size << "\n";
+}
+
+
+class LteAbstractPhyTestSuite : public TestSuite
+{
+public:
+  LteAbstractPhyTestSuite ();
+};
+
+LteAbstractPhyTestSuite::LteAbstractPhyTestSuite ()
+  : TestSuite ("lte-abstract-phy", SYSTEM)
+{
+  AddTestCase (new LteAbstractPhyTestCase (1, 2), TestCase::QUICK);
+  AddTestCase (new LteAbstractPhyTestCase (3, 2), TestCase::QUICK);
+}
+
+static LteAbstractPhyTestSuite g_lteAbstractPhyTestSuite;
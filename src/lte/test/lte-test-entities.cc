@@ -460,6 +460,29 @@ LteTestMac::SendTxOpportunity (Time time, uint32_t bytes)
   }
 }
 
+void
+LteTestMac::SendTxOpportunities (Time time, std::vector<uint32_t> bytes)
+{
+  NS_LOG_FUNCTION (this << time << bytes.size ());
+  Simulator::Schedule (time, &LteTestMac::DoSendTxOpportunities, this, bytes);
+}
+
+void
+LteTestMac::DoSendTxOpportunities (std::vector<uint32_t> bytes)
+{
+  NS_LOG_FUNCTION (this << bytes.size ());
+  std::vector<LteMacSapUser::TxOpportunityParameters> opportunities;
+  for (uint32_t i = 0; i < bytes.size (); i++)
+    {
+      LteMacSapUser::TxOpportunityParameters opportunity;
+      opportunity.bytes = bytes.at (i);
+      opportunity.layer = i;
+      opportunity.harqId = 0;
+      opportunities.push_back (opportunity);
+    }
+  m_macSapUser->NotifyTxOpportunities (opportunities);
+}
+
 void
 LteTestMac::SetPdcpHeaderPresent (bool present)
 {
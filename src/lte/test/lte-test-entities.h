@@ -169,6 +169,11 @@ class LteTestMac : public Object
     void SetDevice (Ptr<NetDevice> device);
 
     void SendTxOpportunity (Time, uint32_t);
+    /**
+     * Notify the RLC of several transmission opportunities at once, as
+     * the eNB MAC does for the layers of a TTI
+     */
+    void SendTxOpportunities (Time, std::vector<uint32_t>);
     std::string GetDataReceived (void);
 
     bool Receive (Ptr<NetDevice> nd, Ptr<const Packet> p, uint16_t protocol, const Address& addr);
@@ -226,6 +231,8 @@ class LteTestMac : public Object
     uint32_t GetRxBytes (void);
 
   private:
+    void DoSendTxOpportunities (std::vector<uint32_t> bytes);
+
     // forwarded from LteMacSapProvider
     void DoTransmitPdu (LteMacSapProvider::TransmitPduParameters);
     void DoReportBufferStatus (LteMacSapProvider::ReportBufferStatusParameters);
@@ -0,0 +1,137 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <string>
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/lte-fading-trace.h"
+
+NS_LOG_COMPONENT_DEFINE ("LteTestFadingTrace");
+
+using namespace ns3;
+
+/**
+ * Write the same trace in the text and binary formats, and check that
+ * both are loaded with the same samples and shared between their users.
+ */
+class LteFadingTraceTestCase : public TestCase
+{
+public:
+  LteFadingTraceTestCase ();
+  virtual ~LteFadingTraceTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param rb index of a RB
+   * \param sample index of a sample
+   * \returns the sample of the trace written by the test
+   */
+  static double Sample (uint32_t rb, uint32_t sample);
+};
+
+LteFadingTraceTestCase::LteFadingTraceTestCase ()
+  : TestCase ("Check the text and binary fading traces")
+{
+}
+
+LteFadingTraceTestCase::~LteFadingTraceTestCase ()
+{
+}
+
+double
+LteFadingTraceTestCase::Sample (uint32_t rb, uint32_t sample)
+{
+  return -0.25 * rb + 0.125 * sample - 3;
+}
+
+void
+LteFadingTraceTestCase::DoRun (void)
+{
+  const uint32_t rbNum = 6;
+  const uint32_t samplesNum = 40;
+
+  std::string textFile = CreateTempDirFilename ("trace.fad");
+  std::ofstream text (textFile.c_str ());
+  for (uint32_t rb = 0; rb < rbNum; rb++)
+    {
+      for (uint32_t j = 0; j < samplesNum; j++)
+        {
+          text << Sample (rb, j) << " ";
+        }
+      text << "\n";
+    }
+  text.close ();
+
+  // the layout written by fading-trace-converter.py
+  std::string binaryFile = CreateTempDirFilename ("trace.fadb");
+  std::ofstream binary (binaryFile.c_str (), std::ios_base::out | std::ios_base::binary);
+  uint32_t header[4] = { 0x01020304, rbNum, samplesNum, 0 };
+  binary.write ("NS3FAD01", 8);
+  binary.write (reinterpret_cast<const char *> (header), sizeof (header));
+  for (uint32_t rb = 0; rb < rbNum; rb++)
+    {
+      for (uint32_t j = 0; j < samplesNum; j++)
+        {
+          double sample = Sample (rb, j);
+          binary.write (reinterpret_cast<const char *> (&sample), sizeof (sample));
+        }
+    }
+  binary.close ();
+
+  Ptr<const LteFadingTrace> fromText = LteFadingTrace::Get (textFile, rbNum, samplesNum);
+  Ptr<const LteFadingTrace> fromBinary = LteFadingTrace::Get (binaryFile, rbNum, samplesNum);
+  // a subset of the RBs and samples
+  Ptr<const LteFadingTrace> partial = LteFadingTrace::Get (binaryFile, rbNum - 1, samplesNum / 2);
+  NS_TEST_ASSERT_MSG_EQ (fromText->IsBinary (), false, "text trace loaded as binary");
+  NS_TEST_ASSERT_MSG_EQ (fromBinary->IsBinary (), true, "binary trace not detected");
+  for (uint32_t rb = 0; rb < rbNum; rb++)
+    {
+      for (uint32_t j = 0; j < samplesNum; j++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (fromText->GetSample (rb, j), Sample (rb, j), "wrong text sample " << rb << " " << j);
+          NS_TEST_ASSERT_MSG_EQ (fromBinary->GetSample (rb, j), Sample (rb, j), "wrong binary sample " << rb << " " << j);
+          if (rb < rbNum - 1 && j < samplesNum / 2)
+            {
+              NS_TEST_ASSERT_MSG_EQ (partial->GetSample (rb, j), Sample (rb, j), "wrong partial sample " << rb << " " << j);
+            }
+        }
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (LteFadingTrace::Get (textFile, rbNum, samplesNum), fromText, "text trace loaded twice");
+  NS_TEST_ASSERT_MSG_EQ (LteFadingTrace::Get (binaryFile, rbNum, samplesNum), fromBinary, "binary trace loaded twice");
+  // a trace released by all its users is loaded again
+  partial = 0;
+  partial = LteFadingTrace::Get (binaryFile, rbNum - 1, samplesNum / 2);
+  NS_TEST_ASSERT_MSG_EQ (partial->GetSample (rbNum - 2, 3), Sample (rbNum - 2, 3), "wrong sample after reloading");
+}
+
+class LteFadingTraceTestSuite : public TestSuite
+{
+public:
+  LteFadingTraceTestSuite ();
+};
+
+LteFadingTraceTestSuite::LteFadingTraceTestSuite ()
+  : TestSuite ("lte-fading-trace", UNIT)
+{
+  AddTestCase (new LteFadingTraceTestCase (), TestCase::QUICK);
+}
+
+static LteFadingTraceTestSuite g_lteFadingTraceTestSuite;
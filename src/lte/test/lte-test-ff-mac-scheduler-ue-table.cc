@@ -0,0 +1,443 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ctime>
+#include <iostream>
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/object-factory.h"
+#include "ns3/ff-mac-scheduler.h"
+#include "ns3/ff-mac-csched-sap.h"
+#include "ns3/ff-mac-sched-sap.h"
+#include "ns3/ff-mac-scheduler-ue-table.h"
+#include "ns3/ff-mac-scheduler-harq.h"
+
+NS_LOG_COMPONENT_DEFINE ("LteTestFfMacSchedulerUeTable");
+
+using namespace ns3;
+
+namespace {
+
+/**
+ * The CSCHED SAP user of the benchmark: ignore the confirmations.
+ */
+class BenchCschedSapUser : public FfMacCschedSapUser
+{
+public:
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params) {}
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params) {}
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params) {}
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params) {}
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params) {}
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params) {}
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params) {}
+};
+
+/**
+ * The SCHED SAP user of the benchmark: acknowledge all the DL TBs
+ * scheduled, as a MAC would when they are received, and keep a
+ * checksum of the allocations.
+ */
+class BenchSchedSapUser : public FfMacSchedSapUser
+{
+public:
+  BenchSchedSapUser ()
+    : m_checksum (0)
+  {
+  }
+
+  virtual void SchedDlConfigInd (const struct SchedDlConfigIndParameters& params)
+  {
+    for (uint32_t i = 0; i < params.m_buildDataList.size (); i++)
+      {
+        const DlDciListElement_s &dci = params.m_buildDataList.at (i).m_dci;
+        DlInfoListElement_s ack;
+        ack.m_rnti = dci.m_rnti;
+        ack.m_harqProcessId = dci.m_harqProcess;
+        ack.m_harqStatus.resize (dci.m_ndi.size (), DlInfoListElement_s::ACK);
+        m_acks.push_back (ack);
+        m_checksum = m_checksum * 31 + dci.m_rnti * 65599 + dci.m_rbBitmap;
+      }
+  }
+
+  virtual void SchedUlConfigInd (const struct SchedUlConfigIndParameters& params)
+  {
+    for (uint32_t i = 0; i < params.m_dciList.size (); i++)
+      {
+        const UlDciListElement_s &dci = params.m_dciList.at (i);
+        m_checksum = m_checksum * 31 + dci.m_rnti * 65599 + dci.m_rbStart * 257 + dci.m_rbLen;
+      }
+  }
+
+  std::vector<DlInfoListElement_s> m_acks;  //!< the DL TBs to acknowledge
+  uint64_t m_checksum;                      //!< checksum of the allocations
+};
+
+} // anonymous namespace
+
+
+/**
+ * Check the snapshot of the UEs state against the maps of a scheduler.
+ */
+class LteFfMacSchedulerUeTableTestCase : public TestCase
+{
+public:
+  LteFfMacSchedulerUeTableTestCase ();
+  virtual ~LteFfMacSchedulerUeTableTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteFfMacSchedulerUeTableTestCase::LteFfMacSchedulerUeTableTestCase ()
+  : TestCase ("Check the per-UE table of the FF MAC schedulers")
+{
+}
+
+LteFfMacSchedulerUeTableTestCase::~LteFfMacSchedulerUeTableTestCase ()
+{
+}
+
+void
+LteFfMacSchedulerUeTableTestCase::DoRun (void)
+{
+  FfMacSchedulerUeTable::RlcBufferReqMap_t rlcBufferReq;
+  FfMacSchedulerHarq harq;
+  std::map <uint16_t, uint8_t> txModes;
+  for (uint16_t rnti = 1; rnti <= 20; rnti++)
+    {
+      // RNTI % 4 LCs, each one with data in a different queue but the first
+      for (uint8_t lcId = 1; lcId <= rnti % 4; lcId++)
+        {
+          FfMacSchedSapProvider::SchedDlRlcBufferReqParameters params;
+          params.m_rnti = rnti;
+          params.m_logicalChannelIdentity = lcId;
+          params.m_rlcTransmissionQueueSize = (lcId == 2) ? 100 : 0;
+          params.m_rlcRetransmissionQueueSize = (lcId == 3) ? 100 : 0;
+          params.m_rlcStatusPduSize = (lcId == 4) ? 10 : 0;
+          rlcBufferReq.insert (std::make_pair (LteFlowId_t (rnti, lcId), params));
+        }
+      harq.AddUe (rnti);
+      // every third UE has all its HARQ processes busy
+      DlHarqProcessesStatus_t &status = harq.GetDlStatus (rnti);
+      status.assign (HARQ_PROC_NUM, (rnti % 3 == 0) ? 1 : 0);
+      status.at (rnti % HARQ_PROC_NUM) = 1;
+      txModes[rnti] = rnti % 3;
+    }
+
+  FfMacSchedulerUeTable table;
+  table.Update (rlcBufferReq, harq, txModes);
+  for (uint16_t rnti = 1; rnti <= 20; rnti++)
+    {
+      uint16_t lcs = (rnti % 4 > 1) ? rnti % 4 - 1 : 0;
+      NS_TEST_ASSERT_MSG_EQ (table.GetActiveLcs (rnti), lcs, "wrong active LCs of RNTI " << rnti);
+      NS_TEST_ASSERT_MSG_EQ (FfMacSchedulerUeTable::CountActiveLcs (rlcBufferReq, rnti), lcs, "wrong count of the active LCs of RNTI " << rnti);
+      NS_TEST_ASSERT_MSG_EQ (table.IsDlHarqProcessAvailable (rnti), (rnti % 3 != 0), "wrong HARQ availability of RNTI " << rnti);
+      NS_TEST_ASSERT_MSG_EQ (table.GetLayers (rnti), ((rnti % 3 == 2) ? 2 : 1), "wrong layers of RNTI " << rnti);
+
+      FfMacSchedulerUeTable::RlcBufferReqMap_t::iterator it = FfMacSchedulerUeTable::FindFirstFlow (rlcBufferReq, rnti);
+      if (rnti % 4 == 0)
+        {
+          // no flow: the first flow of the next UE, if any
+          uint16_t next = (it == rlcBufferReq.end ()) ? 0 : it->first.m_rnti;
+          NS_TEST_ASSERT_MSG_EQ (next, ((rnti < 20) ? rnti + 1 : 0), "wrong flow after RNTI " << rnti);
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (it->first.m_rnti, rnti, "wrong first flow of RNTI " << rnti);
+          NS_TEST_ASSERT_MSG_EQ ((uint16_t) it->first.m_lcId, 1, "wrong first LC of RNTI " << rnti);
+        }
+    }
+  // a UE without any state
+  NS_TEST_ASSERT_MSG_EQ (table.GetActiveLcs (1000), 0, "active LCs for an unknown RNTI");
+}
+
+/**
+ * Check the bookkeeping of the HARQ processes shared by the schedulers.
+ */
+class LteFfMacSchedulerHarqTestCase : public TestCase
+{
+public:
+  LteFfMacSchedulerHarqTestCase ();
+  virtual ~LteFfMacSchedulerHarqTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteFfMacSchedulerHarqTestCase::LteFfMacSchedulerHarqTestCase ()
+  : TestCase ("Check the HARQ processes of the FF MAC schedulers")
+{
+}
+
+LteFfMacSchedulerHarqTestCase::~LteFfMacSchedulerHarqTestCase ()
+{
+}
+
+void
+LteFfMacSchedulerHarqTestCase::DoRun (void)
+{
+  FfMacSchedulerHarq harq;
+  harq.AddUe (1);
+  harq.AddUe (5);
+  NS_TEST_ASSERT_MSG_EQ (harq.HasUe (1), true, "RNTI 1 was added");
+  NS_TEST_ASSERT_MSG_EQ (harq.HasUe (3), false, "RNTI 3 was not added");
+  NS_TEST_ASSERT_MSG_EQ (harq.HasUe (1000), false, "RNTI 1000 was not added");
+
+  // the DL processes are taken in turn, starting after the current one
+  for (uint8_t i = 1; i < HARQ_PROC_NUM; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (harq.IsDlProcessAvailable (1), true, "free DL process expected");
+      NS_TEST_ASSERT_MSG_EQ ((uint16_t) harq.UpdateDlProcessId (1), (uint16_t) i, "wrong DL process");
+    }
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) harq.UpdateDlProcessId (1), 0, "wrong last DL process");
+  NS_TEST_ASSERT_MSG_EQ (harq.IsDlProcessAvailable (1), false, "all the DL processes are busy");
+  NS_TEST_ASSERT_MSG_EQ (harq.IsDlProcessAvailable (5), true, "the other UE is not affected");
+
+  // a process freed by an ACK is the next one taken
+  harq.GetDlStatus (1).at (3) = 0;
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) harq.UpdateDlProcessId (1), 3, "the freed DL process expected");
+
+  // the processes are freed when their timer expires
+  harq.GetDlTimers (1).at (2) = HARQ_DL_TIMEOUT - 1;
+  harq.RefreshDlProcesses ();
+  NS_TEST_ASSERT_MSG_EQ (harq.IsDlProcessAvailable (1), false, "DL process 2 did not time out yet");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) harq.GetDlTimers (1).at (2), HARQ_DL_TIMEOUT, "wrong timer");
+  harq.RefreshDlProcesses ();
+  NS_TEST_ASSERT_MSG_EQ (harq.IsDlProcessAvailable (1), true, "DL process 2 timed out");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) harq.GetDlStatus (1).at (2), 0, "DL process 2 is free");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) harq.GetDlTimers (1).at (2), 0, "the timer of DL process 2 is reset");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) harq.GetDlTimers (5).at (0), 2, "the timers of the other UE advance");
+
+  // the UL processes of all the UEs advance together
+  for (uint8_t i = 0; i < HARQ_PROC_NUM + 2; i++)
+    {
+      harq.UpdateUlProcessIds ();
+    }
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) harq.GetUlProcessId (1), 2, "wrong UL process of RNTI 1");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) harq.GetUlProcessId (5), 2, "wrong UL process of RNTI 5");
+
+  // a released RNTI starts again with free processes
+  harq.RemoveUe (1);
+  NS_TEST_ASSERT_MSG_EQ (harq.HasUe (1), false, "RNTI 1 was removed");
+  NS_TEST_ASSERT_MSG_EQ (harq.HasUe (5), true, "RNTI 5 was not removed");
+  harq.UpdateUlProcessIds ();
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) harq.GetUlProcessId (5), 3, "wrong UL process of RNTI 5");
+  harq.AddUe (1);
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) harq.GetUlProcessId (1), 0, "wrong UL process of a new RNTI 1");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) harq.UpdateDlProcessId (1), 1, "wrong DL process of a new RNTI 1");
+  NS_TEST_ASSERT_MSG_EQ (harq.GetDlRlcPdus (1).size (), 2, "the RLC PDUs of two layers expected");
+  NS_TEST_ASSERT_MSG_EQ (harq.GetDlRlcPdus (1).at (0).size (), HARQ_PROC_NUM, "the RLC PDUs of each process expected");
+}
+
+class LteFfMacSchedulerUeTableTestSuite : public TestSuite
+{
+public:
+  LteFfMacSchedulerUeTableTestSuite ();
+};
+
+LteFfMacSchedulerUeTableTestSuite::LteFfMacSchedulerUeTableTestSuite ()
+  : TestSuite ("lte-ff-mac-scheduler-ue-table", UNIT)
+{
+  AddTestCase (new LteFfMacSchedulerUeTableTestCase (), TestCase::QUICK);
+  AddTestCase (new LteFfMacSchedulerHarqTestCase (), TestCase::QUICK);
+}
+
+static LteFfMacSchedulerUeTableTestSuite g_lteFfMacSchedulerUeTableTestSuite;
+
+
+/**
+ * Measure the time spent by a scheduler in the DL and UL scheduling of
+ * a cell of 100 RBs, with many UEs having data to transmit in both
+ * directions.
+ */
+class LteFfMacSchedulerPerfTestCase : public TestCase
+{
+public:
+  /**
+   * \param scheduler the TypeId name of the scheduler
+   * \param nUes the number of UEs of the cell
+   */
+  LteFfMacSchedulerPerfTestCase (std::string scheduler, uint16_t nUes);
+  virtual ~LteFfMacSchedulerPerfTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  std::string m_scheduler;  //!< the TypeId name of the scheduler
+  uint16_t m_nUes;          //!< the number of UEs
+
+  enum { TTIS = 500 };
+};
+
+LteFfMacSchedulerPerfTestCase::LteFfMacSchedulerPerfTestCase (std::string scheduler, uint16_t nUes)
+  : TestCase ("Scheduling time of " + scheduler),
+    m_scheduler (scheduler),
+    m_nUes (nUes)
+{
+}
+
+LteFfMacSchedulerPerfTestCase::~LteFfMacSchedulerPerfTestCase ()
+{
+}
+
+void
+LteFfMacSchedulerPerfTestCase::DoRun (void)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (m_scheduler);
+  Ptr<FfMacScheduler> scheduler = factory.Create<FfMacScheduler> ();
+  BenchCschedSapUser cschedSapUser;
+  BenchSchedSapUser schedSapUser;
+  scheduler->SetFfMacCschedSapUser (&cschedSapUser);
+  scheduler->SetFfMacSchedSapUser (&schedSapUser);
+  FfMacCschedSapProvider *csched = scheduler->GetFfMacCschedSapProvider ();
+  FfMacSchedSapProvider *sched = scheduler->GetFfMacSchedSapProvider ();
+
+  FfMacCschedSapProvider::CschedCellConfigReqParameters cellConfig;
+  cellConfig.m_dlBandwidth = 100;
+  cellConfig.m_ulBandwidth = 100;
+  csched->CschedCellConfigReq (cellConfig);
+
+  for (uint16_t rnti = 1; rnti <= m_nUes; rnti++)
+    {
+      FfMacCschedSapProvider::CschedUeConfigReqParameters ueConfig;
+      ueConfig.m_rnti = rnti;
+      ueConfig.m_reconfigureFlag = false;
+      ueConfig.m_transmissionMode = 0;
+      csched->CschedUeConfigReq (ueConfig);
+
+      FfMacCschedSapProvider::CschedLcConfigReqParameters lcConfig;
+      lcConfig.m_rnti = rnti;
+      lcConfig.m_reconfigureFlag = false;
+      LogicalChannelConfigListElement_s lc;
+      lc.m_logicalChannelIdentity = 3;
+      lc.m_logicalChannelGroup = 1;
+      lc.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+      lc.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lc.m_qci = 9;
+      lc.m_eRabMaximulBitrateUl = 1000000;
+      lc.m_eRabMaximulBitrateDl = 1000000;
+      lc.m_eRabGuaranteedBitrateUl = 100000;
+      lc.m_eRabGuaranteedBitrateDl = 100000;
+      lcConfig.m_logicalChannelConfigList.push_back (lc);
+      csched->CschedLcConfigReq (lcConfig);
+    }
+
+  clock_t start = clock ();
+  for (uint32_t tti = 0; tti < TTIS; tti++)
+    {
+      uint16_t sfnSf = (((tti / 10) % 1024) << 4) | (tti % 10);
+      if (tti % 10 == 0)
+        {
+          // refresh the buffer status and the CQIs of all the UEs
+          FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsrs;
+          bsrs.m_sfnSf = sfnSf;
+          FfMacSchedSapProvider::SchedDlCqiInfoReqParameters cqis;
+          cqis.m_sfnSf = sfnSf;
+          for (uint16_t rnti = 1; rnti <= m_nUes; rnti++)
+            {
+              MacCeListElement_s bsr;
+              bsr.m_rnti = rnti;
+              bsr.m_macCeType = MacCeListElement_s::BSR;
+              bsr.m_macCeValue.m_bufferStatus.resize (4, 0);
+              bsr.m_macCeValue.m_bufferStatus.at (0) = 40;
+              bsrs.m_macCeList.push_back (bsr);
+
+              CqiListElement_s cqi;
+              cqi.m_rnti = rnti;
+              cqi.m_ri = 1;
+              cqi.m_wbPmi = 0;
+              cqi.m_cqiType = (tti % 20 == 0) ? CqiListElement_s::A30 : CqiListElement_s::P10;
+              cqi.m_wbCqi.push_back (1 + (rnti * 7 + tti) % 15);
+              for (uint32_t rbg = 0; rbg < 25; rbg++)
+                {
+                  HigherLayerSelected_s sb;
+                  sb.m_sbPmi = 0;
+                  sb.m_sbCqi.push_back (1 + (rnti * 7 + rbg * 3 + tti) % 15);
+                  cqi.m_sbMeasResult.m_higherLayerSelected.push_back (sb);
+                }
+              cqis.m_cqiList.push_back (cqi);
+            }
+          sched->SchedUlMacCtrlInfoReq (bsrs);
+          sched->SchedDlCqiInfoReq (cqis);
+        }
+      for (uint16_t rnti = 1; rnti <= m_nUes; rnti++)
+        {
+          FfMacSchedSapProvider::SchedDlRlcBufferReqParameters rlc;
+          rlc.m_rnti = rnti;
+          rlc.m_logicalChannelIdentity = 3;
+          rlc.m_rlcTransmissionQueueSize = 100000;
+          rlc.m_rlcTransmissionQueueHolDelay = 0;
+          rlc.m_rlcRetransmissionQueueSize = 0;
+          rlc.m_rlcRetransmissionHolDelay = 0;
+          rlc.m_rlcStatusPduSize = 0;
+          sched->SchedDlRlcBufferReq (rlc);
+        }
+
+      FfMacSchedSapProvider::SchedDlTriggerReqParameters dlTrigger;
+      dlTrigger.m_sfnSf = sfnSf;
+      dlTrigger.m_dlInfoList.swap (schedSapUser.m_acks);
+      sched->SchedDlTriggerReq (dlTrigger);
+
+      FfMacSchedSapProvider::SchedUlTriggerReqParameters ulTrigger;
+      ulTrigger.m_sfnSf = sfnSf;
+      sched->SchedUlTriggerReq (ulTrigger);
+    }
+  clock_t delta = clock () - start;
+
+  double per = 1E6 * double (delta) / (TTIS * double (CLOCKS_PER_SEC));
+  std::cout << m_scheduler << ": " << m_nUes << " UEs: "
+            << "ticks: " << delta
+            << "\tper: " << per
+            << " microsec/TTI"
+            << "\tchecksum: " << std::hex << schedSapUser.m_checksum << std::dec
+            << std::endl;
+
+  scheduler->Dispose ();
+}
+
+class LteFfMacSchedulerPerfTestSuite : public TestSuite
+{
+public:
+  LteFfMacSchedulerPerfTestSuite ();
+};
+
+LteFfMacSchedulerPerfTestSuite::LteFfMacSchedulerPerfTestSuite ()
+  : TestSuite ("lte-ff-mac-scheduler-perf", PERFORMANCE)
+{
+  const char *schedulers[] = {
+    "ns3::RrFfMacScheduler",
+    "ns3::PfFfMacScheduler",
+    "ns3::FdMtFfMacScheduler",
+    "ns3::TdMtFfMacScheduler",
+    "ns3::TtaFfMacScheduler",
+    "ns3::FdBetFfMacScheduler",
+    "ns3::TdBetFfMacScheduler",
+    "ns3::FdTbfqFfMacScheduler",
+    "ns3::TdTbfqFfMacScheduler",
+    "ns3::PssFfMacScheduler",
+    "ns3::CqaFfMacScheduler"
+  };
+  for (uint32_t i = 0; i < sizeof (schedulers) / sizeof (schedulers[0]); i++)
+    {
+      AddTestCase (new LteFfMacSchedulerPerfTestCase (schedulers[i], 50), TestCase::QUICK);
+      AddTestCase (new LteFfMacSchedulerPerfTestCase (schedulers[i], 250), TestCase::QUICK);
+    }
+}
+
+static LteFfMacSchedulerPerfTestSuite g_lteFfMacSchedulerPerfTestSuite;
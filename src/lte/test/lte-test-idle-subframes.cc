@@ -0,0 +1,234 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/config.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/string.h>
+#include <ns3/uinteger.h>
+#include <ns3/nstime.h>
+#include <ns3/node-container.h>
+#include <ns3/net-device-container.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/lte-helper.h>
+#include <ns3/lte-enb-net-device.h>
+#include <ns3/lte-ue-net-device.h>
+#include <ns3/lte-enb-phy.h>
+#include <ns3/lte-ue-phy.h>
+#include <ns3/eps-bearer.h>
+
+NS_LOG_COMPONENT_DEFINE ("LteTestIdleSubframes");
+
+using namespace ns3;
+
+/**
+ * Check that skipping the idle subframes of the UEs does not change the
+ * outcome of a simulation: the same SRS and PUSCH are received by the
+ * eNB at the same time, and the same TBs are sent in DL and UL.
+ *
+ * The only expected difference is the order of the events of different
+ * UEs in the same subframe.  Simultaneous events run in the order they
+ * were scheduled, and a UE which skipped subframes schedules its next
+ * subframe indication long before the UEs which did not.  So the traces
+ * are compared subframe by subframe, as sets of events.
+ */
+class LteIdleSubframesTestCase : public TestCase
+{
+public:
+  /**
+   * \param nUes the number of UEs attached to the eNB
+   * \param nActiveUes the number of these UEs with a saturated bearer
+   */
+  LteIdleSubframesTestCase (uint16_t nUes, uint16_t nActiveUes);
+  virtual ~LteIdleSubframesTestCase ();
+
+private:
+  static std::string BuildNameString (uint16_t nUes, uint16_t nActiveUes);
+  virtual void DoRun (void);
+
+  /**
+   * Run the simulation and trace the PHY activity of the cell.
+   *
+   * \param skipIdleSubframes the value of LteUePhy::SkipIdleSubframes
+   * \returns the trace of the PHY activity, by increasing time, the
+   * events traced at the same time being sorted
+   */
+  std::string RunSimulation (bool skipIdleSubframes);
+
+  void ReportUeSinr (uint16_t cellId, uint16_t rnti, double sinr);
+  void DlPhyTransmission (PhyTransmissionStatParameters params);
+  void UlPhyTransmission (PhyTransmissionStatParameters params);
+
+  uint16_t m_nUes;
+  uint16_t m_nActiveUes;
+  std::ostringstream m_trace;
+};
+
+LteIdleSubframesTestCase::LteIdleSubframesTestCase (uint16_t nUes, uint16_t nActiveUes)
+  : TestCase (BuildNameString (nUes, nActiveUes)),
+    m_nUes (nUes),
+    m_nActiveUes (nActiveUes)
+{
+}
+
+LteIdleSubframesTestCase::~LteIdleSubframesTestCase ()
+{
+}
+
+std::string
+LteIdleSubframesTestCase::BuildNameString (uint16_t nUes, uint16_t nActiveUes)
+{
+  std::ostringstream oss;
+  oss << "Skipping the idle subframes of " << nUes << " UEs, " << nActiveUes << " active";
+  return oss.str ();
+}
+
+void
+LteIdleSubframesTestCase::DoRun (void)
+{
+  std::string expected = RunSimulation (false);
+  std::string trace = RunSimulation (true);
+  NS_TEST_ASSERT_MSG_GT (expected.size (), 0, "no PHY activity traced");
+  NS_TEST_ASSERT_MSG_EQ (trace, expected, "the PHY activity changed when skipping the idle subframes");
+}
+
+std::string
+LteIdleSubframesTestCase::RunSimulation (bool skipIdleSubframes)
+{
+  Config::Reset ();
+  Config::SetDefault ("ns3::LteUePhy::SkipIdleSubframes", BooleanValue (skipIdleSubframes));
+  Config::SetDefault ("ns3::LteUePhy::WidebandCqiPeriodicity", TimeValue (MilliSeconds (10)));
+  Config::SetDefault ("ns3::LteUePhy::SubbandCqiPeriodicity", TimeValue (MilliSeconds (10)));
+  Config::SetDefault ("ns3::LteEnbRrc::SrsPeriodicity", UintegerValue (20));
+  m_trace.str ("");
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::FriisSpectrumPropagationLossModel"));
+
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (1);
+  ueNodes.Create (m_nUes);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (enbNodes);
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (100.0),
+                                 "DeltaX", DoubleValue (150.0),
+                                 "GridWidth", UintegerValue (m_nUes));
+  mobility.Install (ueNodes);
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  // the same random access in both runs
+  int64_t stream = lteHelper->AssignStreams (enbDevs, 1);
+  lteHelper->AssignStreams (ueDevs, stream + 1);
+  lteHelper->Attach (ueDevs, enbDevs.Get (0));
+
+  NetDeviceContainer activeUeDevs;
+  for (uint16_t i = 0; i < m_nActiveUes; i++)
+    {
+      activeUeDevs.Add (ueDevs.Get (i));
+    }
+  lteHelper->ActivateDataRadioBearer (activeUeDevs, EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+
+  Ptr<LteEnbPhy> enbPhy = enbDevs.Get (0)->GetObject<LteEnbNetDevice> ()->GetPhy ();
+  enbPhy->TraceConnectWithoutContext ("ReportUeSinr",
+                                      MakeCallback (&LteIdleSubframesTestCase::ReportUeSinr, this));
+  enbPhy->TraceConnectWithoutContext ("DlPhyTransmission",
+                                      MakeCallback (&LteIdleSubframesTestCase::DlPhyTransmission, this));
+  for (uint32_t i = 0; i < ueDevs.GetN (); i++)
+    {
+      Ptr<LteUePhy> uePhy = ueDevs.Get (i)->GetObject<LteUeNetDevice> ()->GetPhy ();
+      uePhy->TraceConnectWithoutContext ("UlPhyTransmission",
+                                         MakeCallback (&LteIdleSubframesTestCase::UlPhyTransmission, this));
+    }
+
+  Simulator::Stop (Seconds (0.5));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  Config::Reset ();
+
+  // sort the events of each subframe, each line starting with its time
+  std::ostringstream trace;
+  std::istringstream iss (m_trace.str ());
+  std::vector<std::string> subframe;
+  std::string line;
+  bool more = true;
+  while (more)
+    {
+      more = !std::getline (iss, line).fail ();
+      if (!subframe.empty ()
+          && (!more || line.substr (0, line.find (' ')) != subframe.front ().substr (0, subframe.front ().find (' '))))
+        {
+          std::sort (subframe.begin (), subframe.end ());
+          for (std::vector<std::string>::const_iterator it = subframe.begin (); it != subframe.end (); ++it)
+            {
+              trace << *it << "\n";
+            }
+          subframe.clear ();
+        }
+      if (more)
+        {
+          subframe.push_back (line);
+        }
+    }
+  return trace.str ();
+}
+
+void
+LteIdleSubframesTestCase::ReportUeSinr (uint16_t cellId, uint16_t rnti, double sinr)
+{
+  m_trace << Simulator::Now ().GetNanoSeconds () << " sinr " << rnti << " " << sinr << "\n";
+}
+
+void
+LteIdleSubframesTestCase::DlPhyTransmission (PhyTransmissionStatParameters params)
+{
+  m_trace << Simulator::Now ().GetNanoSeconds () << " dl " << params.m_rnti
+          << " " << (uint16_t) params.m_mcs << " " << params.m_size << "\n";
+}
+
+void
+LteIdleSubframesTestCase::UlPhyTransmission (PhyTransmissionStatParameters params)
+{
+  m_trace << Simulator::Now ().GetNanoSeconds () << " ul " << params.m_rnti
+          << " " << (uint16_t) params.m_mcs << " " << params.m_size << "\n";
+}
+
+
+class LteIdleSubframesTestSuite : public TestSuite
+{
+public:
+  LteIdleSubframesTestSuite ();
+};
+
+LteIdleSubframesTestSuite::LteIdleSubframesTestSuite ()
+  : TestSuite ("lte-idle-subframes", SYSTEM)
+{
+  AddTestCase (new LteIdleSubframesTestCase (4, 0), TestCase::QUICK);
+  AddTestCase (new LteIdleSubframesTestCase (6, 2), TestCase::QUICK);
+}
+
+static LteIdleSubframesTestSuite g_lteIdleSubframesTestSuite;
@@ -0,0 +1,258 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ctime>
+#include <iostream>
+#include <cmath>
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/object.h"
+#include "ns3/lte-mi-error-model.h"
+#include "ns3/lte-spectrum-value-helper.h"
+#include "ns3/lte-amc.h"
+
+NS_LOG_COMPONENT_DEFINE ("LteTestMiErrorModel");
+
+using namespace ns3;
+
+namespace {
+
+/**
+ * \param nRb the number of RBs
+ * \returns a SINR covering the range of the MI maps, from -10 to 30 dB,
+ * and a few RBs without signal
+ */
+SpectrumValue
+CreateSinr (uint8_t nRb)
+{
+  SpectrumValue sinr (LteSpectrumValueHelper::GetSpectrumModel (100, nRb));
+  for (uint32_t i = 0; i < nRb; i++)
+    {
+      sinr[i] = (i % 17 == 0) ? 0.0 : std::pow (10.0, (-10.0 + (i * 37 % nRb) * 40.0 / nRb) / 10.0);
+    }
+  return sinr;
+}
+
+/**
+ * \param rbgSize the size of a RBG
+ * \param nRb the number of RBs
+ * \returns the RB maps of all the RBGs of the bandwidth
+ */
+std::vector<std::vector<int> >
+CreateRbgMaps (uint8_t rbgSize, uint8_t nRb)
+{
+  std::vector<std::vector<int> > maps;
+  for (int rb = 0; rb < nRb; rb += rbgSize)
+    {
+      std::vector<int> map;
+      for (int j = rb; j < rb + rbgSize && j < nRb; j++)
+        {
+          map.push_back (j);
+        }
+      maps.push_back (map);
+    }
+  return maps;
+}
+
+} // anonymous namespace
+
+/**
+ * Check that the TBs evaluated against the MI per RB computed once for
+ * the whole bandwidth get the same BLER and MI as the TBs evaluated
+ * directly against the SINR.
+ */
+class LteMiErrorModelTestCase : public TestCase
+{
+public:
+  LteMiErrorModelTestCase ();
+  virtual ~LteMiErrorModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteMiErrorModelTestCase::LteMiErrorModelTestCase ()
+  : TestCase ("Check the TB error rates computed from the MI per RB")
+{
+}
+
+LteMiErrorModelTestCase::~LteMiErrorModelTestCase ()
+{
+}
+
+void
+LteMiErrorModelTestCase::DoRun (void)
+{
+  const uint8_t nRb = 50;
+  const uint8_t rbgSize = 3;
+  SpectrumValue sinr = CreateSinr (nRb);
+  LteMiErrorModel::MiPerRb miPerRb (sinr);
+  Ptr<LteAmc> amc = CreateObject<LteAmc> ();
+  std::vector<std::vector<int> > maps = CreateRbgMaps (rbgSize, nRb);
+  // the whole bandwidth, as a large TB
+  std::vector<int> all;
+  for (int rb = 0; rb < nRb; rb++)
+    {
+      all.push_back (rb);
+    }
+  maps.push_back (all);
+
+  for (uint32_t m = 0; m < maps.size (); m++)
+    {
+      for (uint8_t mcs = 0; mcs <= 28; mcs++)
+        {
+          uint16_t size = amc->GetTbSizeFromMcs (mcs, maps[m].size ()) / 8;
+          HarqProcessInfoList_t history;
+          TbStats_t expected = LteMiErrorModel::GetTbDecodificationStats (sinr, maps[m], size, mcs, history);
+          TbStats_t stats = LteMiErrorModel::GetTbDecodificationStats (miPerRb, maps[m], size, mcs, history);
+          NS_TEST_ASSERT_MSG_EQ (stats.mi, expected.mi, "wrong MI for RBG " << m << " MCS " << (uint16_t) mcs);
+          NS_TEST_ASSERT_MSG_EQ (stats.tbler, expected.tbler, "wrong TBLER for RBG " << m << " MCS " << (uint16_t) mcs);
+
+          // a retransmission of the same TB
+          HarqProcessInfoElement_t el;
+          el.m_mi = expected.mi;
+          el.m_rv = 0;
+          el.m_infoBits = size * 8;
+          el.m_codeBits = size * 8 / 0.5;
+          history.push_back (el);
+          expected = LteMiErrorModel::GetTbDecodificationStats (sinr, maps[m], size, mcs, history);
+          stats = LteMiErrorModel::GetTbDecodificationStats (miPerRb, maps[m], size, mcs, history);
+          NS_TEST_ASSERT_MSG_EQ (stats.tbler, expected.tbler, "wrong HARQ TBLER for RBG " << m << " MCS " << (uint16_t) mcs);
+        }
+    }
+}
+
+class LteMiErrorModelTestSuite : public TestSuite
+{
+public:
+  LteMiErrorModelTestSuite ();
+};
+
+LteMiErrorModelTestSuite::LteMiErrorModelTestSuite ()
+  : TestSuite ("lte-mi-error-model", UNIT)
+{
+  AddTestCase (new LteMiErrorModelTestCase (), TestCase::QUICK);
+}
+
+static LteMiErrorModelTestSuite g_lteMiErrorModelTestSuite;
+
+
+/**
+ * Measure the time needed to find the CQI of every RBG of the
+ * bandwidth, as LteAmc::CreateCqiFeedbacks does, evaluating each TB
+ * against the SINR or against the MI per RB computed once.
+ */
+class LteMiErrorModelPerfTestCase : public TestCase
+{
+public:
+  LteMiErrorModelPerfTestCase ();
+  virtual ~LteMiErrorModelPerfTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param how the name of the evaluation
+   * \param delta the clock ticks spent
+   */
+  void Report (std::string how, clock_t delta) const;
+
+  enum { REPETITIONS = 200 };
+};
+
+LteMiErrorModelPerfTestCase::LteMiErrorModelPerfTestCase ()
+  : TestCase ("Measure the time to evaluate the CQIs of a 100 RBs bandwidth")
+{
+}
+
+LteMiErrorModelPerfTestCase::~LteMiErrorModelPerfTestCase ()
+{
+}
+
+void
+LteMiErrorModelPerfTestCase::DoRun (void)
+{
+  const uint8_t nRb = 100;
+  const uint8_t rbgSize = 4;
+  SpectrumValue sinr = CreateSinr (nRb);
+  std::vector<std::vector<int> > maps = CreateRbgMaps (rbgSize, nRb);
+  Ptr<LteAmc> amc = CreateObject<LteAmc> ();
+  uint16_t sizes[29];
+  for (uint8_t mcs = 0; mcs <= 28; mcs++)
+    {
+      sizes[mcs] = amc->GetTbSizeFromMcs (mcs, rbgSize) / 8;
+    }
+  HarqProcessInfoList_t history;
+
+  std::cout << GetName () << ": " << REPETITIONS << " repetitions of "
+            << maps.size () << " RBGs x 29 MCSs" << std::endl;
+
+  double sumSinr = 0;
+  clock_t start = clock ();
+  for (uint32_t r = 0; r < REPETITIONS; r++)
+    {
+      for (uint32_t m = 0; m < maps.size (); m++)
+        {
+          for (uint8_t mcs = 0; mcs <= 28; mcs++)
+            {
+              sumSinr += LteMiErrorModel::GetTbDecodificationStats (sinr, maps[m], sizes[mcs], mcs, history).tbler;
+            }
+        }
+    }
+  Report ("SINR", clock () - start);
+
+  double sumMi = 0;
+  start = clock ();
+  for (uint32_t r = 0; r < REPETITIONS; r++)
+    {
+      LteMiErrorModel::MiPerRb miPerRb (sinr);
+      for (uint32_t m = 0; m < maps.size (); m++)
+        {
+          for (uint8_t mcs = 0; mcs <= 28; mcs++)
+            {
+              sumMi += LteMiErrorModel::GetTbDecodificationStats (miPerRb, maps[m], sizes[mcs], mcs, history).tbler;
+            }
+        }
+    }
+  Report ("MI per RB", clock () - start);
+
+  NS_TEST_ASSERT_MSG_EQ (sumMi, sumSinr, "the two evaluations differ");
+}
+
+void
+LteMiErrorModelPerfTestCase::Report (std::string how, clock_t delta) const
+{
+  double per = 1E6 * double (delta) / (REPETITIONS * double (CLOCKS_PER_SEC));
+  std::cout << GetName () << ": by " << how << ": "
+            << "ticks: " << delta
+            << "\tper: " << per
+            << " microsec/bandwidth"
+            << std::endl;
+}
+
+class LteMiErrorModelPerfTestSuite : public TestSuite
+{
+public:
+  LteMiErrorModelPerfTestSuite ();
+};
+
+LteMiErrorModelPerfTestSuite::LteMiErrorModelPerfTestSuite ()
+  : TestSuite ("lte-mi-error-model-perf", PERFORMANCE)
+{
+  AddTestCase (new LteMiErrorModelPerfTestCase (), TestCase::QUICK);
+}
+
+static LteMiErrorModelPerfTestSuite g_lteMiErrorModelPerfTestSuite;
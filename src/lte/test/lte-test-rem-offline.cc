@@ -0,0 +1,206 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/config.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/string.h>
+#include <ns3/uinteger.h>
+#include <ns3/node-container.h>
+#include <ns3/net-device-container.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/position-allocator.h>
+#include <ns3/building.h>
+#include <ns3/buildings-helper.h>
+#include <ns3/lte-helper.h>
+#include <ns3/radio-environment-map-helper.h>
+
+NS_LOG_COMPONENT_DEFINE ("LteTestRemOffline");
+
+using namespace ns3;
+
+/**
+ * Check that the offline mode of the RadioEnvironmentMapHelper
+ * generates the same map as the simulation of the RemSpectrumPhy
+ * instances.
+ */
+class LteRemOfflineTestCase : public TestCase
+{
+public:
+  /**
+   * \param pathlossModel the type of the pathloss model of the channel
+   * \param numThreads the number of threads of the offline mode
+   * \param buildings whether a building is placed among the eNBs
+   */
+  LteRemOfflineTestCase (std::string pathlossModel, uint32_t numThreads, bool buildings);
+  virtual ~LteRemOfflineTestCase ();
+
+private:
+  static std::string BuildNameString (std::string pathlossModel, uint32_t numThreads, bool buildings);
+  virtual void DoRun (void);
+
+  /**
+   * Generate the map and read it back.
+   *
+   * \param offline the value of RadioEnvironmentMapHelper::Offline
+   * \returns the points of the map, each as x, y, z and SINR
+   */
+  std::vector<std::vector<double> > GenerateRem (bool offline);
+
+  std::string m_pathlossModel;
+  uint32_t m_numThreads;
+  bool m_buildings;
+};
+
+LteRemOfflineTestCase::LteRemOfflineTestCase (std::string pathlossModel, uint32_t numThreads, bool buildings)
+  : TestCase (BuildNameString (pathlossModel, numThreads, buildings)),
+    m_pathlossModel (pathlossModel),
+    m_numThreads (numThreads),
+    m_buildings (buildings)
+{
+}
+
+LteRemOfflineTestCase::~LteRemOfflineTestCase ()
+{
+}
+
+std::string
+LteRemOfflineTestCase::BuildNameString (std::string pathlossModel, uint32_t numThreads, bool buildings)
+{
+  std::ostringstream oss;
+  oss << "Offline REM with " << pathlossModel << ", " << numThreads << " threads";
+  if (buildings)
+    {
+      oss << ", buildings";
+    }
+  return oss.str ();
+}
+
+void
+LteRemOfflineTestCase::DoRun (void)
+{
+  std::vector<std::vector<double> > expected = GenerateRem (false);
+  std::vector<std::vector<double> > rem = GenerateRem (true);
+  NS_TEST_ASSERT_MSG_EQ (expected.size (), 20 * 15, "wrong number of points in the event-driven REM");
+  NS_TEST_ASSERT_MSG_EQ (rem.size (), expected.size (), "wrong number of points in the offline REM");
+  for (uint32_t i = 0; i < rem.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (rem[i].size (), 4, "malformed line " << i);
+      NS_TEST_ASSERT_MSG_EQ (rem[i][0], expected[i][0], "wrong x at line " << i);
+      NS_TEST_ASSERT_MSG_EQ (rem[i][1], expected[i][1], "wrong y at line " << i);
+      NS_TEST_ASSERT_MSG_EQ (rem[i][2], expected[i][2], "wrong z at line " << i);
+      NS_TEST_ASSERT_MSG_EQ_TOL (rem[i][3], expected[i][3], 1e-5 * expected[i][3], "wrong SINR at line " << i);
+    }
+}
+
+std::vector<std::vector<double> >
+LteRemOfflineTestCase::GenerateRem (bool offline)
+{
+  Config::Reset ();
+  std::string fileName = CreateTempDirFilename (offline ? "offline.rem" : "event.rem");
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue (m_pathlossModel));
+  if (m_buildings)
+    {
+      lteHelper->SetPathlossModelAttribute ("ShadowSigmaExtWalls", DoubleValue (0));
+      lteHelper->SetPathlossModelAttribute ("ShadowSigmaOutdoor", DoubleValue (0));
+      lteHelper->SetPathlossModelAttribute ("ShadowSigmaIndoor", DoubleValue (0));
+      Ptr<Building> building = CreateObject<Building> ();
+      building->SetBoundaries (Box (100.0, 200.0, 50.0, 100.0, 0.0, 10.0));
+    }
+  lteHelper->SetEnbAntennaModelType ("ns3::CosineAntennaModel");
+  lteHelper->SetEnbAntennaModelAttribute ("Beamwidth", DoubleValue (120));
+
+  NodeContainer enbNodes;
+  enbNodes.Create (3);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 30.0));
+  positionAlloc->Add (Vector (300.0, 0.0, 30.0));
+  positionAlloc->Add (Vector (150.0, 250.0, 30.0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  if (m_buildings)
+    {
+      BuildingsHelper::Install (enbNodes);
+      BuildingsHelper::MakeMobilityModelConsistent ();
+    }
+  lteHelper->InstallEnbDevice (enbNodes);
+
+  Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper> ();
+  remHelper->SetAttribute ("ChannelPath", StringValue ("/ChannelList/0"));
+  remHelper->SetAttribute ("OutputFile", StringValue (fileName));
+  remHelper->SetAttribute ("XMin", DoubleValue (-100.0));
+  remHelper->SetAttribute ("XMax", DoubleValue (400.0));
+  remHelper->SetAttribute ("XRes", UintegerValue (20));
+  remHelper->SetAttribute ("YMin", DoubleValue (-100.0));
+  remHelper->SetAttribute ("YMax", DoubleValue (300.0));
+  remHelper->SetAttribute ("YRes", UintegerValue (15));
+  remHelper->SetAttribute ("Z", DoubleValue (1.5));
+  remHelper->SetAttribute ("MaxPointsPerIteration", UintegerValue (70));
+  remHelper->SetAttribute ("Offline", BooleanValue (offline));
+  remHelper->SetAttribute ("NumThreads", UintegerValue (m_numThreads));
+  remHelper->Install ();
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+  Config::Reset ();
+
+  std::vector<std::vector<double> > rem;
+  std::ifstream inFile (fileName.c_str ());
+  NS_TEST_EXPECT_MSG_EQ (inFile.is_open (), true, "could not open " << fileName);
+  std::string line;
+  while (std::getline (inFile, line))
+    {
+      std::istringstream iss (line);
+      std::vector<double> point;
+      double value;
+      while (iss >> value)
+        {
+          point.push_back (value);
+        }
+      rem.push_back (point);
+    }
+  return rem;
+}
+
+
+class LteRemOfflineTestSuite : public TestSuite
+{
+public:
+  LteRemOfflineTestSuite ();
+};
+
+LteRemOfflineTestSuite::LteRemOfflineTestSuite ()
+  : TestSuite ("lte-rem-offline", SYSTEM)
+{
+  AddTestCase (new LteRemOfflineTestCase ("ns3::FriisPropagationLossModel", 1, false), TestCase::QUICK);
+  AddTestCase (new LteRemOfflineTestCase ("ns3::FriisPropagationLossModel", 3, false), TestCase::QUICK);
+  AddTestCase (new LteRemOfflineTestCase ("ns3::FriisSpectrumPropagationLossModel", 2, false), TestCase::QUICK);
+  // with buildings, the offline mode falls back to a single thread
+  AddTestCase (new LteRemOfflineTestCase ("ns3::HybridBuildingsPropagationLossModel", 2, true), TestCase::QUICK);
+}
+
+static LteRemOfflineTestSuite g_lteRemOfflineTestSuite;
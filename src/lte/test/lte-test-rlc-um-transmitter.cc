@@ -48,6 +48,7 @@ LteRlcUmTransmitterTestSuite::LteRlcUmTransmitterTestSuite ()
   AddTestCase (new LteRlcUmTransmitterSegmentationTestCase ("Segmentation"), TestCase::QUICK);
   AddTestCase (new LteRlcUmTransmitterConcatenationTestCase ("Concatenation"), TestCase::QUICK);
   AddTestCase (new LteRlcUmTransmitterReportBufferStatusTestCase ("ReportBufferStatus primitive"), TestCase::QUICK);
+  AddTestCase (new LteRlcUmTransmitterTxOpportunitiesTestCase ("Transmission opportunities at once"), TestCase::QUICK);
 
 }
 
@@ -298,3 +299,58 @@ LteRlcUmTransmitterReportBufferStatusTestCase::DoRun (void)
   Simulator::Run ();
   Simulator::Destroy ();
 }
+
+/**
+ * Test 4.1.1.5 Transmission opportunities notified at once
+ */
+LteRlcUmTransmitterTxOpportunitiesTestCase::LteRlcUmTransmitterTxOpportunitiesTestCase (std::string name)
+  : LteRlcUmTransmitterTestCase (name)
+{
+}
+
+LteRlcUmTransmitterTxOpportunitiesTestCase::~LteRlcUmTransmitterTxOpportunitiesTestCase ()
+{
+}
+
+void
+LteRlcUmTransmitterTxOpportunitiesTestCase::DoRun (void)
+{
+  // Create topology
+  LteRlcUmTransmitterTestCase::DoRun ();
+
+  //
+  // e) Several transmission opportunities in the same TTI generate the
+  //    same PDUs as the same opportunities notified one by one
+  //
+
+  // PDCP entity sends data
+  txPdcp->SendData (Seconds (0.100), "ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+
+  // MAC entity sends two TxOpp to RLC entity generating two segments
+  std::vector<uint32_t> bytes;
+  bytes.push_back (10);
+  bytes.push_back (10);
+  txMac->SendTxOpportunities (Seconds (0.150), bytes);
+  CheckDataReceived (Seconds (0.200), "IJKLMNOP", "Segment #2 is not OK");
+  Simulator::Schedule (Seconds (0.200), &LteRlcUmTransmitterTxOpportunitiesTestCase::CheckTxPdus, this, 2);
+
+  // the opportunity too small for a PDU is skipped, the last one is
+  // left unused as the transmission buffer is empty
+  bytes.clear ();
+  bytes.push_back (2);
+  bytes.push_back (10);
+  bytes.push_back (4);
+  bytes.push_back (10);
+  txMac->SendTxOpportunities (Seconds (0.300), bytes);
+  CheckDataReceived (Seconds (0.350), "YZ", "Segment #4 is not OK");
+  Simulator::Schedule (Seconds (0.350), &LteRlcUmTransmitterTxOpportunitiesTestCase::CheckTxPdus, this, 4);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+LteRlcUmTransmitterTxOpportunitiesTestCase::CheckTxPdus (uint32_t txPdus)
+{
+  NS_TEST_ASSERT_MSG_EQ (txMac->GetTxPdus (), txPdus, "wrong number of PDUs");
+}
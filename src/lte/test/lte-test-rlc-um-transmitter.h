@@ -123,4 +123,20 @@ class LteRlcUmTransmitterReportBufferStatusTestCase : public LteRlcUmTransmitter
 
 };
 
+/**
+ * Test 4.1.1.5 Transmission opportunities notified at once
+ */
+class LteRlcUmTransmitterTxOpportunitiesTestCase : public LteRlcUmTransmitterTestCase
+{
+  public:
+    LteRlcUmTransmitterTxOpportunitiesTestCase (std::string name);
+    LteRlcUmTransmitterTxOpportunitiesTestCase ();
+    virtual ~LteRlcUmTransmitterTxOpportunitiesTestCase ();
+
+  private:
+    virtual void DoRun (void);
+    void CheckTxPdus (uint32_t txPdus);
+
+};
+
 #endif /* LTE_TEST_RLC_UM_TRANSMITTER_H */
@@ -0,0 +1,154 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <string>
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/config.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/mac-stats-calculator.h"
+
+NS_LOG_COMPONENT_DEFINE ("LteTestStatsWriter");
+
+using namespace ns3;
+
+/**
+ * Write a record of a MacStatsCalculator every millisecond, and check
+ * the lines found in the file in the middle of the simulation and after
+ * Simulator::Destroy.
+ */
+class LteStatsWriterTestCase : public TestCase
+{
+public:
+  /**
+   * \param name the name of the test case
+   * \param flushInterval the FlushInterval of the writer
+   * \param minLines minimum number of lines found in the file at 50.5 ms
+   * \param maxLines maximum number of lines found in the file at 50.5 ms
+   */
+  LteStatsWriterTestCase (std::string name, Time flushInterval, uint32_t minLines, uint32_t maxLines);
+  virtual ~LteStatsWriterTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /// \returns the number of lines of the output file
+  uint32_t CountLines (void);
+  /// Check the number of lines written so far
+  void CheckLines (void);
+  /// Write the record of a millisecond
+  void Write (Ptr<MacStatsCalculator> macStats, uint32_t i);
+
+  Time m_flushInterval;
+  uint32_t m_minLines;
+  uint32_t m_maxLines;
+  std::string m_filename;
+  uint32_t m_lines;     //!< lines found by CheckLines
+};
+
+LteStatsWriterTestCase::LteStatsWriterTestCase (std::string name, Time flushInterval, uint32_t minLines, uint32_t maxLines)
+  : TestCase ("Check the output of the LTE stats writer " + name),
+    m_flushInterval (flushInterval),
+    m_minLines (minLines),
+    m_maxLines (maxLines),
+    m_lines (0)
+{
+}
+
+LteStatsWriterTestCase::~LteStatsWriterTestCase ()
+{
+}
+
+uint32_t
+LteStatsWriterTestCase::CountLines (void)
+{
+  std::ifstream file (m_filename.c_str ());
+  uint32_t lines = 0;
+  std::string line;
+  while (std::getline (file, line))
+    {
+      lines++;
+    }
+  return lines;
+}
+
+void
+LteStatsWriterTestCase::CheckLines (void)
+{
+  m_lines = CountLines ();
+}
+
+void
+LteStatsWriterTestCase::Write (Ptr<MacStatsCalculator> macStats, uint32_t i)
+{
+  macStats->DlScheduling (1, 1, i / 10, i % 10, 1, 28, 1000, 0, 0);
+}
+
+void
+LteStatsWriterTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::LteStatsWriter::FlushInterval", TimeValue (m_flushInterval));
+  m_filename = CreateTempDirFilename ("DlMacStats.txt");
+
+  Ptr<MacStatsCalculator> macStats = CreateObject<MacStatsCalculator> ();
+  macStats->SetDlOutputFilename (m_filename);
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Simulator::Schedule (MilliSeconds (i), &LteStatsWriterTestCase::Write, this, macStats, i);
+    }
+  Simulator::Schedule (MicroSeconds (50500), &LteStatsWriterTestCase::CheckLines, this);
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_GT (m_lines + 1, m_minLines, "too few lines flushed during the simulation");
+  NS_TEST_ASSERT_MSG_LT (m_lines, m_maxLines + 1, "too many lines flushed during the simulation");
+  Simulator::Destroy ();
+
+  // the header and the 100 records
+  NS_TEST_ASSERT_MSG_EQ (CountLines (), 101, "records lost at Simulator::Destroy");
+  std::ifstream file (m_filename.c_str ());
+  std::string line;
+  std::getline (file, line);
+  NS_TEST_ASSERT_MSG_EQ (line.substr (0, 6), "% time", "header not found");
+  std::getline (file, line);
+  NS_TEST_ASSERT_MSG_EQ (line, "0\t1\t1\t0\t0\t1\t28\t1000\t0\t0", "wrong first record");
+}
+
+void
+LteStatsWriterTestCase::DoTeardown (void)
+{
+  Config::SetDefault ("ns3::LteStatsWriter::FlushInterval", TimeValue (Seconds (0)));
+}
+
+class LteStatsWriterTestSuite : public TestSuite
+{
+public:
+  LteStatsWriterTestSuite ();
+};
+
+LteStatsWriterTestSuite::LteStatsWriterTestSuite ()
+  : TestSuite ("lte-stats-writer", UNIT)
+{
+  // without a flush interval, nothing is written before the end
+  AddTestCase (new LteStatsWriterTestCase ("without flush interval", Seconds (0), 0, 0), TestCase::QUICK);
+  // flushed by the record of 50 ms at the latest: the header and the
+  // records of 0 to 49 ms
+  AddTestCase (new LteStatsWriterTestCase ("with a flush interval of 10 ms", MilliSeconds (10), 41, 51), TestCase::QUICK);
+}
+
+static LteStatsWriterTestSuite g_lteStatsWriterTestSuite;
@@ -42,7 +42,7 @@ public:
   {
     uint32_t psize = pkt->GetSize ();
     uint8_t buffer[psize];
-    char sbuffer[psize * 3];
+    char sbuffer[psize * 3 + 1];
     pkt->CopyData (buffer, psize);
     for (uint32_t i = 0; i < psize; i++)
       {
@@ -272,9 +272,15 @@ RrcConnectionRequestTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the encoding against the reference one
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet),
+                         "48 3f ec af ec a6 ",
+                         "Wrong encoding");
+
   // Remove header
   RrcConnectionRequestHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not completely removed");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionRequestHeader> (destination,"DESTINATION");
@@ -320,9 +326,15 @@ RrcConnectionSetupTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the encoding against the reference one
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet),
+                         "7f 81 c8 ce 14 e0 b8 80 80 4d 98 46 10 84 20 1b 00 01 80 20 ",
+                         "Wrong encoding");
+
   // remove header
   RrcConnectionSetupHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not completely removed");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionSetupHeader> (destination,"DESTINATION");
@@ -368,9 +380,15 @@ RrcConnectionSetupCompleteTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the encoding against the reference one
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet),
+                         "26 40 ",
+                         "Wrong encoding");
+
   // Remove header
   RrcConnectionSetupCompleteHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not completely removed");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionSetupCompleteHeader> (destination,"DESTINATION");
@@ -415,9 +433,15 @@ RrcConnectionReconfigurationCompleteTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the encoding against the reference one
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet),
+                         "15 ",
+                         "Wrong encoding");
+
   // remove header
   RrcConnectionReconfigurationCompleteHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not completely removed");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionReconfigurationCompleteHeader> (destination,"DESTINATION");
@@ -572,9 +596,18 @@ RrcConnectionReconfigurationTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the encoding against the reference one
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet),
+                         "24 1a 3f e8 6c c0 08 3e 00 2a 79 82 40 82 60 ee 80 00 8d 01 4f a0 99 e0 "
+                         "a8 10 f9 25 32 04 71 09 8a 41 9d 68 87 8a b9 c2 98 4d 02 40 00 c0 01 66 "
+                         "40 00 2d 00 00 00 80 00 00 00 02 02 27 23 38 53 82 e2 02 01 36 61 18 42 "
+                         "10 80 6c 00 06 00 80 ",
+                         "Wrong encoding");
+
   // remove header
   RrcConnectionReconfigurationHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not completely removed");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionReconfigurationHeader> (destination,"DESTINATION");
@@ -685,9 +718,17 @@ HandoverPreparationInfoTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the encoding against the reference one
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet),
+                         "08 00 00 39 19 c2 9c 17 10 10 09 b3 08 c2 10 84 03 60 00 30 04 00 00 2d "
+                         "80 15 04 42 24 60 00 00 00 00 05 20 00 00 10 a0 00 00 00 00 00 08 00 00 "
+                         "00 f0 00 00 00 00 00 03 f0 68 00 40 00 03 00 0a bc 00 00 18 ",
+                         "Wrong encoding");
+
   // remove header
   HandoverPreparationInfoHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not completely removed");
 
   // Log destination info
   TestUtils::LogPacketInfo<HandoverPreparationInfoHeader> (destination,"DESTINATION");
@@ -741,9 +782,15 @@ RrcConnectionReestablishmentRequestTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the encoding against the reference one
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet),
+                         "00 01 81 50 00 04 ",
+                         "Wrong encoding");
+
   // remove header
   RrcConnectionReestablishmentRequestHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not completely removed");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionReestablishmentRequestHeader> (destination,"DESTINATION");
@@ -790,9 +837,15 @@ RrcConnectionReestablishmentTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the encoding against the reference one
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet),
+                         "10 1c 8c e1 4e 0b 88 08 04 d9 84 61 08 42 01 b0 00 18 02 00 ",
+                         "Wrong encoding");
+
   // remove header
   RrcConnectionReestablishmentHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not completely removed");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionReestablishmentHeader> (destination,"DESTINATION");
@@ -837,9 +890,15 @@ RrcConnectionReestablishmentCompleteTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the encoding against the reference one
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet),
+                         "1e 00 ",
+                         "Wrong encoding");
+
   // remove header
   RrcConnectionReestablishmentCompleteHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not completely removed");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionReestablishmentCompleteHeader> (destination,"DESTINATION");
@@ -883,9 +942,15 @@ RrcConnectionRejectTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the encoding against the reference one
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet),
+                         "40 20 ",
+                         "Wrong encoding");
+
   // remove header
   RrcConnectionRejectHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not completely removed");
 
   // Log destination info
   TestUtils::LogPacketInfo<RrcConnectionRejectHeader> (destination,"DESTINATION");
@@ -945,9 +1010,15 @@ MeasurementReportTestCase::DoRun (void)
   // Log serialized packet contents
   TestUtils::LogPacketContents (packet);
 
+  // Check the encoding against the reference one
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet),
+                         "08 12 12 54 10 48 07 00 00 00 30 00 2b 42 b0 ",
+                         "Wrong encoding");
+
   // remove header
   MeasurementReportHeader destination;
   packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "Header not completely removed");
 
   // Log destination info
   TestUtils::LogPacketInfo<MeasurementReportHeader> (destination,"DESTINATION");
@@ -91,6 +91,9 @@ EpcTftClassifierTestCase::EpcTftClassifierTestCase (Ptr<EpcTftClassifier> c,
 
   m_udpHeader.SetSourcePort (sp);
   m_udpHeader.SetDestinationPort (dp);  
+
+  m_tcpHeader.SetSourcePort (sp);
+  m_tcpHeader.SetDestinationPort (dp);
 }
 
 EpcTftClassifierTestCase::~EpcTftClassifierTestCase ()
@@ -131,6 +134,74 @@ EpcTftClassifierTestCase::DoRun (void)
   NS_LOG_LOGIC (this << *udpPacket);
   uint32_t obtainedTftId = m_c ->Classify (udpPacket, m_d);
   NS_TEST_ASSERT_MSG_EQ (obtainedTftId, m_tftId, "bad classification of UDP packet");
+  // the second packet of the flow is classified from the cache
+  obtainedTftId = m_c ->Classify (udpPacket, m_d);
+  NS_TEST_ASSERT_MSG_EQ (obtainedTftId, m_tftId, "bad classification of second UDP packet");
+
+  Ptr<Packet> tcpPacket = Create<Packet> ();
+  m_ipHeader.SetProtocol (TcpL4Protocol::PROT_NUMBER);
+  tcpPacket->AddHeader (m_tcpHeader);
+  tcpPacket->AddHeader (m_ipHeader);
+  NS_LOG_LOGIC (this << *tcpPacket);
+  obtainedTftId = m_c ->Classify (tcpPacket, m_d);
+  NS_TEST_ASSERT_MSG_EQ (obtainedTftId, m_tftId, "bad classification of TCP packet");
+}
+
+
+
+/**
+ * Check that the classification of a flow follows the TFTs added to and
+ * deleted from the classifier after its first packet.
+ */
+class EpcTftClassifierUpdateTestCase : public TestCase
+{
+public:
+  EpcTftClassifierUpdateTestCase ();
+  virtual ~EpcTftClassifierUpdateTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EpcTftClassifierUpdateTestCase::EpcTftClassifierUpdateTestCase ()
+  : TestCase ("classification after adding and deleting TFTs")
+{
+}
+
+EpcTftClassifierUpdateTestCase::~EpcTftClassifierUpdateTestCase ()
+{
+}
+
+void
+EpcTftClassifierUpdateTestCase::DoRun (void)
+{
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (Ipv4Address ("9.1.1.1"));
+  ipHeader.SetDestination (Ipv4Address ("8.1.1.1"));
+  ipHeader.SetProtocol (UdpL4Protocol::PROT_NUMBER);
+  UdpHeader udpHeader;
+  udpHeader.SetSourcePort (9);
+  udpHeader.SetDestinationPort (3489);
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (udpHeader);
+  packet->AddHeader (ipHeader);
+
+  EpcTftClassifier c;
+  NS_TEST_ASSERT_MSG_EQ (c.Classify (packet, EpcTft::DOWNLINK), 0, "no TFT should match");
+
+  c.Add (EpcTft::Default (), 1);
+  NS_TEST_ASSERT_MSG_EQ (c.Classify (packet, EpcTft::DOWNLINK), 1, "the default TFT should match");
+
+  Ptr<EpcTft> tft = Create<EpcTft> ();
+  EpcTft::PacketFilter pf;
+  pf.localPortStart = 3489;
+  pf.localPortEnd = 3489;
+  tft->Add (pf);
+  c.Add (tft, 2);
+  NS_TEST_ASSERT_MSG_EQ (c.Classify (packet, EpcTft::DOWNLINK), 2, "the new TFT should match");
+
+  c.Delete (2);
+  NS_TEST_ASSERT_MSG_EQ (c.Classify (packet, EpcTft::DOWNLINK), 1, "the deleted TFT should not match");
 }
 
 
@@ -328,4 +399,7 @@ EpcTftClassifierTestSuite::EpcTftClassifierTestSuite ()
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::UPLINK,   Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),     9,     5897,     0,    2), TestCase::QUICK);
   AddTestCase (new EpcTftClassifierTestCase (c4, EpcTft::DOWNLINK, Ipv4Address ("9.1.1.1"), Ipv4Address ("8.1.1.1"),  5897,       10,     0,    2), TestCase::QUICK);
 
+
+  AddTestCase (new EpcTftClassifierUpdateTestCase (), TestCase::QUICK);
+
 }
@@ -21,6 +21,7 @@
 #include <cmath>
 
 #include "mobility-model.h"
+#include "mobility-snapshot.h"
 #include "ns3/trace-source-accessor.h"
 
 namespace ns3 {
@@ -51,6 +52,8 @@ MobilityModel::GetTypeId (void)
 }
 
 MobilityModel::MobilityModel ()
+  : m_snapshot (0),
+    m_snapshotIndex (0)
 {
 }
 
@@ -61,6 +64,10 @@ MobilityModel::~MobilityModel ()
 Vector
 MobilityModel::GetPosition (void) const
 {
+  if (m_snapshot != 0)
+    {
+      return m_snapshot->GetPosition (m_snapshotIndex);
+    }
   return DoGetPosition ();
 }
 Vector
@@ -78,8 +85,12 @@ MobilityModel::SetPosition (const Vector &position)
 double 
 MobilityModel::GetDistanceFrom (Ptr<const MobilityModel> other) const
 {
-  Vector oPosition = other->DoGetPosition ();
-  Vector position = DoGetPosition ();
+  if (m_snapshot != 0 && m_snapshot == other->m_snapshot)
+    {
+      return m_snapshot->GetDistance (m_snapshotIndex, other->m_snapshotIndex);
+    }
+  Vector oPosition = other->GetPosition ();
+  Vector position = GetPosition ();
   return CalculateDistance (position, oPosition);
 }
 
@@ -95,6 +106,10 @@ MobilityModel::GetRelativeSpeed (Ptr<const MobilityModel> other) const
 void
 MobilityModel::NotifyCourseChange (void) const
 {
+  if (m_snapshot != 0)
+    {
+      m_snapshot->NotifyCourseChange (m_snapshotIndex);
+    }
   m_courseChangeTrace (this);
 }
 
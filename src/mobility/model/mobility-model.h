@@ -26,6 +26,8 @@
 
 namespace ns3 {
 
+class MobilitySnapshot;
+
 /**
  * \ingroup mobility
  * \brief Keep track of the current position and velocity of an object.
@@ -45,6 +47,9 @@ public:
 
   /**
    * \return the current position
+   *
+   * If this model was added to a MobilitySnapshot, the position is
+   * read from the snapshot of the current simulation time.
    */
   Vector GetPosition (void) const;
   /**
@@ -82,6 +87,8 @@ protected:
    */
   void NotifyCourseChange (void) const;
 private:
+  friend class MobilitySnapshot;
+
   /**
    * \return the current position.
    *
@@ -116,6 +123,15 @@ private:
    */
   TracedCallback<Ptr<const MobilityModel> > m_courseChangeTrace;
 
+  /**
+   * The snapshot which serves the position queries of this model, if any.
+   * The snapshot holds a reference to this model and clears this
+   * pointer when it is disposed.
+   */
+  MobilitySnapshot *m_snapshot;
+  /// index of this model in m_snapshot
+  uint32_t m_snapshotIndex;
+
 };
 
 } // namespace ns3
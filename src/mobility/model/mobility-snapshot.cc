@@ -0,0 +1,232 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "mobility-snapshot.h"
+#include "mobility-model.h"
+#include "constant-position-mobility-model.h"
+#include "constant-velocity-mobility-model.h"
+
+NS_LOG_COMPONENT_DEFINE ("MobilitySnapshot");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (MobilitySnapshot);
+
+TypeId
+MobilitySnapshot::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MobilitySnapshot")
+    .SetParent<Object> ()
+    .AddConstructor<MobilitySnapshot> ()
+  ;
+  return tid;
+}
+
+MobilitySnapshot::MobilitySnapshot ()
+  : m_valid (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MobilitySnapshot::~MobilitySnapshot ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ptr<MobilitySnapshot>
+MobilitySnapshot::GetDefault (void)
+{
+  return *DoGet ();
+}
+
+Ptr<MobilitySnapshot> *
+MobilitySnapshot::DoGet (void)
+{
+  static Ptr<MobilitySnapshot> ptr = 0;
+  if (ptr == 0)
+    {
+      ptr = CreateObject<MobilitySnapshot> ();
+      Simulator::ScheduleDestroy (&MobilitySnapshot::Delete);
+    }
+  return &ptr;
+}
+
+void
+MobilitySnapshot::Delete (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  (*DoGet ())->Dispose ();
+  (*DoGet ()) = 0;
+}
+
+void
+MobilitySnapshot::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Ptr<MobilityModel> >::iterator i = m_models.begin ();
+       i != m_models.end (); ++i)
+    {
+      (*i)->m_snapshot = 0;
+    }
+  m_models.clear ();
+  m_linear.clear ();
+  m_exact.clear ();
+  m_t0.clear ();
+  m_x0.clear ();
+  m_y0.clear ();
+  m_z0.clear ();
+  m_vx.clear ();
+  m_vy.clear ();
+  m_vz.clear ();
+  m_x.clear ();
+  m_y.clear ();
+  m_z.clear ();
+  m_valid = false;
+  Object::DoDispose ();
+}
+
+void
+MobilitySnapshot::Add (Ptr<MobilityModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  if (model->m_snapshot == this)
+    {
+      return;
+    }
+  NS_ASSERT_MSG (model->m_snapshot == 0, "MobilityModel already tracked by another snapshot");
+  uint32_t index = m_models.size ();
+  bool linear = DynamicCast<ConstantPositionMobilityModel> (model) != 0
+    || DynamicCast<ConstantVelocityMobilityModel> (model) != 0;
+  m_models.push_back (model);
+  m_linear.push_back (linear);
+  if (!linear)
+    {
+      m_exact.push_back (index);
+    }
+  m_t0.push_back (0.0);
+  m_x0.push_back (0.0);
+  m_y0.push_back (0.0);
+  m_z0.push_back (0.0);
+  m_vx.push_back (0.0);
+  m_vy.push_back (0.0);
+  m_vz.push_back (0.0);
+  m_x.push_back (0.0);
+  m_y.push_back (0.0);
+  m_z.push_back (0.0);
+  Resample (index);
+  model->m_snapshot = this;
+  model->m_snapshotIndex = index;
+}
+
+uint32_t
+MobilitySnapshot::GetN (void) const
+{
+  return m_models.size ();
+}
+
+void
+MobilitySnapshot::Resample (uint32_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+  Vector position = m_models[index]->DoGetPosition ();
+  Vector velocity = m_linear[index] ? m_models[index]->DoGetVelocity () : Vector ();
+  m_t0[index] = Simulator::Now ().GetSeconds ();
+  m_x0[index] = position.x;
+  m_y0[index] = position.y;
+  m_z0[index] = position.z;
+  m_vx[index] = velocity.x;
+  m_vy[index] = velocity.y;
+  m_vz[index] = velocity.z;
+  // if the snapshot of the current timestamp was already computed,
+  // it must reflect the new course.
+  m_x[index] = position.x;
+  m_y[index] = position.y;
+  m_z[index] = position.z;
+}
+
+void
+MobilitySnapshot::NotifyCourseChange (uint32_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+  NS_ASSERT (index < m_models.size ());
+  Resample (index);
+}
+
+void
+MobilitySnapshot::Refresh (void) const
+{
+  Time now = Simulator::Now ();
+  if (m_valid && m_time == now)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << now);
+  m_time = now;
+  m_valid = true;
+  double t = now.GetSeconds ();
+  uint32_t n = m_models.size ();
+  // Plain loops over contiguous arrays, without any call, so that
+  // the compiler can vectorize them.
+  const double *t0 = n ? &m_t0[0] : 0;
+  const double *x0 = n ? &m_x0[0] : 0;
+  const double *y0 = n ? &m_y0[0] : 0;
+  const double *z0 = n ? &m_z0[0] : 0;
+  const double *vx = n ? &m_vx[0] : 0;
+  const double *vy = n ? &m_vy[0] : 0;
+  const double *vz = n ? &m_vz[0] : 0;
+  double *x = n ? &m_x[0] : 0;
+  double *y = n ? &m_y[0] : 0;
+  double *z = n ? &m_z[0] : 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double dt = t - t0[i];
+      x[i] = x0[i] + vx[i] * dt;
+      y[i] = y0[i] + vy[i] * dt;
+      z[i] = z0[i] + vz[i] * dt;
+    }
+  for (std::vector<uint32_t>::const_iterator i = m_exact.begin (); i != m_exact.end (); ++i)
+    {
+      Vector position = m_models[*i]->DoGetPosition ();
+      m_x[*i] = position.x;
+      m_y[*i] = position.y;
+      m_z[*i] = position.z;
+    }
+}
+
+Vector
+MobilitySnapshot::GetPosition (uint32_t index) const
+{
+  NS_ASSERT (index < m_models.size ());
+  Refresh ();
+  return Vector (m_x[index], m_y[index], m_z[index]);
+}
+
+double
+MobilitySnapshot::GetDistance (uint32_t a, uint32_t b) const
+{
+  NS_ASSERT (a < m_models.size () && b < m_models.size ());
+  Refresh ();
+  double dx = m_x[b] - m_x[a];
+  double dy = m_y[b] - m_y[a];
+  double dz = m_z[b] - m_z[a];
+  return std::sqrt (dx * dx + dy * dy + dz * dz);
+}
+
+} // namespace ns3
@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_SNAPSHOT_H
+#define MOBILITY_SNAPSHOT_H
+
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup mobility
+ * \brief Per-timestamp cache of the positions of a set of mobility models.
+ *
+ * Once a MobilityModel has been added to a snapshot, its GetPosition
+ * and GetDistanceFrom methods are served from this object.  The first
+ * query issued at a given simulation time recomputes the position of
+ * every registered model in a single pass over struct-of-arrays
+ * storage; all other queries issued at the same time are plain array
+ * reads.
+ *
+ * Models whose trajectory is piecewise linear between two course
+ * changes (ConstantPositionMobilityModel and
+ * ConstantVelocityMobilityModel) are extrapolated from the position
+ * and velocity recorded at their last course change.  All other models
+ * are queried through their own DoGetPosition method once per
+ * timestamp.
+ *
+ * The snapshot pays off when many positions are needed at the same
+ * instant, which is what a wireless channel does for every frame.  It
+ * is therefore enabled by the channels themselves (see the
+ * "UseMobilitySnapshot" attribute of YansWifiChannel and
+ * SingleModelSpectrumChannel) rather than by default.
+ */
+class MobilitySnapshot : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+  MobilitySnapshot ();
+  virtual ~MobilitySnapshot ();
+
+  /**
+   * \return the snapshot shared by all the channels of the simulation.
+   *
+   * The object is created on first use and disposed of during
+   * Simulator::Destroy.
+   */
+  static Ptr<MobilitySnapshot> GetDefault (void);
+
+  /**
+   * \param model the mobility model to track.
+   *
+   * Adding a model which is already tracked by this snapshot does
+   * nothing.  A model can be tracked by at most one snapshot.
+   */
+  void Add (Ptr<MobilityModel> model);
+  /**
+   * \return the number of models tracked by this snapshot.
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \param index the index of the model, as stored in the model itself.
+   * \return the position of the model at the current simulation time.
+   */
+  Vector GetPosition (uint32_t index) const;
+  /**
+   * \param a the index of the first model.
+   * \param b the index of the second model.
+   * \return the distance between the two models at the current
+   *         simulation time. Unit is meters.
+   */
+  double GetDistance (uint32_t a, uint32_t b) const;
+  /**
+   * \param index the index of the model whose course just changed.
+   *
+   * Invoked by MobilityModel::NotifyCourseChange to record the new
+   * reference position and velocity of the model.
+   */
+  void NotifyCourseChange (uint32_t index);
+
+private:
+  virtual void DoDispose (void);
+  /**
+   * Recompute the position of every model for the current
+   * simulation time, if not already done.
+   */
+  void Refresh (void) const;
+  /**
+   * \param index the model to resample.
+   *
+   * Record the current position and velocity of a model as the new
+   * reference for linear extrapolation.
+   */
+  void Resample (uint32_t index);
+  static Ptr<MobilitySnapshot> *DoGet (void);
+  static void Delete (void);
+
+  std::vector<Ptr<MobilityModel> > m_models;
+  /// true for the models which can be linearly extrapolated
+  std::vector<bool> m_linear;
+  /// indices of the models which must be queried at every timestamp
+  std::vector<uint32_t> m_exact;
+  /// reference time of each model, in seconds
+  std::vector<double> m_t0;
+  /// reference position of each model
+  std::vector<double> m_x0;
+  std::vector<double> m_y0;
+  std::vector<double> m_z0;
+  /// velocity of each model since its reference time
+  std::vector<double> m_vx;
+  std::vector<double> m_vy;
+  std::vector<double> m_vz;
+  /// positions at m_time
+  mutable std::vector<double> m_x;
+  mutable std::vector<double> m_y;
+  mutable std::vector<double> m_z;
+  mutable Time m_time;
+  mutable bool m_valid;
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_SNAPSHOT_H */
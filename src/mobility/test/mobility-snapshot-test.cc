@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/mobility-snapshot.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/constant-acceleration-mobility-model.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * Check that the positions served by a MobilitySnapshot match the ones
+ * computed by the mobility models themselves, across course changes.
+ */
+class MobilitySnapshotTestCase : public TestCase
+{
+public:
+  MobilitySnapshotTestCase ();
+  virtual ~MobilitySnapshotTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Check (void);
+  void ChangeCourse (void);
+
+  Ptr<MobilitySnapshot> m_snapshot;
+  Ptr<ConstantPositionMobilityModel> m_fixed;
+  Ptr<ConstantVelocityMobilityModel> m_moving;
+  Ptr<ConstantAccelerationMobilityModel> m_accelerating;
+  /// same trajectory as m_moving, not tracked by the snapshot
+  Ptr<ConstantVelocityMobilityModel> m_reference;
+};
+
+MobilitySnapshotTestCase::MobilitySnapshotTestCase ()
+  : TestCase ("Check positions and distances served by a MobilitySnapshot")
+{
+}
+
+MobilitySnapshotTestCase::~MobilitySnapshotTestCase ()
+{
+}
+
+void
+MobilitySnapshotTestCase::Check (void)
+{
+  Vector expected = m_reference->GetPosition ();
+  Vector actual = m_moving->GetPosition ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (actual.x, expected.x, 1e-9, "wrong x at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_EXPECT_MSG_EQ_TOL (actual.y, expected.y, 1e-9, "wrong y at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_EXPECT_MSG_EQ_TOL (actual.z, expected.z, 1e-9, "wrong z at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_fixed->GetDistanceFrom (m_moving),
+                             m_fixed->GetDistanceFrom (m_reference), 1e-9,
+                             "wrong distance at " << Simulator::Now ().GetSeconds ());
+
+  // models which cannot be extrapolated are resampled at each timestamp
+  double t = Simulator::Now ().GetSeconds ();
+  Vector accelerating = m_accelerating->GetPosition ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (accelerating.x, 0.5 * t * t, 1e-9, "wrong accelerated position");
+}
+
+void
+MobilitySnapshotTestCase::ChangeCourse (void)
+{
+  m_moving->SetVelocity (Vector (-3.0, 0.5, 1.0));
+  m_reference->SetVelocity (Vector (-3.0, 0.5, 1.0));
+  Check ();
+}
+
+void
+MobilitySnapshotTestCase::DoRun (void)
+{
+  m_snapshot = CreateObject<MobilitySnapshot> ();
+  m_fixed = CreateObject<ConstantPositionMobilityModel> ();
+  m_fixed->SetPosition (Vector (100.0, 0.0, 0.0));
+  m_moving = CreateObject<ConstantVelocityMobilityModel> ();
+  m_moving->SetPosition (Vector (1.0, 2.0, 3.0));
+  m_moving->SetVelocity (Vector (10.0, -2.0, 0.0));
+  m_reference = CreateObject<ConstantVelocityMobilityModel> ();
+  m_reference->SetPosition (Vector (1.0, 2.0, 3.0));
+  m_reference->SetVelocity (Vector (10.0, -2.0, 0.0));
+  m_accelerating = CreateObject<ConstantAccelerationMobilityModel> ();
+  m_accelerating->SetVelocityAndAcceleration (Vector (0.0, 0.0, 0.0), Vector (1.0, 0.0, 0.0));
+
+  m_snapshot->Add (m_fixed);
+  m_snapshot->Add (m_moving);
+  m_snapshot->Add (m_accelerating);
+  m_snapshot->Add (m_moving);
+  NS_TEST_ASSERT_MSG_EQ (m_snapshot->GetN (), 3, "a model was added twice");
+
+  for (double t = 0.0; t < 10.0; t += 0.7)
+    {
+      Simulator::Schedule (Seconds (t), &MobilitySnapshotTestCase::Check, this);
+    }
+  Simulator::Schedule (Seconds (4.2), &MobilitySnapshotTestCase::ChangeCourse, this);
+  Simulator::Run ();
+
+  m_snapshot->Dispose ();
+  m_snapshot = 0;
+  m_fixed = 0;
+  m_moving = 0;
+  m_accelerating = 0;
+  m_reference = 0;
+  Simulator::Destroy ();
+}
+
+static class MobilitySnapshotTestSuite : public TestSuite
+{
+public:
+  MobilitySnapshotTestSuite ()
+    : TestSuite ("mobility-snapshot", UNIT)
+  {
+    AddTestCase (new MobilitySnapshotTestCase, TestCase::QUICK);
+  }
+} g_mobilitySnapshotTestSuite;
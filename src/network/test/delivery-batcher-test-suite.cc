@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/delivery-batcher.h"
+
+using namespace ns3;
+
+class DeliveryBatcherTestCase : public TestCase
+{
+public:
+  DeliveryBatcherTestCase ();
+  virtual void DoRun (void);
+
+private:
+  void Receive (uint32_t id, uint32_t context);
+
+  std::vector<uint32_t> m_ids;
+  std::vector<uint32_t> m_contexts;
+  std::vector<Time> m_times;
+};
+
+DeliveryBatcherTestCase::DeliveryBatcherTestCase ()
+  : TestCase ("Check the contexts, times and order of the coalesced receptions")
+{
+}
+
+void
+DeliveryBatcherTestCase::Receive (uint32_t id, uint32_t context)
+{
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetContext (), context, "reception " << id << " invoked with the wrong context");
+  m_ids.push_back (id);
+  m_contexts.push_back (Simulator::GetContext ());
+  m_times.push_back (Simulator::Now ());
+}
+
+void
+DeliveryBatcherTestCase::DoRun (void)
+{
+  {
+    DeliveryBatcher batcher;
+    batcher.Add (1, MicroSeconds (2), MakeEvent (&DeliveryBatcherTestCase::Receive, this, 0, 1));
+    batcher.Add (2, MicroSeconds (2), MakeEvent (&DeliveryBatcherTestCase::Receive, this, 1, 2));
+    batcher.Add (1, MicroSeconds (2), MakeEvent (&DeliveryBatcherTestCase::Receive, this, 2, 1));
+    batcher.Add (1, MicroSeconds (1), MakeEvent (&DeliveryBatcherTestCase::Receive, this, 3, 1));
+    batcher.Add (2, MicroSeconds (2), MakeEvent (&DeliveryBatcherTestCase::Receive, this, 4, 2));
+    batcher.Add (2, MicroSeconds (2), MakeEvent (&DeliveryBatcherTestCase::Receive, this, 5, 2));
+    batcher.Schedule ();
+    // the receptions still pending are scheduled with the batcher destruction
+    batcher.Add (3, MicroSeconds (1), MakeEvent (&DeliveryBatcherTestCase::Receive, this, 6, 3));
+    batcher.Add (3, MicroSeconds (1), MakeEvent (&DeliveryBatcherTestCase::Receive, this, 7, 3));
+  }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // the receptions run in the order they were added, as if each of them
+  // had been scheduled on its own
+  uint32_t ids[] = { 3, 6, 7, 0, 1, 2, 4, 5 };
+  uint32_t contexts[] = { 1, 3, 3, 1, 2, 1, 2, 2 };
+  int64_t times[] = { 1, 1, 1, 2, 2, 2, 2, 2 };
+  NS_TEST_ASSERT_MSG_EQ (m_ids.size (), 8, "wrong number of receptions");
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_ids[i], ids[i], "wrong order of receptions");
+      NS_TEST_EXPECT_MSG_EQ (m_contexts[i], contexts[i], "wrong context of reception " << m_ids[i]);
+      NS_TEST_EXPECT_MSG_EQ (m_times[i], MicroSeconds (times[i]), "wrong time of reception " << m_ids[i]);
+    }
+}
+
+static class DeliveryBatcherTestSuite : public TestSuite
+{
+public:
+  DeliveryBatcherTestSuite ()
+    : TestSuite ("delivery-batcher", UNIT)
+  {
+    AddTestCase (new DeliveryBatcherTestCase (), TestCase::QUICK);
+  }
+} g_deliveryBatcherTestSuite;
@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "delivery-batcher.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("DeliveryBatcher");
+
+namespace ns3 {
+
+namespace {
+
+/**
+ * The simulator event which invokes a batch of receptions.
+ */
+class BatchEvent : public EventImpl
+{
+public:
+  /**
+   * \param events the receptions; the batch event takes ownership of them.
+   */
+  BatchEvent (std::vector<EventImpl *> &events)
+  {
+    m_events.swap (events);
+  }
+  virtual ~BatchEvent ()
+  {
+    for (std::vector<EventImpl *>::iterator i = m_events.begin (); i != m_events.end (); ++i)
+      {
+        (*i)->Unref ();
+      }
+  }
+private:
+  virtual void Notify (void)
+  {
+    for (std::vector<EventImpl *>::iterator i = m_events.begin (); i != m_events.end (); ++i)
+      {
+        (*i)->Invoke ();
+      }
+  }
+  std::vector<EventImpl *> m_events;
+};
+
+} // anonymous namespace
+
+DeliveryBatcher::DeliveryBatcher ()
+  : m_context (0),
+    m_first (0)
+{
+}
+
+DeliveryBatcher::~DeliveryBatcher ()
+{
+  Schedule ();
+}
+
+void
+DeliveryBatcher::Add (uint32_t context, const Time &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay << event);
+  if (m_first != 0 && context == m_context && delay == m_delay)
+    {
+      m_others.push_back (event);
+      return;
+    }
+  Schedule ();
+  m_context = context;
+  m_delay = delay;
+  m_first = event;
+}
+
+void
+DeliveryBatcher::Schedule (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_first == 0)
+    {
+      return;
+    }
+  EventImpl *event = m_first;
+  if (!m_others.empty ())
+    {
+      NS_LOG_LOGIC ("coalescing " << m_others.size () + 1 << " receptions of context " << m_context);
+      m_others.insert (m_others.begin (), m_first);
+      event = new BatchEvent (m_others);
+    }
+  m_first = 0;
+  Simulator::ScheduleWithContext (m_context, m_delay, event);
+}
+
+} // namespace ns3
@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef DELIVERY_BATCHER_H
+#define DELIVERY_BATCHER_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/nstime.h"
+#include "ns3/event-impl.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup channel
+ * \brief Coalesces the receptions of a transmission which reach the same
+ * node at the same time into a single simulator event.
+ *
+ * A channel creates one reception event per receiver (see MakeEvent) and
+ * hands it to Add () along with the context and the delay it would have
+ * been scheduled with.  Consecutive receptions which share a context and
+ * a delay are merged into a single event, scheduled with that context so
+ * that Simulator::GetContext () keeps returning the receiving node, which
+ * invokes them in the order they were added.  A reception which is not
+ * merged is scheduled as is, without any extra allocation.
+ *
+ * Only consecutive receptions are merged: the events are scheduled in the
+ * order they were added, so the receptions run in exactly the order they
+ * would have run had the channel scheduled them one by one.  Receptions
+ * with different contexts are never merged either: the context is what
+ * the simulator implementations (and the distributed ones in particular)
+ * use to identify the node an event belongs to.
+ *
+ * Receptions are only merged when a node has several devices attached to
+ * the same channel, since each device of the node is a receiver with the
+ * same context and delay.  With one device per node, as built by the
+ * usual helpers, every reception has its own context and the batcher
+ * schedules each of them unchanged.
+ *
+ * The receptions still pending when the batcher is destroyed are
+ * scheduled then, so that none of them is lost.
+ */
+class DeliveryBatcher
+{
+public:
+  DeliveryBatcher ();
+  /**
+   * Schedule the receptions added since the last call to Schedule ().
+   */
+  ~DeliveryBatcher ();
+
+  /**
+   * \param context the context the reception must be invoked with
+   * \param delay the delay of the reception, relative to now
+   * \param event the reception.  The batcher takes ownership of it.
+   *
+   * The receptions added before may be scheduled by this call.
+   */
+  void Add (uint32_t context, const Time &delay, EventImpl *event);
+  /**
+   * Schedule all the receptions added since the last call.
+   */
+  void Schedule (void);
+
+private:
+  DeliveryBatcher (const DeliveryBatcher &);
+  DeliveryBatcher & operator = (const DeliveryBatcher &);
+
+  /// context of the pending receptions
+  uint32_t m_context;
+  /// delay of the pending receptions
+  Time m_delay;
+  /// first pending reception, or zero if there is none
+  EventImpl *m_first;
+  /// the pending receptions which follow m_first
+  std::vector<EventImpl *> m_others;
+};
+
+} // namespace ns3
+
+#endif /* DELIVERY_BATCHER_H */
@@ -31,7 +31,9 @@
  *
  * Currently, the ns-3 model of nix-vector routing supports IPv4 p2p links 
  * as well as CSMA links.  It does not (yet) provide support for 
- * efficient adaptation to link failures.  It simply flushes all nix-vector 
+ * efficient adaptation to link failures.  When an interface goes down, it
+ * flushes the nix-vector caches of the nodes whose paths may go through
+ * the node of the interface; any other change flushes all nix-vector 
  * routing caches. Finally, IPv6 is not supported.
  *
  * \section api API and Usage
@@ -65,4 +67,9 @@
  * current node extracts the appropriate neighbor-index from the 
  * nix-vector and transmits the packet through the corresponding 
  * net-device.  This continues until the packet reaches the destination.
+ *
+ * The breadth-first search of a node is shared by all its destinations:
+ * it is resumed only until each new destination is reached, and it walks
+ * a compact copy of the topology (the neighbors of each net-device, by
+ * node index) which is built once for all the nodes.
  * */
@@ -34,6 +34,9 @@ namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (Ipv4NixVectorRouting);
 
+/* parent of the nodes not reached by a BFS */
+static const uint32_t NO_PARENT = 0xffffffff;
+
 TypeId 
 Ipv4NixVectorRouting::GetTypeId (void)
 {
@@ -45,7 +48,10 @@ Ipv4NixVectorRouting::GetTypeId (void)
 }
 
 Ipv4NixVectorRouting::Ipv4NixVectorRouting ()
-  : m_totalNeighbors (0)
+  : m_bfsExpanded (0),
+    m_bfsGeneration (0),
+    m_oifNixCached (false),
+    m_totalNeighbors (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -72,6 +78,8 @@ Ipv4NixVectorRouting::DoDispose ()
 
   m_node = 0;
   m_ipv4 = 0;
+  FlushNixCache ();
+  InvalidateTopology ();
 
   Ipv4RoutingProtocol::DoDispose ();
 }
@@ -89,6 +97,7 @@ void
 Ipv4NixVectorRouting::FlushGlobalNixRoutingCache ()
 {
   NS_LOG_FUNCTION_NOARGS ();
+  InvalidateTopology ();
   NodeList::Iterator listEnd = NodeList::End ();
   for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
     {
@@ -104,11 +113,65 @@ Ipv4NixVectorRouting::FlushGlobalNixRoutingCache ()
     }
 }
 
+void
+Ipv4NixVectorRouting::FlushAffectedNixRoutingCaches ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  if (!m_node)
+    {
+      FlushGlobalNixRoutingCache ();
+      return;
+    }
+  uint32_t nodeId = m_node->GetId ();
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<Node> node = *i;
+      Ptr<Ipv4NixVectorRouting> rp = node->GetObject<Ipv4NixVectorRouting> ();
+      if (!rp)
+        {
+          continue;
+        }
+      rp->FlushIpv4RouteCache ();
+      if (rp->IsTreeAffected (nodeId))
+        {
+          NS_LOG_LOGIC ("Flushing Nix cache of node " << node->GetId ());
+          rp->FlushNixCache ();
+        }
+    }
+}
+
+bool
+Ipv4NixVectorRouting::IsTreeAffected (uint32_t nodeId) const
+{
+  if (m_oifNixCached)
+    {
+      return true;
+    }
+  if (m_bfsParents.empty ())
+    {
+      // the cache only holds destinations without a path
+      return false;
+    }
+  if (m_bfsGeneration != PeekTopology ().generation)
+    {
+      return true;
+    }
+  // a node which did not reach any other node in the tree
+  // cannot change the tree by losing an interface
+  return nodeId < m_bfsInterior.size () && m_bfsInterior[nodeId];
+}
+
 void
 Ipv4NixVectorRouting::FlushNixCache ()
 {
   NS_LOG_FUNCTION_NOARGS ();
   m_nixCache.clear ();
+  std::vector<uint32_t> ().swap (m_bfsParents);
+  std::vector<uint32_t> ().swap (m_bfsQueue);
+  std::vector<bool> ().swap (m_bfsInterior);
+  m_bfsExpanded = 0;
+  m_oifNixCached = false;
 }
 
 void
@@ -147,11 +210,24 @@ Ipv4NixVectorRouting::GetNixVector (Ptr<Node> source, Ipv4Address dest, Ptr<NetD
     {
       // otherwise proceed as normal 
       // and build the nix vector
-      std::vector< Ptr<Node> > parentVector;
+      const std::vector<uint32_t> *parentVector = &m_bfsParents;
+      std::vector<uint32_t> oifParentVector;
 
-      BFS (NodeList::GetNNodes (), source, destNode, parentVector, oif);
+      if (oif)
+        {
+          // the BFS tree of this node cannot be used when
+          // a specific output interface is given
+          m_oifNixCached = true;
+          BFS (source, destNode, oifParentVector, oif);
+          parentVector = &oifParentVector;
+        }
+      else
+        {
+          NS_ASSERT (source == m_node);
+          ExpandTree (destNode->GetId ());
+        }
 
-      if (BuildNixVector (parentVector, source->GetId (), destNode->GetId (), nixVector))
+      if (BuildNixVector (*parentVector, source->GetId (), destNode->GetId (), nixVector))
         {
           return nixVector;
         }
@@ -196,34 +272,7 @@ Ipv4NixVectorRouting::GetIpv4RouteInCache (Ipv4Address address)
 }
 
 bool
-Ipv4NixVectorRouting::BuildNixVectorLocal (Ptr<NixVector> nixVector)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-
-  uint32_t numberOfDevices = m_node->GetNDevices ();
-
-  // here we are building a nix vector to 
-  // ourself, so we need to find the loopback 
-  // interface and add that to the nix vector
-  Ipv4Address loopback ("127.0.0.1");
-  for (uint32_t i = 0; i < numberOfDevices; i++)
-    {
-      uint32_t interfaceIndex = (m_ipv4)->GetInterfaceForDevice (m_node->GetDevice (i));
-      Ipv4InterfaceAddress ifAddr = m_ipv4->GetAddress (interfaceIndex, 0);
-      if (ifAddr.GetLocal () == loopback)
-        {
-          NS_LOG_LOGIC ("Adding loopback to nix.");
-          NS_LOG_LOGIC ("Adding Nix: " << i << " with " << nixVector->BitCount (numberOfDevices) 
-                                       << " bits, for node " << m_node->GetId ());
-          nixVector->AddNeighborIndex (i, nixVector->BitCount (numberOfDevices));
-          return true;
-        }
-    }
-  return false;
-}
-
-bool
-Ipv4NixVectorRouting::BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector)
+Ipv4NixVectorRouting::BuildNixVector (const std::vector<uint32_t> & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
@@ -232,66 +281,48 @@ Ipv4NixVectorRouting::BuildNixVector (const std::vector< Ptr<Node> > & parentVec
       return true;
     }
 
-  if (parentVector.at (dest) == 0)
+  if (parentVector.at (dest) == NO_PARENT)
     {
       return false;
     }
 
-  Ptr<Node> parentNode = parentVector.at (dest);
+  uint32_t parentNode = parentVector.at (dest);
+  const Topology &topology = PeekTopology ();
 
-  uint32_t numberOfDevices = parentNode->GetNDevices ();
   uint32_t destId = 0;
   uint32_t totalNeighbors = 0;
 
   // scan through the net devices on the parent node
   // and then look at the nodes adjacent to them
-  for (uint32_t i = 0; i < numberOfDevices; i++)
+  for (uint32_t i = topology.firstDevice[parentNode]; i < topology.firstDevice[parentNode + 1]; i++)
     {
-      // Get a net device from the node
-      // as well as the channel, and figure
-      // out the adjacent net devices
-      Ptr<NetDevice> localNetDevice = parentNode->GetDevice (i);
-      if (localNetDevice->IsBridge ())
-        {
-          continue;
-        }
-      Ptr<Channel> channel = localNetDevice->GetChannel ();
-      if (channel == 0)
+      if (topology.devices[i].bridge)
         {
           continue;
         }
 
-      // this function takes in the local net dev, and channnel, and
-      // writes to the netDeviceContainer the adjacent net devs
-      NetDeviceContainer netDeviceContainer;
-      GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
-
-      // Finally we can get the adjacent nodes
-      // and scan through them.  If we find the 
-      // node that matches "dest" then we can add 
-      // the index  to the nix vector.
+      // If we find the node that matches "dest" then we
+      // can add the index to the nix vector.
       // the index corresponds to the neighbor index
-      uint32_t offset = 0;
-      for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+      uint32_t first = topology.devices[i].firstNeighbor;
+      uint32_t last = topology.devices[i + 1].firstNeighbor;
+      for (uint32_t j = first; j < last; j++)
         {
-          Ptr<Node> remoteNode = (*iter)->GetNode ();
-
-          if (remoteNode->GetId () == dest)
+          if (topology.neighbors[j] == dest)
             {
-              destId = totalNeighbors + offset;
+              destId = totalNeighbors + j - first;
             }
-          offset += 1;
         }
 
-      totalNeighbors += netDeviceContainer.GetN ();
+      totalNeighbors += last - first;
     }
   NS_LOG_LOGIC ("Adding Nix: " << destId << " with " 
-                               << nixVector->BitCount (totalNeighbors) << " bits, for node " << parentNode->GetId ());
+                               << nixVector->BitCount (totalNeighbors) << " bits, for node " << parentNode);
   nixVector->AddNeighborIndex (destId, nixVector->BitCount (totalNeighbors));
 
   // recurse through parent vector, grabbing the path 
   // and building the nix vector
-  BuildNixVector (parentVector, source, (parentVector.at (dest))->GetId (), nixVector);
+  BuildNixVector (parentVector, source, parentNode, nixVector);
   return true;
 }
 
@@ -340,27 +371,16 @@ Ipv4NixVectorRouting::GetNodeByIp (Ipv4Address dest)
 { 
   NS_LOG_FUNCTION_NOARGS ();
 
-  NodeContainer allNodes = NodeContainer::GetGlobal ();
-  Ptr<Node> destNode;
+  const Topology &topology = GetTopology ();
+  std::map<Ipv4Address, uint32_t>::const_iterator i = topology.nodeByAddress.find (dest);
 
-  for (NodeContainer::Iterator i = allNodes.Begin (); i != allNodes.End (); ++i)
-    {
-      Ptr<Node> node = *i;
-      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-      if (ipv4->GetInterfaceForAddress (dest) != -1)
-        {
-          destNode = node;
-          break;
-        }
-    }
-
-  if (!destNode)
+  if (i == topology.nodeByAddress.end ())
     {
       NS_LOG_ERROR ("Couldn't find dest node given the IP" << dest);
       return 0;
     }
 
-  return destNode;
+  return NodeList::GetNode (i->second);
 }
 
 uint32_t
@@ -712,7 +732,8 @@ Ipv4NixVectorRouting::NotifyInterfaceUp (uint32_t i)
 void
 Ipv4NixVectorRouting::NotifyInterfaceDown (uint32_t i)
 {
-  FlushGlobalNixRoutingCache ();
+  // the paths which do not go through this node do not change
+  FlushAffectedNixRoutingCaches ();
 }
 void
 Ipv4NixVectorRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
@@ -726,151 +747,232 @@ Ipv4NixVectorRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddr
 }
 
 bool
-Ipv4NixVectorRouting::BFS (uint32_t numberOfNodes, Ptr<Node> source, 
-                           Ptr<Node> dest, std::vector< Ptr<Node> > & parentVector,
+Ipv4NixVectorRouting::BFS (Ptr<Node> source, Ptr<Node> dest,
+                           std::vector<uint32_t> & parentVector,
                            Ptr<NetDevice> oif)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
   NS_LOG_LOGIC ("Going from Node " << source->GetId () << " to Node " << dest->GetId ());
-  std::queue< Ptr<Node> > greyNodeList;  // discovered nodes with unexplored children
+  const Topology &topology = GetTopology ();
+  std::vector<uint32_t> greyNodeList;  // discovered nodes, in the order they are explored
 
   // reset the parent vector
-  parentVector.clear ();
-  parentVector.reserve (sizeof (Ptr<Node>)*numberOfNodes);
-  parentVector.insert (parentVector.begin (), sizeof (Ptr<Node>)*numberOfNodes, 0); // initialize to 0
+  parentVector.assign (topology.ipv4.size (), NO_PARENT);
 
   // Add the source node to the queue, set its parent to itself 
-  greyNodeList.push (source);
-  parentVector.at (source->GetId ()) = source;
+  greyNodeList.push_back (source->GetId ());
+  parentVector.at (source->GetId ()) = source->GetId ();
 
   // BFS loop
-  while (greyNodeList.size () != 0)
+  for (uint32_t head = 0; head < greyNodeList.size (); head++)
     {
-      Ptr<Node> currNode = greyNodeList.front ();
-      Ptr<Ipv4> ipv4 = currNode->GetObject<Ipv4> ();
- 
-      if (currNode == dest) 
+      uint32_t currNode = greyNodeList[head];
+
+      if (currNode == dest->GetId ())
         {
-          NS_LOG_LOGIC ("Made it to Node " << currNode->GetId ());
+          NS_LOG_LOGIC ("Made it to Node " << currNode);
           return true;
         }
 
       // if this is the first iteration of the loop and a 
       // specific output interface was given, make sure 
       // we go this way
-      if (currNode == source && oif)
+      ExpandNode (currNode, head == 0 ? oif : 0, parentVector, greyNodeList);
+    }
+
+  // Didn't find the dest...
+  return false;
+}
+
+bool
+Ipv4NixVectorRouting::ExpandTree (uint32_t dest)
+{
+  NS_LOG_FUNCTION (this << dest);
+
+  const Topology &topology = GetTopology ();
+  if (m_bfsParents.empty () || m_bfsGeneration != topology.generation)
+    {
+      uint32_t source = m_node->GetId ();
+      NS_LOG_LOGIC ("New BFS tree from Node " << source);
+      m_bfsGeneration = topology.generation;
+      m_bfsParents.assign (topology.ipv4.size (), NO_PARENT);
+      m_bfsInterior.assign (topology.ipv4.size (), false);
+      m_bfsQueue.clear ();
+      m_bfsQueue.push_back (source);
+      m_bfsParents[source] = source;
+      m_bfsExpanded = 0;
+    }
+
+  // resume the BFS until the destination is reached
+  while (m_bfsParents[dest] == NO_PARENT && m_bfsExpanded < m_bfsQueue.size ())
+    {
+      uint32_t currNode = m_bfsQueue[m_bfsExpanded++];
+      if (ExpandNode (currNode, 0, m_bfsParents, m_bfsQueue))
         {
-          // make sure that we can go this way
-          if (ipv4)
-            {
-              uint32_t interfaceIndex = (ipv4)->GetInterfaceForDevice (oif);
-              if (!(ipv4->IsUp (interfaceIndex)))
-                {
-                  NS_LOG_LOGIC ("Ipv4Interface is down");
-                  return false;
-                }
-            }
-          if (!(oif->IsLinkUp ()))
+          m_bfsInterior[currNode] = true;
+        }
+    }
+
+  if (m_bfsExpanded == m_bfsQueue.size ())
+    {
+      NS_LOG_LOGIC ("BFS tree from Node " << m_node->GetId () << " complete");
+      std::vector<uint32_t> ().swap (m_bfsQueue);
+      m_bfsExpanded = 0;
+    }
+
+  return m_bfsParents[dest] != NO_PARENT;
+}
+
+bool
+Ipv4NixVectorRouting::ExpandNode (uint32_t node, Ptr<NetDevice> oif,
+                                  std::vector<uint32_t> & parentVector,
+                                  std::vector<uint32_t> & queue)
+{
+  const Topology &topology = PeekTopology ();
+  Ptr<Ipv4> ipv4 = topology.ipv4[node];
+  bool expanded = false;
+
+  // Iterate over the current node's adjacent vertices
+  // and push them into the queue
+  for (uint32_t i = topology.firstDevice[node]; i < topology.firstDevice[node + 1]; i++)
+    {
+      const TopologyDevice &device = topology.devices[i];
+      if (oif && device.device != oif)
+        {
+          continue;
+        }
+
+      // make sure that we can go this way
+      if (ipv4 && (device.interface < 0 || !(ipv4->IsUp (device.interface))))
+        {
+          NS_LOG_LOGIC ("Ipv4Interface is down");
+          continue;
+        }
+      if (!(device.device->IsLinkUp ()))
+        {
+          NS_LOG_LOGIC ("Link is down.");
+          continue;
+        }
+
+      // Finally we can get the adjacent nodes
+      // and scan through them.  We push them
+      // to the greyNode queue, if they aren't 
+      // already there.
+      for (uint32_t j = device.firstNeighbor; j < topology.devices[i + 1].firstNeighbor; j++)
+        {
+          uint32_t remoteNode = topology.neighbors[j];
+
+          // check to see if this node has been pushed before
+          // by checking to see if it has a parent
+          // if it doesn't, then set its parent and 
+          // push to the queue
+          if (parentVector[remoteNode] == NO_PARENT)
             {
-              NS_LOG_LOGIC ("Link is down.");
-              return false;
+              parentVector[remoteNode] = node;
+              queue.push_back (remoteNode);
+              expanded = true;
             }
-          Ptr<Channel> channel = oif->GetChannel ();
+        }
+    }
+  return expanded;
+}
+
+const Ipv4NixVectorRouting::Topology &
+Ipv4NixVectorRouting::GetTopology (void)
+{
+  Topology &topology = PeekTopology ();
+  uint32_t nNodes = NodeList::GetNNodes ();
+  if (topology.valid && topology.ipv4.size () == nNodes)
+    {
+      return topology;
+    }
+
+  NS_LOG_FUNCTION_NOARGS ();
+  InvalidateTopology ();
+  topology.valid = true;
+  topology.ipv4.reserve (nNodes);
+  topology.firstDevice.reserve (nNodes + 1);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Ptr<Node> node = NodeList::GetNode (i);
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+      topology.ipv4.push_back (ipv4);
+      topology.firstDevice.push_back (topology.devices.size ());
+      for (uint32_t j = 0; j < node->GetNDevices (); j++)
+        {
+          Ptr<NetDevice> localNetDevice = node->GetDevice (j);
+          Ptr<Channel> channel = localNetDevice->GetChannel ();
           if (channel == 0)
-            { 
-              return false;
+            {
+              continue;
             }
+          TopologyDevice device;
+          device.device = localNetDevice;
+          device.interface = ipv4 ? ipv4->GetInterfaceForDevice (localNetDevice) : -1;
+          device.bridge = localNetDevice->IsBridge ();
+          device.firstNeighbor = topology.neighbors.size ();
+          topology.devices.push_back (device);
 
-          // this function takes in the local net dev, and channnel, and
-          // writes to the netDeviceContainer the adjacent net devs
           NetDeviceContainer netDeviceContainer;
-          GetAdjacentNetDevices (oif, channel, netDeviceContainer);
-
-          // Finally we can get the adjacent nodes
-          // and scan through them.  We push them
-          // to the greyNode queue, if they aren't 
-          // already there.
+          GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
           for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
             {
-              Ptr<Node> remoteNode = (*iter)->GetNode ();
-
-              // check to see if this node has been pushed before
-              // by checking to see if it has a parent
-              // if it doesn't (null or 0), then set its parent and 
-              // push to the queue
-              if (parentVector.at (remoteNode->GetId ()) == 0)
-                {
-                  parentVector.at (remoteNode->GetId ()) = currNode;
-                  greyNodeList.push (remoteNode);
-                }
+              topology.neighbors.push_back ((*iter)->GetNode ()->GetId ());
             }
         }
-      else
+      if (ipv4)
         {
-          // Iterate over the current node's adjacent vertices
-          // and push them into the queue
-          for (uint32_t i = 0; i < (currNode->GetNDevices ()); i++)
+          // the first node holding an address is its destination
+          for (uint32_t j = 0; j < ipv4->GetNInterfaces (); j++)
             {
-              // Get a net device from the node
-              // as well as the channel, and figure
-              // out the adjacent net device
-              Ptr<NetDevice> localNetDevice = currNode->GetDevice (i);
-
-              // make sure that we can go this way
-              if (ipv4)
-                {
-                  uint32_t interfaceIndex = (ipv4)->GetInterfaceForDevice (currNode->GetDevice (i));
-                  if (!(ipv4->IsUp (interfaceIndex)))
-                    {
-                      NS_LOG_LOGIC ("Ipv4Interface is down");
-                      continue;
-                    }
-                }
-              if (!(localNetDevice->IsLinkUp ()))
+              for (uint32_t k = 0; k < ipv4->GetNAddresses (j); k++)
                 {
-                  NS_LOG_LOGIC ("Link is down.");
-                  continue;
-                }
-              Ptr<Channel> channel = localNetDevice->GetChannel ();
-              if (channel == 0)
-                { 
-                  continue;
-                }
-
-              // this function takes in the local net dev, and channnel, and
-              // writes to the netDeviceContainer the adjacent net devs
-              NetDeviceContainer netDeviceContainer;
-              GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
-
-              // Finally we can get the adjacent nodes
-              // and scan through them.  We push them
-              // to the greyNode queue, if they aren't 
-              // already there.
-              for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
-                {
-                  Ptr<Node> remoteNode = (*iter)->GetNode ();
-
-                  // check to see if this node has been pushed before
-                  // by checking to see if it has a parent
-                  // if it doesn't (null or 0), then set its parent and 
-                  // push to the queue
-                  if (parentVector.at (remoteNode->GetId ()) == 0)
-                    {
-                      parentVector.at (remoteNode->GetId ()) = currNode;
-                      greyNodeList.push (remoteNode);
-                    }
+                  topology.nodeByAddress.insert (std::make_pair (ipv4->GetAddress (j, k).GetLocal (), i));
                 }
             }
         }
+    }
+  topology.firstDevice.push_back (topology.devices.size ());
+  TopologyDevice sentinel;
+  sentinel.interface = -1;
+  sentinel.bridge = false;
+  sentinel.firstNeighbor = topology.neighbors.size ();
+  topology.devices.push_back (sentinel);
+  NS_LOG_LOGIC ("Topology of " << nNodes << " nodes, " << topology.devices.size () - 1
+                << " net devices and " << topology.neighbors.size () << " adjacencies");
+  return topology;
+}
 
-      // Pop off the head grey node.  We have all its children.
-      // It is now black.
-      greyNodeList.pop ();
+void
+Ipv4NixVectorRouting::InvalidateTopology (void)
+{
+  Topology &topology = PeekTopology ();
+  if (!topology.valid)
+    {
+      return;
     }
+  topology.valid = false;
+  topology.generation++;
+  std::vector<Ptr<Ipv4> > ().swap (topology.ipv4);
+  std::vector<uint32_t> ().swap (topology.firstDevice);
+  std::vector<TopologyDevice> ().swap (topology.devices);
+  std::vector<uint32_t> ().swap (topology.neighbors);
+  topology.nodeByAddress.clear ();
+}
 
-  // Didn't find the dest...
-  return false;
+Ipv4NixVectorRouting::Topology &
+Ipv4NixVectorRouting::PeekTopology (void)
+{
+  static Topology topology;
+  static bool initialized = false;
+  if (!initialized)
+    {
+      topology.valid = false;
+      topology.generation = 0;
+      initialized = true;
+    }
+  return topology;
 }
 
 } // namespace ns3
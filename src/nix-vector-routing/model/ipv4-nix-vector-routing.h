@@ -22,6 +22,7 @@
 #define IPV4_NIX_VECTOR_ROUTING_H
 
 #include <map>
+#include <vector>
 
 #include "ns3/channel.h"
 #include "ns3/node-container.h"
@@ -32,6 +33,8 @@
 #include "ns3/nix-vector.h"
 #include "ns3/bridge-net-device.h"
 
+class Ipv4NixVectorRoutingTestCase;
+
 namespace ns3 {
 
 /**
@@ -48,6 +51,14 @@ typedef std::map<Ipv4Address, Ptr<Ipv4Route> > Ipv4RouteMap_t;
 /**
  * \ingroup nix-vector-routing
  * Nix-vector routing protocol
+ *
+ * The nix-vectors are computed on demand from a breadth-first search
+ * tree rooted at the source node.  The tree is expanded only as far as
+ * needed to reach each new destination and is shared by all the
+ * destinations of the source.  The search walks a compact copy of the
+ * topology (the nodes adjacent to each net device, by node index) built
+ * once for all the nodes.  An interface going down only flushes the
+ * caches of the nodes whose tree goes through the node of the interface.
  */
 class Ipv4NixVectorRouting : public Ipv4RoutingProtocol
 {
@@ -77,10 +88,21 @@ public:
   void FlushGlobalNixRoutingCache (void);
 
 private:
+  friend class ::Ipv4NixVectorRoutingTestCase;
+
   /* flushes the cache which stores nix-vector based on
-   * destination IP */
+   * destination IP, and the BFS tree they come from */
   void FlushNixCache (void);
 
+  /* after an interface of this node went down, flushes the
+   * Ipv4 route caches of all the nodes and the nix-vector caches
+   * of the nodes whose BFS tree goes through this node */
+  void FlushAffectedNixRoutingCaches (void);
+
+  /* returns true if the nix-vectors cached by this node may
+   * go through the given node */
+  bool IsTreeAffected (uint32_t nodeId) const;
+
   /* flushes the cache which stores the Ipv4 route
    * based on the destination IP */
   void FlushIpv4RouteCache (void);
@@ -105,15 +127,11 @@ private:
    * essentially getting the neighbors on that channel */
   void GetAdjacentNetDevices (Ptr<NetDevice>, Ptr<Channel>, NetDeviceContainer &);
 
-  /* iterates through the node list and finds the one
-   * corresponding to the given Ipv4Address */
+  /* finds the node corresponding to the given Ipv4Address */
   Ptr<Node> GetNodeByIp (Ipv4Address);
 
   /* Recurses the parent vector, created by BFS and actually builds the nixvector */
-  bool BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector);
-
-  /* special variation of BuildNixVector for when a node is sending to itself */
-  bool BuildNixVectorLocal (Ptr<NixVector> nixVector);
+  bool BuildNixVector (const std::vector<uint32_t> & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector);
 
   /* simple iterates through the nodes net-devices and determines
    * how many neighbors it has */
@@ -128,19 +146,65 @@ private:
   uint32_t FindNetDeviceForNixIndex (uint32_t nodeIndex, Ipv4Address & gatewayIp);
 
   /* Breadth first search algorithm
-   * Param1: total number of nodes
-   * Param2: Source Node
-   * Param3: Dest Node
-   * Param4: (returned) Parent vector for retracing routes
-   * Param5: specific output interface to use from source node, if not null
+   * Param1: Source Node
+   * Param2: Dest Node
+   * Param3: (returned) Parent vector for retracing routes
+   * Param4: specific output interface to use from source node, if not null
    * Returns: false if dest not found, true o.w.
    */
-  bool BFS (uint32_t numberOfNodes,
-            Ptr<Node> source,
+  bool BFS (Ptr<Node> source,
             Ptr<Node> dest,
-            std::vector< Ptr<Node> > & parentVector,
+            std::vector<uint32_t> & parentVector,
             Ptr<NetDevice> oif);
 
+  /* expands the BFS tree rooted at this node until the given
+   * node is reached, or the whole topology is explored
+   * Returns: false if dest not found, true o.w. */
+  bool ExpandTree (uint32_t dest);
+
+  /* BFS step: pushes to the queue the nodes adjacent to the given
+   * node which have not been reached yet, going out of the given
+   * net device only if not null
+   * Returns: true if any node was pushed */
+  static bool ExpandNode (uint32_t node,
+                          Ptr<NetDevice> oif,
+                          std::vector<uint32_t> & parentVector,
+                          std::vector<uint32_t> & queue);
+
+  /* a net device of the topology and the nodes adjacent to it */
+  struct TopologyDevice
+  {
+    Ptr<NetDevice> device;   /* the net device */
+    int32_t interface;       /* its Ipv4 interface, -1 if none */
+    bool bridge;             /* true if it is a bridge net device */
+    uint32_t firstNeighbor;  /* index of its first neighbor in Topology::neighbors */
+  };
+
+  /* compact view of the topology, shared by all the nodes: the
+   * net devices of node i are devices[firstDevice[i]] to
+   * devices[firstDevice[i + 1] - 1], and the nodes adjacent to the
+   * net device j are neighbors[devices[j].firstNeighbor] to
+   * neighbors[devices[j + 1].firstNeighbor - 1] */
+  struct Topology
+  {
+    bool valid;                              /* false if it must be rebuilt */
+    uint32_t generation;                     /* incremented at each rebuild */
+    std::vector<Ptr<Ipv4> > ipv4;            /* the Ipv4 of each node */
+    std::vector<uint32_t> firstDevice;       /* by node, plus one */
+    std::vector<TopologyDevice> devices;     /* by node, plus one */
+    std::vector<uint32_t> neighbors;         /* by net device */
+    std::map<Ipv4Address, uint32_t> nodeByAddress; /* the node of each address */
+  };
+
+  /* returns the shared topology, built if needed */
+  const Topology & GetTopology (void);
+
+  /* discards the shared topology, which is built again when needed */
+  static void InvalidateTopology (void);
+
+  /* the shared topology */
+  static Topology & PeekTopology (void);
+
   void DoDispose (void);
 
   /* From Ipv4RoutingProtocol */
@@ -162,6 +226,21 @@ private:
   /* cache stores Ipv4Routes based on destination ip */
   Ipv4RouteMap_t m_ipv4RouteCache;
 
+  /* BFS tree rooted at this node, shared by the nix-vectors in
+   * m_nixCache: the parent of each node (itself for this node),
+   * the nodes reached in BFS order, the number of them already
+   * expanded, the nodes which have children, and the generation
+   * of the topology the tree comes from */
+  std::vector<uint32_t> m_bfsParents;
+  std::vector<uint32_t> m_bfsQueue;
+  uint32_t m_bfsExpanded;
+  std::vector<bool> m_bfsInterior;
+  uint32_t m_bfsGeneration;
+
+  /* true if m_nixCache holds nix-vectors which were built for a
+   * specific output interface, hence not from the BFS tree */
+  bool m_oifNixCached;
+
   Ptr<Ipv4> m_ipv4;
   Ptr<Node> m_node;
 
@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/ipv4-nix-vector-helper.h"
+#include "ns3/ipv4-nix-vector-routing.h"
+
+using namespace ns3;
+
+/**
+ * Check the nix-vectors built from the BFS trees shared by the
+ * destinations of a node, and the caches flushed when an interface
+ * goes down, on the topology
+ *
+ *   n4 -- n0 -- n1 -- n2 -- n3
+ *               |           |
+ *               +--- n5 ----+
+ *
+ * where n1 reaches n3 through n2 first.
+ */
+class Ipv4NixVectorRoutingTestCase : public TestCase
+{
+public:
+  Ipv4NixVectorRoutingTestCase ();
+  virtual ~Ipv4NixVectorRoutingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Connect two nodes with a channel of their own.
+   * \returns the two net devices, the one of a first
+   */
+  NetDeviceContainer Link (Ptr<Node> a, Ptr<Node> b);
+  /**
+   * \returns the route of the source node to the destination, 0 if none
+   */
+  Ptr<Ipv4Route> Route (Ptr<Node> source, Ipv4Address dest);
+  /**
+   * \returns the nix-vector cached by the source node for the
+   * destination, 0 if none
+   */
+  Ptr<NixVector> Cached (Ptr<Node> source, Ipv4Address dest);
+  /**
+   * Check the nix-vector cached by the source node for the destination
+   * against the one built from a separate BFS.
+   */
+  void CheckFreshBfs (Ptr<Node> source, Ptr<Node> dest, Ipv4Address address);
+};
+
+Ipv4NixVectorRoutingTestCase::Ipv4NixVectorRoutingTestCase ()
+  : TestCase ("Check the nix-vectors of the shared BFS trees and the flush of the affected caches")
+{
+}
+
+Ipv4NixVectorRoutingTestCase::~Ipv4NixVectorRoutingTestCase ()
+{
+}
+
+NetDeviceContainer
+Ipv4NixVectorRoutingTestCase::Link (Ptr<Node> a, Ptr<Node> b)
+{
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  NetDeviceContainer devices;
+  Ptr<Node> nodes[] = { a, b };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      device->SetChannel (channel);
+      nodes[i]->AddDevice (device);
+      devices.Add (device);
+    }
+  return devices;
+}
+
+Ptr<Ipv4Route>
+Ipv4NixVectorRoutingTestCase::Route (Ptr<Node> source, Ipv4Address dest)
+{
+  Ipv4Header header;
+  header.SetDestination (dest);
+  Socket::SocketErrno sockerr;
+  return source->GetObject<Ipv4NixVectorRouting> ()->RouteOutput (0, header, 0, sockerr);
+}
+
+Ptr<NixVector>
+Ipv4NixVectorRoutingTestCase::Cached (Ptr<Node> source, Ipv4Address dest)
+{
+  return source->GetObject<Ipv4NixVectorRouting> ()->GetNixVectorInCache (dest);
+}
+
+void
+Ipv4NixVectorRoutingTestCase::CheckFreshBfs (Ptr<Node> source, Ptr<Node> dest, Ipv4Address address)
+{
+  Ptr<Ipv4NixVectorRouting> rp = source->GetObject<Ipv4NixVectorRouting> ();
+  std::vector<uint32_t> parents;
+  NS_TEST_ASSERT_MSG_EQ (rp->BFS (source, dest, parents, 0), true,
+                         "no path from node " << source->GetId () << " to node " << dest->GetId ());
+  Ptr<NixVector> fresh = Create<NixVector> ();
+  rp->BuildNixVector (parents, source->GetId (), dest->GetId (), fresh);
+
+  Ptr<NixVector> cached = Cached (source, address);
+  NS_TEST_ASSERT_MSG_NE (cached, 0, "no nix-vector cached for " << address);
+  std::ostringstream expected, actual;
+  expected << *fresh;
+  actual << *cached;
+  NS_TEST_EXPECT_MSG_EQ (actual.str (), expected.str (),
+                         "wrong nix-vector from node " << source->GetId () << " to node " << dest->GetId ());
+}
+
+void
+Ipv4NixVectorRoutingTestCase::DoRun (void)
+{
+  NodeContainer n;
+  n.Create (6);
+  Ipv4NixVectorHelper nixRouting;
+  InternetStackHelper internet;
+  internet.SetRoutingHelper (nixRouting);
+  internet.Install (n);
+
+  // the links, in the order of the net devices of n1
+  NetDeviceContainer links[] = {
+    Link (n.Get (0), n.Get (1)),
+    Link (n.Get (1), n.Get (2)),
+    Link (n.Get (1), n.Get (5)),
+    Link (n.Get (2), n.Get (3)),
+    Link (n.Get (5), n.Get (3)),
+    Link (n.Get (4), n.Get (0))
+  };
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces[6];
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      interfaces[i] = ipv4.Assign (links[i]);
+      ipv4.NewNetwork ();
+    }
+  Ipv4Address n0Address = interfaces[0].GetAddress (0);
+  Ipv4Address n1Address = interfaces[0].GetAddress (1);
+  Ipv4Address n2Address = interfaces[1].GetAddress (1);
+  Ipv4Address n3Address = interfaces[3].GetAddress (1);
+
+  // several destinations of n0, all from the same tree
+  Ipv4Address dests[] = { n1Address, n3Address, n2Address };
+  Ptr<Node> destNodes[] = { n.Get (1), n.Get (3), n.Get (2) };
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<Ipv4Route> route = Route (n.Get (0), dests[i]);
+      NS_TEST_ASSERT_MSG_NE (route, 0, "no route from n0 to " << dests[i]);
+      NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), n1Address, "wrong gateway from n0 to " << dests[i]);
+      NS_TEST_EXPECT_MSG_EQ (route->GetOutputDevice (), links[0].Get (0), "wrong output device from n0 to " << dests[i]);
+    }
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      CheckFreshBfs (n.Get (0), destNodes[i], dests[i]);
+    }
+  Ptr<Ipv4NixVectorRouting> rp0 = n.Get (0)->GetObject<Ipv4NixVectorRouting> ();
+  NS_TEST_ASSERT_MSG_EQ (rp0->m_bfsParents.at (n.Get (3)->GetId ()), n.Get (2)->GetId (), "n3 not reached through n2");
+
+  // trees which do not go through n2: n4 only expands itself to
+  // reach n0, and n5 only expands itself to reach n1
+  NS_TEST_ASSERT_MSG_NE (Route (n.Get (4), n0Address), 0, "no route from n4 to n0");
+  NS_TEST_ASSERT_MSG_NE (Route (n.Get (5), n1Address), 0, "no route from n5 to n1");
+  Ptr<NixVector> n4Cached = Cached (n.Get (4), n0Address);
+  Ptr<NixVector> n5Cached = Cached (n.Get (5), n1Address);
+
+  // the link of n2 to n3 goes down
+  Ptr<Ipv4> n2Ipv4 = n.Get (2)->GetObject<Ipv4> ();
+  n2Ipv4->SetDown (n2Ipv4->GetInterfaceForDevice (links[3].Get (0)));
+
+  NS_TEST_EXPECT_MSG_EQ (rp0->m_nixCache.empty (), true, "the cache of n0 goes through n2");
+  NS_TEST_EXPECT_MSG_EQ (rp0->m_bfsParents.empty (), true, "the tree of n0 goes through n2");
+  NS_TEST_EXPECT_MSG_EQ (Cached (n.Get (4), n0Address), n4Cached, "the cache of n4 does not go through n2");
+  NS_TEST_EXPECT_MSG_EQ (Cached (n.Get (5), n1Address), n5Cached, "the cache of n5 does not go through n2");
+  NS_TEST_EXPECT_MSG_EQ (n.Get (4)->GetObject<Ipv4NixVectorRouting> ()->m_bfsParents.empty (), false,
+                         "the tree of n4 does not go through n2");
+
+  // n3 is now reached through n5
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<Ipv4Route> route = Route (n.Get (0), dests[i]);
+      NS_TEST_ASSERT_MSG_NE (route, 0, "no route from n0 to " << dests[i] << " after the link went down");
+      NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), n1Address, "wrong gateway from n0 to " << dests[i]);
+      CheckFreshBfs (n.Get (0), destNodes[i], dests[i]);
+    }
+  NS_TEST_EXPECT_MSG_EQ (rp0->m_bfsParents.at (n.Get (3)->GetId ()), n.Get (5)->GetId (), "n3 not reached through n5");
+
+  Simulator::Destroy ();
+}
+
+class Ipv4NixVectorRoutingTestSuite : public TestSuite
+{
+public:
+  Ipv4NixVectorRoutingTestSuite ();
+};
+
+Ipv4NixVectorRoutingTestSuite::Ipv4NixVectorRoutingTestSuite ()
+  : TestSuite ("nix-vector-routing", UNIT)
+{
+  AddTestCase (new Ipv4NixVectorRoutingTestCase (), TestCase::QUICK);
+}
+
+static Ipv4NixVectorRoutingTestSuite g_ipv4NixVectorRoutingTestSuite;
@@ -27,6 +27,9 @@
 #include <ns3/node.h>
 #include <ns3/double.h>
 #include <ns3/mobility-model.h>
+#include <ns3/mobility-snapshot.h>
+#include <ns3/delivery-batcher.h>
+#include <ns3/boolean.h>
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-loss-model.h>
@@ -47,6 +50,7 @@ namespace ns3 {
 NS_OBJECT_ENSURE_REGISTERED (SingleModelSpectrumChannel);
 
 SingleModelSpectrumChannel::SingleModelSpectrumChannel ()
+  : m_useSnapshot (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -82,6 +86,13 @@ SingleModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&SingleModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("UseMobilitySnapshot",
+                   "If true, the mobility models of the PHYs attached to this channel "
+                   "are added to the default MobilitySnapshot so that all the positions "
+                   "needed to deliver a signal are computed in a single pass.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&SingleModelSpectrumChannel::m_useSnapshot),
+                   MakeBooleanChecker ())
     .AddTraceSource ("PathLoss",
                      "This trace is fired "
                      "whenever a new path loss value is calculated. The first and second parameters "
@@ -128,7 +139,17 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
 
   Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
+  Ptr<MobilitySnapshot> snapshot;
+  if (m_useSnapshot)
+    {
+      snapshot = MobilitySnapshot::GetDefault ();
+      if (senderMobility)
+        {
+          snapshot->Add (senderMobility);
+        }
+    }
 
+  DeliveryBatcher batcher;
   for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
        rxPhyIterator != m_phyList.end ();
        ++rxPhyIterator)
@@ -138,16 +159,20 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
           Time delay  = MicroSeconds (0);
 
           Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
-          NS_LOG_LOGIC ("copying signal parameters " << txParams);
-          Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-
+          if (snapshot != 0 && receiverMobility)
+            {
+              snapshot->Add (receiverMobility);
+            }
+          // Evaluate the path loss before copying the signal parameters
+          // (and the packets they carry), so that no copy is made for the
+          // receivers which are out of range.
+          double pathLossDb = 0;
           if (senderMobility && receiverMobility)
             {
-              double pathLossDb = 0;
-              if (rxParams->txAntenna != 0)
+              if (txParams->txAntenna != 0)
                 {
                   Angles txAngles (receiverMobility->GetPosition (), senderMobility->GetPosition ());
-                  double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+                  double txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
                   NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
                   pathLossDb -= txAntennaGain;
                 }
@@ -172,6 +197,13 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                   // beyond range
                   continue;
                 }
+            }
+
+          NS_LOG_LOGIC ("copying signal parameters " << txParams);
+          Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+
+          if (senderMobility && receiverMobility)
+            {
               double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
               *(rxParams->psd) *= pathGainLinear;              
 
@@ -188,20 +220,21 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
 
           Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
+          EventImpl *rxEvent = MakeEvent (&SingleModelSpectrumChannel::StartRx, this, rxParams, *rxPhyIterator);
           if (netDev)
             {
               // the receiver has a NetDevice, so we expect that it is attached to a Node
               uint32_t dstNode =  netDev->GetNode ()->GetId ();
-              Simulator::ScheduleWithContext (dstNode, delay, &SingleModelSpectrumChannel::StartRx, this, rxParams, *rxPhyIterator);
+              batcher.Add (dstNode, delay, rxEvent);
             }
           else
             {
               // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
-              Simulator::Schedule (delay, &SingleModelSpectrumChannel::StartRx, this,
-                                   rxParams, *rxPhyIterator);
+              batcher.Add (Simulator::GetContext (), delay, rxEvent);
             }
         }
     }
+  batcher.Schedule ();
 
 }
 
@@ -256,6 +289,13 @@ SingleModelSpectrumChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel>
 }
 
 
+Ptr<PropagationLossModel>
+SingleModelSpectrumChannel::GetPropagationLossModel (void)
+{
+  NS_LOG_FUNCTION (this);
+  return m_propagationLoss;
+}
+
 Ptr<SpectrumPropagationLossModel>
 SingleModelSpectrumChannel::GetSpectrumPropagationLossModel (void)
 {
@@ -61,6 +61,7 @@ public:
 
   typedef std::vector<Ptr<SpectrumPhy> > PhyList;
 
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void);
   virtual Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void);
 
 private:
@@ -109,6 +110,12 @@ private:
 
   double m_maxLossDb;
 
+  /**
+   * If true, the mobility models of the attached PHYs are added to the
+   * default MobilitySnapshot.
+   */
+  bool m_useSnapshot;
+
   TracedCallback<Ptr<SpectrumPhy>, Ptr<SpectrumPhy>, double > m_pathLossTrace;
 };
 
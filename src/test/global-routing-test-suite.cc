@@ -15,6 +15,7 @@
  */
 
 #include <vector>
+#include <sstream>
 #include "ns3/boolean.h"
 #include "ns3/config.h"
 #include "ns3/csma-helper.h"
@@ -24,6 +25,10 @@
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/global-router-interface.h"
+#include "ns3/global-route-manager-impl.h"
+#include "ns3/simulation-singleton.h"
 #include "ns3/ipv4-static-routing-helper.h"
 #include "ns3/node.h"
 #include "ns3/node-container.h"
@@ -386,6 +391,287 @@ GlobalRoutingSlash32TestCase::DoRun (void)
 }
 
 
+// Check that the incremental update of the routes after a topology change
+// yields the same routing tables as a full recomputation.
+class GlobalRoutingIncrementalUpdateTestCase : public TestCase
+{
+public:
+  GlobalRoutingIncrementalUpdateTestCase ();
+  virtual ~GlobalRoutingIncrementalUpdateTestCase ();
+
+private:
+  virtual void DoRun (void);
+  std::string DumpRoutes (NodeContainer nodes) const;
+  void CheckUpdate (NodeContainer nodes, std::string event, bool incremental);
+};
+
+GlobalRoutingIncrementalUpdateTestCase::GlobalRoutingIncrementalUpdateTestCase ()
+  : TestCase ("Incremental update of the global routes")
+{
+}
+
+GlobalRoutingIncrementalUpdateTestCase::~GlobalRoutingIncrementalUpdateTestCase ()
+{
+}
+
+std::string
+GlobalRoutingIncrementalUpdateTestCase::DumpRoutes (NodeContainer nodes) const
+{
+  std::ostringstream oss;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> gr = nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      oss << "node " << i << std::endl;
+      for (uint32_t j = 0; j < gr->GetNRoutes (); j++)
+        {
+          oss << *gr->GetRoute (j) << std::endl;
+        }
+    }
+  return oss.str ();
+}
+
+void
+GlobalRoutingIncrementalUpdateTestCase::CheckUpdate (NodeContainer nodes, std::string event, bool incremental)
+{
+  GlobalRouteManagerImpl *manager = SimulationSingleton<GlobalRouteManagerImpl>::Get ();
+  uint32_t nFullRecomputes = manager->GetNFullRecomputes ();
+  Ipv4GlobalRoutingHelper::UpdateRoutingTables ();
+  NS_TEST_ASSERT_MSG_EQ ((manager->GetNFullRecomputes () == nFullRecomputes), incremental,
+                         "Unexpected kind of update after " << event);
+  std::string updated = DumpRoutes (nodes);
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::string full = DumpRoutes (nodes);
+  NS_TEST_ASSERT_MSG_EQ (updated, full, "Routes differ from a full recomputation after " << event);
+}
+
+// Test program for a 4x4 grid of point-to-point links, with a LAN between
+// routers 10 and 15 and a host hanging off router 3.
+//
+//  0 --- 1 --- 2 --- 3 --- host
+//  |     |     |     |
+//  4 --- 5 --- 6 --- 7
+//  |     |     |     |
+//  8 --- 9 --- 10 -- 11
+//  |     |     |     |
+//  12 -- 13 -- 14 -- 15
+//              |     |
+//           ==============
+//                  |
+//                 lan
+//
+void
+GlobalRoutingIncrementalUpdateTestCase::DoRun (void)
+{
+  const uint32_t size = 4;
+  NodeContainer grid;
+  grid.Create (size * size);
+  NodeContainer others;
+  others.Create (2);
+  NodeContainer all (grid, others);
+
+  // record the shortest path trees from the first calculation
+  Config::SetDefault ("ns3::Ipv4GlobalRouting::IncrementalRouteUpdates", BooleanValue (true));
+  InternetStackHelper internet;
+  internet.Install (all);
+
+  PointToPointHelper p2p;
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.252");
+  std::vector<Ipv4InterfaceContainer> links;
+  for (uint32_t row = 0; row < size; row++)
+    {
+      for (uint32_t col = 0; col < size; col++)
+        {
+          uint32_t n = row * size + col;
+          if (col + 1 < size)
+            {
+              links.push_back (ipv4.Assign (p2p.Install (grid.Get (n), grid.Get (n + 1))));
+              ipv4.NewNetwork ();
+            }
+          if (row + 1 < size)
+            {
+              links.push_back (ipv4.Assign (p2p.Install (grid.Get (n), grid.Get (n + size))));
+              ipv4.NewNetwork ();
+            }
+        }
+    }
+  Ipv4InterfaceContainer host = ipv4.Assign (p2p.Install (grid.Get (3), others.Get (0)));
+
+  CsmaHelper csma;
+  ipv4.SetBase ("10.2.0.0", "255.255.255.0");
+  Ipv4InterfaceContainer lan = ipv4.Assign (csma.Install (NodeContainer (grid.Get (14), grid.Get (15), others.Get (1))));
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  std::string initial = DumpRoutes (all);
+
+  // link 1 is 0 -- 4
+  links[1].Get (0).first->SetDown (links[1].Get (0).second);
+  CheckUpdate (all, "the failure of 0 -- 4", true);
+  NS_TEST_ASSERT_MSG_NE (DumpRoutes (all), initial, "Routes did not change after a link failure");
+  // link 10 is 5 -- 9
+  links[10].Get (1).first->SetDown (links[10].Get (1).second);
+  CheckUpdate (all, "the failure of 5 -- 9", true);
+  // router 15 leaves the LAN
+  lan.Get (1).first->SetDown (lan.Get (1).second);
+  CheckUpdate (all, "the failure of 15 on the LAN", true);
+  // router 14, the designated router of the LAN, leaves it too: the
+  // network LSA is now advertised by another router
+  lan.Get (0).first->SetDown (lan.Get (0).second);
+  CheckUpdate (all, "the failure of 14 on the LAN", false);
+  // the host goes away
+  host.Get (0).first->SetDown (host.Get (0).second);
+  CheckUpdate (all, "the failure of the host link", true);
+  // link 1 comes back
+  links[1].Get (0).first->SetUp (links[1].Get (0).second);
+  CheckUpdate (all, "the recovery of 0 -- 4", false);
+  // both ends of link 5 (2 -- 6) fail
+  links[5].Get (0).first->SetDown (links[5].Get (0).second);
+  links[5].Get (1).first->SetDown (links[5].Get (1).second);
+  CheckUpdate (all, "the failure of 2 -- 6", true);
+  // no change
+  CheckUpdate (all, "no change", true);
+
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::Ipv4GlobalRouting::IncrementalRouteUpdates", BooleanValue (false));
+}
+
+// Check that the route cache returns the same routes as the routing
+// table lookups, shares them between lookups, and follows the changes
+// of the routing tables.
+class GlobalRoutingRouteCacheTestCase : public TestCase
+{
+public:
+  GlobalRoutingRouteCacheTestCase ();
+  virtual ~GlobalRoutingRouteCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void SetRouteCacheSize (NodeContainer nodes, uint32_t size) const;
+  std::string DumpLookups (NodeContainer nodes, std::vector<Ipv4Address> destinations) const;
+};
+
+GlobalRoutingRouteCacheTestCase::GlobalRoutingRouteCacheTestCase ()
+  : TestCase ("Route cache of the global routing")
+{
+}
+
+GlobalRoutingRouteCacheTestCase::~GlobalRoutingRouteCacheTestCase ()
+{
+}
+
+void
+GlobalRoutingRouteCacheTestCase::SetRouteCacheSize (NodeContainer nodes, uint32_t size) const
+{
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> gr = nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      gr->SetAttribute ("RouteCacheSize", UintegerValue (size));
+    }
+}
+
+std::string
+GlobalRoutingRouteCacheTestCase::DumpLookups (NodeContainer nodes, std::vector<Ipv4Address> destinations) const
+{
+  std::ostringstream oss;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> gr = nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      for (std::vector<Ipv4Address>::const_iterator j = destinations.begin (); j != destinations.end (); j++)
+        {
+          Ipv4Header header;
+          header.SetDestination (*j);
+          Socket::SocketErrno sockerr;
+          Ptr<Ipv4Route> route = gr->RouteOutput (0, header, 0, sockerr);
+          oss << i << " " << *j << ": ";
+          if (route == 0)
+            {
+              oss << "no route" << std::endl;
+              continue;
+            }
+          oss << route->GetDestination () << " " << route->GetSource () << " "
+              << route->GetGateway () << " " << route->GetOutputDevice ()->GetIfIndex () << std::endl;
+        }
+    }
+  return oss.str ();
+}
+
+// Test program for a 3x3 grid of point-to-point links
+//
+//  0 --- 1 --- 2
+//  |     |     |
+//  3 --- 4 --- 5
+//  |     |     |
+//  6 --- 7 --- 8
+//
+void
+GlobalRoutingRouteCacheTestCase::DoRun (void)
+{
+  const uint32_t size = 3;
+  NodeContainer grid;
+  grid.Create (size * size);
+
+  InternetStackHelper internet;
+  internet.Install (grid);
+
+  PointToPointHelper p2p;
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.252");
+  std::vector<Ipv4InterfaceContainer> links;
+  std::vector<Ipv4Address> destinations;
+  for (uint32_t row = 0; row < size; row++)
+    {
+      for (uint32_t col = 0; col < size; col++)
+        {
+          uint32_t n = row * size + col;
+          if (col + 1 < size)
+            {
+              links.push_back (ipv4.Assign (p2p.Install (grid.Get (n), grid.Get (n + 1))));
+              ipv4.NewNetwork ();
+            }
+          if (row + 1 < size)
+            {
+              links.push_back (ipv4.Assign (p2p.Install (grid.Get (n), grid.Get (n + size))));
+              ipv4.NewNetwork ();
+            }
+        }
+    }
+  for (std::vector<Ipv4InterfaceContainer>::const_iterator i = links.begin (); i != links.end (); i++)
+    {
+      destinations.push_back (i->GetAddress (0));
+      destinations.push_back (i->GetAddress (1));
+    }
+  destinations.push_back (Ipv4Address ("192.168.0.1"));
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  std::string uncached = DumpLookups (grid, destinations);
+  SetRouteCacheSize (grid, 100);
+  NS_TEST_ASSERT_MSG_EQ (DumpLookups (grid, destinations), uncached, "Routes differ when they are cached");
+  NS_TEST_ASSERT_MSG_EQ (DumpLookups (grid, destinations), uncached, "Cached routes differ");
+
+  Ptr<Ipv4GlobalRouting> gr = grid.Get (0)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+  Ipv4Header header;
+  header.SetDestination (links.back ().GetAddress (1));
+  Socket::SocketErrno sockerr;
+  Ptr<Ipv4Route> first = gr->RouteOutput (0, header, 0, sockerr);
+  Ptr<Ipv4Route> second = gr->RouteOutput (0, header, 0, sockerr);
+  NS_TEST_ASSERT_MSG_EQ (first, second, "The cached route is not shared");
+
+  // a cache smaller than the number of destinations
+  SetRouteCacheSize (grid, 5);
+  NS_TEST_ASSERT_MSG_EQ (DumpLookups (grid, destinations), uncached, "Routes differ with a small cache");
+
+  // link 0 is 0 -- 1
+  links[0].Get (0).first->SetDown (links[0].Get (0).second);
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::string cached = DumpLookups (grid, destinations);
+  NS_TEST_ASSERT_MSG_NE (cached, uncached, "Cached routes did not change after a link failure");
+  SetRouteCacheSize (grid, 0);
+  NS_TEST_ASSERT_MSG_EQ (cached, DumpLookups (grid, destinations), "Cached routes differ after a link failure");
+
+  Simulator::Destroy ();
+}
+
 class GlobalRoutingTestSuite : public TestSuite
 {
 public:
@@ -397,6 +683,8 @@ GlobalRoutingTestSuite::GlobalRoutingTestSuite ()
 {
   AddTestCase (new DynamicGlobalRoutingTestCase, TestCase::QUICK);
   AddTestCase (new GlobalRoutingSlash32TestCase, TestCase::QUICK);
+  AddTestCase (new GlobalRoutingIncrementalUpdateTestCase, TestCase::QUICK);
+  AddTestCase (new GlobalRoutingRouteCacheTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
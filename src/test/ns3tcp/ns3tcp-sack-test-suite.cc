@@ -0,0 +1,279 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <set>
+#include <sstream>
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/data-rate.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/tcp-header.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+#include "ns3/error-model.h"
+#include "ns3/pointer.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("Ns3TcpSackTest");
+
+// ===========================================================================
+// Tests of the SACK-based loss recovery of TcpNewReno, for windows with
+// several losses
+// ===========================================================================
+//
+
+class Ns3TcpSackTestCase : public TestCase
+{
+public:
+  /**
+   * \param name name of the loss pattern
+   * \param losses indices of the packets dropped at the receiver
+   */
+  Ns3TcpSackTestCase (std::string name, std::list<uint32_t> losses);
+  virtual ~Ns3TcpSackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Transfer the data over a lossy path.
+   * \param sack true to enable the SACK option on both sides
+   */
+  void RunTransfer (bool sack);
+
+  void Ipv4L3Tx (std::string context, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+  void SinkRx (Ptr<const Packet> packet, const Address &address);
+  void WriteUntilBufferFull (Ptr<Socket> localSocket, uint32_t txSpace);
+  void StartFlow (Ptr<Socket> localSocket, Ipv4Address servAddress, uint16_t servPort);
+
+  std::list<uint32_t> m_losses;
+  uint32_t m_totalTxBytes;
+  uint32_t m_currentTxBytes;
+  bool m_needToClose;
+
+  // Results of a transfer
+  std::set<uint32_t> m_sentSeqs;   //!< sequence numbers of the data segments sent
+  uint32_t m_retransmissions;      //!< number of data segments sent again
+  bool m_sackOffered;              //!< the SYN carried the SACK-permitted option
+  uint32_t m_totalRxBytes;         //!< bytes received by the sink
+  Time m_completion;               //!< time the last byte was received
+};
+
+Ns3TcpSackTestCase::Ns3TcpSackTestCase (std::string name, std::list<uint32_t> losses)
+  : TestCase ("Check the SACK-based loss recovery with " + name),
+    m_losses (losses),
+    m_totalTxBytes (200000),
+    m_currentTxBytes (0),
+    m_needToClose (true),
+    m_retransmissions (0),
+    m_sackOffered (false),
+    m_totalRxBytes (0)
+{
+}
+
+void
+Ns3TcpSackTestCase::DoTeardown (void)
+{
+  Config::SetDefault ("ns3::TcpSocketBase::Sack", BooleanValue (false));
+}
+
+void
+Ns3TcpSackTestCase::Ipv4L3Tx (std::string context, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  Ptr<Packet> p = packet->Copy ();
+  Ipv4Header ipHeader;
+  p->RemoveHeader (ipHeader);
+  TcpHeader tcpHeader;
+  p->RemoveHeader (tcpHeader);
+  if (tcpHeader.GetFlags () & TcpHeader::SYN)
+    {
+      m_sackOffered = tcpHeader.IsSackPermitted ();
+    }
+  if (p->GetSize () > 0 && !m_sentSeqs.insert (tcpHeader.GetSequenceNumber ().GetValue ()).second)
+    {
+      m_retransmissions++;
+    }
+}
+
+void
+Ns3TcpSackTestCase::SinkRx (Ptr<const Packet> packet, const Address &address)
+{
+  m_totalRxBytes += packet->GetSize ();
+  if (m_totalRxBytes == m_totalTxBytes)
+    {
+      m_completion = Simulator::Now ();
+    }
+}
+
+void
+Ns3TcpSackTestCase::WriteUntilBufferFull (Ptr<Socket> localSocket, uint32_t txSpace)
+{
+  while (m_currentTxBytes < m_totalTxBytes)
+    {
+      uint32_t toWrite = std::min (m_totalTxBytes - m_currentTxBytes, localSocket->GetTxAvailable ());
+      if (toWrite == 0)
+        {
+          return;
+        }
+      int amountSent = localSocket->Send (0, toWrite, 0);
+      NS_ASSERT (amountSent > 0);
+      m_currentTxBytes += amountSent;
+    }
+  if (m_needToClose)
+    {
+      localSocket->Close ();
+      m_needToClose = false;
+    }
+}
+
+void
+Ns3TcpSackTestCase::StartFlow (Ptr<Socket> localSocket, Ipv4Address servAddress, uint16_t servPort)
+{
+  localSocket->Connect (InetSocketAddress (servAddress, servPort));
+  localSocket->SetSendCallback (MakeCallback (&Ns3TcpSackTestCase::WriteUntilBufferFull, this));
+  WriteUntilBufferFull (localSocket, localSocket->GetTxAvailable ());
+}
+
+void
+Ns3TcpSackTestCase::RunTransfer (bool sack)
+{
+  m_currentTxBytes = 0;
+  m_needToClose = true;
+  m_sentSeqs.clear ();
+  m_retransmissions = 0;
+  m_sackOffered = false;
+  m_totalRxBytes = 0;
+  m_completion = Seconds (0);
+
+  // Network topology: the path of ns3-tcp-loss
+  //
+  //           8Mb/s, 0.1ms       0.8Mb/s, 100ms
+  //       s1-----------------r1-----------------k1
+  //
+  Config::SetDefault ("ns3::TcpL4Protocol::SocketType", StringValue ("ns3::TcpNewReno"));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1000));
+  Config::SetDefault ("ns3::TcpSocket::DelAckCount", UintegerValue (1));
+  Config::SetDefault ("ns3::TcpSocketBase::Sack", BooleanValue (sack));
+
+  NodeContainer s1r1;
+  s1r1.Create (2);
+  NodeContainer r1k1;
+  r1k1.Add (s1r1.Get (1));
+  r1k1.Create (1);
+
+  InternetStackHelper internet;
+  internet.InstallAll ();
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", DataRateValue (DataRate (8000000)));
+  p2p.SetChannelAttribute ("Delay", TimeValue (Seconds (0.0001)));
+  NetDeviceContainer dev0 = p2p.Install (s1r1);
+  p2p.SetDeviceAttribute ("DataRate", DataRateValue (DataRate (800000)));
+  p2p.SetChannelAttribute ("Delay", TimeValue (Seconds (0.1)));
+  NetDeviceContainer dev1 = p2p.Install (r1k1);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.3.0", "255.255.255.0");
+  ipv4.Assign (dev0);
+  ipv4.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer ipInterfs = ipv4.Assign (dev1);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  uint16_t servPort = 50000;
+  PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), servPort));
+  ApplicationContainer apps = sink.Install (r1k1.Get (1));
+  apps.Start (Seconds (0.0));
+  apps.Stop (Seconds (100.0));
+  apps.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&Ns3TcpSackTestCase::SinkRx, this));
+
+  Ptr<Socket> localSocket = Socket::CreateSocket (s1r1.Get (0), TcpSocketFactory::GetTypeId ());
+  localSocket->Bind ();
+  Simulator::ScheduleNow (&Ns3TcpSackTestCase::StartFlow, this, localSocket, ipInterfs.GetAddress (1), servPort);
+
+  Config::Connect ("/NodeList/0/$ns3::Ipv4L3Protocol/Tx", MakeCallback (&Ns3TcpSackTestCase::Ipv4L3Tx, this));
+
+  Ptr<ReceiveListErrorModel> pem = CreateObject<ReceiveListErrorModel> ();
+  pem->SetList (m_losses);
+  dev1.Get (1)->SetAttribute ("ReceiveErrorModel", PointerValue (pem));
+
+  Simulator::Stop (Seconds (1000));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_LOG_DEBUG ((sack ? "SACK" : "NewReno") << ": " << m_retransmissions << " retransmissions, completed at "
+                << m_completion.GetSeconds ());
+}
+
+void
+Ns3TcpSackTestCase::DoRun (void)
+{
+  RunTransfer (false);
+  NS_TEST_ASSERT_MSG_EQ (m_sackOffered, false, "SACK offered while disabled");
+  NS_TEST_ASSERT_MSG_EQ (m_totalRxBytes, m_totalTxBytes, "data lost without SACK");
+  Time newRenoCompletion = m_completion;
+
+  RunTransfer (true);
+  NS_TEST_ASSERT_MSG_EQ (m_sackOffered, true, "SACK not offered");
+  NS_TEST_ASSERT_MSG_EQ (m_totalRxBytes, m_totalTxBytes, "data lost with SACK");
+  // Every lost segment is retransmitted once, without a timeout
+  NS_TEST_ASSERT_MSG_EQ (m_retransmissions, m_losses.size (), "unnecessary retransmissions with SACK");
+  if (m_losses.size () > 1)
+    { // NewReno repairs a single hole per round trip
+      NS_TEST_ASSERT_MSG_LT (m_completion, newRenoCompletion, "SACK recovery slower than NewReno");
+    }
+}
+
+class Ns3TcpSackTestSuite : public TestSuite
+{
+public:
+  Ns3TcpSackTestSuite ();
+};
+
+Ns3TcpSackTestSuite::Ns3TcpSackTestSuite ()
+  : TestSuite ("ns3-tcp-sack", SYSTEM)
+{
+  // Indices of the packets received by k1, as in ns3-tcp-loss: the 15th
+  // data packet and the following ones
+  std::list<uint32_t> losses;
+  losses.push_back (16);
+  AddTestCase (new Ns3TcpSackTestCase ("one loss", losses), TestCase::QUICK);
+  losses.push_back (17);
+  losses.push_back (18);
+  losses.push_back (19);
+  AddTestCase (new Ns3TcpSackTestCase ("four consecutive losses", losses), TestCase::QUICK);
+  losses.clear ();
+  losses.push_back (16);
+  losses.push_back (19);
+  losses.push_back (22);
+  losses.push_back (25);
+  AddTestCase (new Ns3TcpSackTestCase ("four spaced losses", losses), TestCase::QUICK);
+}
+
+static Ns3TcpSackTestSuite ns3TcpSackTestSuite;
@@ -0,0 +1,200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "chunk-success-rate-table.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+
+NS_LOG_COMPONENT_DEFINE ("ChunkSuccessRateTable");
+
+namespace ns3 {
+
+namespace {
+/// lowest SNR (dB) of the tables
+const double MIN_SNR_DB = -10.0;
+/// highest SNR (dB) of the tables
+const double MAX_SNR_DB = 40.0;
+/// grid step (dB) of the first attempt
+const double INITIAL_STEP_DB = 0.25;
+/// finest grid step (dB)
+const double MIN_STEP_DB = 1.0 / 64;
+/// the per-bit log success rate is clamped to this value
+const double LOG_PSR_FLOOR = -700.0;
+/// 1500 bytes
+const uint32_t REFERENCE_CHUNK_BITS = 12000;
+} // anonymous namespace
+
+ChunkSuccessRateTable::ChunkSuccessRateTable ()
+  : m_tolerance (1e-6)
+{
+}
+
+void
+ChunkSuccessRateTable::SetChunkSuccessRateCallback (ChunkSuccessRateCallback callback)
+{
+  m_analytical = callback;
+  m_curves.clear ();
+}
+
+void
+ChunkSuccessRateTable::SetTolerance (double tolerance)
+{
+  NS_ASSERT (tolerance > 0);
+  m_tolerance = tolerance;
+  m_curves.clear ();
+}
+
+double
+ChunkSuccessRateTable::GetTolerance (void) const
+{
+  return m_tolerance;
+}
+
+uint32_t
+ChunkSuccessRateTable::GetReferenceChunkBits (void)
+{
+  return REFERENCE_CHUNK_BITS;
+}
+
+bool
+ChunkSuccessRateTable::IsTabulated (WifiMode mode)
+{
+  return mode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM
+         || mode.GetModulationClass () == WIFI_MOD_CLASS_OFDM
+         || mode.GetModulationClass () == WIFI_MOD_CLASS_HT;
+}
+
+double
+ChunkSuccessRateTable::CalculateLogPsr (WifiMode mode, double snrDb) const
+{
+  double psr = m_analytical (mode, std::pow (10.0, snrDb / 10.0), 1);
+  if (psr <= 0)
+    {
+      return LOG_PSR_FLOOR;
+    }
+  return std::max (std::log (psr), LOG_PSR_FLOOR);
+}
+
+double
+ChunkSuccessRateTable::GetSensitivity (double logPsr)
+{
+  // d/dL exp(n L) = n exp(n L), which is maximal for n = -1/L.
+  double n = REFERENCE_CHUNK_BITS;
+  if (logPsr < 0)
+    {
+      n = std::min (std::max (-1.0 / logPsr, 1.0), n);
+    }
+  return n * std::exp (n * logPsr);
+}
+
+const ChunkSuccessRateTable::Curve &
+ChunkSuccessRateTable::GetCurve (WifiMode mode) const
+{
+  std::map<uint32_t, Curve>::iterator it = m_curves.find (mode.GetUid ());
+  if (it != m_curves.end ())
+    {
+      return it->second;
+    }
+  NS_LOG_FUNCTION (this << mode);
+  Curve &curve = m_curves[mode.GetUid ()];
+  curve.stepDb = INITIAL_STEP_DB;
+  uint32_t n = static_cast<uint32_t> (std::ceil ((MAX_SNR_DB - MIN_SNR_DB) / curve.stepDb)) + 1;
+  curve.logPsr.reserve (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      curve.logPsr.push_back (CalculateLogPsr (mode, MIN_SNR_DB + i * curve.stepDb));
+    }
+  while (true)
+    {
+      // evaluate the interpolation error at the middle of each interval;
+      // the midpoints are the new samples if the grid must be refined.
+      // The midpoint error is only an estimate of the error within the
+      // interval: keep a safety margin of one refinement step.
+      double tolerance = m_tolerance / 4;
+      std::vector<double> middle;
+      middle.reserve (curve.logPsr.size () - 1);
+      curve.analytical.assign (curve.logPsr.size () - 1, false);
+      double maxError = 0;
+      for (uint32_t i = 0; i + 1 < curve.logPsr.size (); i++)
+        {
+          double exact = CalculateLogPsr (mode, MIN_SNR_DB + (i + 0.5) * curve.stepDb);
+          middle.push_back (exact);
+          if (curve.logPsr[i] == LOG_PSR_FLOOR || curve.logPsr[i + 1] == LOG_PSR_FLOOR)
+            {
+              // the success rate drops to zero within this interval
+              curve.analytical[i] = true;
+              continue;
+            }
+          double interpolated = 0.5 * (curve.logPsr[i] + curve.logPsr[i + 1]);
+          double error = std::fabs (interpolated - exact) * GetSensitivity (exact);
+          curve.analytical[i] = error > tolerance;
+          maxError = std::max (maxError, error);
+        }
+      if (maxError <= tolerance)
+        {
+          break;
+        }
+      if (curve.stepDb / 2 < MIN_STEP_DB)
+        {
+          // Only the steepest part of the curve, where the success rate
+          // of a bit vanishes, is left to the analytical model.
+          NS_LOG_DEBUG ("mode " << mode << ": " << std::count (curve.analytical.begin (), curve.analytical.end (), true)
+                        << " intervals above tolerance at the finest grid step");
+          break;
+        }
+      std::vector<double> refined;
+      refined.reserve (curve.logPsr.size () + middle.size ());
+      for (uint32_t i = 0; i < middle.size (); i++)
+        {
+          refined.push_back (curve.logPsr[i]);
+          refined.push_back (middle[i]);
+        }
+      refined.push_back (curve.logPsr.back ());
+      curve.logPsr.swap (refined);
+      curve.stepDb /= 2;
+    }
+  curve.invStepDb = 1.0 / curve.stepDb;
+  NS_LOG_DEBUG ("mode " << mode << ": " << curve.logPsr.size () << " points, step " << curve.stepDb << " dB");
+  return curve;
+}
+
+double
+ChunkSuccessRateTable::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  if (!IsTabulated (mode) || snr <= 0)
+    {
+      return m_analytical (mode, snr, nbits);
+    }
+  double snrDb = 10.0 * std::log10 (snr);
+  if (snrDb < MIN_SNR_DB || snrDb >= MAX_SNR_DB)
+    {
+      return m_analytical (mode, snr, nbits);
+    }
+  const Curve &curve = GetCurve (mode);
+  double x = (snrDb - MIN_SNR_DB) * curve.invStepDb;
+  uint32_t i = static_cast<uint32_t> (x);
+  NS_ASSERT (i + 1 < curve.logPsr.size ());
+  if (curve.analytical[i])
+    {
+      return m_analytical (mode, snr, nbits);
+    }
+  double logPsr = curve.logPsr[i] + (x - i) * (curve.logPsr[i + 1] - curve.logPsr[i]);
+  return std::exp (nbits * logPsr);
+}
+
+} // namespace ns3
@@ -0,0 +1,133 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef CHUNK_SUCCESS_RATE_TABLE_H
+#define CHUNK_SUCCESS_RATE_TABLE_H
+
+#include <stdint.h>
+#include <vector>
+#include <map>
+#include "ns3/callback.h"
+#include "wifi-mode.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief Tabulated chunk success rate of an analytical error rate model.
+ *
+ * The OFDM error rate models compute the success rate of a chunk of
+ * \f$n\f$ bits as \f$(1 - p_e(snr))^n\f$.  This helper samples, once per
+ * WifiMode, the per-bit log success rate \f$\ln (1 - p_e)\f$ of the
+ * analytical model over a uniform SNR grid (in dB) and serves
+ * subsequent queries by linear interpolation followed by a single
+ * exponential.
+ *
+ * The grid step of each curve is halved until the interpolation error,
+ * measured at the middle of every grid interval, translates into an
+ * absolute error on the success rate of any chunk of at most
+ * GetReferenceChunkBits () bits which is below the tolerance.  The
+ * intervals which still exceed the tolerance at the finest grid step
+ * (where the per-bit success rate falls to zero) are not interpolated.
+ *
+ * Modes which are not OFDM-based, SNRs outside of the tabulated range
+ * and SNRs in the non-interpolated intervals are forwarded to the
+ * analytical model.
+ */
+class ChunkSuccessRateTable
+{
+public:
+  /**
+   * Callback to the analytical model: mode, linear SNR, number of bits.
+   */
+  typedef Callback<double, WifiMode, double, uint32_t> ChunkSuccessRateCallback;
+
+  ChunkSuccessRateTable ();
+
+  /**
+   * \param callback the analytical model used to build the curves
+   *        and to handle the queries outside of the tables.
+   */
+  void SetChunkSuccessRateCallback (ChunkSuccessRateCallback callback);
+  /**
+   * \param tolerance the maximum absolute error on the success rate of
+   *        a chunk.  Changing the tolerance discards all the curves
+   *        built so far.
+   */
+  void SetTolerance (double tolerance);
+  /**
+   * \return the maximum absolute error on the success rate of a chunk.
+   */
+  double GetTolerance (void) const;
+  /**
+   * \return the size of the largest chunk for which the tolerance is
+   *         guaranteed.
+   */
+  static uint32_t GetReferenceChunkBits (void);
+
+  /**
+   * \param mode the Wi-Fi mode the chunk is sent
+   * \param snr the SNR of the chunk (linear ratio)
+   * \param nbits the number of bits in this chunk
+   * \return probability of successfully receiving the chunk
+   */
+  double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
+
+private:
+  /**
+   * Per-bit log success rate sampled from MIN_SNR_DB every stepDb.
+   * The queries which fall in an interval flagged in analytical are
+   * forwarded to the analytical model.
+   */
+  struct Curve
+  {
+    double stepDb;
+    double invStepDb;
+    std::vector<double> logPsr;
+    std::vector<bool> analytical;
+  };
+
+  /**
+   * \param mode a Wi-Fi mode
+   * \return true if the error model of this mode is tabulated.
+   */
+  static bool IsTabulated (WifiMode mode);
+  /**
+   * \param mode a Wi-Fi mode
+   * \param snrDb a SNR in dB
+   * \return the per-bit log success rate of the analytical model.
+   */
+  double CalculateLogPsr (WifiMode mode, double snrDb) const;
+  /**
+   * \param logPsr a per-bit log success rate
+   * \return the largest value of \f$n\,e^{n\,logPsr}\f$ for
+   *         \f$1 \le n \le\f$ GetReferenceChunkBits (), that is the
+   *         sensitivity of the chunk success rate to an error on logPsr.
+   */
+  static double GetSensitivity (double logPsr);
+  /**
+   * \param mode a Wi-Fi mode
+   * \return the curve of this mode, built on first use.
+   */
+  const Curve & GetCurve (WifiMode mode) const;
+
+  ChunkSuccessRateCallback m_analytical;
+  double m_tolerance;
+  mutable std::map<uint32_t, Curve> m_curves;
+};
+
+} // namespace ns3
+
+#endif /* CHUNK_SUCCESS_RATE_TABLE_H */
@@ -98,7 +98,15 @@ InterferenceHelper::Event::GetTxVector (void) const
 
 InterferenceHelper::NiChange::NiChange (Time time, double delta)
   : m_time (time),
-    m_delta (delta)
+    m_delta (delta),
+    m_power (0.0)
+{
+}
+InterferenceHelper::NiChange::NiChange (Time time, double delta, Ptr<InterferenceHelper::Event> event)
+  : m_time (time),
+    m_delta (delta),
+    m_power (0.0),
+    m_event (event)
 {
 }
 Time
@@ -111,6 +119,21 @@ InterferenceHelper::NiChange::GetDelta (void) const
 {
   return m_delta;
 }
+double
+InterferenceHelper::NiChange::GetPower (void) const
+{
+  return m_power;
+}
+void
+InterferenceHelper::NiChange::SetPower (double power)
+{
+  m_power = power;
+}
+Ptr<InterferenceHelper::Event>
+InterferenceHelper::NiChange::GetEvent (void) const
+{
+  return m_event;
+}
 bool
 InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o) const
 {
@@ -124,7 +147,8 @@ InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o)
 InterferenceHelper::InterferenceHelper ()
   : m_errorRateModel (0),
     m_firstPower (0.0),
-    m_rxing (false)
+    m_rxing (false),
+    m_maxNiChanges (0)
 {
 }
 InterferenceHelper::~InterferenceHelper ()
@@ -175,23 +199,35 @@ InterferenceHelper::GetErrorRateModel (void) const
   return m_errorRateModel;
 }
 
+void
+InterferenceHelper::SetMaxNiChanges (uint32_t maxNiChanges)
+{
+  m_maxNiChanges = maxNiChanges;
+}
+
+uint32_t
+InterferenceHelper::GetMaxNiChanges (void) const
+{
+  return m_maxNiChanges;
+}
+
 Time
 InterferenceHelper::GetEnergyDuration (double energyW)
 {
   Time now = Simulator::Now ();
-  double noiseInterferenceW = 0.0;
-  Time end = now;
-  noiseInterferenceW = m_firstPower;
-  for (NiChanges::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
+  if (m_niChanges.empty ())
     {
-      noiseInterferenceW += i->GetDelta ();
-      end = i->GetTime ();
-      if (end < now)
-        {
-          continue;
-        }
-      if (noiseInterferenceW < energyW)
+      return MicroSeconds (0);
+    }
+  // look for the first change, not earlier than now, after which the
+  // energy drops below the threshold.
+  NiChanges::const_iterator i = std::lower_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (now, 0));
+  Time end = m_niChanges.back ().GetTime ();
+  for (; i != m_niChanges.end (); i++)
+    {
+      if (i->GetPower () < energyW)
         {
+          end = i->GetTime ();
           break;
         }
     }
@@ -204,20 +240,16 @@ InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
   Time now = Simulator::Now ();
   if (!m_rxing)
     {
-      NiChanges::iterator nowIterator = GetPosition (now);
-      for (NiChanges::iterator i = m_niChanges.begin (); i != nowIterator; i++)
-        {
-          m_firstPower += i->GetDelta ();
-        }
-      m_niChanges.erase (m_niChanges.begin (), nowIterator);
-      m_niChanges.insert (m_niChanges.begin (), NiChange (event->GetStartTime (), event->GetRxPowerW ()));
+      // nobody needs the past changes anymore
+      FoldNiChanges (GetPosition (now));
     }
-  else
+  AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW (), event));
+  AddNiChangeEvent (NiChange (event->GetEndTime (), -event->GetRxPowerW (), event));
+  if (m_maxNiChanges != 0 && m_niChanges.size () > m_maxNiChanges)
     {
-      AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW ()));
+      NS_LOG_DEBUG ("dropping " << m_niChanges.size () - m_maxNiChanges << " changes");
+      FoldNiChanges (m_niChanges.begin () + (m_niChanges.size () - m_maxNiChanges));
     }
-  AddNiChangeEvent (NiChange (event->GetEndTime (), -event->GetRxPowerW ()));
-
 }
 
 
@@ -238,15 +270,43 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, WifiM
 double
 InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event, NiChanges *ni) const
 {
-  double noiseInterference = m_firstPower;
   NS_ASSERT (m_rxing);
-  for (NiChanges::const_iterator i = m_niChanges.begin () + 1; i != m_niChanges.end (); i++)
+  double noiseInterference;
+  // find the start of the event among the changes at its start time
+  NiChanges::const_iterator i = std::lower_bound (m_niChanges.begin (), m_niChanges.end (),
+                                                  NiChange (event->GetStartTime (), 0));
+  while (i != m_niChanges.end () && i->GetTime () == event->GetStartTime ()
+         && i->GetEvent () != event)
+    {
+      i++;
+    }
+  bool startFolded = (i == m_niChanges.end () || i->GetEvent () != event);
+  if (!startFolded)
     {
-      if ((event->GetEndTime () == i->GetTime ()) && event->GetRxPowerW () == -i->GetDelta ())
+      noiseInterference = (i == m_niChanges.begin ()) ? m_firstPower : (i - 1)->GetPower ();
+      i++;
+    }
+  // stop at the end of the event even if its own end change was folded,
+  // so that the changes handed to CalculatePer stay sorted by time.
+  for (; i != m_niChanges.end () && i->GetTime () < event->GetEndTime (); i++)
+    {
+      ni->push_back (NiChange (i->GetTime (), i->GetDelta ()));
+    }
+  if (startFolded)
+    {
+      // the start of the event was dropped to honor m_maxNiChanges, so
+      // m_firstPower holds the power after the folded changes.  It
+      // includes the event itself unless its end was folded too.
+      bool ended = true;
+      for (; i != m_niChanges.end () && i->GetTime () == event->GetEndTime (); i++)
         {
-          break;
+          if (i->GetEvent () == event)
+            {
+              ended = false;
+              break;
+            }
         }
-      ni->push_back (*i);
+      noiseInterference = std::max (m_firstPower - (ended ? 0.0 : event->GetRxPowerW ()), 0.0);
     }
   ni->insert (ni->begin (), NiChange (event->GetStartTime (), noiseInterference));
   ni->push_back (NiChange (event->GetEndTime (), 0));
@@ -571,10 +631,33 @@ InterferenceHelper::GetPosition (Time moment)
   return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (moment, 0));
 
 }
+double
+InterferenceHelper::GetPowerW (Time moment) const
+{
+  NiChanges::const_iterator i = std::upper_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (moment, 0));
+  return (i == m_niChanges.begin ()) ? m_firstPower : (i - 1)->GetPower ();
+}
+void
+InterferenceHelper::FoldNiChanges (NiChanges::iterator end)
+{
+  if (end == m_niChanges.begin ())
+    {
+      return;
+    }
+  m_firstPower = (end - 1)->GetPower ();
+  m_niChanges.erase (m_niChanges.begin (), end);
+}
 void
 InterferenceHelper::AddNiChangeEvent (NiChange change)
 {
-  m_niChanges.insert (GetPosition (change.GetTime ()), change);
+  NiChanges::iterator i = GetPosition (change.GetTime ());
+  change.SetPower (((i == m_niChanges.begin ()) ? m_firstPower : (i - 1)->GetPower ()) + change.GetDelta ());
+  i = m_niChanges.insert (i, change);
+  // only the changes of the signals still in the air follow
+  for (i++; i != m_niChanges.end (); i++)
+    {
+      i->SetPower (i->GetPower () + change.GetDelta ());
+    }
 }
 void
 InterferenceHelper::NotifyRxStart ()
@@ -201,6 +201,20 @@ private:
    * Erase all events.
    */
   void EraseEvents (void);
+  /**
+   * Bound the number of noise and interference changes kept by this
+   * helper.  When the bound is exceeded, the oldest changes are folded
+   * into the initial power, which makes the PER of the reception in
+   * progress approximate.
+   *
+   * \param maxNiChanges the maximum number of changes, or 0 for no limit
+   */
+  void SetMaxNiChanges (uint32_t maxNiChanges);
+  /**
+   * \return the maximum number of noise and interference changes kept
+   *         by this helper, or 0 if there is no limit.
+   */
+  uint32_t GetMaxNiChanges (void) const;
 private:
   /**
    * Noise and Interference (thus Ni) event.
@@ -215,6 +229,15 @@ public:
      * \param delta the power
      */
     NiChange (Time time, double delta);
+    /**
+     * Create a NiChange at the given time and the amount of NI change,
+     * caused by the start or the end of the given event.
+     *
+     * \param time time of the event
+     * \param delta the power
+     * \param event the event which causes the change
+     */
+    NiChange (Time time, double delta, Ptr<Event> event);
     /**
      * Return the event time.
      *
@@ -227,6 +250,21 @@ public:
      * \return the power
      */
     double GetDelta (void) const;
+    /**
+     * Return the total noise and interference power right after this
+     * change, when the change is stored in m_niChanges.
+     *
+     * \return the power (w)
+     */
+    double GetPower (void) const;
+    /**
+     * \param power the total power (w) right after this change
+     */
+    void SetPower (double power);
+    /**
+     * \return the event which causes this change, if any
+     */
+    Ptr<Event> GetEvent (void) const;
     /**
      * Compare the event time of two NiChange objects (a < o).
      *
@@ -237,6 +275,8 @@ public:
 private:
     Time m_time;
     double m_delta;
+    double m_power;
+    Ptr<Event> m_event;
   };
   /**
    * typedef for a vector of NiChanges
@@ -295,14 +335,35 @@ private:
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel;
-  /// Experimental: needed for energy duration calculation
+  /**
+   * Changes of the noise and interference power, sorted by time.  Each
+   * change also holds the total power right after it, so that the
+   * power at any time is found by a binary search.  When no packet is
+   * being received, the changes which are not in the future are folded
+   * into m_firstPower.
+   */
   NiChanges m_niChanges;
+  /// total power before the first change of m_niChanges
   double m_firstPower;
   bool m_rxing;
+  uint32_t m_maxNiChanges; //!< bound on the size of m_niChanges, 0 if none
   /// Returns an iterator to the first nichange, which is later than moment
   NiChanges::iterator GetPosition (Time moment);
   /**
-   * Add NiChange to the list at the appropriate position.
+   * \param moment a time
+   * \return the total noise and interference power once all the changes
+   *         up to and including moment are applied.
+   */
+  double GetPowerW (Time moment) const;
+  /**
+   * Fold the changes before the given position into m_firstPower.
+   *
+   * \param end the first change to keep
+   */
+  void FoldNiChanges (NiChanges::iterator end);
+  /**
+   * Add NiChange to the list at the appropriate position and update the
+   * total power of the following changes.
    *
    * \param change
    */
@@ -19,9 +19,12 @@
  */
 
 #include <cmath>
+#include <limits>
 #include "nist-error-rate-model.h"
 #include "wifi-phy.h"
 #include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
 
 NS_LOG_COMPONENT_DEFINE ("NistErrorRateModel");
 
@@ -35,12 +38,28 @@ NistErrorRateModel::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::NistErrorRateModel")
     .SetParent<ErrorRateModel> ()
     .AddConstructor<NistErrorRateModel> ()
+    .AddAttribute ("UseLookupTable",
+                   "If true, the success rate of OFDM chunks is interpolated from tables "
+                   "sampled from the analytical model instead of being computed for "
+                   "each chunk.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&NistErrorRateModel::m_useLookupTable),
+                   MakeBooleanChecker ())
+    .AddAttribute ("LookupTableTolerance",
+                   "The maximum absolute error on the success rate of a chunk of up to "
+                   "1500 bytes when the lookup tables are used. Must be positive.",
+                   DoubleValue (1e-6),
+                   MakeDoubleAccessor (&NistErrorRateModel::SetLookupTableTolerance,
+                                       &NistErrorRateModel::GetLookupTableTolerance),
+                   MakeDoubleChecker<double> (std::numeric_limits<double>::min ()))
   ;
   return tid;
 }
 
 NistErrorRateModel::NistErrorRateModel ()
+  : m_useLookupTable (false)
 {
+  m_table.SetChunkSuccessRateCallback (MakeCallback (&NistErrorRateModel::CalculateChunkSuccessRate, this));
 }
 
 double
@@ -189,8 +208,30 @@ NistErrorRateModel::GetFec64QamBer (double snr, uint32_t nbits,
   double pms = std::pow (1 - pe, static_cast<double> (nbits));
   return pms;
 }
+void
+NistErrorRateModel::SetLookupTableTolerance (double tolerance)
+{
+  m_table.SetTolerance (tolerance);
+}
+
+double
+NistErrorRateModel::GetLookupTableTolerance (void) const
+{
+  return m_table.GetTolerance ();
+}
+
 double
 NistErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  if (m_useLookupTable)
+    {
+      return m_table.GetChunkSuccessRate (mode, snr, nbits);
+    }
+  return CalculateChunkSuccessRate (mode, snr, nbits);
+}
+
+double
+NistErrorRateModel::CalculateChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
 {
   if (mode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM
       || mode.GetModulationClass () == WIFI_MOD_CLASS_OFDM|| mode.GetModulationClass()==WIFI_MOD_CLASS_HT)
@@ -24,6 +24,7 @@
 #include "wifi-mode.h"
 #include "error-rate-model.h"
 #include "dsss-error-rate-model.h"
+#include "chunk-success-rate-table.h"
 
 namespace ns3 {
 
@@ -44,7 +45,28 @@ public:
 
   virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
 
+  /**
+   * \param tolerance the maximum absolute error on the chunk success
+   *        rate when the lookup tables are used.
+   */
+  void SetLookupTableTolerance (double tolerance);
+  /**
+   * \return the maximum absolute error on the chunk success rate when
+   *         the lookup tables are used.
+   */
+  double GetLookupTableTolerance (void) const;
+
 private:
+  /**
+   * Evaluate the analytical model.
+   *
+   * \param mode the Wi-Fi mode the chunk is sent
+   * \param snr the SNR of the chunk
+   * \param nbits the number of bits in this chunk
+   * \return probability of successfully receiving the chunk
+   */
+  double CalculateChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
+
   /**
    * Return the coded BER for the given p and b.
    *
@@ -121,6 +143,9 @@ private:
    */
   double GetFec64QamBer (double snr, uint32_t nbits,
                          uint32_t bValue) const;
+
+  bool m_useLookupTable; //!< whether GetChunkSuccessRate uses m_table
+  ChunkSuccessRateTable m_table; //!< tabulated version of this model
 };
 
 
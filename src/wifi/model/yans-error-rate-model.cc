@@ -19,10 +19,13 @@
  */
 
 #include <cmath>
+#include <limits>
 
 #include "yans-error-rate-model.h"
 #include "wifi-phy.h"
 #include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
 
 NS_LOG_COMPONENT_DEFINE ("YansErrorRateModel");
 
@@ -36,12 +39,28 @@ YansErrorRateModel::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::YansErrorRateModel")
     .SetParent<ErrorRateModel> ()
     .AddConstructor<YansErrorRateModel> ()
+    .AddAttribute ("UseLookupTable",
+                   "If true, the success rate of OFDM chunks is interpolated from tables "
+                   "sampled from the analytical model instead of being computed for "
+                   "each chunk.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansErrorRateModel::m_useLookupTable),
+                   MakeBooleanChecker ())
+    .AddAttribute ("LookupTableTolerance",
+                   "The maximum absolute error on the success rate of a chunk of up to "
+                   "1500 bytes when the lookup tables are used. Must be positive.",
+                   DoubleValue (1e-6),
+                   MakeDoubleAccessor (&YansErrorRateModel::SetLookupTableTolerance,
+                                       &YansErrorRateModel::GetLookupTableTolerance),
+                   MakeDoubleChecker<double> (std::numeric_limits<double>::min ()))
   ;
   return tid;
 }
 
 YansErrorRateModel::YansErrorRateModel ()
+  : m_useLookupTable (false)
 {
+  m_table.SetChunkSuccessRateCallback (MakeCallback (&YansErrorRateModel::CalculateChunkSuccessRate, this));
 }
 
 double
@@ -172,8 +191,30 @@ YansErrorRateModel::GetFecQamBer (double snr, uint32_t nbits,
   return pms;
 }
 
+void
+YansErrorRateModel::SetLookupTableTolerance (double tolerance)
+{
+  m_table.SetTolerance (tolerance);
+}
+
+double
+YansErrorRateModel::GetLookupTableTolerance (void) const
+{
+  return m_table.GetTolerance ();
+}
+
 double
 YansErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  if (m_useLookupTable)
+    {
+      return m_table.GetChunkSuccessRate (mode, snr, nbits);
+    }
+  return CalculateChunkSuccessRate (mode, snr, nbits);
+}
+
+double
+YansErrorRateModel::CalculateChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
 {
   if (mode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM
       || mode.GetModulationClass () == WIFI_MOD_CLASS_OFDM)
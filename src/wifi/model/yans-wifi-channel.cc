@@ -20,10 +20,13 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/mobility-model.h"
+#include "ns3/mobility-snapshot.h"
+#include "ns3/delivery-batcher.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
 #include "ns3/object-factory.h"
 #include "yans-wifi-channel.h"
 #include "yans-wifi-phy.h"
@@ -50,11 +53,19 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("UseMobilitySnapshot",
+                   "If true, the mobility models of the PHYs attached to this channel "
+                   "are added to the default MobilitySnapshot so that all the positions "
+                   "needed to deliver a frame are computed in a single pass.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_useSnapshot),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_useSnapshot (false)
 {
 }
 YansWifiChannel::~YansWifiChannel ()
@@ -80,6 +91,17 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
+  Ptr<MobilitySnapshot> snapshot;
+  if (m_useSnapshot)
+    {
+      snapshot = MobilitySnapshot::GetDefault ();
+      snapshot->Add (senderMobility);
+    }
+  // The sender may still modify its packet: take a single copy which is
+  // shared by all the receivers.  Only the PHYs which synchronize on the
+  // signal copy it again.
+  Ptr<const Packet> shared = packet->Copy ();
+  DeliveryBatcher batcher;
   uint32_t j = 0;
   for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
     {
@@ -92,11 +114,14 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
             }
 
           Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
+          if (snapshot != 0)
+            {
+              snapshot->Add (receiverMobility);
+            }
           Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
           double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
           NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
                         "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
           Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
           uint32_t dstNode;
           if (dstNetDevice == 0)
@@ -107,15 +132,16 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
             {
               dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
             }
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive, this,
-                                          j, copy, rxPowerDbm, txVector, preamble);
+          batcher.Add (dstNode, delay,
+                       MakeEvent (&YansWifiChannel::Receive, this,
+                                  j, shared, rxPowerDbm, txVector, preamble));
         }
     }
+  batcher.Schedule ();
 }
 
 void
-YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, double rxPowerDbm,
+YansWifiChannel::Receive (uint32_t i, Ptr<const Packet> packet, double rxPowerDbm,
                           WifiTxVector txVector, WifiPreamble preamble) const
 {
   m_phyList[i]->StartReceivePacket (packet, rxPowerDbm, txVector, preamble);
@@ -106,6 +106,15 @@ YansWifiPhy::GetTypeId (void)
                    MakeDoubleAccessor (&YansWifiPhy::SetRxNoiseFigure,
                                        &YansWifiPhy::GetRxNoiseFigure),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxInterferenceChanges",
+                   "The maximum number of noise and interference power changes remembered "
+                   "while a packet is being received. Beyond this limit, the oldest changes "
+                   "are merged, which makes the PER of that packet approximate. "
+                   "0 means no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&YansWifiPhy::SetMaxInterferenceChanges,
+                                         &YansWifiPhy::GetMaxInterferenceChanges),
+                   MakeUintegerChecker<uint32_t> ())
     .AddAttribute ("State", "The state of the PHY layer",
                    PointerValue (),
                    MakePointerAccessor (&YansWifiPhy::m_state),
@@ -241,6 +250,17 @@ YansWifiPhy::SetRxNoiseFigure (double noiseFigureDb)
   m_interference.SetNoiseFigure (DbToRatio (noiseFigureDb));
 }
 void
+YansWifiPhy::SetMaxInterferenceChanges (uint32_t maxChanges)
+{
+  NS_LOG_FUNCTION (this << maxChanges);
+  m_interference.SetMaxNiChanges (maxChanges);
+}
+uint32_t
+YansWifiPhy::GetMaxInterferenceChanges (void) const
+{
+  return m_interference.GetMaxNiChanges ();
+}
+void
 YansWifiPhy::SetTxPowerStart (double start)
 {
   NS_LOG_FUNCTION (this << start);
@@ -442,7 +462,7 @@ YansWifiPhy::SetReceiveErrorCallback (RxErrorCallback callback)
   m_state->SetReceiveErrorCallback (callback);
 }
 void
-YansWifiPhy::StartReceivePacket (Ptr<Packet> packet,
+YansWifiPhy::StartReceivePacket (Ptr<const Packet> packet,
                                  double rxPowerDbm,
                                  WifiTxVector txVector,
                                  enum WifiPreamble preamble)
@@ -517,7 +537,7 @@ YansWifiPhy::StartReceivePacket (Ptr<Packet> packet,
               NotifyRxBegin (packet);
               m_interference.NotifyRxStart ();
               m_endRxEvent = Simulator::Schedule (rxDuration, &YansWifiPhy::EndReceive, this,
-                                                  packet,
+                                                  packet->Copy (),
                                                   event);
             }
           else
@@ -97,13 +97,15 @@ public:
 
   /**
    * Starting receiving the packet (i.e. the first bit of the preamble has arrived).
+   * The packet is shared by all the receivers of the transmission: the PHY
+   * only makes its own copy when it synchronizes on the signal.
    *
    * \param packet the arriving packet
    * \param rxPowerDbm the receive power in dBm
    * \param txVector the TXVECTOR of the arriving packet
    * \param preamble the preamble of the arriving packet
    */
-  void StartReceivePacket (Ptr<Packet> packet,
+  void StartReceivePacket (Ptr<const Packet> packet,
                            double rxPowerDbm,
                            WifiTxVector txVector,
                            WifiPreamble preamble);
@@ -114,6 +116,13 @@ public:
    * \param noiseFigureDb noise figure in dB
    */
   void SetRxNoiseFigure (double noiseFigureDb);
+  /**
+   * Sets the maximum number of noise and interference changes kept by
+   * the InterferenceHelper of this PHY.
+   *
+   * \param maxChanges the maximum number of changes, or 0 for no limit
+   */
+  void SetMaxInterferenceChanges (uint32_t maxChanges);
   /**
    * Sets the minimum available transmission power level (dBm).
    *
@@ -186,6 +195,13 @@ public:
    * \return the RX noise figure in dBm
    */
   double GetRxNoiseFigure (void) const;
+  /**
+   * Return the maximum number of noise and interference changes kept
+   * by the InterferenceHelper of this PHY.
+   *
+   * \return the maximum number of changes, or 0 if there is no limit
+   */
+  uint32_t GetMaxInterferenceChanges (void) const;
   /**
    * Return the transmission gain (dB).
    *
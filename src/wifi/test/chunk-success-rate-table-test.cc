@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <ns3/test.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/object-factory.h>
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/wifi-phy.h"
+
+using namespace ns3;
+
+/**
+ * Compare the chunk success rates interpolated from the lookup tables
+ * with the ones of the analytical model, over the whole tabulated SNR
+ * range and for chunk sizes up to the reference size.
+ */
+class ChunkSuccessRateTableTestCase : public TestCase
+{
+public:
+  ChunkSuccessRateTableTestCase (std::string model, double tolerance);
+  virtual ~ChunkSuccessRateTableTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  std::string m_model;
+  double m_tolerance;
+};
+
+ChunkSuccessRateTableTestCase::ChunkSuccessRateTableTestCase (std::string model, double tolerance)
+  : TestCase ("Check the lookup tables of " + model),
+    m_model (model),
+    m_tolerance (tolerance)
+{
+}
+
+ChunkSuccessRateTableTestCase::~ChunkSuccessRateTableTestCase ()
+{
+}
+
+void
+ChunkSuccessRateTableTestCase::DoRun (void)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (m_model);
+  Ptr<ErrorRateModel> analytical = factory.Create<ErrorRateModel> ();
+  factory.Set ("UseLookupTable", BooleanValue (true));
+  factory.Set ("LookupTableTolerance", DoubleValue (m_tolerance));
+  Ptr<ErrorRateModel> tabulated = factory.Create<ErrorRateModel> ();
+
+  NS_TEST_ASSERT_MSG_EQ (tabulated->SetAttributeFailSafe ("LookupTableTolerance", DoubleValue (0)), false,
+                         "A zero tolerance should be rejected");
+
+  std::vector<WifiMode> modes;
+  modes.push_back (WifiPhy::GetOfdmRate6Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate9Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate12Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate18Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate24Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate36Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate48Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate54Mbps ());
+  modes.push_back (WifiPhy::GetErpOfdmRate54Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate3MbpsBW10MHz ());
+  modes.push_back (WifiPhy::GetDsssRate11Mbps ());
+
+  uint32_t sizes[] = { 1, 100, 1000, 12000 };
+  for (std::vector<WifiMode>::const_iterator mode = modes.begin (); mode != modes.end (); ++mode)
+    {
+      for (double snrDb = -15.0; snrDb < 45.0; snrDb += 0.0137)
+        {
+          double snr = std::pow (10.0, snrDb / 10.0);
+          for (uint32_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); i++)
+            {
+              double expected = analytical->GetChunkSuccessRate (*mode, snr, sizes[i]);
+              double actual = tabulated->GetChunkSuccessRate (*mode, snr, sizes[i]);
+              NS_TEST_ASSERT_MSG_EQ_TOL (actual, expected, m_tolerance,
+                                         *mode << " snr=" << snrDb << "dB nbits=" << sizes[i]);
+            }
+        }
+    }
+}
+
+class ChunkSuccessRateTableTestSuite : public TestSuite
+{
+public:
+  ChunkSuccessRateTableTestSuite ();
+};
+
+ChunkSuccessRateTableTestSuite::ChunkSuccessRateTableTestSuite ()
+  : TestSuite ("wifi-chunk-success-rate-table", UNIT)
+{
+  AddTestCase (new ChunkSuccessRateTableTestCase ("ns3::NistErrorRateModel", 1e-6), TestCase::QUICK);
+  AddTestCase (new ChunkSuccessRateTableTestCase ("ns3::NistErrorRateModel", 1e-3), TestCase::QUICK);
+  AddTestCase (new ChunkSuccessRateTableTestCase ("ns3::YansErrorRateModel", 1e-6), TestCase::QUICK);
+  AddTestCase (new ChunkSuccessRateTableTestCase ("ns3::YansErrorRateModel", 1e-3), TestCase::QUICK);
+}
+
+static ChunkSuccessRateTableTestSuite g_chunkSuccessRateTableTestSuite;
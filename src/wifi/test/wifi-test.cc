@@ -29,6 +29,7 @@
 #include "ns3/propagation-loss-model.h"
 #include "ns3/error-rate-model.h"
 #include "ns3/yans-error-rate-model.h"
+#include "ns3/interference-helper.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/node.h"
 #include "ns3/simulator.h"
@@ -41,6 +42,7 @@
 #include "ns3/edca-txop-n.h"
 #include "ns3/config.h"
 #include "ns3/boolean.h"
+#include <cmath>
 
 using namespace ns3;
 
@@ -323,6 +325,85 @@ InterferenceHelperSequenceTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Receive a frame while more frames overlap it than the InterferenceHelper
+ * is allowed to remember, so that the changes of the received frame itself
+ * are folded.  The interferers are too weak to matter, so the PER must
+ * stay the one computed without a bound.
+ */
+class InterferenceHelperMaxChangesTest : public TestCase
+{
+public:
+  InterferenceHelperMaxChangesTest ();
+
+  virtual void DoRun (void);
+private:
+  double ReceiveWithInterferers (uint32_t maxChanges);
+  void AddInterferer (void);
+  void EndRx (void);
+
+  InterferenceHelper m_interference;
+  Ptr<InterferenceHelper::Event> m_event;
+  WifiTxVector m_txVector;
+  double m_rxPowerW;
+  double m_per;
+};
+
+InterferenceHelperMaxChangesTest::InterferenceHelperMaxChangesTest ()
+  : TestCase ("InterferenceHelperMaxChanges")
+{
+}
+
+void
+InterferenceHelperMaxChangesTest::AddInterferer (void)
+{
+  m_interference.Add (1000, m_txVector.GetMode (), WIFI_PREAMBLE_LONG,
+                      MicroSeconds (1000), 1e-16, m_txVector);
+}
+
+void
+InterferenceHelperMaxChangesTest::EndRx (void)
+{
+  m_per = m_interference.CalculateSnrPer (m_event).per;
+  m_interference.NotifyRxEnd ();
+}
+
+double
+InterferenceHelperMaxChangesTest::ReceiveWithInterferers (uint32_t maxChanges)
+{
+  m_interference.EraseEvents ();
+  m_interference.SetMaxNiChanges (maxChanges);
+  m_event = m_interference.Add (1000, m_txVector.GetMode (), WIFI_PREAMBLE_LONG,
+                                MicroSeconds (1000), m_rxPowerW, m_txVector);
+  m_interference.NotifyRxStart ();
+  // six interferers start during the frame and end after it
+  for (uint32_t i = 1; i <= 6; i++)
+    {
+      Simulator::Schedule (MicroSeconds (100 * i), &InterferenceHelperMaxChangesTest::AddInterferer, this);
+    }
+  Simulator::Schedule (MicroSeconds (1000), &InterferenceHelperMaxChangesTest::EndRx, this);
+  m_per = -1;
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_per;
+}
+
+void
+InterferenceHelperMaxChangesTest::DoRun (void)
+{
+  m_interference.SetNoiseFigure (std::pow (10.0, 7.0 / 10.0));
+  m_interference.SetErrorRateModel (CreateObject<YansErrorRateModel> ());
+  m_txVector.SetMode (WifiPhy::GetOfdmRate6Mbps ());
+
+  // a weak frame, whose PER depends on the duration of its chunks
+  m_rxPowerW = 4.3e-13;
+  double per = ReceiveWithInterferers (0);
+  NS_TEST_ASSERT_MSG_EQ_TOL (per, 0.28, 0.01, "unexpected PER without a bound on the changes");
+  double perBounded = ReceiveWithInterferers (4);
+  NS_TEST_ASSERT_MSG_EQ_TOL (perBounded, per, 1e-3, "wrong PER once the changes of the frame are folded");
+}
+
 //-----------------------------------------------------------------------------
 /**
  * Make sure that when multiple broadcast packets are queued on the same
@@ -491,6 +572,7 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new WifiTest, TestCase::QUICK);
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); // Bug 991
+  AddTestCase (new InterferenceHelperMaxChangesTest, TestCase::QUICK);
   AddTestCase (new Bug555TestCase, TestCase::QUICK); // Bug 555
 }
 
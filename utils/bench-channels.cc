@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Benchmark the delivery of the shared channels: every node echoes UDP
+// packets with node 0 over either a CSMA LAN or an ad hoc wifi network
+// built with the default helpers, and the real and user times of the
+// simulation are reported.  With --devices, each node attaches several
+// devices to the channel, which is the case where the receptions of a
+// transmission reach the same node at the same time.
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/csma-module.h"
+#include "ns3/wifi-module.h"
+#include <iostream>
+#include <iomanip>
+
+using namespace ns3;
+
+static NetDeviceContainer
+InstallCsma (NodeContainer nodes, uint32_t devices)
+{
+  CsmaHelper csma;
+  Ptr<CsmaChannel> channel = CreateObject<CsmaChannel> ();
+  NetDeviceContainer result;
+  for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
+    {
+      for (uint32_t j = 0; j < devices; j++)
+        {
+          result.Add (csma.Install (*i, channel));
+        }
+    }
+  return result;
+}
+
+static NetDeviceContainer
+InstallWifi (NodeContainer nodes, uint32_t devices)
+{
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (5.0),
+                                 "DeltaY", DoubleValue (5.0),
+                                 "GridWidth", UintegerValue (10));
+  mobility.Install (nodes);
+
+  WifiHelper wifi = WifiHelper::Default ();
+  NqosWifiMacHelper mac = NqosWifiMacHelper::Default ();
+  mac.SetType ("ns3::AdhocWifiMac");
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  NetDeviceContainer result;
+  for (uint32_t i = 0; i < devices; i++)
+    {
+      result.Add (wifi.Install (phy, mac, nodes));
+    }
+  return result;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nodes = 20;
+  uint32_t devices = 1;
+  uint32_t packets = 100;
+  uint32_t runs = 1;
+  bool useWifi = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("nodes", "number of nodes (default 20)", nodes);
+  cmd.AddValue ("devices", "number of devices of each node on the channel (default 1)", devices);
+  cmd.AddValue ("packets", "number of packets echoed by each node (default 100)", packets);
+  cmd.AddValue ("runs", "number of runs (default 1)", runs);
+  cmd.AddValue ("wifi", "use an ad hoc wifi network instead of a CSMA LAN", useWifi);
+  cmd.Parse (argc, argv);
+
+  std::cout << (useWifi ? "wifi" : "csma") << ", " << nodes << " nodes, "
+            << devices << " devices per node, " << packets << " packets per node" << std::endl;
+
+  for (uint32_t run = 0; run < runs; run++)
+    {
+      NodeContainer c;
+      c.Create (nodes);
+      NetDeviceContainer d = useWifi ? InstallWifi (c, devices) : InstallCsma (c, devices);
+
+      InternetStackHelper internet;
+      internet.Install (c);
+      Ipv4AddressHelper ipv4;
+      ipv4.SetBase ("10.1.0.0", "255.255.0.0");
+      Ipv4InterfaceContainer interfaces = ipv4.Assign (d);
+
+      UdpEchoServerHelper server (9);
+      ApplicationContainer apps = server.Install (c.Get (0));
+      UdpEchoClientHelper client (interfaces.GetAddress (0), 9);
+      client.SetAttribute ("MaxPackets", UintegerValue (packets));
+      client.SetAttribute ("Interval", TimeValue (MilliSeconds (10)));
+      for (uint32_t i = 1; i < nodes; i++)
+        {
+          apps.Add (client.Install (c.Get (i)));
+        }
+      apps.Start (Seconds (1.0));
+      apps.Stop (Seconds (1.0 + 0.01 * packets + 1.0));
+
+      SystemWallClockMs time;
+      time.Start ();
+      Simulator::Run ();
+      time.End ();
+      std::cout << "run " << run << ": " << std::setw (8) << time.GetElapsedReal () << " ms real, "
+                << std::setw (8) << time.GetElapsedUser () << " ms user" << std::endl;
+      Simulator::Destroy ();
+    }
+
+  return 0;
+}